@@ -13,7 +13,12 @@ layout (binding = 0, std430) readonly buffer Line_ssbo {
     Line_data lines[];
 };
 
-uniform mat4 camera_projection_view;
+layout (std140, binding = 0) uniform Camera_ubo {
+    mat4 camera_projection;
+    mat4 camera_view;
+    mat4 camera_projection_view;
+    vec4 camera_position;
+};
 
 
 void main()
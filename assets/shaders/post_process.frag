@@ -6,12 +6,16 @@ layout (location = 0) out vec4 out_frag_color;
 
 uniform sampler2D hdr_buffer;
 uniform float exposure;
+uniform vec2 render_scale;  // Part of `hdr_buffer` that was rendered to (dynamic resolution).
 
 
 void main()
 {
     const float gamma = 2.2;
-    vec3 hdr_color = texture(hdr_buffer, in_tex_coord).rgb;
+    // Keep bilinear taps from bleeding past the edge of the rendered part.
+    vec2 max_tex_coord = render_scale - 0.5 / vec2(textureSize(hdr_buffer, 0));
+    vec2 tex_coord = min(in_tex_coord * render_scale, max_tex_coord);
+    vec3 hdr_color = texture(hdr_buffer, tex_coord).rgb;
 
     // Reinhard tone mapping w/ gamma correction.
     vec3 mapped = hdr_color / (hdr_color + vec3(1.0));
@@ -7,13 +7,25 @@ layout (location = 2) in vec2 in_tex_coord;
 layout (location = 0) out vec3 out_normal;
 layout (location = 1) out vec2 out_tex_coord;
 
-uniform mat4 camera_projection_view;
+layout (std140, binding = 0) uniform Camera_ubo {
+    mat4 camera_projection;
+    mat4 camera_view;
+    mat4 camera_projection_view;
+    vec4 camera_position;
+};
+layout (std430, binding = 5) readonly buffer Instance_transforms_ssbo {
+    mat4 instance_transforms[];
+};
 uniform mat4 model_transform;
+uniform bool use_instance_transforms;  // Instanced draws read `instance_transforms` instead.
 
 
 void main()
 {
-    gl_Position = camera_projection_view * model_transform * vec4(in_position, 1.0);
-    out_normal = mat3(transpose(inverse(model_transform))) * in_normal;
+    mat4 transform = (use_instance_transforms
+                          ? instance_transforms[gl_BaseInstance + gl_InstanceID]
+                          : model_transform);
+    gl_Position = camera_projection_view * transform * vec4(in_position, 1.0);
+    out_normal = mat3(transpose(inverse(transform))) * in_normal;
     out_tex_coord = in_tex_coord;
 }
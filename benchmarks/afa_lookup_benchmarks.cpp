@@ -0,0 +1,97 @@
+#include "animation_frame_action_tool/runtime_data.h"
+#include "benchmark_harness.h"
+
+#include <unordered_map>
+#include <vector>
+
+
+namespace
+{
+
+using namespace BT::anim_frame_action;
+
+template<typename T>
+using Overridable_data = Runtime_controllable_data::Overridable_data<T>;
+
+constexpr size_t k_num_ticks{ 100000 };
+constexpr size_t k_num_runs{ 5 };
+
+/// Labels in [`begin_marker` + 1, `end_marker`).
+std::vector<Controllable_data_label> get_labels_between(uint32_t begin_marker,
+                                                        uint32_t end_marker)
+{
+    std::vector<Controllable_data_label> labels;
+    for (uint32_t label = begin_marker + 1; label < end_marker; label++)
+        labels.emplace_back(static_cast<Controllable_data_label>(label));
+    return labels;
+}
+
+}  // namespace
+
+
+/// Reads and writes every float and bool label once per tick, like gameplay systems do.
+/// Compares the flat label-indexed arrays against label keyed `std::unordered_map`s (the storage
+/// `Runtime_controllable_data` used to have).
+BT_BENCHMARK(afa_controllable_data_lookup)
+{
+    auto const float_labels{
+        get_labels_between(INTERNAL__CTRL_DATA_LABEL_MARKER_BEGIN_FLOAT,
+                           INTERNAL__CTRL_DATA_LABEL_MARKER_END_FLOAT_BEGIN_BOOL) };
+    auto const bool_labels{
+        get_labels_between(INTERNAL__CTRL_DATA_LABEL_MARKER_END_FLOAT_BEGIN_BOOL,
+                           INTERNAL__CTRL_DATA_LABEL_MARKER_END_BOOL_BEGIN_REEVE) };
+
+    // One read and one write lookup per label per tick.
+    double_t const num_lookups{ static_cast<double_t>(k_num_ticks) * 2.0 *
+                                (float_labels.size() + bool_labels.size()) };
+
+    {   // Flat arrays.
+        Runtime_controllable_data flat_data;
+        auto seconds{ BT::benchmark::time_fastest_run(k_num_runs, [&]() {
+            float_t sum{ 0.0f };
+            for (size_t tick = 0; tick < k_num_ticks; tick++)
+            {
+                for (auto label : float_labels)
+                {
+                    sum += flat_data.get_float_data_handle(label).get_val();
+                    flat_data.get_float_data_handle(label).write_val(static_cast<float_t>(tick));
+                }
+                for (auto label : bool_labels)
+                {
+                    sum += (flat_data.get_bool_data_handle(label).get_val() ? 1.0f : 0.0f);
+                    flat_data.get_bool_data_handle(label).write_val((tick & 1) == 0);
+                }
+            }
+            BT::benchmark::keep_result(sum);
+        }) };
+        BT::benchmark::report_throughput("flat arrays", num_lookups, seconds, "lookups");
+    }
+
+    {   // Label keyed maps.
+        std::unordered_map<Controllable_data_label, Overridable_data<float_t>> map_floats;
+        std::unordered_map<Controllable_data_label, Overridable_data<bool>> map_bools;
+        for (auto label : float_labels)
+            map_floats.emplace(label, Overridable_data<float_t>(0.0f));
+        for (auto label : bool_labels)
+            map_bools.emplace(label, Overridable_data<bool>(false));
+
+        auto seconds{ BT::benchmark::time_fastest_run(k_num_runs, [&]() {
+            float_t sum{ 0.0f };
+            for (size_t tick = 0; tick < k_num_ticks; tick++)
+            {
+                for (auto label : float_labels)
+                {
+                    sum += map_floats.at(label).get_val();
+                    map_floats.at(label).write_val(static_cast<float_t>(tick));
+                }
+                for (auto label : bool_labels)
+                {
+                    sum += (map_bools.at(label).get_val() ? 1.0f : 0.0f);
+                    map_bools.at(label).write_val((tick & 1) == 0);
+                }
+            }
+            BT::benchmark::keep_result(sum);
+        }) };
+        BT::benchmark::report_throughput("unordered_maps", num_lookups, seconds, "lookups");
+    }
+}
@@ -0,0 +1,74 @@
+#pragma once
+
+#include "timer/timer.h"
+
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+
+namespace BT
+{
+namespace benchmark
+{
+
+using Benchmark_func = void (*)();
+
+struct Benchmark
+{
+    char const* name;
+    Benchmark_func func;
+};
+
+/// All benchmarks defined with `BT_BENCHMARK()`, in registration order.
+std::vector<Benchmark>& get_registered_benchmarks();
+
+/// Registers a benchmark at static init time (use `BT_BENCHMARK()` instead).
+struct Benchmark_registrar
+{
+    Benchmark_registrar(char const* name, Benchmark_func func);
+};
+
+/// Prints `num_items / seconds` for a measured run.
+void report_throughput(char const* label, double_t num_items, float_t seconds, char const* unit);
+
+/// Keeps the compiler from optimizing away the calculation of `value`.
+template<typename T>
+void keep_result(T const& value)
+{
+#if defined(_MSC_VER)
+    // @NOTE: MSVC x64 has no inline asm, so store to a volatile sink instead.
+    static volatile T s_sink;
+    s_sink = value;
+#else
+    // Empty asm that "reads" `value` (GCC/Clang warn about set but unused volatile sinks).
+    asm volatile("" : : "g"(value) : "memory");
+#endif
+}
+
+/// Runs `func` `num_runs` times and returns the fastest run in seconds.
+template<typename Func>
+float_t time_fastest_run(size_t num_runs, Func&& func)
+{
+    float_t fastest_time{ INFINITY };
+    for (size_t i = 0; i < num_runs; i++)
+    {
+        Timer timer;
+        timer.start_timer();
+        func();
+        fastest_time = std::fmin(fastest_time, timer.calc_delta_time());
+    }
+    return fastest_time;
+}
+
+}  // namespace benchmark
+}  // namespace BT
+
+
+/// Defines and registers a benchmark.
+#define BT_BENCHMARK(benchmark_name)                                                        \
+    static void benchmark_name();                                                           \
+    static BT::benchmark::Benchmark_registrar s_##benchmark_name##_registrar{               \
+        #benchmark_name, benchmark_name };                                                  \
+    static void benchmark_name()
@@ -0,0 +1,48 @@
+#include "benchmark_harness.h"
+#include "btlogger.h"
+
+#include <cstdint>
+#include <cstring>
+
+
+std::vector<BT::benchmark::Benchmark>& BT::benchmark::get_registered_benchmarks()
+{
+    static std::vector<Benchmark> s_registered_benchmarks;
+    return s_registered_benchmarks;
+}
+
+BT::benchmark::Benchmark_registrar::Benchmark_registrar(char const* name, Benchmark_func func)
+{
+    get_registered_benchmarks().emplace_back(name, func);
+}
+
+void BT::benchmark::report_throughput(char const* label,
+                                      double_t num_items,
+                                      float_t seconds,
+                                      char const* unit)
+{
+    BT_TRACEF("  %-40s %14.0f %s/sec  (%.3f ms)",
+              label,
+              num_items / seconds,
+              unit,
+              seconds * 1000.0f);
+}
+
+/// Runs every benchmark, or only the ones whose name contains the first argument.
+int32_t main(int32_t argc, char** argv)
+{
+    char const* name_filter{ argc > 1 ? argv[1] : "" };
+
+#ifndef NDEBUG
+    BT_WARN("Benchmarking a debug build. Numbers are not representative.");
+#endif  // NDEBUG
+
+    for (auto const& benchmark : BT::benchmark::get_registered_benchmarks())
+        if (std::strstr(benchmark.name, name_filter) != nullptr)
+        {
+            BT_TRACEF("%s", benchmark.name);
+            benchmark.func();
+        }
+
+    return 0;
+}
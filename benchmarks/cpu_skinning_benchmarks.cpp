@@ -0,0 +1,114 @@
+#include "benchmark_harness.h"
+#include "btglm.h"
+#include "btlogger.h"
+#include "renderer/cpu_skinning.h"
+#include "renderer/mesh.h"
+
+#include <random>
+#include <string>
+#include <vector>
+
+
+namespace
+{
+
+using namespace BT;
+
+constexpr size_t k_num_vertices{ 256 * 1024 };
+constexpr size_t k_num_joints{ 64 };
+constexpr size_t k_num_runs{ 10 };
+
+struct Skinning_test_data
+{
+    std::vector<Vertex> vertices;
+    std::vector<Vertex_skin_data> skin_datas;
+    std::vector<cpu_skinning::Palette_entry> palette;
+};
+
+/// Random vertices w/ 4 joint influences each, and a palette of random rigid joints.
+Skinning_test_data make_skinning_test_data()
+{
+    std::mt19937 rng{ 1234 };
+    std::uniform_real_distribution<float_t> unit_dist{ -1.0f, 1.0f };
+    std::uniform_int_distribution<uint32_t> joint_dist{ 0, k_num_joints - 1 };
+
+    Skinning_test_data data;
+    data.vertices.reserve(k_num_vertices);
+    data.skin_datas.reserve(k_num_vertices);
+    for (size_t i = 0; i < k_num_vertices; i++)
+    {
+        Vertex vertex{ { unit_dist(rng), unit_dist(rng), unit_dist(rng) },
+                       { unit_dist(rng), unit_dist(rng), unit_dist(rng) },
+                       { 0.0f, 0.0f } };
+        glm_vec3_normalize(vertex.normal);
+        data.vertices.emplace_back(vertex);
+
+        Vertex_skin_data skin_data{
+            { joint_dist(rng), joint_dist(rng), joint_dist(rng), joint_dist(rng) },
+            { 0.4f, 0.3f, 0.2f, 0.1f } };
+        data.skin_datas.emplace_back(skin_data);
+    }
+
+    data.palette.resize(k_num_joints);
+    for (size_t i = 0; i < k_num_joints; i++)
+    {
+        vec3 axis{ unit_dist(rng), unit_dist(rng), 1.0f };
+        vec3 translation{ unit_dist(rng), unit_dist(rng), unit_dist(rng) };
+
+        mat4 joint_matrix;
+        glm_translate_make(joint_matrix, translation);
+        glm_rotate(joint_matrix, unit_dist(rng) * 3.0f, axis);
+        cpu_skinning::calc_palette_entry(joint_matrix, data.palette[i]);
+    }
+
+    return data;
+}
+
+}  // namespace
+
+
+/// Skins a big mesh w/ each kernel, on one thread (one vertex range) and split across threads.
+BT_BENCHMARK(cpu_skinning_kernels)
+{
+    auto const data{ make_skinning_test_data() };
+    std::vector<Vertex> skinned_vertices(k_num_vertices);
+
+    auto run_kernel{ [&](cpu_skinning::Kernel kernel, char const* kernel_name) {
+        auto seconds{ BT::benchmark::time_fastest_run(k_num_runs, [&]() {
+            cpu_skinning::skin_vertex_range(kernel,
+                                            data.vertices.data(),
+                                            data.skin_datas.data(),
+                                            data.palette.data(),
+                                            0,
+                                            k_num_vertices,
+                                            skinned_vertices.data());
+            BT::benchmark::keep_result(skinned_vertices.back().normal[0]);
+        }) };
+        BT::benchmark::report_throughput(
+            (std::string(kernel_name) + ", single thread").c_str(),
+            static_cast<double_t>(k_num_vertices),
+            seconds,
+            "vertices");
+
+        seconds = BT::benchmark::time_fastest_run(k_num_runs, [&]() {
+            cpu_skinning::skin_vertices_parallel(kernel,
+                                                 data.vertices.data(),
+                                                 data.skin_datas.data(),
+                                                 data.palette.data(),
+                                                 k_num_vertices,
+                                                 skinned_vertices.data());
+            BT::benchmark::keep_result(skinned_vertices.back().normal[0]);
+        });
+        BT::benchmark::report_throughput((std::string(kernel_name) + ", parallel").c_str(),
+                                         static_cast<double_t>(k_num_vertices),
+                                         seconds,
+                                         "vertices");
+    } };
+
+    run_kernel(cpu_skinning::KERNEL_SCALAR, "scalar");
+
+    if (cpu_skinning::is_avx2_supported())
+        run_kernel(cpu_skinning::KERNEL_AVX2, "AVX2");
+    else
+        BT_WARN("AVX2 not supported. Skipping AVX2 kernel.");
+}
@@ -0,0 +1,66 @@
+#include "benchmark_harness.h"
+#include "renderer/animator_template_types.h"
+#include "renderer/model_animator.h"
+
+#include <string>
+#include <vector>
+
+
+namespace
+{
+
+using BT::anim_tmpl_types::Animator_variable;
+
+constexpr size_t k_num_variables{ 64 };
+constexpr size_t k_num_sets{ 1000000 };
+constexpr size_t k_num_runs{ 5 };
+constexpr double_t k_num_sets_per_run{ static_cast<double_t>(k_num_sets) };
+
+/// Animator w/ `k_num_variables` float vars and a single state w/o transitions.
+void configure_benchmark_animator(BT::Model_animator& animator)
+{
+    std::vector<Animator_variable> variables;
+    for (size_t i = 0; i < k_num_variables; i++)
+        variables.emplace_back(Animator_variable::TYPE_FLOAT, "var_" + std::to_string(i), 0.0f);
+
+    BT::anim_tmpl_types::Compiled_state_transitions transitions;
+    transitions.state_offsets = { 0, 0 };
+
+    animator.configure_animator_states({ { "idle", 0 } }, variables, transitions);
+}
+
+}  // namespace
+
+
+/// Sets the first and the last of `k_num_variables` vars, by resolved handle and by name.
+/// Handle sets should cost the same for both, while name sets go up w/ the var's position.
+BT_BENCHMARK(model_animator_variable_set)
+{
+    BT::Model_skin model_skin;
+    std::vector<BT::Model_joint_animation> model_animations;
+    BT::Model_animator animator{ model_skin, model_animations, false };
+    configure_benchmark_animator(animator);
+
+    for (size_t var_idx : { size_t{ 0 }, k_num_variables - 1 })
+    {
+        std::string const var_name{ "var_" + std::to_string(var_idx) };
+        std::string const position{ var_idx == 0 ? "first" : "last" };
+
+        auto const handle{ animator.find_variable_handle(var_name) };
+        auto seconds{ BT::benchmark::time_fastest_run(k_num_runs, [&]() {
+            for (size_t i = 0; i < k_num_sets; i++)
+                animator.set_float_variable(handle, static_cast<float_t>(i));
+            BT::benchmark::keep_result(animator.get_float_variable(handle));
+        }) };
+        BT::benchmark::report_throughput(
+            ("by handle, " + position + " var").c_str(), k_num_sets_per_run, seconds, "sets");
+
+        seconds = BT::benchmark::time_fastest_run(k_num_runs, [&]() {
+            for (size_t i = 0; i < k_num_sets; i++)
+                animator.set_float_variable(var_name, static_cast<float_t>(i));
+            BT::benchmark::keep_result(animator.get_float_variable(handle));
+        });
+        BT::benchmark::report_throughput(
+            ("by name, " + position + " var").c_str(), k_num_sets_per_run, seconds, "sets");
+    }
+}
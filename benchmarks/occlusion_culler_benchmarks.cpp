@@ -0,0 +1,145 @@
+#include "benchmark_harness.h"
+#include "btlogger.h"
+#include "cglm/cglm.h"
+#include "renderer/occlusion_culler.h"
+
+#include <cstdint>
+#include <vector>
+
+
+namespace
+{
+
+using namespace BT;
+
+constexpr size_t k_num_runs{ 20 };
+constexpr int32_t k_num_buildings_per_side{ 8 };
+constexpr int32_t k_num_occludees_per_side{ 64 };
+
+/// Unit box (-1 to 1 on every axis), 12 triangles.
+struct Box_mesh
+{
+    float_t positions[8][3];
+    uint32_t indices[36];
+};
+
+Box_mesh make_box_mesh()
+{
+    Box_mesh box_mesh{};
+    for (uint32_t i = 0; i < 8; i++)
+    {
+        box_mesh.positions[i][0] = (i & 0b001) ? 1.0f : -1.0f;
+        box_mesh.positions[i][1] = (i & 0b010) ? 1.0f : -1.0f;
+        box_mesh.positions[i][2] = (i & 0b100) ? 1.0f : -1.0f;
+    }
+
+    constexpr uint32_t k_indices[36]{
+        0, 1, 3, 0, 3, 2,  // -Z
+        4, 6, 7, 4, 7, 5,  // +Z
+        0, 4, 5, 0, 5, 1,  // -Y
+        2, 3, 7, 2, 7, 6,  // +Y
+        0, 2, 6, 0, 6, 4,  // -X
+        1, 5, 7, 1, 7, 3,  // +X
+    };
+    for (uint32_t i = 0; i < 36; i++)
+        box_mesh.indices[i] = k_indices[i];
+
+    return box_mesh;
+}
+
+/// City block like scene: a grid of buildings in front of the camera, w/ a grid of small props
+/// spread out behind and between them.
+struct Occlusion_test_scene
+{
+    mat4 projection_view;
+    Box_mesh box_mesh;
+    std::vector<mat4s> building_transforms;
+    std::vector<vec3s> occludee_mins;
+    std::vector<vec3s> occludee_maxs;
+};
+
+Occlusion_test_scene make_occlusion_test_scene()
+{
+    Occlusion_test_scene scene;
+
+    mat4 projection;
+    mat4 view;
+    glm_perspective(glm_rad(70.0f), 16.0f / 9.0f, 0.1f, 500.0f, projection);
+    vec3 eye{ 0.0f, 2.0f, 0.0f };
+    vec3 center{ 0.0f, 2.0f, -1.0f };
+    vec3 up{ 0.0f, 1.0f, 0.0f };
+    glm_lookat(eye, center, up, view);
+    glm_mat4_mul(projection, view, scene.projection_view);
+
+    scene.box_mesh = make_box_mesh();
+
+    for (int32_t z = 0; z < k_num_buildings_per_side; z++)
+    for (int32_t x = 0; x < k_num_buildings_per_side; x++)
+    {
+        vec3 position{ (x - k_num_buildings_per_side / 2) * 12.0f + 6.0f, 5.0f, -15.0f - z * 12.0f };
+        vec3 scale{ 4.0f, 5.0f, 4.0f };
+
+        mat4s transform;
+        glm_translate_make(transform.raw, position);
+        glm_scale(transform.raw, scale);
+        scene.building_transforms.emplace_back(transform);
+    }
+
+    for (int32_t z = 0; z < k_num_occludees_per_side; z++)
+    for (int32_t x = 0; x < k_num_occludees_per_side; x++)
+    {
+        vec3s center{ (x - k_num_occludees_per_side / 2) * 1.5f, 0.5f, -20.0f - z * 1.5f };
+        scene.occludee_mins.emplace_back(vec3s{ center.x - 0.5f, center.y - 0.5f, center.z - 0.5f });
+        scene.occludee_maxs.emplace_back(vec3s{ center.x + 0.5f, center.y + 0.5f, center.z + 0.5f });
+    }
+
+    return scene;
+}
+
+void rasterize_test_scene(Occlusion_culler& occlusion_culler, Occlusion_test_scene& scene)
+{
+    occlusion_culler.begin_frame(scene.projection_view);
+    for (auto& transform : scene.building_transforms)
+        occlusion_culler.rasterize_occluder(&scene.box_mesh.positions[0][0],
+                                            sizeof(scene.box_mesh.positions[0]),
+                                            8,
+                                            scene.box_mesh.indices,
+                                            36,
+                                            transform.raw);
+    occlusion_culler.finish_occluders();
+}
+
+}  // namespace
+
+
+/// Rasterizes a grid of building occluders, then tests a grid of prop bounds against them.
+BT_BENCHMARK(occlusion_culler)
+{
+    auto scene{ make_occlusion_test_scene() };
+    Occlusion_culler occlusion_culler;
+
+    auto seconds{ BT::benchmark::time_fastest_run(k_num_runs, [&]() {
+        rasterize_test_scene(occlusion_culler, scene);
+        BT::benchmark::keep_result(occlusion_culler.get_depth_buffer()[0]);
+    }) };
+    BT::benchmark::report_throughput("rasterize occluders",
+                                     static_cast<double_t>(scene.building_transforms.size() * 12),
+                                     seconds,
+                                     "triangles");
+
+    rasterize_test_scene(occlusion_culler, scene);
+    size_t num_occludees{ scene.occludee_mins.size() };
+    size_t num_visible{ 0 };
+    seconds = BT::benchmark::time_fastest_run(k_num_runs, [&]() {
+        num_visible = 0;
+        for (size_t i = 0; i < num_occludees; i++)
+            if (occlusion_culler.is_visible(scene.occludee_mins[i].raw, scene.occludee_maxs[i].raw))
+                num_visible++;
+        BT::benchmark::keep_result(num_visible);
+    });
+    BT::benchmark::report_throughput("test occludees",
+                                     static_cast<double_t>(num_occludees),
+                                     seconds,
+                                     "bounds");
+    BT_TRACEF("  %zu/%zu occludees occluded", num_occludees - num_visible, num_occludees);
+}
@@ -6,6 +6,7 @@
 #include "../renderer/model_animator.h"
 #include "btjson.h"
 
+#include <algorithm>
 #include <sstream>
 #include <string>
 #include <unordered_map>
@@ -73,7 +74,7 @@ BT::anim_frame_action::Runtime_controllable_data
     ::get_float_data_handle(Controllable_data_label label)
 {
     assert(get_data_type(label) == CTRL_DATA_TYPE_FLOAT);
-    return data_floats.at(label);
+    return data_floats[label - INTERNAL__CTRL_DATA_LABEL_MARKER_BEGIN_FLOAT - 1];
 }
 
 BT::anim_frame_action::Runtime_controllable_data::Overridable_data<bool>&
@@ -81,7 +82,7 @@ BT::anim_frame_action::Runtime_controllable_data
     ::get_bool_data_handle(Controllable_data_label label)
 {
     assert(get_data_type(label) == CTRL_DATA_TYPE_BOOL);
-    return data_bools.at(label);
+    return data_bools[label - INTERNAL__CTRL_DATA_LABEL_MARKER_END_FLOAT_BEGIN_BOOL - 1];
 }
 
 BT::anim_frame_action::Runtime_controllable_data::Rising_edge_event&
@@ -89,58 +90,27 @@ BT::anim_frame_action::Runtime_controllable_data
     ::get_reeve_data_handle(Controllable_data_label label)
 {
     assert(get_data_type(label) == CTRL_DATA_TYPE_RISING_EDGE_EVENT);
-    return data_reeves.at(label);
+    return data_reeves[label - INTERNAL__CTRL_DATA_LABEL_MARKER_END_BOOL_BEGIN_REEVE - 1];
 }
 
 void BT::anim_frame_action::Runtime_controllable_data
     ::clear_all_data_overrides()
-{   // Populate the overridable data labels.
-    static auto s_get_overridable_data_labels_fn = []() {
-        std::vector<Controllable_data_label> overridable_data_labels;
-
-        auto const& str_labels{ get_all_str_labels() };
-        for (auto const& str_label : str_labels)
-        {
-            auto data_label{ str_label_to_enum(str_label) };
-            switch (get_data_type(data_label))
-            {
-                case CTRL_DATA_TYPE_FLOAT:
-                case CTRL_DATA_TYPE_BOOL:
-                    overridable_data_labels.emplace_back(data_label);
-                    break;
-
-                default:
-                    // Ignore since not overridable label.
-                    break;
-            }
-        }
-
-        return overridable_data_labels;
-    };
-
-    static auto s_overridable_data_labels{ s_get_overridable_data_labels_fn() };
+{
+    for (auto& data_float : data_floats)
+        data_float.clear_overriding();
 
-    // Clear the data labels.
-    for (auto data_label : s_overridable_data_labels)
-    {
-        switch (get_data_type(data_label))
-        {
-            case CTRL_DATA_TYPE_FLOAT:
-                get_float_data_handle(data_label)
-                    .clear_overriding();
-                break;
+    for (auto& data_bool : data_bools)
+        data_bool.clear_overriding();
+}
 
-            case CTRL_DATA_TYPE_BOOL:
-                get_bool_data_handle(data_label)
-                    .clear_overriding();
-                break;
+void BT::anim_frame_action::Runtime_controllable_data
+    ::mark_all_data_changed()
+{
+    for (auto& data_float : data_floats)
+        data_float.mark_changed();
 
-            default:
-                // @NOTE: Should not enter this branch bc of prior filtering.
-                assert(false);
-                break;
-        }
-    }
+    for (auto& data_bool : data_bools)
+        data_bool.mark_changed();
 }
 
 void BT::anim_frame_action::Runtime_controllable_data::map_animator_to_control_regions(
@@ -189,9 +159,13 @@ void BT::anim_frame_action::Runtime_controllable_data
     {
         assert(data_label_idx < s_all_hitcapsule_grp_data_labels.size());
 
-        // Use data handle to set hitcapsule group enabled flag.
-        hitcapsule_grp.set_enabled(
-            get_bool_data_handle(s_all_hitcapsule_grp_data_labels[data_label_idx]).get_val());
+        // Use data handle to set hitcapsule group enabled flag (skip if unchanged).
+        auto& enabled_data{ get_bool_data_handle(s_all_hitcapsule_grp_data_labels[data_label_idx]) };
+        if (enabled_data.is_changed())
+        {
+            hitcapsule_grp.set_enabled(enabled_data.get_val());
+            enabled_data.clear_changed();
+        }
 
         data_label_idx++;
     }
@@ -225,6 +199,9 @@ BT::anim_frame_action::Runtime_data_controls::Runtime_data_controls(std::string
 
     // Ctrl items type calculation.
     calculate_all_ctrl_item_types();
+
+    // Compile timelines for runtime.
+    compile_timelines();
 }
 
 void BT::anim_frame_action::Runtime_data_controls::calculate_all_ctrl_item_types()
@@ -314,6 +291,65 @@ void BT::anim_frame_action::Runtime_data_controls::calculate_all_ctrl_item_types
     }
 }
 
+void BT::anim_frame_action::Runtime_data_controls::compile_timelines()
+{
+    static uint32_t s_compiled_timelines_generation_counter{ 0 };
+
+    compiled_timelines.clear();
+    compiled_timelines.resize(data.anim_frame_action_timelines.size());
+
+    for (size_t timeline_idx = 0;
+         timeline_idx < data.anim_frame_action_timelines.size();
+         timeline_idx++)
+    {
+        auto const& regions{ data.anim_frame_action_timelines[timeline_idx].regions };
+        auto& compiled{ compiled_timelines[timeline_idx] };
+
+        // Find frame range.
+        int32_t num_frames{ 0 };
+        for (auto const& region : regions)
+            if (data.control_items[region.ctrl_item_idx].type != CTRL_ITEM_TYPE_EVENT_TRIGGER)
+            {
+                num_frames = std::max(num_frames, region.end_frame);
+            }
+
+        // Fill in per frame active ctrl items.
+        compiled.frame_offsets.reserve(num_frames + 1);
+        for (int32_t frame = 0; frame < num_frames; frame++)
+        {
+            compiled.frame_offsets.emplace_back(
+                static_cast<uint32_t>(compiled.active_ctrl_item_idxs.size()));
+
+            for (auto const& region : regions)
+                if (data.control_items[region.ctrl_item_idx].type != CTRL_ITEM_TYPE_EVENT_TRIGGER &&
+                    frame >= region.start_frame &&
+                    frame < region.end_frame)
+                {
+                    compiled.active_ctrl_item_idxs.emplace_back(region.ctrl_item_idx);
+                }
+        }
+        compiled.frame_offsets.emplace_back(
+            static_cast<uint32_t>(compiled.active_ctrl_item_idxs.size()));
+
+        // Fill in event triggers.
+        for (auto const& region : regions)
+            if (data.control_items[region.ctrl_item_idx].type == CTRL_ITEM_TYPE_EVENT_TRIGGER)
+            {
+                compiled.event_triggers_sorted.emplace_back(region.start_frame,
+                                                            region.ctrl_item_idx);
+            }
+
+        std::stable_sort(compiled.event_triggers_sorted.begin(),
+                         compiled.event_triggers_sorted.end(),
+                         [](Compiled_timeline::Event_trigger const& a,
+                            Compiled_timeline::Event_trigger const& b) {
+                             return a.frame < b.frame;
+                         });
+    }
+
+    compiled_timelines_generation = ++s_compiled_timelines_generation_counter;
+}
+
 // Bank of data controls.
 void BT::anim_frame_action::Bank::emplace(std::string const& name,
                                           Runtime_data_controls&& runtime_state)
@@ -3,6 +3,7 @@
 #include "../hitbox_interactor/hitcapsule.h"
 #include "btglm.h"
 #include "btjson.h"
+#include <array>
 #include <string>
 #include <unordered_map>
 #include <vector>
@@ -160,28 +161,41 @@ struct Runtime_controllable_data
 
         void clear_overriding()
         {   // Clear upon every change in the timeline.
+            T prev_val{ get_val() };
             m_use_overriding_val = false;
+            m_changed |= (get_val() != prev_val);
         }
 
         void write_val(T val)
         {
+            T prev_val{ get_val() };
             m_persistant_val = val;
+            m_changed |= (get_val() != prev_val);
         }
 
         void override_val(T val)
         {
+            T prev_val{ get_val() };
             m_overriding_val = val;
             m_use_overriding_val = true;
+            m_changed |= (get_val() != prev_val);
         }
 
         T get_val() const
         {
             return (m_use_overriding_val ? m_overriding_val : m_persistant_val);
         }
+
+        /// Whether `get_val()` changed since the last `clear_changed()`. Starts out changed.
+        bool is_changed() const { return m_changed; }
+        void mark_changed() { m_changed = true; }
+        void clear_changed() { m_changed = false; }
+
     private:
         T m_persistant_val;
         T m_overriding_val;
         bool m_use_overriding_val{ false };
+        bool m_changed{ true };
     };
 
     // Rising edge event class.
@@ -196,10 +210,21 @@ struct Runtime_controllable_data
         float_t m__dev_re_ocurred_cooldown{ 0.0f };
     };
 
+    // Number of labels of each data type.
+    static constexpr size_t k_num_float_labels{
+        INTERNAL__CTRL_DATA_LABEL_MARKER_END_FLOAT_BEGIN_BOOL -
+        INTERNAL__CTRL_DATA_LABEL_MARKER_BEGIN_FLOAT - 1 };
+    static constexpr size_t k_num_bool_labels{
+        INTERNAL__CTRL_DATA_LABEL_MARKER_END_BOOL_BEGIN_REEVE -
+        INTERNAL__CTRL_DATA_LABEL_MARKER_END_FLOAT_BEGIN_BOOL - 1 };
+    static constexpr size_t k_num_reeve_labels{
+        INTERNAL__CTRL_DATA_LABEL_MARKER_END_REEVE -
+        INTERNAL__CTRL_DATA_LABEL_MARKER_END_BOOL_BEGIN_REEVE - 1 };
+
 private:
-    // Lookup reading/writing handle for data.
-    std::unordered_map<Controllable_data_label, Overridable_data<float_t>> data_floats{
-        #define X_float(name, def_val)  { CTRL_DATA_LABEL_##name, Overridable_data<float_t>(def_val) },
+    // Reading/writing handles for data, indexed by label offset from the type's begin marker.
+    std::array<Overridable_data<float_t>, k_num_float_labels> data_floats{
+        #define X_float(name, def_val)  Overridable_data<float_t>(def_val),
         #define X__bool(name, def_val)
         #define X_reeve(name)
         BT_MODEL_ANIMATOR_CONTROLLABLE_DATA_LIST
@@ -207,24 +232,16 @@ private:
         #undef X__bool
         #undef X_reeve
     };
-    std::unordered_map<Controllable_data_label, Overridable_data<bool>> data_bools{
+    std::array<Overridable_data<bool>, k_num_bool_labels> data_bools{
         #define X_float(name, def_val)
-        #define X__bool(name, def_val)  { CTRL_DATA_LABEL_##name, Overridable_data<bool>(def_val) },
+        #define X__bool(name, def_val)  Overridable_data<bool>(def_val),
         #define X_reeve(name)
         BT_MODEL_ANIMATOR_CONTROLLABLE_DATA_LIST
         #undef X_float
         #undef X__bool
         #undef X_reeve
     };
-    std::unordered_map<Controllable_data_label, Rising_edge_event> data_reeves{
-        #define X_float(name, def_val)
-        #define X__bool(name, def_val)
-        #define X_reeve(name)           { CTRL_DATA_LABEL_##name, Rising_edge_event{} },
-        BT_MODEL_ANIMATOR_CONTROLLABLE_DATA_LIST
-        #undef X_float
-        #undef X__bool
-        #undef X_reeve
-    };
+    std::array<Rising_edge_event, k_num_reeve_labels> data_reeves;
 
     #undef BT_MODEL_ANIMATOR_CONTROLLABLE_DATA_LIST
 
@@ -235,6 +252,9 @@ public:
 
     void clear_all_data_overrides();
 
+    /// Marks all float and bool data as changed (e.g. when consumers need a full resync).
+    void mark_all_data_changed();
+
     /// Map to get timeline idx for runtime controls.
     std::unordered_map<size_t, size_t> anim_state_idx_to_timeline_idx_map;
 
@@ -267,6 +287,10 @@ struct Runtime_data_controls
 
     void calculate_all_ctrl_item_types();
 
+    /// Compiles `data.anim_frame_action_timelines` into `compiled_timelines`. Call again whenever
+    /// the timelines or control items change (e.g. from the editor).
+    void compile_timelines();
+
     Model const* animated_model{ nullptr };
 
     struct Data
@@ -313,6 +337,34 @@ struct Runtime_data_controls
                                        anim_frame_action_timelines,
                                        hitcapsule_group_set_template);
     } data;
+
+    /// Runtime lookup version of a timeline. Same order as `data.anim_frame_action_timelines`.
+    /// @NOTE: The editor only works with the source `data`, so this is never serialized.
+    struct Compiled_timeline
+    {
+        /// Data write/override ctrl items active at each frame, in region order (so later regions
+        /// still win). Frame `i` is in range [`frame_offsets[i]`, `frame_offsets[i + 1]`).
+        /// Frames past the end have no active ctrl items.
+        std::vector<uint32_t> frame_offsets;
+        std::vector<uint32_t> active_ctrl_item_idxs;
+
+        /// Event trigger rising edges, sorted by frame.
+        struct Event_trigger
+        {
+            int32_t  frame;
+            uint32_t ctrl_item_idx;
+        };
+        std::vector<Event_trigger> event_triggers_sorted;
+
+        uint32_t get_num_frames() const
+        {
+            return (frame_offsets.empty() ? 0 : static_cast<uint32_t>(frame_offsets.size() - 1));
+        }
+    };
+    std::vector<Compiled_timeline> compiled_timelines;
+
+    /// Unique per `compile_timelines()` call, so users can tell when tables got recompiled.
+    uint32_t compiled_timelines_generation{ 0 };
 };
 
 // Bank of data controls.
@@ -100,6 +100,36 @@ inline void btglm_quat_mul_rvec3(versor const q, rvec3 const v, rvec3 dest)
 }
 
 
+/// Mat4 funcs.
+/// Calculates the normal matrix (inverse transpose of the upper 3x3) of `m`.
+/// If the upper 3x3 is (nearly) singular, eg. scaled to 0 on an axis, there is no inverse, so
+/// this gives the cofactor matrix instead (the inverse transpose before dividing by the
+/// determinant). It still points transformed normals the same way, as long as they get normalized
+/// afterwards.
+inline void btglm_mat4_normal_matrix(mat4 const m, mat3 dest)
+{
+    vec3 col_0{ m[0][0], m[0][1], m[0][2] };
+    vec3 col_1{ m[1][0], m[1][1], m[1][2] };
+    vec3 col_2{ m[2][0], m[2][1], m[2][2] };
+
+    // Columns of the cofactor matrix are `[c1 x c2, c2 x c0, c0 x c1]`.
+    mat3 cofactors;
+    glm_vec3_cross(col_1, col_2, cofactors[0]);
+    glm_vec3_cross(col_2, col_0, cofactors[1]);
+    glm_vec3_cross(col_0, col_1, cofactors[2]);
+
+    // Compare the determinant against the column lengths, so that small but uniform scales still
+    // count as invertible.
+    constexpr float_t k_min_relative_determinant{ 1e-6f };
+    float_t determinant{ glm_vec3_dot(col_0, cofactors[0]) };
+    float_t max_determinant{ glm_vec3_norm(col_0) * glm_vec3_norm(col_1) * glm_vec3_norm(col_2) };
+    if (std::abs(determinant) > k_min_relative_determinant * max_determinant)
+        glm_mat3_scale(cofactors, 1.0f / determinant);
+
+    glm_mat3_copy(cofactors, dest);
+}
+
+
 /// Types from cglm.
 NLOHMANN_DEFINE_TYPE_NON_INTRUSIVE(vec2s, x, y);
 NLOHMANN_DEFINE_TYPE_NON_INTRUSIVE(vec3s, x, y, z);
@@ -2,6 +2,7 @@
 
 #include "btglm.h"
 #include "btjson.h"
+#include "renderer/animator_template_types.h"
 #include "uuid/uuid.h"
 
 #include <array>
@@ -97,6 +98,17 @@ struct Character_mvt_animated_state
         bool prev_attack_pressed{ false };
     } state;
 
+    /// Animator var handles, resolved once per affecting animator.
+    struct Animator_var_handles
+    {
+        uint64_t resolved_for_generation{ 0 };  // Animator variables generation (0 is unresolved).
+        anim_tmpl_types::Animator_variable_handle is_moving;
+        anim_tmpl_types::Animator_variable_handle on_turnaround;
+        anim_tmpl_types::Animator_variable_handle is_grounded;
+        anim_tmpl_types::Animator_variable_handle on_jump;
+        anim_tmpl_types::Animator_variable_handle on_attack;
+    } animator_var_handles;
+
     NLOHMANN_DEFINE_TYPE_INTRUSIVE_WITH_DEFAULT(
         Character_mvt_animated_state,
         affecting_animator_uuid
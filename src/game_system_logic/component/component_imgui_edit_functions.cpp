@@ -362,8 +362,12 @@ void BT::component::edit::imgui_edit__render_object_settings(entt::registry& reg
 
     ImGui::BeginDisabled(!rend_obj_settings.is_deformed);
     ImGui::InputText("Animator template name", &rend_obj_settings.animator_template_name);
+    ImGui::Checkbox("Is CPU skinned", &rend_obj_settings.is_cpu_skinned);
     ImGui::EndDisabled();
 
+    ImGui::Checkbox("Is occluder", &rend_obj_settings.is_occluder);
+    ImGui::Checkbox("Is static", &rend_obj_settings.is_static);
+
     ImGui::EndDisabled();
 
     ImGui::PopItemWidth();
@@ -378,14 +382,17 @@ void BT::component::edit::imgui_edit__created_render_object_reference(entt::regi
 
     ImGui::PushID(&rend_obj_ref);
 
-    ImGui::TextWrapped("A render object is created in the renderer.\n  UUID: %s",
-                       UUID_helper::to_pretty_repr(rend_obj_ref.render_obj_uuid_ref).c_str());
+    auto& rend_obj_pool{ service_finder::find_service<Renderer>().get_render_object_pool() };
+    auto& rend_obj{ *rend_obj_pool.checkout_render_obj(rend_obj_ref.render_obj_handle) };
+
+    ImGui::TextWrapped("A render object is created in the renderer.\n"
+                       "  UUID: %s\n"
+                       "  Handle: %u (gen %u)",
+                       UUID_helper::to_pretty_repr(rend_obj.get_uuid()).c_str(),
+                       rend_obj_ref.render_obj_handle.slot_idx,
+                       rend_obj_ref.render_obj_handle.generation);
 
     // Extras for if there's an animator.
-    auto& rend_obj_pool{ service_finder::find_service<Renderer>().get_render_object_pool() };
-    auto& rend_obj{
-        *rend_obj_pool.checkout_render_obj_by_key({ rend_obj_ref.render_obj_uuid_ref }).front()
-    };
 
     if (auto animator{ rend_obj.get_model_animator() }; animator != nullptr)
     {   // EXTRAS!!
@@ -442,7 +449,7 @@ void BT::component::edit::imgui_edit__created_render_object_reference(entt::regi
         }
     }
 
-    rend_obj_pool.return_render_objs({ &rend_obj });
+    rend_obj_pool.return_render_obj(&rend_obj);
 
     ImGui::PopID();
 }
@@ -2,6 +2,7 @@
 
 #include "btjson.h"
 #include "renderer/render_layer.h"
+#include "renderer/render_object_handle.h"
 #include "uuid/uuid.h"
 
 
@@ -20,12 +21,27 @@ struct Render_object_settings
     bool is_deformed{ false };
     std::string animator_template_name{ "" };
 
+    /// Skins on the CPU (w/ the fastest supported kernel) instead of in the batched compute
+    /// dispatch. Only for deformed render objects.
+    bool is_cpu_skinned{ false };
+
+    /// Rasterized into the occlusion culler's depth buffer to hide render objects behind it.
+    // @NOTE: Best for big, simple, static meshes (walls, floors, buildings).
+    bool is_occluder{ false };
+
+    /// Never moves once placed, so it gets merged with other static render objects of the same
+    /// material into world space batches.
+    bool is_static{ false };
+
     NLOHMANN_DEFINE_TYPE_INTRUSIVE_WITH_DEFAULT(
         Render_object_settings,
         render_layer,
         model_name,
         is_deformed,
-        animator_template_name
+        animator_template_name,
+        is_cpu_skinned,
+        is_occluder,
+        is_static
     );
 };
 
@@ -33,7 +49,7 @@ struct Render_object_settings
 /// `Render_object_settings` means that a render object needs to be created for this entity.
 struct Created_render_object_reference
 {
-    UUID render_obj_uuid_ref;
+    Render_object_handle render_obj_handle;
 };
 
 }  // namespace component
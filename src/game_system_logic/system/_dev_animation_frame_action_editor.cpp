@@ -69,20 +69,18 @@ void BT::system::_dev_animation_frame_action_editor()
                 afa_agent.working_anim_state_idx = -1;
 
                 // Get animator.
-                auto rend_obj_uuid{
-                    reg.get<component::Created_render_object_reference>(entity).render_obj_uuid_ref
+                auto rend_obj_handle{
+                    reg.get<component::Created_render_object_reference>(entity).render_obj_handle
                 };
                 auto& rend_obj_pool{
                     service_finder::find_service<Renderer>().get_render_object_pool()
                 };
-                auto render_obj{
-                    rend_obj_pool.checkout_render_obj_by_key({ rend_obj_uuid }).front()
-                };
+                auto render_obj{ rend_obj_pool.checkout_render_obj(rend_obj_handle) };
 
                 eds.working_model_animator = render_obj->get_model_animator();
                 assert(eds.working_model_animator != nullptr);
 
-                rend_obj_pool.return_render_objs({ render_obj });
+                rend_obj_pool.return_render_obj(render_obj);
 
                 // Fill in animator state name to idx map.
                 auto const& anim_states{ eds.working_model_animator->get_animator_states() };
@@ -143,6 +141,11 @@ void BT::system::_dev_animation_frame_action_editor()
                         .get_num_frames();
             }
 
+            // Recompile timelines while there are unsaved edits, since the editor works on the
+            // source timeline data and the animator reads the compiled tables.
+            if (eds.is_working_afa_dirty)
+                eds.working_afa_ctrls_copy->compile_timelines();
+
             // Update animator frame.
             assert(eds.working_model_animator != nullptr);
 
@@ -14,6 +14,8 @@
 #include "renderer/renderer.h"
 #include "service_finder/service_finder.h"
 
+#include <vector>
+
 
 void BT::system::animator_driven_hitcapsule_sets_update()
 {
@@ -23,34 +25,51 @@ void BT::system::animator_driven_hitcapsule_sets_update()
                         component::Created_render_object_reference const>() };
     auto& rend_obj_pool{ service_finder::find_service<Renderer>().get_render_object_pool() };
 
-    // Work with tagged entities.
+    // Reused between entities and frames, so checking out and evaluating poses doesn't allocate.
+    static std::vector<Render_object_handle> s_rend_obj_handles;
+    static std::vector<Render_object*> s_rend_objs;
+    static std::vector<mat4s> s_joint_matrices;
+    static std::vector<mat4s> s_joint_global_transform_scratch;
+
+    // Check out render objects of all tagged entities at once.
+    s_rend_obj_handles.clear();
     for (auto entity : view)
+        s_rend_obj_handles.emplace_back(
+            view.get<component::Created_render_object_reference const>(entity).render_obj_handle);
+    s_rend_objs.resize(s_rend_obj_handles.size());
+    rend_obj_pool.checkout_render_objs(s_rend_obj_handles, s_rend_objs);
+
+    // Work with tagged entities.
+    for (auto rend_obj_ptr : s_rend_objs)
     {
-        auto const& rend_obj_ref{ view.get<component::Created_render_object_reference const>(
-            entity) };
-        auto& rend_obj{
-            *rend_obj_pool.checkout_render_obj_by_key({ rend_obj_ref.render_obj_uuid_ref }).front()
-        };
+        auto& rend_obj{ *rend_obj_ptr };
 
         // Update whether capsules are enabled and keep capsules attached to connecting bone in
         // animator.
         auto& animator{ *rend_obj.get_model_animator() };
 
-        animator.get_anim_frame_action_data_handle().assign_hitcapsule_enabled_flags();
+        auto& afa_data{ animator.get_anim_frame_action_data_handle() };
+        afa_data.assign_hitcapsule_enabled_flags();
+
+        // Only evaluate the joints that the hitcapsules are connected to.
+        auto const& joint_mask{ afa_data.hitcapsule_group_set.get_joint_mask() };
 
-        std::vector<mat4s> joint_matrices;
         if (animator.get_is_using_root_motion())
             animator.get_anim_floored_frame_pose_with_root_motion_zeroing(
                 Model_animator::SIMULATION_PROFILE,
-                joint_matrices);
+                &joint_mask,
+                s_joint_global_transform_scratch,
+                s_joint_matrices);
         else
             animator.get_anim_floored_frame_pose(Model_animator::SIMULATION_PROFILE,
-                                                 joint_matrices);
+                                                 &joint_mask,
+                                                 s_joint_global_transform_scratch,
+                                                 s_joint_matrices);
 
-        animator.get_anim_frame_action_data_handle().update_hitcapsule_transforms(
+        afa_data.update_hitcapsule_transforms(
             rend_obj.render_transform(),
-            joint_matrices);
-
-        rend_obj_pool.return_render_objs({ &rend_obj });
+            s_joint_matrices);
     }
+
+    rend_obj_pool.return_render_objs(s_rend_objs);
 }
@@ -94,10 +94,8 @@ void BT::system::hitcapsule_attack_processing(float_t delta_time)
             bool is_parry_active;
             bool is_guard_active;
             {
-                auto& rend_obj{ *rend_obj_pool
-                                     .checkout_render_obj_by_key(
-                                         { try_get_rend_obj_ref->render_obj_uuid_ref })
-                                     .front() };
+                auto& rend_obj{ *rend_obj_pool.checkout_render_obj(
+                    try_get_rend_obj_ref->render_obj_handle) };
                 auto& animator{ *rend_obj.get_model_animator() };
 
                 auto& afa_data_handle{ animator.get_anim_frame_action_data_handle() };
@@ -110,7 +108,7 @@ void BT::system::hitcapsule_attack_processing(float_t delta_time)
                         .get_bool_data_handle(anim_frame_action::CTRL_DATA_LABEL_is_guard_active)
                         .get_val();
 
-                rend_obj_pool.return_render_objs({ &rend_obj });
+                rend_obj_pool.return_render_obj(&rend_obj);
             }
 
             // Parry attack.
@@ -400,29 +400,27 @@ void BT::system::update_selected_entity_debug_render_transform()
     if (s_state.debug_mesh_key.is_nil())
     {
         auto& rend_obj_pool{ service_finder::find_service<Renderer>().get_render_object_pool() };
-        auto checked_out_rend_objs{ rend_obj_pool.checkout_render_obj_by_key(
-            { poss_rend_obj_ref->render_obj_uuid_ref }) };
+        auto rend_obj{ rend_obj_pool.checkout_render_obj(poss_rend_obj_ref->render_obj_handle) };
 
         // Create debug mesh.
         s_state.debug_mesh_key = get_main_debug_mesh_pool().emplace_debug_mesh(
-            { checked_out_rend_objs.front()->get_renderable(),
+            { rend_obj->get_renderable(),
               Debug_mesh_pool::k_mask_selected_obj,
               Material_bank::get_material("debug_selected_wireframe_fore_material"),
               Material_bank::get_material("debug_selected_wireframe_back_material") });
 
-        rend_obj_pool.return_render_objs(std::move(checked_out_rend_objs));
+        rend_obj_pool.return_render_obj(rend_obj);
     }
 
     // Get render transform of render object.
     mat4 rend_trans;
 
     auto& rend_obj_pool{ service_finder::find_service<Renderer>().get_render_object_pool() };
-    auto checked_out_rend_objs{ rend_obj_pool.checkout_render_obj_by_key(
-        { poss_rend_obj_ref->render_obj_uuid_ref }) };
+    auto rend_obj{ rend_obj_pool.checkout_render_obj(poss_rend_obj_ref->render_obj_handle) };
 
-    glm_mat4_copy(checked_out_rend_objs.front()->render_transform(), rend_trans);
+    glm_mat4_copy(rend_obj->render_transform(), rend_trans);
 
-    rend_obj_pool.return_render_objs(std::move(checked_out_rend_objs));
+    rend_obj_pool.return_render_obj(rend_obj);
 
     // Set render transform of debug mesh.
     glm_mat4_copy(rend_trans,
@@ -43,9 +43,7 @@ void fetch_wanted_afa_data(Entity_container const& entity_container,
 
     // Get animator AFA data.
     auto& rend_obj_pool{ service_finder::find_service<Renderer>().get_render_object_pool() };
-    auto& rend_obj{
-        *rend_obj_pool.checkout_render_obj_by_key({ rend_obj_ref->render_obj_uuid_ref }).front()
-    };
+    auto& rend_obj{ *rend_obj_pool.checkout_render_obj(rend_obj_ref->render_obj_handle) };
 
     if (auto animator{ rend_obj.get_model_animator() })
     {
@@ -56,7 +54,7 @@ void fetch_wanted_afa_data(Entity_container const& entity_container,
         out_can_attack_exit = afa_data.get_bool_data_handle(anim_frame_action::CTRL_DATA_LABEL_can_attack_exit).get_val();
     }
 
-    rend_obj_pool.return_render_objs({ &rend_obj });
+    rend_obj_pool.return_render_obj(&rend_obj);
 }
 
 /// Takes `input_vec` user input and transforms it into a world space input vector where forward is
@@ -17,6 +17,7 @@
 #include "service_finder/service_finder.h"
 #include "uuid/uuid.h"
 
+#include <cassert>
 #include <memory>
 
 
@@ -36,26 +37,30 @@ enum Destroy_behavior
 void destroy_render_objects(entt::registry& reg,
                             Render_object_pool& rend_obj_pool,
                             Destroy_behavior destroy_behavior)
-{   // Get all UUIDs inside render object pool.
+{   // Get all handles inside render object pool.
     auto all_rend_objs{ rend_obj_pool.checkout_all_render_objs() };
 
     struct Found_metadata
     {
+        Render_object_handle handle;
+        UUID uuid;
         bool found_tag{ false };
         entt::entity ecs_entity{ entt::null };
         bool is_deformable_in_settings{ false };
         bool is_deformed_in_created{ false };
     };
-    std::unordered_map<UUID, Found_metadata> rend_obj_uuid_to_metadata_map;
-    rend_obj_uuid_to_metadata_map.reserve(all_rend_objs.size());
+    std::unordered_map<uint32_t, Found_metadata> rend_obj_slot_idx_to_metadata_map;
+    rend_obj_slot_idx_to_metadata_map.reserve(all_rend_objs.size());
 
     // Populate data from renderer.
     for (auto rend_obj : all_rend_objs)
     {
         Found_metadata metadata{
+            .handle                 = rend_obj_pool.get_handle(*rend_obj),
+            .uuid                   = rend_obj->get_uuid(),
             .is_deformed_in_created = (rend_obj->get_deformed_model() != nullptr)
         };
-        rend_obj_uuid_to_metadata_map.emplace(rend_obj->get_uuid(), std::move(metadata));
+        rend_obj_slot_idx_to_metadata_map.emplace(metadata.handle.slot_idx, std::move(metadata));
     }
 
     rend_obj_pool.return_render_objs(std::move(all_rend_objs));
@@ -64,22 +69,23 @@ void destroy_render_objects(entt::registry& reg,
     auto view{ reg.view<component::Render_object_settings const,
                         component::Created_render_object_reference const>() };
     for (auto entity : view)
-    {   // Mark UUID as non-dangling.
+    {   // Mark handle as non-dangling.
         auto const& rend_obj_settings{ view.get<component::Render_object_settings const>(entity) };
         auto const& created_rend_obj_ref{
             view.get<component::Created_render_object_reference const>(entity)
         };
 
-        auto& found_metadata{ rend_obj_uuid_to_metadata_map.at(
-            created_rend_obj_ref.render_obj_uuid_ref) };
+        auto& found_metadata{ rend_obj_slot_idx_to_metadata_map.at(
+            created_rend_obj_ref.render_obj_handle.slot_idx) };
+        assert(found_metadata.handle == created_rend_obj_ref.render_obj_handle);
         found_metadata.found_tag                 = true;
         found_metadata.ecs_entity                = entity;
         found_metadata.is_deformable_in_settings = rend_obj_settings.is_deformed;
     }
 
-    // Remove certain UUIDs.
-    for (auto& it : rend_obj_uuid_to_metadata_map)
-    {   // `!it.second == true` means this UUID is dangling.
+    // Remove certain handles.
+    for (auto& it : rend_obj_slot_idx_to_metadata_map)
+    {   // `!it.second == true` means this handle is dangling.
         bool destroy_this{ !it.second.found_tag };
         switch (destroy_behavior)
         {
@@ -94,14 +100,14 @@ void destroy_render_objects(entt::registry& reg,
         }
 
         if (destroy_this)
-        {   // Remove this UUID.
-            rend_obj_pool.remove(it.first);
+        {   // Remove this handle.
+            rend_obj_pool.remove(it.second.handle);
 
             if (it.second.ecs_entity != entt::null)
                 reg.remove<component::Created_render_object_reference>(it.second.ecs_entity);
 
             BT_TRACEF("Destroyed and removed \"%s\" from render object pool.",
-                      UUID_helper::to_pretty_repr(it.first).c_str());
+                      UUID_helper::to_pretty_repr(it.second.uuid).c_str());
         }
     }
 }
@@ -127,6 +133,9 @@ void create_staged_render_objects(Entity_container& entity_container,
         if (allow_deformed_creation && rend_obj_settings.is_deformed)
         {   // Create deformed model w/ animator.
             auto deformed_model{ std::make_unique<Deformed_model>(model) };
+            if (rend_obj_settings.is_cpu_skinned)
+                deformed_model->set_skinning_mode(Deformed_model::SKINNING_MODE_CPU,
+                                                  cpu_skinning::get_best_supported_kernel());
 
             bool has_root_motion_tag{ reg.any_of<component::Animator_root_motion>(entity) };
             auto model_animator{ std::make_unique<Model_animator>(model, has_root_motion_tag) };
@@ -155,13 +164,17 @@ void create_staged_render_objects(Entity_container& entity_container,
             new_rend_obj.set_model(Model_bank::get_model(rend_obj_settings.model_name));
         }
 
-        UUID rend_obj_uuid{ rend_obj_pool.emplace(std::move(new_rend_obj)) };
+        new_rend_obj.set_occluder(rend_obj_settings.is_occluder);
+        new_rend_obj.set_static(rend_obj_settings.is_static);
 
-        // Attach render object id as new component.
-        reg.emplace<component::Created_render_object_reference>(entity, rend_obj_uuid);
+        Render_object_handle rend_obj_handle{ rend_obj_pool.emplace(std::move(new_rend_obj)) };
 
-        BT_TRACEF("Created and emplaced \"%s\" into render object pool.",
-                  UUID_helper::to_pretty_repr(rend_obj_uuid).c_str());
+        // Attach render object handle as new component.
+        reg.emplace<component::Created_render_object_reference>(entity, rend_obj_handle);
+
+        BT_TRACEF("Created and emplaced (slot %u, gen %u) into render object pool.",
+                  rend_obj_handle.slot_idx,
+                  rend_obj_handle.generation);
     }
 }
 
@@ -31,35 +31,45 @@ void BT::system::tick_sim_char_mvt_animator()
             if (!affecting_rend_obj_ref)
                 continue;  // Cancel bc no created render object.
 
-            auto& affecting_rend_obj{ *rend_obj_pool
-                                           .checkout_render_obj_by_key(
-                                               { affecting_rend_obj_ref->render_obj_uuid_ref })
-                                           .front() };
+            auto& affecting_rend_obj{ *rend_obj_pool.checkout_render_obj(
+                affecting_rend_obj_ref->render_obj_handle) };
 
             auto animator{ affecting_rend_obj.get_model_animator() };
             if (!animator)
             {   // Cancel bc animator doesn't exist.
-                rend_obj_pool.return_render_objs({ &affecting_rend_obj });
+                rend_obj_pool.return_render_obj(&affecting_rend_obj);
                 continue;
             }
 
+            // Resolve animator var handles (only once per animator).
+            auto& var_handles{ char_mvt_anim_state.animator_var_handles };
+            if (var_handles.resolved_for_generation != animator->get_variables_generation())
+            {
+                var_handles.is_moving     = animator->find_variable_handle("is_moving");
+                var_handles.on_turnaround = animator->find_variable_handle("on_turnaround");
+                var_handles.is_grounded   = animator->find_variable_handle("is_grounded");
+                var_handles.on_jump       = animator->find_variable_handle("on_jump");
+                var_handles.on_attack     = animator->find_variable_handle("on_attack");
+                var_handles.resolved_for_generation = animator->get_variables_generation();
+            }
+
             // Set animator vars.
-            animator->set_bool_variable("is_moving",
+            animator->set_bool_variable(var_handles.is_moving,
                                         char_mvt_anim_state.write_to_animator_data.is_moving);
 
             if (char_mvt_anim_state.write_to_animator_data.on_turnaround)
-                animator->set_trigger_variable("on_turnaround");
+                animator->set_trigger_variable(var_handles.on_turnaround);
             char_mvt_anim_state.write_to_animator_data.on_turnaround = false;
 
-            animator->set_bool_variable("is_grounded",
+            animator->set_bool_variable(var_handles.is_grounded,
                                         char_mvt_anim_state.write_to_animator_data.is_grounded);
 
             if (char_mvt_anim_state.write_to_animator_data.on_jump)
-                animator->set_trigger_variable("on_jump");
+                animator->set_trigger_variable(var_handles.on_jump);
             char_mvt_anim_state.write_to_animator_data.on_jump = false;
 
             if (char_mvt_anim_state.write_to_animator_data.on_attack)
-                animator->set_trigger_variable("on_attack");
+                animator->set_trigger_variable(var_handles.on_attack);
             char_mvt_anim_state.write_to_animator_data.on_attack = false;
 
             // Update animator.
@@ -103,7 +113,7 @@ void BT::system::tick_sim_char_mvt_animator()
             }
 
             // Finish.
-            rend_obj_pool.return_render_objs({ &affecting_rend_obj });
+            rend_obj_pool.return_render_obj(&affecting_rend_obj);
         }
     }
 }
@@ -9,6 +9,8 @@
 #include "service_finder/service_finder.h"
 #include "uuid/uuid.h"
 
+#include <vector>
+
 
 void BT::system::write_render_transforms()
 {
@@ -19,17 +21,26 @@ void BT::system::write_render_transforms()
     auto view{
         reg.view<component::Transform const, component::Created_render_object_reference const>()
     };
+
+    // Check out all render objects at once.
+    // @NOTE: Reused between frames so that checking out doesn't allocate.
+    static std::vector<Render_object_handle> s_rend_obj_handles;
+    static std::vector<Render_object*> s_rend_objs;
+    s_rend_obj_handles.clear();
+    for (auto entity : view)
+        s_rend_obj_handles.emplace_back(
+            view.get<component::Created_render_object_reference const>(entity).render_obj_handle);
+    s_rend_objs.resize(s_rend_obj_handles.size());
+    rend_obj_pool.checkout_render_objs(s_rend_obj_handles, s_rend_objs);
+
+    size_t rend_obj_idx{ 0 };
     for (auto entity : view)
     {
         auto const& transform{ view.get<component::Transform const>(entity) };
-        auto const& rend_obj_ref{
-            view.get<component::Created_render_object_reference const>(entity) };
 
         // @TODO: Include interpolation instead of just straight copying.
 
-        auto rend_obj{
-            rend_obj_pool.checkout_render_obj_by_key({ rend_obj_ref.render_obj_uuid_ref }).front()
-        };
+        auto rend_obj{ s_rend_objs[rend_obj_idx++] };
 
         // Calculate TRS into mat4 transform.
         auto rend_trans{ rend_obj->render_transform() };
@@ -39,7 +50,7 @@ void BT::system::write_render_transforms()
                                  static_cast<float_t>(transform.position.z) });
         glm_quat_rotate(rend_trans, const_cast<float_t*>(transform.rotation.raw), rend_trans);
         glm_scale(rend_trans, const_cast<float_t*>(transform.scale.raw));
-
-        rend_obj_pool.return_render_objs({ rend_obj });
     }
+
+    rend_obj_pool.return_render_objs(s_rend_objs);
 }
@@ -184,15 +184,28 @@ void BT::Hitcapsule_group_set::unregister_from_overlap_solver()
 
 void BT::Hitcapsule_group_set::connect_animator(Model_animator const& animator)
 {
+    std::vector<uint32_t> required_joint_idxs;
     for (auto& group : m_hitcapsule_grps)
     for (auto& capsule : group.get_capsules())
     {
         capsule.init_calc_info(animator);
+
+        if (capsule.calcd_bone_mat_idx != (size_t)-1)
+            required_joint_idxs.emplace_back(static_cast<uint32_t>(capsule.calcd_bone_mat_idx));
+        if (capsule.calcd_bone_mat_idx_2 != (size_t)-1)
+            required_joint_idxs.emplace_back(static_cast<uint32_t>(capsule.calcd_bone_mat_idx_2));
     }
 
+    m_joint_mask = animator.calc_joint_mask(required_joint_idxs);
+
     m_is_connected_to_animator = true;
 }
 
+BT::Model_joint_mask const& BT::Hitcapsule_group_set::get_joint_mask() const
+{
+    return m_joint_mask;
+}
+
 std::vector<BT::Hitcapsule_group>& BT::Hitcapsule_group_set::get_hitcapsule_groups()
 {
     return m_hitcapsule_grps;
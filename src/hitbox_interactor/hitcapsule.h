@@ -2,6 +2,7 @@
 
 #include "btglm.h"
 #include "btjson.h"
+#include "renderer/model_joint_mask.h"
 #include "uuid/uuid.h"
 
 #include <string>
@@ -86,6 +87,10 @@ public:
 
     void connect_animator(Model_animator const& animator);
 
+    /// Gets the joints needed for updating the hitcapsule transforms. Calculated when connecting
+    /// the animator.
+    Model_joint_mask const& get_joint_mask() const;
+
     std::vector<Hitcapsule_group>& get_hitcapsule_groups();
 
     /// Gets responsible entity UUID.
@@ -101,6 +106,7 @@ public:
 private:
     std::vector<Hitcapsule_group> m_hitcapsule_grps;
     bool m_is_connected_to_animator{ false };
+    Model_joint_mask m_joint_mask;
     bool m_is_registered_in_overlap_solver{ false };
     UUID m_resp_entity_uuid;  // The entity UUID that is responsible for responding for overlaps.
 
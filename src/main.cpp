@@ -40,6 +40,7 @@
 #include "renderer/render_object.h"  // @DEBUG
 #include "renderer/renderer.h"
 #include "renderer/shader.h"  // @DEBUG
+#include "renderer/shader_binary_cache.h"
 #include "renderer/texture.h"  // @DEBUG
 #include "service_finder/service_finder.h"
 #include "settings/settings.h"
@@ -95,6 +96,15 @@ int32_t main()
         "skinned_mesh_compute",
         make_unique<BT::Shader>(BTZC_GAME_ENGINE_ASSET_SHADER_PATH "skinned_mesh.comp"));
 
+    auto const& shader_cache_stats{ BT::shader_binary_cache::get_stats() };
+    BT_TRACEF("Loaded shaders: %zu cache hits (%.3f ms), "
+              "%zu cache misses (%zu rejected, %.3f ms).",
+              shader_cache_stats.num_cache_hits,
+              shader_cache_stats.cache_hit_load_time * 1000.0f,
+              shader_cache_stats.num_cache_misses,
+              shader_cache_stats.num_rejected_binaries,
+              shader_cache_stats.cache_miss_load_time * 1000.0f);
+
     // Textures.
     BT::Texture_bank::emplace_texture_2d(
         "default_texture",
@@ -187,6 +197,7 @@ int32_t main()
     //     "test_gltf",
     //     make_unique<BT::Model>(BTZC_GAME_ENGINE_ASSET_MODEL_PATH "Leever.glb",
     //                            "textured_material"));
+    BT::Model_bank::pack_models_into_geometry_arenas();
 
     // Animator templates.
     BT::Animator_template_bank main_anim_template_bank;
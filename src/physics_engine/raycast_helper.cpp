@@ -105,20 +105,39 @@ BT::Raycast_helper::raycast(JPH::RVec3Arg origin, JPH::Vec3Arg direction_and_mag
         return_result.hit_normal   = ray_collector.m_contact_normal;
     }
 
-    // Draw debug line in raycast.
-    vec4 color_1{ 0.5f, 0.0f, 0.0f, 1.0f };
-    if (return_result.success)
-        glm_vec4_copy(vec4{ 1.0f, 0.0f, 0.0f, 1.0f }, color_1);
+    // Draw debug lines in raycast (submitted as one batch).
+    auto make_dbg_line{ [](JPH::RVec3Arg pos_1, JPH::RVec3Arg pos_2, vec4 color_1, vec4 color_2) {
+        Debug_line dbg_line{ { static_cast<float_t>(pos_1.GetX()),
+                               static_cast<float_t>(pos_1.GetY()),
+                               static_cast<float_t>(pos_1.GetZ()) },
+                             { static_cast<float_t>(pos_2.GetX()),
+                               static_cast<float_t>(pos_2.GetY()),
+                               static_cast<float_t>(pos_2.GetZ()) } };
+        glm_vec4_copy(color_1, dbg_line.color1);
+        glm_vec4_copy(color_2, dbg_line.color2);
+        return dbg_line;
+    } };
+
+    vec4 color_hit{ 1.0f, 0.0f, 0.0f, 1.0f };
+    vec4 color_miss{ 0.5f, 0.0f, 0.0f, 1.0f };
+    vec4 color_end{ 0.85f, 0.85f, 0.85f, 1.0f };
+    vec4 color_normal{ 1.0f, 1.0f, 0.0f, 1.0f };
     JPH::RVec3 pos_2{ origin + direction_and_magnitude };
-    get_main_debug_line_pool().emplace_debug_line(  // Ensure matching with `write_render_transforms.cpp`
-        { { static_cast<float_t>(origin.GetX()),
-            static_cast<float_t>(origin.GetY()),
-            static_cast<float_t>(origin.GetZ()) },
-          { static_cast<float_t>(pos_2.GetX()),
-            static_cast<float_t>(pos_2.GetY()),
-            static_cast<float_t>(pos_2.GetZ()) },
-          { color_1[0], color_1[1], color_1[2], color_1[3] },
-          { 0.85f, 0.85f, 0.85f, 1.0f } });
+    if (return_result.success)
+    {   // Ray up to the hit, rest of the ray, and hit normal.
+        JPH::RVec3 normal_end{ return_result.hit_point + 0.25f * return_result.hit_normal };
+        Debug_line dbg_lines[]{
+            make_dbg_line(origin, return_result.hit_point, color_hit, color_hit),
+            make_dbg_line(return_result.hit_point, pos_2, color_end, color_end),
+            make_dbg_line(return_result.hit_point, normal_end, color_normal, color_normal),
+        };
+        get_main_debug_line_pool().emplace_debug_lines(dbg_lines);
+    }
+    else
+    {
+        Debug_line dbg_lines[]{ make_dbg_line(origin, pos_2, color_miss, color_end) };
+        get_main_debug_line_pool().emplace_debug_lines(dbg_lines);
+    }
 
     return return_result;
 }
@@ -12,163 +12,206 @@
 #include <string>
 
 
-BT::Animator_template_bank::Animator_template_bank()
+void BT::Animator_template::cook()
 {
-    // Add self as service.
-    BT_SERVICE_FINDER_ADD_SERVICE(Animator_template_bank, this);
-}
+    // Cook animator template variables.
+    variables_cooked.resize(variables.size());
+    for (size_t i = 0; i < variables.size(); i++)
+    {   // Get tokens of variable string.
+        std::vector<std::string> tokens;
+        {
+            std::istringstream iss(variables[i]);
+            std::copy(std::istream_iterator<std::string>(iss),
+                      std::istream_iterator<std::string>(),
+                      std::back_inserter(tokens));
+            assert(tokens.size() == 2);
+        }
 
-BT::Animator_template const& BT::Animator_template_bank::load_animator_template(
-    std::string const& anim_template_name)
-{
-    if (m_anim_template_cache.find(anim_template_name) == m_anim_template_cache.end())
-    {   // Load from disk.
-        json root = json_load_from_disk(BTZC_GAME_ENGINE_ASSET_ANIMATOR_TEMPLATES_PATH +
-                                        anim_template_name);
+        // Start cookin'
+        auto& ckd{ variables_cooked[i] };
 
-        // Fill in new struct.
-        Animator_template new_template = root;
+        // Convert type.
+        if      (tokens[0] == "bool")  ckd.type = anim_tmpl_types::Animator_variable::TYPE_BOOL;
+        else if (tokens[0] == "int")   ckd.type = anim_tmpl_types::Animator_variable::TYPE_INT;
+        else if (tokens[0] == "float") ckd.type = anim_tmpl_types::Animator_variable::TYPE_FLOAT;
+        else if (tokens[0] == "trig")  ckd.type = anim_tmpl_types::Animator_variable::TYPE_TRIGGER;
+        else assert(false);
 
-        // Cook animator template variables.
-        new_template.variables_cooked.resize(new_template.variables.size());
-        for (size_t i = 0; i < new_template.variables.size(); i++)
-        {   // Get tokens of variable string.
-            std::vector<std::string> tokens;
-            {
-                std::istringstream iss(new_template.variables[i]);
-                std::copy(std::istream_iterator<std::string>(iss),
-                          std::istream_iterator<std::string>(),
-                          std::back_inserter(tokens));
-                assert(tokens.size() == 2);
-            }
+        // Convert name.
+        ckd.var_name = tokens[1];
+    }
 
-            // Start cookin'
-            auto& ckd{ new_template.variables_cooked[i] };
+    // Cook animator template state transitions.
+    for (auto& state_trans : state_transitions)
+    {
+        auto& ckd{ state_trans.cooked };
+
+        // Convert from-to-state.
+        static auto const s_find_anim_state_idx =
+            [](std::vector<Animator_template::Animator_state> const& anim_states,
+               std::string const& anim_state_name) {
+                for (size_t j = 0; j < anim_states.size(); j++)
+                    if (anim_state_name == anim_states[j].state_name)
+                    {
+                        return j;
+                    }
 
-            // Convert type.
-            if      (tokens[0] == "bool")  ckd.type = anim_tmpl_types::Animator_variable::TYPE_BOOL;
-            else if (tokens[0] == "int")   ckd.type = anim_tmpl_types::Animator_variable::TYPE_INT;
-            else if (tokens[0] == "float") ckd.type = anim_tmpl_types::Animator_variable::TYPE_FLOAT;
-            else if (tokens[0] == "trig")  ckd.type = anim_tmpl_types::Animator_variable::TYPE_TRIGGER;
-            else assert(false);
+                BT_ERRORF("Failed: Could not find anim state name: %s",
+                          anim_state_name.c_str());
+                assert(false);
+                return (size_t)-1;
+            };
+
+        ckd.from_to_state.first.resize(state_trans.from_to_state.first.size());
+        for (size_t i = 0; i < state_trans.from_to_state.first.size(); i++)
+            ckd.from_to_state.first[i] =
+                s_find_anim_state_idx(animator_states,
+                                      state_trans.from_to_state.first[i]);
 
-            // Convert name.
-            ckd.var_name = tokens[1];
+        ckd.from_to_state.second = s_find_anim_state_idx(animator_states,
+                                                         state_trans.from_to_state.second);
+
+        // Get tokens of condition string.
+        std::vector<std::string> tokens;
+        {
+            std::istringstream iss(state_trans.condition);
+            std::copy(std::istream_iterator<std::string>(iss),
+                      std::istream_iterator<std::string>(),
+                      std::back_inserter(tokens));
+            assert(tokens.size() == 1 || tokens.size() == 3);
         }
 
-        // Cook animator template state transitions.
-        for (auto& state_trans : new_template.state_transitions)
+        // Convert var idx.
+        auto var_type{ anim_tmpl_types::Animator_variable::TYPE_INVALID };
+
+        if (tokens[0] == "ON_ANIM_END")
+        {   // Special case.
+            ckd.condition_var_idx = anim_tmpl_types::k_on_anim_end_var_idx;
+            var_type = anim_tmpl_types::Animator_variable::TYPE_TRIGGER;
+        }
+        else
         {
-            auto& ckd{ state_trans.cooked };
-
-            // Convert from-to-state.
-            static auto const s_find_anim_state_idx =
-                [](std::vector<Animator_template::Animator_state> const& anim_states,
-                   std::string const& anim_state_name) {
-                    for (size_t j = 0; j < anim_states.size(); j++)
-                        if (anim_state_name == anim_states[j].state_name)
-                        {
-                            return j;
-                        }
-
-                    BT_ERRORF("Failed: Could not find anim state name: %s",
-                              anim_state_name.c_str());
-                    assert(false);
-                    return (size_t)-1;
-                };
-
-            ckd.from_to_state.first.resize(state_trans.from_to_state.first.size());
-            for (size_t i = 0; i < state_trans.from_to_state.first.size(); i++)
-                ckd.from_to_state.first[i] =
-                    s_find_anim_state_idx(new_template.animator_states,
-                                          state_trans.from_to_state.first[i]);
-
-            ckd.from_to_state.second = s_find_anim_state_idx(new_template.animator_states,
-                                                             state_trans.from_to_state.second);
-
-            // Get tokens of condition string.
-            std::vector<std::string> tokens;
+            bool found{ false };
+            for (size_t i = 0; i < variables_cooked.size(); i++)
+                if (tokens[0] == variables_cooked[i].var_name)
+                {   // Found var name!
+                    ckd.condition_var_idx = i;
+                    var_type = variables_cooked[i].type;
+                    found = true;
+                    break;
+                }
+
+            if (!found)
             {
-                std::istringstream iss(state_trans.condition);
-                std::copy(std::istream_iterator<std::string>(iss),
-                          std::istream_iterator<std::string>(),
-                          std::back_inserter(tokens));
-                assert(tokens.size() == 1 || tokens.size() == 3);
+                BT_ERRORF("Var name not found: %s", tokens[0].c_str());
+                assert(false);
             }
+        }
 
-            // Convert var idx.
-            auto var_type{ anim_tmpl_types::Animator_variable::TYPE_INVALID };
+        // Convert compare op and value.
+        switch (var_type)
+        {
+        case anim_tmpl_types::Animator_variable::TYPE_BOOL:
+            if      (tokens[1] == "eq")  ckd.compare_operator = ckd.COMP_EQ;
+            else if (tokens[1] == "neq") ckd.compare_operator = ckd.COMP_NEQ;
+            else assert(false);
 
-            if (tokens[0] == "ON_ANIM_END")
-            {   // Special case.
-                ckd.condition_var_idx = anim_tmpl_types::k_on_anim_end_var_idx;
-                var_type = anim_tmpl_types::Animator_variable::TYPE_TRIGGER;
-            }
-            else
-            {
-                bool found{ false };
-                for (size_t i = 0; i < new_template.variables_cooked.size(); i++)
-                    if (tokens[0] == new_template.variables_cooked[i].var_name)
-                    {   // Found var name!
-                        ckd.condition_var_idx = i;
-                        var_type = new_template.variables_cooked[i].type;
-                        found = true;
-                        break;
-                    }
+            if      (tokens[2] == "false") ckd.compare_value = anim_tmpl_types::k_bool_false;
+            else if (tokens[2] == "true")  ckd.compare_value = anim_tmpl_types::k_bool_true;
+            else assert(false);
+            break;
+
+        case anim_tmpl_types::Animator_variable::TYPE_INT:
+            if      (tokens[1] == "eq")      ckd.compare_operator = ckd.COMP_EQ;
+            else if (tokens[1] == "neq")     ckd.compare_operator = ckd.COMP_NEQ;
+            else if (tokens[1] == "less")    ckd.compare_operator = ckd.COMP_LESS;
+            else if (tokens[1] == "leq")     ckd.compare_operator = ckd.COMP_LEQ;
+            else if (tokens[1] == "greater") ckd.compare_operator = ckd.COMP_GREATER;
+            else if (tokens[1] == "geq")     ckd.compare_operator = ckd.COMP_GEQ;
+            else assert(false);
 
-                if (!found)
-                {
-                    BT_ERRORF("Var name not found: %s", tokens[0].c_str());
-                    assert(false);
-                }
-            }
+            assert(false);  // @TODO: Implement str-to-int here!
+            break;
+
+        case anim_tmpl_types::Animator_variable::TYPE_FLOAT:
+            if      (tokens[1] == "eq")      ckd.compare_operator = ckd.COMP_EQ;
+            else if (tokens[1] == "neq")     ckd.compare_operator = ckd.COMP_NEQ;
+            else if (tokens[1] == "less")    ckd.compare_operator = ckd.COMP_LESS;
+            else if (tokens[1] == "leq")     ckd.compare_operator = ckd.COMP_LEQ;
+            else if (tokens[1] == "greater") ckd.compare_operator = ckd.COMP_GREATER;
+            else if (tokens[1] == "geq")     ckd.compare_operator = ckd.COMP_GEQ;
+            else assert(false);
+
+            assert(false);  // @TODO: Implement str-to-float here!
+            break;
+
+        case anim_tmpl_types::Animator_variable::TYPE_TRIGGER:
+            ckd.compare_operator = ckd.COMP_EQ;
+            ckd.compare_value = anim_tmpl_types::k_trig_triggered;
+            break;
+
+        default: assert(false); break;
+        }
+    }
+
+    // Compile per-state outgoing transition tables.
+    {
+        auto& compiled{ state_transitions_compiled };
+        size_t num_states{ animator_states.size() };
 
-            // Convert compare op and value.
-            switch (var_type)
+        std::vector<std::vector<anim_tmpl_types::Transition_predicate>> per_state_preds;
+        per_state_preds.resize(num_states);
+        for (size_t i = 0; i < state_transitions.size(); i++)
+        {
+            auto const& ckd{ state_transitions[i].cooked };
+            for (auto from_state_idx : ckd.from_to_state.first)
             {
-            case anim_tmpl_types::Animator_variable::TYPE_BOOL:
-                if      (tokens[1] == "eq")  ckd.compare_operator = ckd.COMP_EQ;
-                else if (tokens[1] == "neq") ckd.compare_operator = ckd.COMP_NEQ;
-                else assert(false);
-
-                if      (tokens[2] == "false") ckd.compare_value = anim_tmpl_types::k_bool_false;
-                else if (tokens[2] == "true")  ckd.compare_value = anim_tmpl_types::k_bool_true;
-                else assert(false);
-                break;
-
-            case anim_tmpl_types::Animator_variable::TYPE_INT:
-                if      (tokens[1] == "eq")      ckd.compare_operator = ckd.COMP_EQ;
-                else if (tokens[1] == "neq")     ckd.compare_operator = ckd.COMP_NEQ;
-                else if (tokens[1] == "less")    ckd.compare_operator = ckd.COMP_LESS;
-                else if (tokens[1] == "leq")     ckd.compare_operator = ckd.COMP_LEQ;
-                else if (tokens[1] == "greater") ckd.compare_operator = ckd.COMP_GREATER;
-                else if (tokens[1] == "geq")     ckd.compare_operator = ckd.COMP_GEQ;
-                else assert(false);
-
-                assert(false);  // @TODO: Implement str-to-int here!
-                break;
-
-            case anim_tmpl_types::Animator_variable::TYPE_FLOAT:
-                if      (tokens[1] == "eq")      ckd.compare_operator = ckd.COMP_EQ;
-                else if (tokens[1] == "neq")     ckd.compare_operator = ckd.COMP_NEQ;
-                else if (tokens[1] == "less")    ckd.compare_operator = ckd.COMP_LESS;
-                else if (tokens[1] == "leq")     ckd.compare_operator = ckd.COMP_LEQ;
-                else if (tokens[1] == "greater") ckd.compare_operator = ckd.COMP_GREATER;
-                else if (tokens[1] == "geq")     ckd.compare_operator = ckd.COMP_GEQ;
-                else assert(false);
-
-                assert(false);  // @TODO: Implement str-to-float here!
-                break;
-
-            case anim_tmpl_types::Animator_variable::TYPE_TRIGGER:
-                ckd.compare_operator = ckd.COMP_EQ;
-                ckd.compare_value = anim_tmpl_types::k_trig_triggered;
-                break;
-
-            default: assert(false); break;
+                assert(from_state_idx < num_states);
+                auto& state_preds{ per_state_preds[from_state_idx] };
+                if (!state_preds.empty() && state_preds.back().template_idx == i)
+                    continue;  // Same from state listed twice.
+
+                state_preds.emplace_back(ckd.condition_var_idx,
+                                         ckd.compare_operator,
+                                         ckd.compare_value,
+                                         static_cast<uint32_t>(ckd.from_to_state.second),
+                                         static_cast<uint32_t>(i));
             }
         }
 
+        compiled.state_offsets.clear();
+        compiled.state_offsets.reserve(num_states + 1);
+        compiled.predicates.clear();
+        for (auto& state_preds : per_state_preds)
+        {
+            compiled.state_offsets.emplace_back(static_cast<uint32_t>(compiled.predicates.size()));
+            compiled.predicates.insert(compiled.predicates.end(),
+                                       state_preds.begin(),
+                                       state_preds.end());
+        }
+        compiled.state_offsets.emplace_back(static_cast<uint32_t>(compiled.predicates.size()));
+    }
+}
+
+
+BT::Animator_template_bank::Animator_template_bank()
+{
+    // Add self as service.
+    BT_SERVICE_FINDER_ADD_SERVICE(Animator_template_bank, this);
+}
+
+BT::Animator_template const& BT::Animator_template_bank::load_animator_template(
+    std::string const& anim_template_name)
+{
+    if (m_anim_template_cache.find(anim_template_name) == m_anim_template_cache.end())
+    {   // Load from disk.
+        json root = json_load_from_disk(BTZC_GAME_ENGINE_ASSET_ANIMATOR_TEMPLATES_PATH +
+                                        anim_template_name);
+
+        // Fill in new struct.
+        Animator_template new_template = root;
+        new_template.cook();
+
         m_anim_template_cache.emplace(anim_template_name, std::move(new_template));
     }
 
@@ -197,14 +240,7 @@ void BT::Animator_template_bank::load_animator_template_into_animator(
     
     // @TODO: Also include transition states in model animator.
 
-    std::vector<anim_tmpl_types::Animator_state_transition> anim_state_transitions;
-    anim_state_transitions.reserve(anim_temp.state_transitions.size());
-    for (auto const& temp_state_trans : anim_temp.state_transitions)
-    {
-        anim_state_transitions.emplace_back(temp_state_trans.cooked);
-    }
-
     animator.configure_animator_states(anim_states,
                                        anim_temp.variables_cooked,
-                                       anim_state_transitions);
+                                       anim_temp.state_transitions_compiled);
 }
@@ -67,6 +67,13 @@ struct Animator_template
     };
     std::vector<State_transition> state_transitions;
 
+    /// DO NOT INCLUDE IN SERIALIZATION.
+    anim_tmpl_types::Compiled_state_transitions state_transitions_compiled;
+
+    /// Fills in the cooked variables and transitions from the serialized ones, then compiles the
+    /// per-state transition tables.
+    void cook();
+
     NLOHMANN_DEFINE_TYPE_INTRUSIVE(Animator_template,
                                    animator_states,
                                    transition_intermediate_states,
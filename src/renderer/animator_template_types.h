@@ -37,6 +37,18 @@ struct Animator_variable
     float_t var_value{ std::numeric_limits<float_t>::lowest() };
 };
 
+/// Variable index resolved once from a variable name, for setting/getting variables without a
+/// name lookup. Only valid for animators configured from the same animator template.
+struct Animator_variable_handle
+{
+    static constexpr uint32_t k_invalid_idx{ (uint32_t)-1 };
+
+    uint32_t var_idx{ k_invalid_idx };
+    Animator_variable::Type type{ Animator_variable::TYPE_INVALID };
+
+    bool is_valid() const { return (var_idx != k_invalid_idx); }
+};
+
 struct Animator_state_transition
 {
     std::pair<std::vector<size_t>, size_t> from_to_state;  // Many "from" states to one "to" state.
@@ -56,6 +68,25 @@ struct Animator_state_transition
     float_t compare_value;
 };
 
+/// Flattened transition condition. Reads the condition variable by index.
+struct Transition_predicate
+{
+    size_t condition_var_idx;
+    Animator_state_transition::Compare_op compare_operator;
+    float_t compare_value;
+    uint32_t to_state;
+    uint32_t template_idx;  // Idx of the transition in the template.
+};
+
+/// Outgoing transitions of every state, compiled from the template's transitions.
+/// Predicates of state `i` are in range [`state_offsets[i]`, `state_offsets[i + 1]`), kept in
+/// template order so that transitions get evaluated in the same order as the template.
+struct Compiled_state_transitions
+{
+    std::vector<uint32_t> state_offsets;  // Num states + 1.
+    std::vector<Transition_predicate> predicates;
+};
+
 /// Special condition var indexes.
 static constexpr size_t k_on_anim_end_var_idx{ (size_t)-2 };
 
@@ -224,6 +224,11 @@ void BT::Camera::get_view_direction(vec3& out_view_direction)
     glm_vec3_copy(m_data->camera.view_direction, out_view_direction);
 }
 
+void BT::Camera::get_position(vec3& out_position)
+{
+    glm_vec3_copy(m_data->camera.position, out_position);
+}
+
 // Camera frontend.
 bool BT::Camera::is_static_cam()
 {
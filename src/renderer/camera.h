@@ -33,6 +33,7 @@ public:
                                           mat4& out_view,
                                           mat4& out_projection_view);
     void get_view_direction(vec3& out_view_direction);
+    void get_position(vec3& out_position);
 
     // Camera frontend.
     bool is_static_cam();
@@ -0,0 +1,251 @@
+#include "cpu_skinning.h"
+
+#include "btglm.h"
+#include "mesh.h"
+#include "timer/timer.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cfloat>
+#include <cstring>
+#include <execution>
+#include <immintrin.h>
+#include <intrin.h>
+#include <vector>
+
+
+namespace
+{
+
+using namespace BT;
+using namespace BT::cpu_skinning;
+
+float_t s_vertices_per_second_last_skin{ 0.0f };
+
+void skin_vertex_range_scalar(Vertex const* in_vertices,
+                              Vertex_skin_data const* in_skin_datas,
+                              Palette_entry const* palette,
+                              size_t vertex_begin,
+                              size_t vertex_end,
+                              Vertex* out_vertices)
+{
+    for (size_t i = vertex_begin; i < vertex_end; i++)
+    {
+        auto const& in_vertex{ in_vertices[i] };
+        auto const& skin_data{ in_skin_datas[i] };
+
+        // Blend joint and normal matrices.
+        mat4 deform_transform = GLM_MAT4_ZERO_INIT;
+        mat3 normal_transform = GLM_MAT3_ZERO_INIT;
+        for (uint32_t j = 0; j < 4; j++)
+        {
+            float_t weight{ skin_data.weights[j] };
+            auto const& entry{ palette[skin_data.joint_mat_idxs[j]] };
+
+            for (uint32_t col = 0; col < 4; col++)
+            for (uint32_t row = 0; row < 4; row++)
+            {
+                deform_transform[col][row] += entry.joint_matrix.raw[col][row] * weight;
+            }
+
+            for (uint32_t col = 0; col < 3; col++)
+            for (uint32_t row = 0; row < 3; row++)
+            {
+                normal_transform[col][row] += entry.normal_matrix.raw[col][row] * weight;
+            }
+        }
+
+        // Spit out the data!
+        auto& out_vertex{ out_vertices[i] };
+        glm_mat4_mulv3(deform_transform,
+                       const_cast<float_t*>(in_vertex.position),
+                       1.0f,
+                       out_vertex.position);
+        glm_mat3_mulv(normal_transform, const_cast<float_t*>(in_vertex.normal), out_vertex.normal);
+        glm_vec3_normalize(out_vertex.normal);
+        glm_vec2_copy(const_cast<float_t*>(in_vertex.tex_coord), out_vertex.tex_coord);
+    }
+}
+
+void skin_vertex_range_avx2(Vertex const* in_vertices,
+                            Vertex_skin_data const* in_skin_datas,
+                            Palette_entry const* palette,
+                            size_t vertex_begin,
+                            size_t vertex_end,
+                            Vertex* out_vertices)
+{
+    for (size_t i = vertex_begin; i < vertex_end; i++)
+    {
+        auto const& in_vertex{ in_vertices[i] };
+        auto const& skin_data{ in_skin_datas[i] };
+
+        // Blend joint and normal matrices (2 columns per register).
+        __m256 deform_cols_01{ _mm256_setzero_ps() };
+        __m256 deform_cols_23{ _mm256_setzero_ps() };
+        __m256 normal_cols_01{ _mm256_setzero_ps() };
+        __m256 normal_cols_23{ _mm256_setzero_ps() };
+        for (uint32_t j = 0; j < 4; j++)
+        {
+            __m256 weight{ _mm256_set1_ps(skin_data.weights[j]) };
+            auto const& entry{ palette[skin_data.joint_mat_idxs[j]] };
+            float_t const* joint_mat{ &entry.joint_matrix.raw[0][0] };
+            float_t const* normal_mat{ &entry.normal_matrix.raw[0][0] };
+
+            deform_cols_01 = _mm256_fmadd_ps(_mm256_loadu_ps(joint_mat), weight, deform_cols_01);
+            deform_cols_23 = _mm256_fmadd_ps(_mm256_loadu_ps(joint_mat + 8), weight, deform_cols_23);
+            normal_cols_01 = _mm256_fmadd_ps(_mm256_loadu_ps(normal_mat), weight, normal_cols_01);
+            normal_cols_23 = _mm256_fmadd_ps(_mm256_loadu_ps(normal_mat + 8), weight, normal_cols_23);
+        }
+
+        // Transform position (c0*x + c1*y + c2*z + c3).
+        __m128 position{
+            _mm_fmadd_ps(_mm256_castps256_ps128(deform_cols_01),
+                         _mm_set1_ps(in_vertex.position[0]),
+                         _mm_fmadd_ps(_mm256_extractf128_ps(deform_cols_01, 1),
+                                      _mm_set1_ps(in_vertex.position[1]),
+                                      _mm_fmadd_ps(_mm256_castps256_ps128(deform_cols_23),
+                                                   _mm_set1_ps(in_vertex.position[2]),
+                                                   _mm256_extractf128_ps(deform_cols_23, 1))))
+        };
+
+        // Transform normal (c0*x + c1*y + c2*z) and normalize.
+        // @NOTE: Row 3 of the normal matrix columns 0-2 is 0, so w ends up 0.
+        __m128 normal{
+            _mm_fmadd_ps(_mm256_castps256_ps128(normal_cols_01),
+                         _mm_set1_ps(in_vertex.normal[0]),
+                         _mm_fmadd_ps(_mm256_extractf128_ps(normal_cols_01, 1),
+                                      _mm_set1_ps(in_vertex.normal[1]),
+                                      _mm_mul_ps(_mm256_castps256_ps128(normal_cols_23),
+                                                 _mm_set1_ps(in_vertex.normal[2]))))
+        };
+        // @NOTE: Same as `glm_vec3_normalize()`, normals shorter than `FLT_EPSILON` become 0
+        //        instead of dividing by 0.
+        __m128 normal_len{ _mm_sqrt_ps(_mm_dp_ps(normal, normal, 0x7F)) };
+        __m128 is_long_enough{ _mm_cmpge_ps(normal_len, _mm_set1_ps(FLT_EPSILON)) };
+        normal = _mm_and_ps(_mm_div_ps(normal, _mm_max_ps(normal_len, _mm_set1_ps(FLT_EPSILON))),
+                            is_long_enough);
+
+        // Spit out the data!
+        alignas(16) float_t position_out[4];
+        alignas(16) float_t normal_out[4];
+        _mm_store_ps(position_out, position);
+        _mm_store_ps(normal_out, normal);
+
+        auto& out_vertex{ out_vertices[i] };
+        std::memcpy(out_vertex.position, position_out, sizeof(vec3));
+        std::memcpy(out_vertex.normal, normal_out, sizeof(vec3));
+        std::memcpy(out_vertex.tex_coord, in_vertex.tex_coord, sizeof(vec2));
+    }
+}
+
+}  // namespace
+
+
+void BT::cpu_skinning::calc_palette_entry(mat4 joint_matrix, Palette_entry& out_entry)
+{
+    glm_mat4_copy(joint_matrix, out_entry.joint_matrix.raw);
+
+    mat3 normal_matrix;
+    btglm_mat4_normal_matrix(joint_matrix, normal_matrix);
+
+    glm_mat4_identity(out_entry.normal_matrix.raw);
+    glm_mat4_ins3(normal_matrix, out_entry.normal_matrix.raw);
+}
+
+bool BT::cpu_skinning::is_avx2_supported()
+{
+    static bool const s_is_supported{ []() {
+        int32_t cpu_info[4];
+
+        __cpuid(cpu_info, 0);
+        if (cpu_info[0] < 7)
+            return false;
+
+        __cpuid(cpu_info, 1);
+        bool has_fma{ (cpu_info[2] & (1 << 12)) != 0 };
+        bool has_osxsave{ (cpu_info[2] & (1 << 27)) != 0 };
+        bool has_avx{ (cpu_info[2] & (1 << 28)) != 0 };
+        if (!has_fma || !has_osxsave || !has_avx)
+            return false;
+
+        // Check OS saves the YMM registers.
+        if ((_xgetbv(0) & 0b110) != 0b110)
+            return false;
+
+        __cpuidex(cpu_info, 7, 0);
+        bool has_avx2{ (cpu_info[1] & (1 << 5)) != 0 };
+        return has_avx2;
+    }() };
+
+    return s_is_supported;
+}
+
+BT::cpu_skinning::Kernel BT::cpu_skinning::get_best_supported_kernel()
+{
+    return (is_avx2_supported() ? KERNEL_AVX2 : KERNEL_SCALAR);
+}
+
+void BT::cpu_skinning::skin_vertex_range(Kernel kernel,
+                                         Vertex const* in_vertices,
+                                         Vertex_skin_data const* in_skin_datas,
+                                         Palette_entry const* palette,
+                                         size_t vertex_begin,
+                                         size_t vertex_end,
+                                         Vertex* out_vertices)
+{
+    switch (kernel)
+    {
+    case KERNEL_SCALAR:
+        skin_vertex_range_scalar(
+            in_vertices, in_skin_datas, palette, vertex_begin, vertex_end, out_vertices);
+        break;
+
+    case KERNEL_AVX2:
+        assert(is_avx2_supported());
+        skin_vertex_range_avx2(
+            in_vertices, in_skin_datas, palette, vertex_begin, vertex_end, out_vertices);
+        break;
+
+    default: assert(false); break;
+    }
+}
+
+void BT::cpu_skinning::skin_vertices_parallel(Kernel kernel,
+                                              Vertex const* in_vertices,
+                                              Vertex_skin_data const* in_skin_datas,
+                                              Palette_entry const* palette,
+                                              size_t num_vertices,
+                                              Vertex* out_vertices)
+{
+    constexpr size_t k_vertices_per_range{ 4096 };
+
+    Timer timer;
+    timer.start_timer();
+
+    std::vector<size_t> range_begins;
+    range_begins.reserve(num_vertices / k_vertices_per_range + 1);
+    for (size_t begin = 0; begin < num_vertices; begin += k_vertices_per_range)
+        range_begins.emplace_back(begin);
+
+    std::for_each(std::execution::par,
+                  range_begins.begin(),
+                  range_begins.end(),
+                  [&](size_t begin) {
+                      skin_vertex_range(kernel,
+                                        in_vertices,
+                                        in_skin_datas,
+                                        palette,
+                                        begin,
+                                        std::min(begin + k_vertices_per_range, num_vertices),
+                                        out_vertices);
+                  });
+
+    float_t elapsed_time{ timer.calc_delta_time() };
+    s_vertices_per_second_last_skin =
+        (elapsed_time > 0.0f ? static_cast<float_t>(num_vertices) / elapsed_time : 0.0f);
+}
+
+float_t BT::cpu_skinning::get_vertices_per_second_last_skin()
+{
+    return s_vertices_per_second_last_skin;
+}
@@ -0,0 +1,66 @@
+#pragma once
+
+#include "btglm.h"
+
+#include <cstddef>
+#include <cstdint>
+
+
+namespace BT
+{
+
+struct Vertex;
+struct Vertex_skin_data;
+
+/// CPU version of the 4-weight skinning that `skinned_mesh.comp` does.
+namespace cpu_skinning
+{
+
+enum Kernel
+{
+    KERNEL_SCALAR,
+    KERNEL_AVX2,  // Needs AVX2 + FMA. Check `is_avx2_supported()` before using.
+};
+
+/// Same layout as the GPU palette entries.
+struct Palette_entry
+{
+    mat4s joint_matrix;
+    mat4s normal_matrix;  // See `btglm_mat4_normal_matrix()`.
+};
+
+/// Fills in `out_entry` with `joint_matrix` and its normal matrix.
+// @NOTE: Blending the normal matrices only equals the inverse transpose of the blended joint
+//        matrices when the blended joints share the same upper 3x3. Otherwise it's the usual
+//        linear blend approximation.
+void calc_palette_entry(mat4 joint_matrix, Palette_entry& out_entry);
+
+/// Checks the CPU (and OS) for AVX2 + FMA support. Result is cached.
+bool is_avx2_supported();
+
+/// Gets the fastest kernel supported by this machine.
+Kernel get_best_supported_kernel();
+
+/// Skins vertices in range [`vertex_begin`, `vertex_end`). Ranges don't overlap in writes, so
+/// different ranges can be skinned on different threads.
+void skin_vertex_range(Kernel kernel,
+                       Vertex const* in_vertices,
+                       Vertex_skin_data const* in_skin_datas,
+                       Palette_entry const* palette,
+                       size_t vertex_begin,
+                       size_t vertex_end,
+                       Vertex* out_vertices);
+
+/// Skins all vertices, split into vertex ranges across threads.
+void skin_vertices_parallel(Kernel kernel,
+                            Vertex const* in_vertices,
+                            Vertex_skin_data const* in_skin_datas,
+                            Palette_entry const* palette,
+                            size_t num_vertices,
+                            Vertex* out_vertices);
+
+/// Throughput of the latest `skin_vertices_parallel()` call.
+float_t get_vertices_per_second_last_skin();
+
+}  // namespace cpu_skinning
+}  // namespace BT
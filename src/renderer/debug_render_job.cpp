@@ -5,8 +5,12 @@
 #include "btglm.h"
 #include "glad/glad.h"
 #include "btlogger.h"
+#include "stream_buffer.h"
+#include <algorithm>
 #include <array>
 #include <cassert>
+#include <cmath>
+#include <cstring>
 #include <memory>
 #include <mutex>
 
@@ -100,34 +104,71 @@ BT::Debug_mesh_pool& BT::get_main_debug_mesh_pool()
 
 // Debug line.
 BT::Debug_line_pool::Debug_line_pool()
+    : m_submission_cells{ std::make_unique<Submission_cell[]>(k_num_lines) }
 {
-    glGenBuffers(1, &m_ssbo);
-    glBindBuffer(GL_SHADER_STORAGE_BUFFER, m_ssbo);
-    glBufferData(GL_SHADER_STORAGE_BUFFER,
-                 sizeof(Debug_line) * k_num_lines,
-                 nullptr,  //  m_huhidkwtd.data(),
-                 GL_DYNAMIC_COPY);
-    glBindBuffer(GL_SHADER_STORAGE_BUFFER, 0);
+    for (uint32_t i = 0; i < k_num_lines; i++)
+    {
+        m_submission_cells[i].sequence.store(i, std::memory_order_relaxed);
+    }
 }
 
-BT::Debug_line_pool::~Debug_line_pool()
+BT::Debug_line_pool::~Debug_line_pool() = default;
+
+void BT::Debug_line_pool::emplace_debug_line(Debug_line&& dbg_line, float_t timeout /*= 1.0f*/)
 {
-    glDeleteBuffers(1, &m_ssbo);
+    emplace_debug_lines({ &dbg_line, 1 }, timeout);
 }
 
-void BT::Debug_line_pool::emplace_debug_line(Debug_line&& dbg_line, float_t timeout /*= 1.0f*/)
+void BT::Debug_line_pool::emplace_debug_lines(std::span<Debug_line const> dbg_lines,
+                                              float_t timeout /*= 1.0f*/)
 {
     assert(timeout > 0.0f);
 
-    // Add to pool.
-    uint32_t write_idx{ m_next_write_idx++ };
-    write_idx = (write_idx % k_num_lines);
-    m_lines[write_idx] = { timeout, std::move(dbg_line) };
+    uint64_t num_lines{ dbg_lines.size() };
+    if (num_lines == 0)
+        return;
+    if (num_lines > k_num_lines)
+    {
+        m_num_dropped_lines += num_lines;
+        return;
+    }
+
+    // Reserve range in submission queue.
+    // @NOTE: Cells are freed in order by the consumer, so if the last cell of the range is free
+    //        then the whole range is free.
+    uint64_t write_pos{ m_submission_write_pos.load(std::memory_order_relaxed) };
+    while (true)
+    {
+        uint64_t last_pos{ write_pos + num_lines - 1 };
+        auto& last_cell{ m_submission_cells[last_pos & (k_num_lines - 1)] };
+        int64_t diff{ static_cast<int64_t>(last_cell.sequence.load(std::memory_order_acquire) -
+                                           last_pos) };
+        if (diff == 0)
+        {
+            if (m_submission_write_pos.compare_exchange_weak(
+                    write_pos, write_pos + num_lines, std::memory_order_relaxed))
+                break;
+        }
+        else if (diff < 0)
+        {   // Queue is full.
+            m_num_dropped_lines += num_lines;
+            return;
+        }
+        else
+        {   // Another thread reserved this range first.
+            write_pos = m_submission_write_pos.load(std::memory_order_relaxed);
+        }
+    }
 
-    // Add to active indices.
-    std::lock_guard<std::mutex> lock{ m_active_indices_mutex };
-    m_active_indices.emplace_back(write_idx);
-    m_is_dirty = true;
+    // Write and publish lines.
+    for (uint64_t i = 0; i < num_lines; i++)
+    {
+        uint64_t pos{ write_pos + i };
+        auto& cell{ m_submission_cells[pos & (k_num_lines - 1)] };
+        cell.timeout  = timeout;
+        cell.dbg_line = dbg_lines[i];
+        cell.sequence.store(pos + 1, std::memory_order_release);
+    }
 }
 
 void BT::Debug_line_pool::emplace_debug_line_based_capsule(
@@ -257,6 +298,8 @@ void BT::Debug_line_pool::emplace_debug_line_based_capsule(
     }
 
     // Emplace points as lines.
+    std::vector<Debug_line> new_lines;
+    new_lines.reserve(72);
     for (auto& ecp_set : trans_ecp_sets)
         for (size_t idx = 1; idx < ecp_set.trans_end_cap.size(); idx++)
         {   // Draw line from translated end cap points.
@@ -266,7 +309,7 @@ void BT::Debug_line_pool::emplace_debug_line_based_capsule(
             glm_vec4_copy(color, new_line.color1);
             glm_vec4_copy(color, new_line.color2);
 
-            emplace_debug_line(std::move(new_line), timeout);
+            new_lines.emplace_back(new_line);
         }
     
     auto& end_cap_a_y{ trans_ecp_sets[2] };
@@ -279,52 +322,134 @@ void BT::Debug_line_pool::emplace_debug_line_based_capsule(
         glm_vec4_copy(color, new_line.color1);
         glm_vec4_copy(color, new_line.color2);
 
-        emplace_debug_line(std::move(new_line), timeout);
+        new_lines.emplace_back(new_line);
     }
+
+    emplace_debug_lines(new_lines, timeout);
 }
 
-BT::Debug_line_pool::Render_data BT::Debug_line_pool::calc_render_data(float_t delta_time)
+BT::Debug_line_pool::Render_data BT::Debug_line_pool::calc_render_data(
+    float_t delta_time, Stream_buffer& stream_buffer)
 {
-    std::lock_guard<std::mutex> lock{ m_active_indices_mutex };
+    update_live_lines(delta_time);
+
+    Render_data data{ 0, stream_buffer.get_buffer(), 0, 0 };
+    if (!get_visible() || m_num_live_lines == 0)
+        return data;
 
-    // Process job timeouts.
-    for (int64_t i = m_active_indices.size() - 1; i >= 0; i--)
+    // Compact live lines straight into this frame's stream buffer region.
+    // @NOTE: Only what fits in `k_num_lines` gets rendered.
+    size_t num_lines{ std::min(m_num_live_lines, static_cast<size_t>(k_num_lines)) };
+    auto allocation{ stream_buffer.allocate(sizeof(Debug_line) * num_lines) };
+    if (allocation.data == nullptr)
     {
-        auto& line{ m_lines[m_active_indices[i]] };
-        line.remaining_time -= delta_time;
-        if (line.remaining_time < 0.0f)
-        {
-            // Remove expired job.
-            m_active_indices.erase(m_active_indices.begin() + i);
-            m_is_dirty = true;
-        }
+        BT_WARN("Not enough stream buffer space for debug lines.");
+        return data;
     }
 
-    if (m_is_dirty)
-    {   // @NOTE: This seems to be the only reason why the GPU upload `memcpy()` step crashes.
-        assert(m_active_indices.size() <= k_num_lines);
+    num_lines = copy_live_lines({ static_cast<Debug_line*>(allocation.data), num_lines });
 
-        // Insert jobs into SSBO.
-        std::vector<Debug_line> jobs;
-        jobs.reserve(m_active_indices.size());
-        for (uint32_t idx : m_active_indices)
-        {
-            jobs.emplace_back(m_lines[idx].dbg_line);
-        }
+    data.num_lines_to_render = num_lines;
+    data.ssbo_offset         = allocation.offset;
+    data.ssbo_size           = allocation.size;
+    return data;
+}
 
-        glBindBuffer(GL_SHADER_STORAGE_BUFFER, m_ssbo);
-        GLvoid* data = glMapBuffer(GL_SHADER_STORAGE_BUFFER, GL_WRITE_ONLY);
-        memcpy(data, jobs.data(), sizeof(Debug_line) * jobs.size());
-        glUnmapBuffer(GL_SHADER_STORAGE_BUFFER);
-        glBindBuffer(GL_SHADER_STORAGE_BUFFER, 0);
+void BT::Debug_line_pool::update_live_lines(float_t delta_time)
+{
+    // Expire buckets that ended.
+    m_time += delta_time;
+    uint64_t new_time_bucket_idx{
+        static_cast<uint64_t>(std::floor(m_time / k_expiry_bucket_duration)) };
+    for (uint64_t i = 0;
+         i < k_num_expiry_buckets && m_time_bucket_idx + i < new_time_bucket_idx;
+         i++)
+    {
+        auto& bucket{ m_expiry_buckets[(m_time_bucket_idx + i) % k_num_expiry_buckets] };
+        m_num_live_lines -= bucket.size();
+        bucket.clear();
+    }
+    m_time_bucket_idx = new_time_bucket_idx;
+
+    rebucket_overflow_lines();
+    drain_submission_queue();
+}
 
-        m_is_dirty = false;
+size_t BT::Debug_line_pool::copy_live_lines(std::span<Debug_line> out_lines) const
+{
+    size_t num_lines{ std::min(m_num_live_lines, out_lines.size()) };
+    size_t num_written{ 0 };
+    for (auto const& bucket : m_expiry_buckets)
+    {
+        if (num_written == num_lines)
+            break;
+
+        size_t num_to_write{ std::min(bucket.size(), num_lines - num_written) };
+        memcpy(out_lines.data() + num_written, bucket.data(), sizeof(Debug_line) * num_to_write);
+        num_written += num_to_write;
     }
+    for (size_t i = 0; i < m_overflow_lines.size() && num_written < num_lines; i++)
+        out_lines[num_written++] = m_overflow_lines[i].dbg_line;
 
-    Render_data data;
-    data.num_lines_to_render = (get_visible() ? m_active_indices.size() : 0);
-    data.ssbo = m_ssbo;
-    return data;
+    return num_written;
+}
+
+BT::Debug_line_pool::Stats BT::Debug_line_pool::get_stats() const
+{
+    return { m_num_live_lines, m_num_dropped_lines.load() };
+}
+
+void BT::Debug_line_pool::drain_submission_queue()
+{
+    while (true)
+    {
+        auto& cell{ m_submission_cells[m_submission_read_pos & (k_num_lines - 1)] };
+        if (cell.sequence.load(std::memory_order_acquire) != m_submission_read_pos + 1)
+            break;  // Nothing more published.
+
+        // Insert into bucket of expiry time.
+        uint64_t expiry_bucket_idx{ static_cast<uint64_t>(
+            std::floor((m_time + cell.timeout) / k_expiry_bucket_duration)) };
+        insert_live_line(std::max(expiry_bucket_idx, m_time_bucket_idx), cell.dbg_line);
+
+        // Free cell for next lap.
+        cell.sequence.store(m_submission_read_pos + k_num_lines, std::memory_order_release);
+        m_submission_read_pos++;
+    }
+}
+
+void BT::Debug_line_pool::insert_live_line(uint64_t expiry_bucket_idx, Debug_line const& dbg_line)
+{
+    assert(expiry_bucket_idx >= m_time_bucket_idx);
+    if (expiry_bucket_idx < m_time_bucket_idx + k_num_expiry_buckets)
+        m_expiry_buckets[expiry_bucket_idx % k_num_expiry_buckets].emplace_back(dbg_line);
+    else
+        m_overflow_lines.emplace_back(expiry_bucket_idx, dbg_line);
+
+    m_num_live_lines++;
+}
+
+void BT::Debug_line_pool::rebucket_overflow_lines()
+{
+    for (size_t i = 0; i < m_overflow_lines.size();)
+    {
+        auto const& overflow_line{ m_overflow_lines[i] };
+        if (overflow_line.expiry_bucket_idx >= m_time_bucket_idx + k_num_expiry_buckets)
+        {   // Still out of range.
+            i++;
+            continue;
+        }
+
+        if (overflow_line.expiry_bucket_idx >= m_time_bucket_idx)
+            m_expiry_buckets[overflow_line.expiry_bucket_idx % k_num_expiry_buckets].emplace_back(
+                overflow_line.dbg_line);
+        else
+            m_num_live_lines--;  // Expired during a long frame.
+
+        // Swap remove.
+        m_overflow_lines[i] = m_overflow_lines.back();
+        m_overflow_lines.pop_back();
+    }
 }
 
 
@@ -7,6 +7,7 @@
 #include <cstdint>
 #include <memory>
 #include <mutex>
+#include <span>
 #include <unordered_map>
 #include <vector>
 
@@ -16,6 +17,7 @@ namespace BT
 
 class Renderable_ifc;
 class Material_ifc;
+class Stream_buffer;
 
 /// Debug mesh.
 struct Debug_mesh
@@ -86,8 +88,14 @@ public:
     Debug_line_pool();
     ~Debug_line_pool();
 
+    /// Submits a debug line that stays visible for `timeout` seconds. Lock-free, so it's fine to
+    /// call from any thread. The line gets dropped if the submission queue is full.
     void emplace_debug_line(Debug_line&& dbg_line, float_t timeout = 1.0f);
 
+    /// Submits all of `dbg_lines` with a single reservation in the submission queue. Either all
+    /// lines get submitted or all get dropped.
+    void emplace_debug_lines(std::span<Debug_line const> dbg_lines, float_t timeout = 1.0f);
+
     // Emplaces a capsule made up of a bunch of debug lines in a batch into the pool. Only one color
     // param is provided for consistency.
     //
@@ -101,28 +109,71 @@ public:
     {
         size_t num_lines_to_render;
         uint32_t ssbo;
+        size_t ssbo_offset;
+        size_t ssbo_size;
+    };
+
+    /// Expires and drains lines, then writes all live lines into `stream_buffer`.
+    Render_data calc_render_data(float_t delta_time, Stream_buffer& stream_buffer);
+
+    /// Advances time by `delta_time`, expiring lines, then drains the submission queue into the
+    /// live lines. Consumer side only (same as `calc_render_data()`, which calls this).
+    void update_live_lines(float_t delta_time);
+
+    /// Copies live lines into `out_lines`, up to its size. Returns the number of copied lines.
+    size_t copy_live_lines(std::span<Debug_line> out_lines) const;
+
+    struct Stats
+    {
+        size_t num_live_lines;
+        size_t num_dropped_lines;  // Total dropped bc of a full submission queue.
     };
-    Render_data calc_render_data(float_t delta_time);
+    Stats get_stats() const;
 
     bool get_visible() { return m_visible.load(); }
     void set_visible(bool flag) { m_visible.store(flag); }
 
+    static constexpr uint32_t k_num_lines{ 32768 };  // @NOTE: Must be power of 2.
+
+    // Live lines are bucketed by expiry time so that expiring is just clearing whole buckets.
+    // Lines expire at most one bucket duration late.
+    static constexpr double_t k_expiry_bucket_duration{ 1.0 / 60.0 };
+    static constexpr uint32_t k_num_expiry_buckets{ 1024 };  // About 17 seconds.
+
 private:
-    struct Debug_line_with_timeout
+    // Submission queue (bounded lock-free multi-producer single-consumer ring).
+    // A cell at queue position `pos` is free for writing when its sequence is `pos`, and ready
+    // for reading when its sequence is `pos + 1`. Reading sets it to `pos + k_num_lines`.
+    struct Submission_cell
     {
-        float_t remaining_time{ -1.0f };
+        std::atomic_uint64_t sequence;
+        float_t timeout;
         Debug_line dbg_line;
     };
+    std::unique_ptr<Submission_cell[]> m_submission_cells;
+    std::atomic_uint64_t m_submission_write_pos{ 0 };
+    uint64_t m_submission_read_pos{ 0 };
+    std::atomic_size_t m_num_dropped_lines{ 0 };
 
-    static constexpr uint32_t k_num_lines{ 32768 };  // @NOTE: Must be power of 2.
-    std::array<Debug_line_with_timeout, k_num_lines> m_lines;
-    std::atomic_uint32_t m_next_write_idx{ 0 };
+    void drain_submission_queue();
+
+    // Live lines.
+    std::array<std::vector<Debug_line>, k_num_expiry_buckets> m_expiry_buckets;
+
+    // Lines w/ timeouts past the last bucket. They move into buckets once their expiry is in range.
+    struct Overflow_line
+    {
+        uint64_t expiry_bucket_idx;
+        Debug_line dbg_line;
+    };
+    std::vector<Overflow_line> m_overflow_lines;
 
-    std::mutex m_active_indices_mutex;
-    std::vector<uint32_t> m_active_indices;
-    bool m_is_dirty{ false };
+    void insert_live_line(uint64_t expiry_bucket_idx, Debug_line const& dbg_line);
+    void rebucket_overflow_lines();
 
-    uint32_t m_ssbo{ (uint32_t)-1 };
+    double_t m_time{ 0.0 };
+    uint64_t m_time_bucket_idx{ 0 };
+    size_t m_num_live_lines{ 0 };
 
     std::atomic_bool m_visible{ false };
 };
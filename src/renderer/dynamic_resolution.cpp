@@ -0,0 +1,116 @@
+#include "dynamic_resolution.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+
+
+BT::Dynamic_resolution_controller::Settings
+BT::Dynamic_resolution_controller::make_default_settings(float_t target_frame_time)
+{
+    return Settings{
+        .target_frame_time   = target_frame_time,
+        .min_scale           = 0.5f,
+        .max_scale           = 1.0f,
+        .scale_up_threshold  = 0.8f,
+        .max_scale_up_step   = 0.1f,
+        .min_scale_change    = 0.02f,
+        .num_history_frames  = 16,
+        .num_cooldown_frames = 4,
+    };
+}
+
+BT::Dynamic_resolution_controller::Dynamic_resolution_controller(Settings const& settings)
+{
+    set_settings(settings);
+}
+
+void BT::Dynamic_resolution_controller::set_settings(Settings const& settings)
+{
+    assert(settings.target_frame_time > 0.0f);
+    assert(settings.min_scale > 0.0f && settings.min_scale <= settings.max_scale);
+    assert(settings.scale_up_threshold > 0.0f && settings.scale_up_threshold <= 1.0f);
+    assert(settings.num_history_frames > 0);
+
+    m_settings = settings;
+    m_frame_time_history.resize(m_settings.num_history_frames);
+    reset();
+}
+
+bool BT::Dynamic_resolution_controller::submit_frame_time(float_t frame_time)
+{
+    if (m_cooldown_frames_left > 0)
+    {   // Frame was probably still rendered at the previous scale.
+        m_cooldown_frames_left--;
+        return false;
+    }
+
+    m_frame_time_history[m_next_history_idx] = frame_time;
+    m_next_history_idx = (m_next_history_idx + 1) % m_frame_time_history.size();
+    m_num_history_frames = std::min(m_num_history_frames + 1, m_frame_time_history.size());
+    if (m_num_history_frames < m_frame_time_history.size())
+        return false;
+
+    float_t average_frame_time{ calc_average_frame_time() };
+    if (average_frame_time <= 0.0f)
+        return false;
+
+    // Aim for the middle of the hold range, so that the next frames land inside of it.
+    // @NOTE: Cost of the scaled passes goes with pixel count, which is the scale squared.
+    float_t aim_frame_time{ m_settings.target_frame_time *
+                            (1.0f + m_settings.scale_up_threshold) * 0.5f };
+    float_t new_scale{ m_render_scale };
+    if (average_frame_time > m_settings.target_frame_time)
+    {   // Over budget.
+        new_scale = m_render_scale * std::sqrt(aim_frame_time / average_frame_time);
+    }
+    else if (average_frame_time < m_settings.target_frame_time * m_settings.scale_up_threshold)
+    {   // Well under budget. Go up slowly.
+        new_scale = std::min(m_render_scale * std::sqrt(aim_frame_time / average_frame_time),
+                             m_render_scale + m_settings.max_scale_up_step);
+    }
+    new_scale = std::clamp(new_scale, m_settings.min_scale, m_settings.max_scale);
+
+    bool is_at_limit{ new_scale == m_settings.min_scale || new_scale == m_settings.max_scale };
+    if (new_scale == m_render_scale ||
+        (std::abs(new_scale - m_render_scale) < m_settings.min_scale_change && !is_at_limit))
+        return false;
+
+    m_render_scale = new_scale;
+    clear_history();
+    m_cooldown_frames_left = m_settings.num_cooldown_frames;
+    return true;
+}
+
+float_t BT::Dynamic_resolution_controller::calc_average_frame_time() const
+{
+    if (m_num_history_frames == 0)
+        return 0.0f;
+
+    float_t total{ 0.0f };
+    for (size_t i = 0; i < m_num_history_frames; i++)
+        total += m_frame_time_history[i];
+    return total / m_num_history_frames;
+}
+
+void BT::Dynamic_resolution_controller::reset()
+{
+    m_render_scale = m_settings.max_scale;
+    clear_history();
+    m_cooldown_frames_left = 0;
+}
+
+void BT::Dynamic_resolution_controller::calc_scaled_dims(int32_t full_width,
+                                                         int32_t full_height,
+                                                         int32_t& out_width,
+                                                         int32_t& out_height) const
+{
+    out_width = std::max(1, static_cast<int32_t>(std::lround(full_width * m_render_scale)));
+    out_height = std::max(1, static_cast<int32_t>(std::lround(full_height * m_render_scale)));
+}
+
+void BT::Dynamic_resolution_controller::clear_history()
+{
+    m_next_history_idx = 0;
+    m_num_history_frames = 0;
+}
@@ -0,0 +1,72 @@
+#pragma once
+
+#include "btglm.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+using std::vector;
+
+
+namespace BT
+{
+
+/// Picks the render scale (of both width and height) of the scene render target from recent frame
+/// times, so that frames stay under a target budget.
+/// Scales down right away when over budget, and only scales back up once frames have been well
+/// under budget for a while. Between the two thresholds the scale is held (hysteresis), so it
+/// doesn't go back and forth around the budget.
+// @NOTE: Does not touch OpenGL. Feed it the GPU time of the scaled passes.
+class Dynamic_resolution_controller
+{
+public:
+    struct Settings
+    {
+        float_t target_frame_time;  // Budget (seconds).
+        float_t min_scale;
+        float_t max_scale;
+        float_t scale_up_threshold;  // Ratio of target that average frame time must be under.
+        float_t max_scale_up_step;   // Max scale increase per change.
+        float_t min_scale_change;    // Smaller changes are skipped.
+        size_t num_history_frames;   // Frames averaged before each decision.
+        size_t num_cooldown_frames;  // Frames ignored after a change (still in flight on GPU).
+    };
+
+    static Settings make_default_settings(float_t target_frame_time);
+
+    Dynamic_resolution_controller(Settings const& settings);
+
+    void set_settings(Settings const& settings);
+    Settings const& get_settings() const { return m_settings; }
+
+    /// Adds a frame time (seconds) to the history. Returns true if the render scale changed.
+    bool submit_frame_time(float_t frame_time);
+
+    float_t get_render_scale() const { return m_render_scale; }
+
+    /// Average of the current frame time history (0 if empty).
+    float_t calc_average_frame_time() const;
+
+    /// Goes back to max scale and clears the frame time history.
+    void reset();
+
+    /// Scales `full_width` and `full_height` by the render scale (at least 1 pixel).
+    void calc_scaled_dims(int32_t full_width,
+                          int32_t full_height,
+                          int32_t& out_width,
+                          int32_t& out_height) const;
+
+private:
+    Settings m_settings;
+    float_t m_render_scale;
+
+    vector<float_t> m_frame_time_history;  // Ring buffer.
+    size_t m_next_history_idx{ 0 };
+    size_t m_num_history_frames{ 0 };
+    size_t m_cooldown_frames_left{ 0 };
+
+    void clear_history();
+};
+
+}  // namespace BT
@@ -0,0 +1,102 @@
+#include "frustum_culler.h"
+
+#include "btglm.h"
+#include "mesh.h"
+#include <cmath>
+#include <xmmintrin.h>
+
+
+void BT::Frustum_culler::clear()
+{
+    m_num_bounds = 0;
+    m_center_xs.clear();
+    m_center_ys.clear();
+    m_center_zs.clear();
+    m_extent_xs.clear();
+    m_extent_ys.clear();
+    m_extent_zs.clear();
+}
+
+void BT::Frustum_culler::emplace_bounds(AA_bounding_box const& world_aabb,
+                                        float_t padding /*= 0.0f*/)
+{
+    if (m_num_bounds % 4 == 0)
+    {   // Add next SIMD lane group.
+        // @NOTE: Padding lanes have 0 extents at the origin and get ignored in `cull()`.
+        size_t new_size{ m_num_bounds + 4 };
+        m_center_xs.resize(new_size, 0.0f);
+        m_center_ys.resize(new_size, 0.0f);
+        m_center_zs.resize(new_size, 0.0f);
+        m_extent_xs.resize(new_size, 0.0f);
+        m_extent_ys.resize(new_size, 0.0f);
+        m_extent_zs.resize(new_size, 0.0f);
+    }
+
+    size_t idx{ m_num_bounds++ };
+    m_center_xs[idx] = (world_aabb.min[0] + world_aabb.max[0]) * 0.5f;
+    m_center_ys[idx] = (world_aabb.min[1] + world_aabb.max[1]) * 0.5f;
+    m_center_zs[idx] = (world_aabb.min[2] + world_aabb.max[2]) * 0.5f;
+    m_extent_xs[idx] = (world_aabb.max[0] - world_aabb.min[0]) * 0.5f + padding;
+    m_extent_ys[idx] = (world_aabb.max[1] - world_aabb.min[1]) * 0.5f + padding;
+    m_extent_zs[idx] = (world_aabb.max[2] - world_aabb.min[2]) * 0.5f + padding;
+}
+
+size_t BT::Frustum_culler::cull(vec4 frustum_planes[6], vector<uint8_t>& out_visible) const
+{
+    out_visible.resize(m_num_bounds);
+
+    // Splat planes (and abs of normals for the extents projection).
+    __m128 plane_xs[6];
+    __m128 plane_ys[6];
+    __m128 plane_zs[6];
+    __m128 plane_ds[6];
+    __m128 plane_abs_xs[6];
+    __m128 plane_abs_ys[6];
+    __m128 plane_abs_zs[6];
+    for (size_t i = 0; i < 6; i++)
+    {
+        plane_xs[i] = _mm_set1_ps(frustum_planes[i][0]);
+        plane_ys[i] = _mm_set1_ps(frustum_planes[i][1]);
+        plane_zs[i] = _mm_set1_ps(frustum_planes[i][2]);
+        plane_ds[i] = _mm_set1_ps(frustum_planes[i][3]);
+        plane_abs_xs[i] = _mm_set1_ps(std::abs(frustum_planes[i][0]));
+        plane_abs_ys[i] = _mm_set1_ps(std::abs(frustum_planes[i][1]));
+        plane_abs_zs[i] = _mm_set1_ps(std::abs(frustum_planes[i][2]));
+    }
+
+    size_t num_visible{ 0 };
+    for (size_t base = 0; base < m_num_bounds; base += 4)
+    {
+        __m128 center_x{ _mm_loadu_ps(&m_center_xs[base]) };
+        __m128 center_y{ _mm_loadu_ps(&m_center_ys[base]) };
+        __m128 center_z{ _mm_loadu_ps(&m_center_zs[base]) };
+        __m128 extent_x{ _mm_loadu_ps(&m_extent_xs[base]) };
+        __m128 extent_y{ _mm_loadu_ps(&m_extent_ys[base]) };
+        __m128 extent_z{ _mm_loadu_ps(&m_extent_zs[base]) };
+
+        // Box is outside if it's fully behind any plane:
+        // `dot(n, center) + d + dot(abs(n), extents) < 0`
+        __m128 outside{ _mm_setzero_ps() };
+        for (size_t i = 0; i < 6; i++)
+        {
+            __m128 dist{ _mm_add_ps(_mm_add_ps(_mm_mul_ps(plane_xs[i], center_x),
+                                               _mm_mul_ps(plane_ys[i], center_y)),
+                                    _mm_add_ps(_mm_mul_ps(plane_zs[i], center_z), plane_ds[i])) };
+            __m128 radius{ _mm_add_ps(_mm_add_ps(_mm_mul_ps(plane_abs_xs[i], extent_x),
+                                                 _mm_mul_ps(plane_abs_ys[i], extent_y)),
+                                      _mm_mul_ps(plane_abs_zs[i], extent_z)) };
+            outside = _mm_or_ps(outside,
+                                _mm_cmplt_ps(_mm_add_ps(dist, radius), _mm_setzero_ps()));
+        }
+
+        int32_t outside_mask{ _mm_movemask_ps(outside) };
+        for (size_t lane = 0; lane < 4 && base + lane < m_num_bounds; lane++)
+        {
+            bool visible{ (outside_mask & (1 << lane)) == 0 };
+            out_visible[base + lane] = (visible ? 1 : 0);
+            num_visible += (visible ? 1 : 0);
+        }
+    }
+
+    return num_visible;
+}
@@ -0,0 +1,44 @@
+#pragma once
+
+#include "btglm.h"
+#include <cstdint>
+#include <vector>
+
+using std::vector;
+
+
+namespace BT
+{
+
+struct AA_bounding_box;
+
+/// Culls world space AABBs against the camera frustum.
+/// Bounds are packed as center/extents structure-of-arrays so that 4 boxes get tested against a
+/// plane with one set of SSE ops.
+class Frustum_culler
+{
+public:
+    void clear();
+
+    /// Packs `world_aabb` for the next `cull()`. Bounds are indexed in emplacement order.
+    void emplace_bounds(AA_bounding_box const& world_aabb, float_t padding = 0.0f);
+    size_t get_num_bounds() const { return m_num_bounds; }
+
+    /// Sets `out_visible[i]` to 1 if bounds `i` touch the frustum, 0 if outside of it.
+    /// Returns number of visible bounds.
+    // @NOTE: `frustum_planes` are in the format of `glm_frustum_planes()`.
+    size_t cull(vec4 frustum_planes[6], vector<uint8_t>& out_visible) const;
+
+private:
+    size_t m_num_bounds{ 0 };
+
+    // Padded to multiple of 4 for SIMD.
+    vector<float_t> m_center_xs;
+    vector<float_t> m_center_ys;
+    vector<float_t> m_center_zs;
+    vector<float_t> m_extent_xs;
+    vector<float_t> m_extent_ys;
+    vector<float_t> m_extent_zs;
+};
+
+}  // namespace BT
@@ -0,0 +1,125 @@
+#include "geometry_arena.h"
+
+#include "glad/glad.h"
+#include "gl_state_cache.h"
+#include "mesh.h"
+#include "vertex_formats.h"
+#include <algorithm>
+#include <cassert>
+
+
+BT::Arena_range_allocator::Arena_range_allocator(uint32_t capacity)
+    : m_capacity{ capacity }
+{
+}
+
+bool BT::Arena_range_allocator::allocate(uint32_t count, uint32_t& out_base)
+{
+    if (count > m_capacity - m_num_used)
+        return false;
+
+    out_base = m_num_used;
+    m_num_used += count;
+    return true;
+}
+
+
+BT::Geometry_arena_packer::Geometry_arena_packer(uint32_t vertex_capacity,
+                                                 uint32_t index_capacity)
+    : m_vertex_capacity{ vertex_capacity }
+    , m_index_capacity{ index_capacity }
+{
+}
+
+BT::Geometry_arena_packer::Placement BT::Geometry_arena_packer::place(uint32_t num_vertices,
+                                                                      uint32_t num_indices)
+{
+    auto has_space{ [&](Arena_ranges const& arena) {
+        auto const& vertices{ arena.vertex_allocator };
+        auto const& indices{ arena.index_allocator };
+        return (num_vertices <= vertices.get_capacity() - vertices.get_num_used() &&
+                num_indices <= indices.get_capacity() - indices.get_num_used());
+    } };
+
+    if (m_arenas.empty() || !has_space(m_arenas.back()))
+    {   // Start new arena (big enough for these ranges in case they're huge).
+        m_arenas.emplace_back(Arena_range_allocator{ std::max(m_vertex_capacity, num_vertices) },
+                              Arena_range_allocator{ std::max(m_index_capacity, num_indices) });
+    }
+
+    Placement placement{ .arena_idx = static_cast<uint32_t>(m_arenas.size() - 1) };
+    bool success{ m_arenas.back().vertex_allocator.allocate(num_vertices,
+                                                            placement.base_vertex) };
+    success &= m_arenas.back().index_allocator.allocate(num_indices, placement.first_index);
+    assert(success);
+
+    return placement;
+}
+
+
+BT::Geometry_arena::Geometry_arena(uint32_t vertex_capacity, uint32_t index_capacity)
+    : m_vertex_capacity{ vertex_capacity }
+    , m_index_capacity{ index_capacity }
+{
+    glGenVertexArrays(1, &m_vertex_vao);
+    glGenBuffers(1, &m_vertex_vbo);
+    glGenBuffers(1, &m_index_ebo);
+
+    get_main_gl_state_cache().bind_vertex_array(m_vertex_vao);
+    glBindBuffer(GL_ARRAY_BUFFER, m_vertex_vbo);
+    glBufferData(GL_ARRAY_BUFFER,
+                 vertex_capacity * sizeof(Compact_vertex),
+                 nullptr,
+                 GL_STATIC_DRAW);
+
+    // Register vertex attributes.
+    vertex_formats::setup_compact_vertex_attribs();
+
+    // @NOTE: Element array buffer binding is part of VAO state.
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, m_index_ebo);
+    glBufferData(GL_ELEMENT_ARRAY_BUFFER,
+                 index_capacity * sizeof(uint32_t),
+                 nullptr,
+                 GL_STATIC_DRAW);
+
+    // Unbind.
+    get_main_gl_state_cache().bind_vertex_array(0);
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
+}
+
+BT::Geometry_arena::~Geometry_arena()
+{
+    get_main_gl_state_cache().delete_vertex_array(m_vertex_vao);
+    glDeleteBuffers(1, &m_vertex_vbo);
+    glDeleteBuffers(1, &m_index_ebo);
+}
+
+void BT::Geometry_arena::upload_vertices(Vertex const* vertices,
+                                         uint32_t num_vertices,
+                                         uint32_t base_vertex)
+{
+    assert(num_vertices <= m_vertex_capacity && base_vertex <= m_vertex_capacity - num_vertices);
+
+    auto compact_vertices{ vertex_formats::make_compact_vertices(vertices, num_vertices) };
+    glBindBuffer(GL_ARRAY_BUFFER, m_vertex_vbo);
+    glBufferSubData(GL_ARRAY_BUFFER,
+                    base_vertex * sizeof(Compact_vertex),
+                    num_vertices * sizeof(Compact_vertex),
+                    compact_vertices.data());
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+}
+
+void BT::Geometry_arena::upload_indices(uint32_t const* indices,
+                                        uint32_t num_indices,
+                                        uint32_t first_index)
+{
+    assert(num_indices <= m_index_capacity && first_index <= m_index_capacity - num_indices);
+
+    glBindBuffer(GL_COPY_WRITE_BUFFER, m_index_ebo);
+    glBufferSubData(GL_COPY_WRITE_BUFFER,
+                    first_index * sizeof(uint32_t),
+                    num_indices * sizeof(uint32_t),
+                    indices);
+    glBindBuffer(GL_COPY_WRITE_BUFFER, 0);
+}
@@ -0,0 +1,89 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+
+namespace BT
+{
+
+struct Vertex;
+
+/// Bump allocator of element ranges inside a fixed capacity arena. CPU only.
+class Arena_range_allocator
+{
+public:
+    Arena_range_allocator(uint32_t capacity);
+
+    /// Returns false if there isn't `count` elements of space left.
+    bool allocate(uint32_t count, uint32_t& out_base);
+
+    uint32_t get_capacity() const { return m_capacity; }
+    uint32_t get_num_used() const { return m_num_used; }
+
+private:
+    uint32_t m_capacity;
+    uint32_t m_num_used{ 0 };
+};
+
+/// Places vertex and index ranges into a growing list of arenas. Keeps filling the latest arena
+/// and starts a new one when the ranges don't fit (sized up if they're bigger than an arena).
+/// CPU only.
+class Geometry_arena_packer
+{
+public:
+    Geometry_arena_packer(uint32_t vertex_capacity, uint32_t index_capacity);
+
+    struct Placement
+    {
+        uint32_t arena_idx;
+        uint32_t base_vertex;
+        uint32_t first_index;
+    };
+    Placement place(uint32_t num_vertices, uint32_t num_indices);
+
+    struct Arena_ranges
+    {
+        Arena_range_allocator vertex_allocator;
+        Arena_range_allocator index_allocator;
+    };
+    std::vector<Arena_ranges> const& get_arenas() const { return m_arenas; }
+
+private:
+    uint32_t m_vertex_capacity;
+    uint32_t m_index_capacity;
+    std::vector<Arena_ranges> m_arenas;
+};
+
+/// Large shared vertex and index buffers that static models get packed into. All meshes in an
+/// arena share one vertex array, so their draws can be merged into multi-draw indirect calls.
+/// Ranges get placed w/ `Geometry_arena_packer`.
+class Geometry_arena
+{
+public:
+    Geometry_arena(uint32_t vertex_capacity, uint32_t index_capacity);
+    Geometry_arena(Geometry_arena const&)            = delete;
+    Geometry_arena(Geometry_arena&&)                 = delete;
+    Geometry_arena& operator=(Geometry_arena const&) = delete;
+    Geometry_arena& operator=(Geometry_arena&&)      = delete;
+    ~Geometry_arena();
+
+    /// Uploads `num_vertices` vertices (converted to `Compact_vertex`) starting at `base_vertex`.
+    void upload_vertices(Vertex const* vertices, uint32_t num_vertices, uint32_t base_vertex);
+
+    /// Uploads `num_indices` indices starting at `first_index`.
+    void upload_indices(uint32_t const* indices, uint32_t num_indices, uint32_t first_index);
+
+    uint32_t get_vertex_vao() const { return m_vertex_vao; }
+    uint32_t get_index_ebo() const { return m_index_ebo; }
+
+private:
+    uint32_t m_vertex_capacity;
+    uint32_t m_index_capacity;
+
+    uint32_t m_vertex_vao{ 0 };
+    uint32_t m_vertex_vbo{ 0 };
+    uint32_t m_index_ebo{ 0 };
+};
+
+}  // namespace BT
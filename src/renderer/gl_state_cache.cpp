@@ -0,0 +1,264 @@
+#include "gl_state_cache.h"
+
+#include "glad/glad.h"
+#include <cassert>
+
+
+// OpenGL backend.
+void BT::Gl_state_backend_opengl::enable(uint32_t capability)
+{
+    glEnable(capability);
+}
+
+void BT::Gl_state_backend_opengl::disable(uint32_t capability)
+{
+    glDisable(capability);
+}
+
+void BT::Gl_state_backend_opengl::depth_func(uint32_t func)
+{
+    glDepthFunc(func);
+}
+
+void BT::Gl_state_backend_opengl::depth_mask(bool mask)
+{
+    glDepthMask(mask ? GL_TRUE : GL_FALSE);
+}
+
+void BT::Gl_state_backend_opengl::cull_face(uint32_t mode)
+{
+    glCullFace(mode);
+}
+
+void BT::Gl_state_backend_opengl::front_face(uint32_t mode)
+{
+    glFrontFace(mode);
+}
+
+void BT::Gl_state_backend_opengl::blend_func(uint32_t src_factor, uint32_t dst_factor)
+{
+    glBlendFunc(src_factor, dst_factor);
+}
+
+void BT::Gl_state_backend_opengl::viewport(int32_t x, int32_t y, int32_t width, int32_t height)
+{
+    glViewport(x, y, width, height);
+}
+
+void BT::Gl_state_backend_opengl::bind_framebuffer(uint32_t target, uint32_t framebuffer)
+{
+    glBindFramebuffer(target, framebuffer);
+}
+
+void BT::Gl_state_backend_opengl::use_program(uint32_t program)
+{
+    glUseProgram(program);
+}
+
+void BT::Gl_state_backend_opengl::active_texture(uint32_t unit)
+{
+    glActiveTexture(GL_TEXTURE0 + unit);
+}
+
+void BT::Gl_state_backend_opengl::bind_texture_2d(uint32_t texture)
+{
+    glBindTexture(GL_TEXTURE_2D, texture);
+}
+
+void BT::Gl_state_backend_opengl::bind_vertex_array(uint32_t vertex_array)
+{
+    glBindVertexArray(vertex_array);
+}
+
+void BT::Gl_state_backend_opengl::delete_vertex_array(uint32_t vertex_array)
+{
+    glDeleteVertexArrays(1, &vertex_array);
+}
+
+
+// GL state cache.
+BT::Gl_state_cache::Gl_state_cache(std::unique_ptr<Gl_state_backend_ifc>&& backend)
+    : m_backend{ std::move(backend) }
+{
+}
+
+void BT::Gl_state_cache::invalidate()
+{
+    m_capabilities.clear();
+    m_depth_func.is_valid = false;
+    m_depth_mask.is_valid = false;
+    m_cull_face.is_valid = false;
+    m_front_face.is_valid = false;
+    m_blend_func.is_valid = false;
+    m_viewport.is_valid = false;
+    m_read_framebuffer.is_valid = false;
+    m_draw_framebuffer.is_valid = false;
+    m_program.is_valid = false;
+    m_active_texture_unit.is_valid = false;
+    for (auto& binding : m_texture_2d_bindings)
+        binding.is_valid = false;
+    m_vertex_array.is_valid = false;
+}
+
+void BT::Gl_state_cache::begin_frame()
+{
+    invalidate();
+    m_stats_last_frame = m_stats;
+    m_stats = {};
+}
+
+template<typename T>
+bool BT::Gl_state_cache::update_cached(Cached<T>& cached, T const& value)
+{
+    if (m_enabled && cached.is_valid && cached.value == value)
+    {
+        m_stats.num_skipped++;
+        return false;
+    }
+
+    cached.value = value;
+    cached.is_valid = true;
+    m_stats.num_issued++;
+    return true;
+}
+
+void BT::Gl_state_cache::set_capability(uint32_t capability, bool enabled)
+{
+    if (update_cached(m_capabilities[capability], enabled))
+    {
+        if (enabled)
+            m_backend->enable(capability);
+        else
+            m_backend->disable(capability);
+    }
+}
+
+void BT::Gl_state_cache::set_depth_func(uint32_t func)
+{
+    if (update_cached(m_depth_func, func))
+        m_backend->depth_func(func);
+}
+
+void BT::Gl_state_cache::set_depth_mask(bool mask)
+{
+    if (update_cached(m_depth_mask, mask))
+        m_backend->depth_mask(mask);
+}
+
+void BT::Gl_state_cache::set_cull_face(uint32_t mode)
+{
+    if (update_cached(m_cull_face, mode))
+        m_backend->cull_face(mode);
+}
+
+void BT::Gl_state_cache::set_front_face(uint32_t mode)
+{
+    if (update_cached(m_front_face, mode))
+        m_backend->front_face(mode);
+}
+
+void BT::Gl_state_cache::set_blend_func(uint32_t src_factor, uint32_t dst_factor)
+{
+    if (update_cached(m_blend_func, Blend_func{ src_factor, dst_factor }))
+        m_backend->blend_func(src_factor, dst_factor);
+}
+
+void BT::Gl_state_cache::set_viewport(int32_t x, int32_t y, int32_t width, int32_t height)
+{
+    if (update_cached(m_viewport, Viewport{ x, y, width, height }))
+        m_backend->viewport(x, y, width, height);
+}
+
+void BT::Gl_state_cache::bind_framebuffer(uint32_t target, uint32_t framebuffer)
+{
+    switch (target)
+    {
+    case GL_FRAMEBUFFER:
+    {   // Binds both read and draw targets.
+        bool read_valid{ m_read_framebuffer.is_valid && m_read_framebuffer.value == framebuffer };
+        bool draw_valid{ m_draw_framebuffer.is_valid && m_draw_framebuffer.value == framebuffer };
+        if (m_enabled && read_valid && draw_valid)
+        {
+            m_stats.num_skipped++;
+            return;
+        }
+
+        m_read_framebuffer = { framebuffer, true };
+        m_draw_framebuffer = { framebuffer, true };
+        m_stats.num_issued++;
+        m_backend->bind_framebuffer(target, framebuffer);
+        break;
+    }
+
+    case GL_READ_FRAMEBUFFER:
+        if (update_cached(m_read_framebuffer, framebuffer))
+            m_backend->bind_framebuffer(target, framebuffer);
+        break;
+
+    case GL_DRAW_FRAMEBUFFER:
+        if (update_cached(m_draw_framebuffer, framebuffer))
+            m_backend->bind_framebuffer(target, framebuffer);
+        break;
+
+    default:
+        assert(false);
+        break;
+    }
+}
+
+void BT::Gl_state_cache::use_program(uint32_t program)
+{
+    if (update_cached(m_program, program))
+        m_backend->use_program(program);
+}
+
+void BT::Gl_state_cache::bind_texture_2d(uint32_t unit, uint32_t texture)
+{
+    assert(unit < k_max_texture_units);
+    if (update_cached(m_texture_2d_bindings[unit], texture))
+    {   // Only switch units when the binding actually changes.
+        if (update_cached(m_active_texture_unit, unit))
+            m_backend->active_texture(unit);
+        m_backend->bind_texture_2d(texture);
+    }
+}
+
+void BT::Gl_state_cache::bind_vertex_array(uint32_t vertex_array)
+{
+    if (update_cached(m_vertex_array, vertex_array))
+        m_backend->bind_vertex_array(vertex_array);
+}
+
+void BT::Gl_state_cache::delete_vertex_array(uint32_t vertex_array)
+{
+    m_backend->delete_vertex_array(vertex_array);
+    m_stats.num_issued++;
+
+    if (vertex_array != 0 && m_vertex_array.is_valid && m_vertex_array.value == vertex_array)
+    {   // Deleting reverts the binding to 0.
+        m_vertex_array.value = 0;
+    }
+}
+
+
+// Main GL state cache.
+namespace
+{
+
+// @NOTE: Never freed at exit, since bank owned GL objects (eg. models) delete their vertex arrays
+//        thru the main cache during static destruction.
+BT::Gl_state_cache* s_gl_state_cache{ nullptr };
+
+}  // namespace
+
+BT::Gl_state_cache& BT::set_main_gl_state_cache(std::unique_ptr<Gl_state_cache>&& gl_state_cache)
+{
+    delete s_gl_state_cache;
+    s_gl_state_cache = gl_state_cache.release();
+    return *s_gl_state_cache;
+}
+
+BT::Gl_state_cache& BT::get_main_gl_state_cache()
+{
+    return *s_gl_state_cache;
+}
@@ -0,0 +1,156 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <unordered_map>
+
+
+namespace BT
+{
+
+/// The GL calls that `Gl_state_cache` forwards to. Swap with a recording implementation to check
+/// the filtering w/o a GL context.
+class Gl_state_backend_ifc
+{
+public:
+    // For unique_ptr.
+    virtual ~Gl_state_backend_ifc() = default;
+
+    virtual void enable(uint32_t capability) = 0;
+    virtual void disable(uint32_t capability) = 0;
+    virtual void depth_func(uint32_t func) = 0;
+    virtual void depth_mask(bool mask) = 0;
+    virtual void cull_face(uint32_t mode) = 0;
+    virtual void front_face(uint32_t mode) = 0;
+    virtual void blend_func(uint32_t src_factor, uint32_t dst_factor) = 0;
+    virtual void viewport(int32_t x, int32_t y, int32_t width, int32_t height) = 0;
+    virtual void bind_framebuffer(uint32_t target, uint32_t framebuffer) = 0;
+    virtual void use_program(uint32_t program) = 0;
+    virtual void active_texture(uint32_t unit) = 0;
+    virtual void bind_texture_2d(uint32_t texture) = 0;
+    virtual void bind_vertex_array(uint32_t vertex_array) = 0;
+    virtual void delete_vertex_array(uint32_t vertex_array) = 0;
+};
+
+/// Calls OpenGL directly (needs a current context).
+class Gl_state_backend_opengl : public Gl_state_backend_ifc
+{
+public:
+    void enable(uint32_t capability) override;
+    void disable(uint32_t capability) override;
+    void depth_func(uint32_t func) override;
+    void depth_mask(bool mask) override;
+    void cull_face(uint32_t mode) override;
+    void front_face(uint32_t mode) override;
+    void blend_func(uint32_t src_factor, uint32_t dst_factor) override;
+    void viewport(int32_t x, int32_t y, int32_t width, int32_t height) override;
+    void bind_framebuffer(uint32_t target, uint32_t framebuffer) override;
+    void use_program(uint32_t program) override;
+    void active_texture(uint32_t unit) override;
+    void bind_texture_2d(uint32_t texture) override;
+    void bind_vertex_array(uint32_t vertex_array) override;
+    void delete_vertex_array(uint32_t vertex_array) override;
+};
+
+/// Remembers the last set GL state and skips calls that would set it to what it already is.
+/// Counts issued and skipped calls per frame.
+// @NOTE: Anything that changes tracked state w/o going thru the cache (eg. deleting a bound object
+//        or a library doing its own GL calls) must call `invalidate()` afterwards. Delete vertex
+//        arrays w/ `delete_vertex_array()` instead.
+class Gl_state_cache
+{
+public:
+    Gl_state_cache(std::unique_ptr<Gl_state_backend_ifc>&& backend);
+
+    /// Off forwards every call to the backend (for comparing).
+    void set_enabled(bool enabled) { m_enabled = enabled; }
+    bool get_enabled() const { return m_enabled; }
+
+    /// Forgets all tracked state, so the next call of each kind always gets issued.
+    void invalidate();
+
+    /// Invalidates and starts counting calls for a new frame.
+    void begin_frame();
+
+    void set_capability(uint32_t capability, bool enabled);  // `glEnable()`/`glDisable()`.
+    void set_depth_func(uint32_t func);
+    void set_depth_mask(bool mask);
+    void set_cull_face(uint32_t mode);
+    void set_front_face(uint32_t mode);
+    void set_blend_func(uint32_t src_factor, uint32_t dst_factor);  // Enable w/ `GL_BLEND`.
+    void set_viewport(int32_t x, int32_t y, int32_t width, int32_t height);
+    void bind_framebuffer(uint32_t target, uint32_t framebuffer);
+    void use_program(uint32_t program);
+    void bind_texture_2d(uint32_t unit, uint32_t texture);
+    void bind_vertex_array(uint32_t vertex_array);
+
+    /// Deletes `vertex_array`. GL unbinds a bound vertex array when it's deleted, so this clears
+    /// the cached binding too (otherwise a new vertex array reusing the name wouldn't get bound).
+    void delete_vertex_array(uint32_t vertex_array);
+
+    struct Stats
+    {
+        size_t num_issued{ 0 };
+        size_t num_skipped{ 0 };
+    };
+    Stats const& get_stats_last_frame() const { return m_stats_last_frame; }
+
+    static constexpr uint32_t k_max_texture_units{ 16 };
+
+private:
+    std::unique_ptr<Gl_state_backend_ifc> m_backend;
+    bool m_enabled{ true };
+
+    template<typename T>
+    struct Cached
+    {
+        T value{};
+        bool is_valid{ false };
+    };
+
+    /// Sets `cached` to `value` and returns true if the call needs issuing.
+    template<typename T>
+    bool update_cached(Cached<T>& cached, T const& value);
+
+    struct Viewport
+    {
+        int32_t x;
+        int32_t y;
+        int32_t width;
+        int32_t height;
+
+        bool operator==(Viewport const&) const = default;
+    };
+
+    struct Blend_func
+    {
+        uint32_t src_factor;
+        uint32_t dst_factor;
+
+        bool operator==(Blend_func const&) const = default;
+    };
+
+    std::unordered_map<uint32_t, Cached<bool>> m_capabilities;
+    Cached<uint32_t> m_depth_func;
+    Cached<bool> m_depth_mask;
+    Cached<uint32_t> m_cull_face;
+    Cached<uint32_t> m_front_face;
+    Cached<Blend_func> m_blend_func;
+    Cached<Viewport> m_viewport;
+    Cached<uint32_t> m_read_framebuffer;
+    Cached<uint32_t> m_draw_framebuffer;
+    Cached<uint32_t> m_program;
+    Cached<uint32_t> m_active_texture_unit;
+    std::array<Cached<uint32_t>, k_max_texture_units> m_texture_2d_bindings;
+    Cached<uint32_t> m_vertex_array;
+
+    Stats m_stats;
+    Stats m_stats_last_frame;
+};
+
+Gl_state_cache& set_main_gl_state_cache(std::unique_ptr<Gl_state_cache>&& gl_state_cache);
+Gl_state_cache& get_main_gl_state_cache();
+
+}  // namespace BT
@@ -137,6 +137,31 @@ void BT::ImGui_renderer::render_imgui(float_t delta_time)
                         !get_main_debug_line_pool().get_visible());
                 }
 
+                if (ImGui::MenuItem("Lines: Stress test"))
+                {   // Fill the whole line budget with a grid of lines.
+                    auto& dbg_line_pool{ get_main_debug_line_pool() };
+                    dbg_line_pool.set_visible(true);
+
+                    constexpr uint32_t k_grid_width{ 128 };
+                    std::vector<Debug_line> stress_lines;
+                    stress_lines.reserve(Debug_line_pool::k_num_lines);
+                    for (uint32_t i = 0; i < Debug_line_pool::k_num_lines; i++)
+                    {
+                        float_t x{ static_cast<float_t>(i % k_grid_width) * 0.5f };
+                        float_t z{ static_cast<float_t>(i / k_grid_width) * 0.5f };
+                        stress_lines.push_back({ { x, 0.0f, z, 1.0f },
+                                                 { x, 1.0f, z, 1.0f },
+                                                 { 1.0f, 0.0f, 1.0f, 1.0f },
+                                                 { 0.0f, 1.0f, 1.0f, 1.0f } });
+                    }
+                    dbg_line_pool.emplace_debug_lines(stress_lines, 10.0f);
+                }
+
+                auto dbg_line_stats{ get_main_debug_line_pool().get_stats() };
+                ImGui::TextDisabled("  %zu live lines (%zu dropped)",
+                                    dbg_line_stats.num_live_lines,
+                                    dbg_line_stats.num_dropped_lines);
+
                 // All the debug mesh masks.
                 static std::vector<std::pair<std::string, uint8_t>> const k_masks{
                     { "Selected obj", Debug_mesh_pool::k_mask_selected_obj },
@@ -354,6 +379,84 @@ void BT::ImGui_renderer::render_imgui(float_t delta_time)
 
         ImGui::SameLine();
         ImGui::Text("%.1f FPS (%.3f ms)", io.Framerate, (1000.0f / io.Framerate));
+        if (ImGui::IsItemHovered())
+        {
+            auto render_stats{ m_renderer->get_render_stats() };
+            ImGui::SetTooltip("Render objects: %zu visible, %zu culled\n"
+                              "Occlusion: %zu occluded by %zu occluders (%.3f ms)\n"
+                              "LOD: %zu below full detail\n"
+                              "Static batches: %zu (%zu render objects), %zu culled, "
+                              "%zu occluded\n"
+                              "Render scale: %.0f%% (scene GPU time %.3f ms)\n"
+                              "Draw calls: %zu (%zu instances)\n"
+                              "Picks: %zu CPU, %zu GPU\n"
+                              "Stream buffer: %zu KiB used (%zu waits on GPU)\n"
+                              "GL state calls: %zu issued, %zu redundant skipped\n"
+                              "CPU skinning: %.2fM vertices/s (latest skin)",
+                              render_stats.num_visible_render_objs,
+                              render_stats.num_culled_render_objs,
+                              render_stats.num_occluded_render_objs,
+                              render_stats.num_occluders,
+                              render_stats.occlusion_cull_time * 1000.0f,
+                              render_stats.num_reduced_lod_render_objs,
+                              render_stats.num_static_batches,
+                              render_stats.num_static_batched_render_objs,
+                              render_stats.num_culled_static_batches,
+                              render_stats.num_occluded_static_batches,
+                              render_stats.render_scale * 100.0f,
+                              render_stats.scene_gpu_time * 1000.0f,
+                              render_stats.num_draw_calls,
+                              render_stats.num_instances,
+                              render_stats.num_cpu_picks,
+                              render_stats.num_gpu_picks,
+                              render_stats.stream_buffer_bytes_used / 1024,
+                              render_stats.num_stream_buffer_waits,
+                              render_stats.num_gl_state_calls,
+                              render_stats.num_gl_state_calls_skipped,
+                              render_stats.cpu_skinning_vertices_per_second / 1000000.0f);
+        }
+
+        ImGui::SameLine();
+        bool instancing_enabled{ m_renderer->get_instancing_enabled() };
+        if (ImGui::Checkbox("Instancing", &instancing_enabled))
+            m_renderer->set_instancing_enabled(instancing_enabled);
+
+        ImGui::SameLine();
+        ImGui::BeginDisabled(!instancing_enabled);
+        bool mdi_enabled{ m_renderer->get_multi_draw_indirect_enabled() };
+        if (ImGui::Checkbox("MDI", &mdi_enabled))
+            m_renderer->set_multi_draw_indirect_enabled(mdi_enabled);
+        ImGui::EndDisabled();
+
+        ImGui::SameLine();
+        bool occlusion_culling_enabled{ m_renderer->get_occlusion_culling_enabled() };
+        if (ImGui::Checkbox("Occlusion", &occlusion_culling_enabled))
+            m_renderer->set_occlusion_culling_enabled(occlusion_culling_enabled);
+
+        ImGui::SameLine();
+        bool lod_enabled{ m_renderer->get_lod_enabled() };
+        if (ImGui::Checkbox("LOD", &lod_enabled))
+            m_renderer->set_lod_enabled(lod_enabled);
+
+        ImGui::SameLine();
+        bool static_batching_enabled{ m_renderer->get_static_batching_enabled() };
+        if (ImGui::Checkbox("Static batching", &static_batching_enabled))
+            m_renderer->set_static_batching_enabled(static_batching_enabled);
+
+        ImGui::SameLine();
+        bool dynamic_resolution_enabled{ m_renderer->get_dynamic_resolution_enabled() };
+        if (ImGui::Checkbox("Dynamic res", &dynamic_resolution_enabled))
+            m_renderer->set_dynamic_resolution_enabled(dynamic_resolution_enabled);
+
+        ImGui::SameLine();
+        bool gl_state_cache_enabled{ m_renderer->get_gl_state_cache_enabled() };
+        if (ImGui::Checkbox("GL state cache", &gl_state_cache_enabled))
+            m_renderer->set_gl_state_cache_enabled(gl_state_cache_enabled);
+
+        ImGui::SameLine();
+        bool cpu_picking_enabled{ m_renderer->get_cpu_picking_enabled() };
+        if (ImGui::Checkbox("CPU picking", &cpu_picking_enabled))
+            m_renderer->set_cpu_picking_enabled(cpu_picking_enabled);
 
         // Viewport views.
         ImGui::SameLine(0, k_wide_spacing);
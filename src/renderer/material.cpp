@@ -26,6 +26,7 @@ void BT::Material_bank::emplace_material(string const& name, unique_ptr<Material
         return;
     }
 
+    material->m_material_sort_id = static_cast<uint16_t>(s_materials.size());
     s_materials.emplace_back(name, std::move(material));
 }
 
@@ -2,6 +2,7 @@
 
 #include "btglm.h"
 #include "camera_read_ifc.h"
+#include <cstdint>
 #include <memory>
 #include <string>
 #include <utility>
@@ -16,14 +17,38 @@ using std::vector;
 namespace BT
 {
 
+class Shader;
+
 class Material_ifc
 {
 public:
     // For unique_ptr.
     virtual ~Material_ifc();
 
-    virtual void bind_material(mat4 transform) = 0;
+    /// Binds all material state, then sets `transform` for the next draw.
+    void bind_material(mat4 transform)
+    {
+        bind_material_shared();
+        set_material_transform(transform);
+    }
+
+    /// Shader this material binds. Used for sorting draws by shader.
+    virtual Shader const& get_shader() const = 0;
+
+    /// Binds shader and material parameters shared between all draws using this material.
+    /// Draws using the same material back-to-back only need to call `set_material_transform()`.
+    virtual void bind_material_shared() = 0;
+    virtual void set_material_transform(mat4 transform) = 0;
     virtual void unbind_material() = 0;
+
+    /// Id of this material in the material bank (`k_invalid_sort_id` if not in the bank).
+    static constexpr uint16_t k_invalid_sort_id{ 0xFFFF };
+    uint16_t get_material_sort_id() const { return m_material_sort_id; }
+
+private:
+    uint16_t m_material_sort_id{ k_invalid_sort_id };
+
+    friend class Material_bank;
 };
 
 // @COPYPASTA. See "mesh.h"
@@ -1,6 +1,7 @@
 #include "material_impl_debug_lines.h"
 
 #include "glad/glad.h"
+#include "gl_state_cache.h"
 #include "shader.h"
 
 
@@ -10,28 +11,33 @@ BT::Material_debug_lines::Material_debug_lines(bool foreground)
 {
 }
 
-void BT::Material_debug_lines::set_lines_ssbo(uint32_t ssbo)
+void BT::Material_debug_lines::set_lines_ssbo(uint32_t ssbo, size_t offset, size_t size)
 {
-    m_ssbo = ssbo;
+    m_ssbo        = ssbo;
+    m_ssbo_offset = offset;
+    m_ssbo_size   = size;
 }
 
-void BT::Material_debug_lines::bind_material(mat4 transform)
+BT::Shader const& BT::Material_debug_lines::get_shader() const
 {
-    mat4 projection;
-    mat4 view;
-    mat4 projection_view;
-    Material_bank::get_camera_read_ifc()->fetch_camera_matrices(projection, view, projection_view);
+    static auto& s_shader{ *Shader_bank::get_shader("color_unlit_lines") };
+    return s_shader;
+}
 
+void BT::Material_debug_lines::bind_material_shared()
+{
     // Setup depth test function.
-    glDepthFunc(m_foreground ? GL_LEQUAL : GL_GREATER);
+    get_main_gl_state_cache().set_depth_func(m_foreground ? GL_LEQUAL : GL_GREATER);
 
-    glBindBuffer(GL_SHADER_STORAGE_BUFFER, m_ssbo);
-    glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 0, m_ssbo);
-    glBindBuffer(GL_SHADER_STORAGE_BUFFER, 0);
+    glBindBufferRange(GL_SHADER_STORAGE_BUFFER, 0, m_ssbo, m_ssbo_offset, m_ssbo_size);
 
-    static auto& s_shader{ *Shader_bank::get_shader("color_unlit_lines") };
-    s_shader.bind();
-    s_shader.set_mat4("camera_projection_view", projection_view);
+    auto const& shader{ get_shader() };
+    shader.bind();
+}
+
+void BT::Material_debug_lines::set_material_transform(mat4 transform)
+{
+    (void)transform;  // Lines are already in world space.
 }
 
 void BT::Material_debug_lines::unbind_material()
@@ -39,7 +45,7 @@ void BT::Material_debug_lines::unbind_material()
     Shader::unbind();
 
     // Reset depth test params.
-    glDepthFunc(GL_LEQUAL);
+    get_main_gl_state_cache().set_depth_func(GL_LEQUAL);
 
     glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 0, 0);
 }
@@ -12,14 +12,19 @@ class Material_debug_lines : public Material_ifc
 public:
     Material_debug_lines(bool foreground);
 
-    void set_lines_ssbo(uint32_t ssbo);
+    /// Sets the range of `ssbo` that the lines are in.
+    void set_lines_ssbo(uint32_t ssbo, size_t offset, size_t size);
 
-    virtual void bind_material(mat4 transform) override;
+    virtual Shader const& get_shader() const override;
+    virtual void bind_material_shared() override;
+    virtual void set_material_transform(mat4 transform) override;
     virtual void unbind_material() override;
 
 private:
     bool m_foreground;
     uint32_t m_ssbo;
+    size_t m_ssbo_offset{ 0 };
+    size_t m_ssbo_size{ 0 };
 };
 
 }  // namespace BT
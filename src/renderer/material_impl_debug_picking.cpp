@@ -13,18 +13,23 @@ void BT::Material_debug_picking::set_color(vec3 color)
     glm_vec3_copy(color, m_color);
 }
 
-void BT::Material_debug_picking::bind_material(mat4 transform)
+BT::Shader const& BT::Material_debug_picking::get_shader() const
 {
-    mat4 projection;
-    mat4 view;
-    mat4 projection_view;
-    Material_bank::get_camera_read_ifc()->fetch_camera_matrices(projection, view, projection_view);
-
     static auto& s_shader{ *Shader_bank::get_shader("color_unlit") };
-    s_shader.bind();
-    s_shader.set_mat4("camera_projection_view", projection_view);
-    s_shader.set_mat4("model_transform", transform);
-    s_shader.set_vec3("color", m_color);
+    return s_shader;
+}
+
+void BT::Material_debug_picking::bind_material_shared()
+{
+    auto const& shader{ get_shader() };
+    shader.bind();
+    shader.set_vec3(shader.get_uniform_location(Shader::UNIFORM_COLOR), m_color);
+}
+
+void BT::Material_debug_picking::set_material_transform(mat4 transform)
+{
+    auto const& shader{ get_shader() };
+    shader.set_mat4(shader.get_uniform_location(Shader::UNIFORM_MODEL_TRANSFORM), transform);
 }
 
 void BT::Material_debug_picking::unbind_material()
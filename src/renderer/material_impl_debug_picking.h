@@ -14,7 +14,9 @@ public:
 
     void set_color(vec3 color);
 
-    virtual void bind_material(mat4 transform) override;
+    virtual Shader const& get_shader() const override;
+    virtual void bind_material_shared() override;
+    virtual void set_material_transform(mat4 transform) override;
     virtual void unbind_material() override;
 
 private:
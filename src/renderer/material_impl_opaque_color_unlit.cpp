@@ -3,6 +3,7 @@
 #include "material.h"
 #include "shader.h"
 #include "glad/glad.h"
+#include "gl_state_cache.h"
 #include <cstdint>
 #include <unordered_map>
 
@@ -27,24 +28,29 @@ BT::Material_opaque_color_unlit::Material_opaque_color_unlit(vec3 color, uint8_t
     glm_vec3_copy(color, m_color);
 }
 
-void BT::Material_opaque_color_unlit::bind_material(mat4 transform)
+BT::Shader const& BT::Material_opaque_color_unlit::get_shader() const
 {
-    mat4 projection;
-    mat4 view;
-    mat4 projection_view;
-    Material_bank::get_camera_read_ifc()->fetch_camera_matrices(projection, view, projection_view);
+    static auto& s_shader{ *Shader_bank::get_shader("color_unlit") };
+    return s_shader;
+}
 
+void BT::Material_opaque_color_unlit::bind_material_shared()
+{
     // Setup depth test function.
-    glDepthFunc(s_depth_test_mode_codes.at(m_depth_test_mode));
+    get_main_gl_state_cache().set_depth_func(s_depth_test_mode_codes.at(m_depth_test_mode));
 
     // Wireframe mode.
     glPolygonMode(GL_FRONT_AND_BACK, GL_LINE);
 
-    static auto& s_shader{ *Shader_bank::get_shader("color_unlit") };
-    s_shader.bind();
-    s_shader.set_mat4("camera_projection_view", projection_view);
-    s_shader.set_mat4("model_transform", transform);
-    s_shader.set_vec3("color", m_color);
+    auto const& shader{ get_shader() };
+    shader.bind();
+    shader.set_vec3(shader.get_uniform_location(Shader::UNIFORM_COLOR), m_color);
+}
+
+void BT::Material_opaque_color_unlit::set_material_transform(mat4 transform)
+{
+    auto const& shader{ get_shader() };
+    shader.set_mat4(shader.get_uniform_location(Shader::UNIFORM_MODEL_TRANSFORM), transform);
 }
 
 void BT::Material_opaque_color_unlit::unbind_material()
@@ -60,5 +66,5 @@ void BT::Material_opaque_color_unlit::unbind_material()
 
     // Reset depth test params.
     // @NOTE: Same problem as above. Idk what the defaults are @TECHDEBT
-    glDepthFunc(GL_LEQUAL);
+    get_main_gl_state_cache().set_depth_func(GL_LEQUAL);
 }
@@ -16,7 +16,9 @@ class Material_opaque_color_unlit : public Material_ifc
 public:
     Material_opaque_color_unlit(vec3 color, uint8_t depth_test_mode);
 
-    virtual void bind_material(mat4 transform) override;
+    virtual Shader const& get_shader() const override;
+    virtual void bind_material_shared() override;
+    virtual void set_material_transform(mat4 transform) override;
     virtual void unbind_material() override;
 
 private:
@@ -12,7 +12,9 @@ class Material_opaque_shaded : public Material_ifc
 public:
     Material_opaque_shaded(vec3 color);
 
-    virtual void bind_material(mat4 transform) override;
+    virtual Shader const& get_shader() const override;
+    virtual void bind_material_shared() override;
+    virtual void set_material_transform(mat4 transform) override;
     virtual void unbind_material() override;
 
 private:
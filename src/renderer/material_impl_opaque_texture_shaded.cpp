@@ -17,21 +17,28 @@ BT::Material_opaque_texture_shaded::Material_opaque_texture_shaded(uint32_t colo
     glm_vec3_copy(tint_non_standable, m_tint_non_standable);
 }
 
-void BT::Material_opaque_texture_shaded::bind_material(mat4 transform)
+BT::Shader const& BT::Material_opaque_texture_shaded::get_shader() const
 {
-    mat4 projection;
-    mat4 view;
-    mat4 projection_view;
-    Material_bank::get_camera_read_ifc()->fetch_camera_matrices(projection, view, projection_view);
-
     static auto& s_shader{ *Shader_bank::get_shader("textured_shaded") };
-    s_shader.bind();
-    s_shader.set_mat4("camera_projection_view", projection_view);
-    s_shader.set_mat4("model_transform", transform);
-    s_shader.bind_texture("color_image", 0, m_color_image);
-    s_shader.set_vec3("tint_standable", m_tint_standable);
-    s_shader.set_vec3("tint_non_standable", m_tint_non_standable);
-    s_shader.set_float("sin_standable_angle", m_sin_standable_angle);
+    return s_shader;
+}
+
+void BT::Material_opaque_texture_shaded::bind_material_shared()
+{
+    auto const& shader{ get_shader() };
+    shader.bind();
+    shader.bind_texture(shader.get_uniform_location(Shader::UNIFORM_COLOR_IMAGE), 0, m_color_image);
+    shader.set_vec3(shader.get_uniform_location(Shader::UNIFORM_TINT_STANDABLE), m_tint_standable);
+    shader.set_vec3(shader.get_uniform_location(Shader::UNIFORM_TINT_NON_STANDABLE),
+                    m_tint_non_standable);
+    shader.set_float(shader.get_uniform_location(Shader::UNIFORM_SIN_STANDABLE_ANGLE),
+                     m_sin_standable_angle);
+}
+
+void BT::Material_opaque_texture_shaded::set_material_transform(mat4 transform)
+{
+    auto const& shader{ get_shader() };
+    shader.set_mat4(shader.get_uniform_location(Shader::UNIFORM_MODEL_TRANSFORM), transform);
 }
 
 void BT::Material_opaque_texture_shaded::unbind_material()
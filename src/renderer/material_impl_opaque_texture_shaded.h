@@ -15,7 +15,9 @@ public:
                                    vec3 tint_non_standable,
                                    float_t standable_angle_deg);
 
-    virtual void bind_material(mat4 transform) override;
+    virtual Shader const& get_shader() const override;
+    virtual void bind_material_shared() override;
+    virtual void set_material_transform(mat4 transform) override;
     virtual void unbind_material() override;
 
 private:
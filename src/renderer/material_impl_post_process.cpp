@@ -10,12 +10,24 @@ BT::Material_impl_post_process::Material_impl_post_process(float_t exposure)
 {
 }
 
-void BT::Material_impl_post_process::bind_material(mat4 transform)
+BT::Shader const& BT::Material_impl_post_process::get_shader() const
 {
     static auto& s_shader{ *Shader_bank::get_shader("post_process") };
-    s_shader.bind();
-    s_shader.bind_texture("hdr_buffer", 0, Texture_bank::get_texture_2d("hdr_color_texture"));
-    s_shader.set_float("exposure", m_exposure);
+    return s_shader;
+}
+
+void BT::Material_impl_post_process::bind_material_shared()
+{
+    auto const& shader{ get_shader() };
+    shader.bind();
+    shader.bind_texture("hdr_buffer", 0, Texture_bank::get_texture_2d("hdr_color_texture"));
+    shader.set_float("exposure", m_exposure);
+    shader.set_vec2("render_scale", m_render_scale);
+}
+
+void BT::Material_impl_post_process::set_material_transform(mat4 transform)
+{
+    (void)transform;  // Fullscreen pass.
 }
 
 void BT::Material_impl_post_process::unbind_material()
@@ -12,11 +12,17 @@ class Material_impl_post_process : public Material_ifc
 public:
     Material_impl_post_process(float_t exposure);
 
-    virtual void bind_material(mat4 transform) override;
+    virtual Shader const& get_shader() const override;
+    virtual void bind_material_shared() override;
+    virtual void set_material_transform(mat4 transform) override;
     virtual void unbind_material() override;
 
+    /// Ratio of the HDR buffer that the scene was rendered into (dynamic resolution).
+    void set_render_scale(vec2 render_scale) { glm_vec2_copy(render_scale, m_render_scale); }
+
 private:
     float_t m_exposure;
+    vec2 m_render_scale{ 1.0f, 1.0f };
 };
 
 }  // namespace BT
@@ -2,15 +2,21 @@
 
 #include "btglm.h"
 #include "btlogger.h"
+#include "cpu_skinning.h"
 #include "fastgltf/core.hpp"
 #include "fastgltf/math.hpp"
 #include "fastgltf/types.hpp"
 #include "fastgltf/tools.hpp"
 #include "glad/glad.h"
+#include "gl_state_cache.h"
 #include "material.h"
+#include "mesh_simplifier.h"
 #include "model_animator.h"
 #include "shader.h"
 #include "tiny_obj_loader.h"
+#include "vertex_cache_optimizer.h"
+#include "vertex_formats.h"
+#include <algorithm>
 #include <cassert>
 #include <cmath>
 #include <filesystem>
@@ -38,13 +44,29 @@ void BT::AA_bounding_box::feed_position(vec3 position)
     glm_vec3_maxv(max, position, max);
 }
 
+void BT::AA_bounding_box::calc_transformed(mat4 transform, AA_bounding_box& out_aabb) const
+{
+    out_aabb.reset();
+    for (uint32_t i = 0; i < 8; i++)
+    {
+        vec3 corner{ (i & 0b001) ? max[0] : min[0],
+                     (i & 0b010) ? max[1] : min[1],
+                     (i & 0b100) ? max[2] : min[2] };
+        glm_mat4_mulv3(transform, corner, 1.0f, corner);
+        out_aabb.feed_position(corner);
+    }
+}
+
 
 BT::Mesh::Mesh(vector<uint32_t>&& indices, string const& material_name)
     : m_indices(std::move(indices))
+    , m_mesh_sort_id{ acquire_sort_id() }
 {
     m_material = Material_bank::get_material(material_name);
     assert(m_material != nullptr);
 
+    m_lod_ranges.push_back({ 0, static_cast<uint32_t>(m_indices.size()) });
+
     // @UNUSED.
     // // Calculate AABB.
     // m_mesh_aabb.reset();
@@ -63,6 +85,22 @@ BT::Mesh::~Mesh()
     glDeleteBuffers(1, &m_mesh_index_ebo);
 }
 
+uint32_t BT::Mesh::acquire_sort_id()
+{
+    if (s_free_mesh_sort_ids.empty())
+        return s_next_mesh_sort_id++;
+
+    uint32_t sort_id{ s_free_mesh_sort_ids.back() };
+    s_free_mesh_sort_ids.pop_back();
+    return sort_id;
+}
+
+void BT::Mesh::release_sort_id(uint32_t sort_id)
+{
+    assert(sort_id < s_next_mesh_sort_id);
+    s_free_mesh_sort_ids.emplace_back(sort_id);
+}
+
 void BT::Mesh::render_mesh(mat4 transform, Material_ifc* override_material /*= nullptr*/) const
 {
     // @NOTE: All meshes share vertices, so they are stored and bound at the model level.
@@ -80,11 +118,95 @@ void BT::Mesh::render_mesh(mat4 transform, Material_ifc* override_material /*= n
     glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
 }
 
+void BT::Mesh::emplace_draw(Render_layer layer,
+                            uint32_t vertex_vao,
+                            mat4 transform,
+                            uint32_t lod_level,
+                            Render_queue& render_queue) const
+{
+    assert(lod_level < m_lod_ranges.size());
+    auto const& lod_range{ m_lod_ranges[lod_level] };
+    render_queue.emplace_draw(layer,
+                              *m_material,
+                              (m_mesh_sort_id * k_max_lod_levels + lod_level),
+                              vertex_vao,
+                              m_mesh_index_ebo,
+                              lod_range.num_indices,
+                              transform,
+                              lod_range.first_index);
+}
+
+void BT::Mesh::emplace_arena_draw(Render_layer layer,
+                                  Geometry_arena const& arena,
+                                  uint32_t base_vertex,
+                                  mat4 transform,
+                                  uint32_t lod_level,
+                                  Render_queue& render_queue) const
+{
+    assert(lod_level < m_lod_ranges.size());
+    auto const& lod_range{ m_lod_ranges[lod_level] };
+    render_queue.emplace_draw(layer,
+                              *m_material,
+                              (m_mesh_sort_id * k_max_lod_levels + lod_level),
+                              arena.get_vertex_vao(),
+                              arena.get_index_ebo(),
+                              lod_range.num_indices,
+                              transform,
+                              m_arena_first_index + lod_range.first_index,
+                              static_cast<int32_t>(base_vertex));
+}
+
 vector<uint32_t> const& BT::Mesh::get_indices() const
 {
     return m_indices;
 }
 
+void BT::Mesh::set_indices(vector<uint32_t>&& indices)
+{
+    assert(m_lod_indices.empty());
+
+    m_indices = std::move(indices);
+    m_lod_ranges[0].num_indices = static_cast<uint32_t>(m_indices.size());
+
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, m_mesh_index_ebo);
+    glBufferData(GL_ELEMENT_ARRAY_BUFFER,
+                 m_indices.size() * sizeof(uint32_t),
+                 m_indices.data(),
+                 GL_STATIC_DRAW);
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
+}
+
+void BT::Mesh::set_lod_levels(vector<vector<uint32_t>> const& lod_level_indices)
+{
+    assert(lod_level_indices.size() < k_max_lod_levels);
+
+    m_lod_indices.clear();
+    m_lod_ranges.resize(1);
+    for (auto const& indices : lod_level_indices)
+    {
+        m_lod_ranges.push_back({ static_cast<uint32_t>(m_indices.size() + m_lod_indices.size()),
+                                 static_cast<uint32_t>(indices.size()) });
+        m_lod_indices.insert(m_lod_indices.end(), indices.begin(), indices.end());
+    }
+
+    // Reupload index buffer with all levels.
+    size_t num_total_indices{ m_indices.size() + m_lod_indices.size() };
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, m_mesh_index_ebo);
+    glBufferData(GL_ELEMENT_ARRAY_BUFFER,
+                 num_total_indices * sizeof(uint32_t),
+                 nullptr,
+                 GL_STATIC_DRAW);
+    glBufferSubData(GL_ELEMENT_ARRAY_BUFFER,
+                    0,
+                    m_indices.size() * sizeof(uint32_t),
+                    m_indices.data());
+    glBufferSubData(GL_ELEMENT_ARRAY_BUFFER,
+                    m_indices.size() * sizeof(uint32_t),
+                    m_lod_indices.size() * sizeof(uint32_t),
+                    m_lod_indices.data());
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
+}
+
 
 BT::Model::Model(string const& fname, string const& material_name)
 {
@@ -104,12 +226,19 @@ BT::Model::Model(string const& fname, string const& material_name)
                         fname_ext.c_str());
         assert(false);
     }
+
+    optimize_vertex_cache_and_fetch(fname);
+    upload_vertex_buffers();
+
+    // @NOTE: Skinned models always get drawn deformed at full detail, so skip them.
+    if (m_vert_skin_datas.empty())
+        generate_lod_levels(fname);
 }
 
 BT::Model::~Model()
 {
     glDeleteBuffers(1, &m_model_vertex_vbo);
-    glDeleteVertexArrays(1, &m_model_vertex_vao);
+    get_main_gl_state_cache().delete_vertex_array(m_model_vertex_vao);
 }
 
 std::string BT::Model::get_model_name() const
@@ -120,14 +249,192 @@ std::string BT::Model::get_model_name() const
 void BT::Model::render(mat4 transform, Material_ifc* override_material /*= nullptr*/) const
 {
     // @NOTE: All meshes share the same vertices, just use different indices.
-    glBindVertexArray(m_model_vertex_vao);
+    get_main_gl_state_cache().bind_vertex_array(m_model_vertex_vao);
 
     for (auto& mesh : m_meshes)
     {
         mesh.render_mesh(transform, override_material);
     }
 
-    glBindVertexArray(0);
+    get_main_gl_state_cache().bind_vertex_array(0);
+}
+
+void BT::Model::emplace_draws(Render_layer layer,
+                              mat4 transform,
+                              uint32_t lod_level,
+                              Render_queue& render_queue) const
+{
+    lod_level = std::min(lod_level, get_num_lod_levels() - 1);
+
+    for (auto& mesh : m_meshes)
+    {
+        if (m_geometry_arena != nullptr)
+            mesh.emplace_arena_draw(
+                layer, *m_geometry_arena, m_arena_base_vertex, transform, lod_level, render_queue);
+        else
+            mesh.emplace_draw(layer, m_model_vertex_vao, transform, lod_level, render_queue);
+    }
+}
+
+uint32_t BT::Model::calc_num_arena_indices() const
+{
+    uint32_t num_indices{ 0 };
+    for (auto const& mesh : m_meshes)
+    {
+        num_indices += static_cast<uint32_t>(mesh.get_indices().size() +
+                                             mesh.get_lod_indices().size());
+    }
+    return num_indices;
+}
+
+void BT::Model::pack_into_geometry_arena(Geometry_arena& arena,
+                                         uint32_t base_vertex,
+                                         uint32_t first_index)
+{
+    assert(m_geometry_arena == nullptr);
+
+    arena.upload_vertices(m_vertices.data(), static_cast<uint32_t>(m_vertices.size()), base_vertex);
+    m_arena_base_vertex = base_vertex;
+
+    uint32_t next_index{ first_index };
+    for (auto& mesh : m_meshes)
+    {   // @NOTE: Same layout as the mesh's own index buffer (LOD levels after full detail).
+        auto const& indices{ mesh.get_indices() };
+        auto const& lod_indices{ mesh.get_lod_indices() };
+        mesh.set_arena_first_index(next_index);
+        arena.upload_indices(indices.data(), static_cast<uint32_t>(indices.size()), next_index);
+        next_index += static_cast<uint32_t>(indices.size());
+        arena.upload_indices(
+            lod_indices.data(), static_cast<uint32_t>(lod_indices.size()), next_index);
+        next_index += static_cast<uint32_t>(lod_indices.size());
+    }
+    assert(next_index == first_index + calc_num_arena_indices());
+
+    m_geometry_arena = &arena;
+}
+
+void BT::Model::generate_lod_levels(string const& fname)
+{
+    vec3 extents;
+    glm_vec3_sub(m_model_aabb.max, m_model_aabb.min, extents);
+    float_t max_error{ glm_vec3_norm(extents) * k_lod_max_relative_error };
+
+    vector<vector<uint32_t>> mesh_indices;
+    mesh_indices.reserve(m_meshes.size());
+    for (auto& mesh : m_meshes)
+        mesh_indices.emplace_back(mesh.get_indices());
+
+    auto lod_levels{ mesh_simplifier::generate_lod_levels(
+        m_vertices, mesh_indices, Mesh::k_max_lod_levels, max_error, k_lod_min_reduction) };
+
+    size_t coarsest_num_indices{ 0 };
+    for (size_t i = 0; i < m_meshes.size(); i++)
+    {
+        auto& level_indices{ lod_levels.mesh_level_indices[i] };
+        for (auto& indices : level_indices)
+            vertex_cache_optimizer::optimize_triangle_order(indices, m_vertices.size());
+
+        coarsest_num_indices +=
+            (level_indices.empty() ? mesh_indices[i].size() : level_indices.back().size());
+        m_meshes[i].set_lod_levels(level_indices);
+    }
+    m_lod_errors = std::move(lod_levels.errors);
+
+    BT_TRACEF("Generated %zu LOD levels for \"%s\" (%zu indices in coarsest, error %.4f).",
+              m_lod_errors.size() - 1,
+              fname.c_str(),
+              coarsest_num_indices,
+              m_lod_errors.back());
+}
+
+void BT::Model::optimize_vertex_cache_and_fetch(string const& fname)
+{
+    // Reorder triangles for the post-transform cache.
+    vector<vector<uint32_t>> mesh_indices;
+    mesh_indices.reserve(m_meshes.size());
+    float_t num_misses_before{ 0.0f };
+    float_t num_misses_after{ 0.0f };
+    size_t num_tris{ 0 };
+    for (auto& mesh : m_meshes)
+    {
+        vector<uint32_t> indices{ mesh.get_indices() };
+        float_t mesh_num_tris{ static_cast<float_t>(indices.size() / 3) };
+        num_misses_before += vertex_cache_optimizer::calc_acmr(indices) * mesh_num_tris;
+
+        vertex_cache_optimizer::optimize_triangle_order(indices, m_vertices.size());
+        num_misses_after += vertex_cache_optimizer::calc_acmr(indices) * mesh_num_tris;
+
+        num_tris += indices.size() / 3;
+        mesh_indices.emplace_back(std::move(indices));
+    }
+
+    // Reorder vertices into the order they get fetched in.
+    vector<vector<uint32_t> const*> index_lists;
+    for (auto const& indices : mesh_indices)
+        index_lists.emplace_back(&indices);
+
+    auto remap{ vertex_cache_optimizer::calc_vertex_fetch_remap(index_lists, m_vertices.size()) };
+
+    vector<Vertex> remapped_vertices(m_vertices.size());
+    for (size_t i = 0; i < m_vertices.size(); i++)
+        remapped_vertices[remap[i]] = m_vertices[i];
+    m_vertices = std::move(remapped_vertices);
+
+    if (!m_vert_skin_datas.empty())
+    {
+        vector<Vertex_skin_data> remapped_skin_datas(m_vert_skin_datas.size());
+        for (size_t i = 0; i < m_vert_skin_datas.size(); i++)
+            remapped_skin_datas[remap[i]] = m_vert_skin_datas[i];
+        m_vert_skin_datas = std::move(remapped_skin_datas);
+    }
+
+    for (size_t i = 0; i < m_meshes.size(); i++)
+    {
+        for (auto& index : mesh_indices[i])
+            index = remap[index];
+        m_meshes[i].set_indices(std::move(mesh_indices[i]));
+    }
+
+    if (num_tris > 0)
+        BT_TRACEF("Optimized vertex cache of \"%s\" (ACMR %.3f -> %.3f, %zu triangles).",
+                  fname.c_str(),
+                  num_misses_before / num_tris,
+                  num_misses_after / num_tris,
+                  num_tris);
+}
+
+void BT::Model::upload_vertex_buffers()
+{
+    auto compact_vertices{ vertex_formats::make_compact_vertices(m_vertices.data(),
+                                                                 m_vertices.size()) };
+
+    glGenVertexArrays(1, &m_model_vertex_vao);
+    glGenBuffers(1, &m_model_vertex_vbo);
+
+    get_main_gl_state_cache().bind_vertex_array(m_model_vertex_vao);
+    glBindBuffer(GL_ARRAY_BUFFER, m_model_vertex_vbo);
+    glBufferData(GL_ARRAY_BUFFER,
+                 compact_vertices.size() * sizeof(Compact_vertex),
+                 compact_vertices.data(),
+                 GL_STATIC_DRAW);
+
+    // Register vertex attributes.
+    vertex_formats::setup_compact_vertex_attribs();
+
+    // Unbind.
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+    get_main_gl_state_cache().bind_vertex_array(0);
+
+    if (!m_vert_skin_datas.empty())
+    {   // Upload vertex skin datas to GPU as well.
+        glGenBuffers(1, &m_model_vertex_skin_datas_buffer);
+        glBindBuffer(GL_SHADER_STORAGE_BUFFER, m_model_vertex_skin_datas_buffer);
+        glBufferData(GL_SHADER_STORAGE_BUFFER,
+                     m_vert_skin_datas.size() * sizeof(Vertex_skin_data),
+                     m_vert_skin_datas.data(),
+                     GL_STATIC_READ);
+        glBindBuffer(GL_SHADER_STORAGE_BUFFER, 0);
+    }
 }
 
 vector<BT::Model_joint_animation> const& BT::Model::get_joint_animations() const
@@ -270,29 +577,6 @@ void BT::Model::load_obj_as_meshes(string const& fname, string const& material_n
         m_model_aabb.feed_position(vertex.position);
     }
 
-    // Upload vertices to GPU.
-    glGenVertexArrays(1, &m_model_vertex_vao);
-    glGenBuffers(1, &m_model_vertex_vbo);
-
-    glBindVertexArray(m_model_vertex_vao);
-    glBindBuffer(GL_ARRAY_BUFFER, m_model_vertex_vbo);
-    glBufferData(GL_ARRAY_BUFFER, m_vertices.size() * sizeof(Vertex), m_vertices.data(), GL_STATIC_DRAW);
-
-    // Register vertex attributes.
-    glEnableVertexAttribArray(0);
-    glEnableVertexAttribArray(1);
-    glEnableVertexAttribArray(2);
-    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE,
-                          sizeof(Vertex), reinterpret_cast<void*>(offsetof(Vertex, position)));
-    glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE,
-                          sizeof(Vertex), reinterpret_cast<void*>(offsetof(Vertex, normal)));
-    glVertexAttribPointer(2, 2, GL_FLOAT, GL_FALSE,
-                          sizeof(Vertex), reinterpret_cast<void*>(offsetof(Vertex, tex_coord)));
-
-    // Unbind.
-    glBindBuffer(GL_ARRAY_BUFFER, 0);
-    glBindVertexArray(0);
-
     // Transform indices into mesh structures.
     m_meshes.clear();
     m_meshes.reserve(shapes.size());
@@ -776,41 +1060,6 @@ void BT::Model::load_gltf2_as_meshes(string const& fname, string const& material
             m_meshes.emplace_back(std::move(indices), material_name);
         }
 
-    {   // Upload vertices to GPU.
-        glGenVertexArrays(1, &m_model_vertex_vao);
-        glGenBuffers(1, &m_model_vertex_vbo);
-
-        glBindVertexArray(m_model_vertex_vao);
-        glBindBuffer(GL_ARRAY_BUFFER, m_model_vertex_vbo);
-        glBufferData(GL_ARRAY_BUFFER, m_vertices.size() * sizeof(Vertex), m_vertices.data(), GL_STATIC_DRAW);
-
-        // Register vertex attributes.
-        glEnableVertexAttribArray(0);
-        glEnableVertexAttribArray(1);
-        glEnableVertexAttribArray(2);
-        glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE,
-                              sizeof(Vertex), reinterpret_cast<void*>(offsetof(Vertex, position)));
-        glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE,
-                              sizeof(Vertex), reinterpret_cast<void*>(offsetof(Vertex, normal)));
-        glVertexAttribPointer(2, 2, GL_FLOAT, GL_FALSE,
-                              sizeof(Vertex), reinterpret_cast<void*>(offsetof(Vertex, tex_coord)));
-
-        // Unbind.
-        glBindBuffer(GL_ARRAY_BUFFER, 0);
-        glBindVertexArray(0);
-
-        if (overall_has_skin)
-        {   // Upload vertex skin datas to GPU as well.
-            glGenBuffers(1, &m_model_vertex_skin_datas_buffer);
-            glBindBuffer(GL_SHADER_STORAGE_BUFFER, m_model_vertex_skin_datas_buffer);
-            glBufferData(GL_SHADER_STORAGE_BUFFER,
-                         m_vert_skin_datas.size() * sizeof(Vertex_skin_data),
-                         m_vert_skin_datas.data(),
-                         GL_STATIC_READ);
-            glBindBuffer(GL_SHADER_STORAGE_BUFFER, 0);
-        }
-    }
-
     // Load animations.
     m_animations.clear();
     m_animations.reserve(asset.animations.size());
@@ -1143,82 +1392,103 @@ void BT::Model::load_gltf2_as_meshes(string const& fname, string const& material
 
 
 // @NOTE: vvv `Deformed_model` vvv
-// Takes `Model` const ref and uses its vertex buffer and skin datas buffer as input for deforming compute shader.
-// Then outputs result into the `m_deform_vertex_vbo`.
+// Takes `Model` const ref and uses its range in the skinning batch input arena as input for the deforming compute shader.
+// Then outputs result into its range in the skinning batch output arena (all deformed models skin in one dispatch).
 // A memory barrier waits for all of these vbo's to be written.
 // When connected to a render object, the render object will take a `unique_ptr` of the deformed model, and if it exists,
 // it will get the `m_deform_vertex_vao` and call `render_model()` with the `override_vao` param set.
 BT::Deformed_model::Deformed_model(Model const& model)
     : m_model{ model }
-{   // Create empty buffer for resulting deformed vertices.
+{   // Reserve ranges in skinning batch for source and resulting deformed vertices.
+    m_input_range = Mesh_skinning_batch::acquire_input_range(m_model);
+    m_output_range = Mesh_skinning_batch::allocate_output_range(
+        static_cast<uint32_t>(m_model.m_vertices.size()));
+
     glGenVertexArrays(1, &m_deform_vertex_vao);
-    glGenBuffers(1, &m_deform_vertex_vbo);
+    setup_deform_vertex_vao();
 
-    glBindVertexArray(m_deform_vertex_vao);
-    glBindBuffer(GL_ARRAY_BUFFER, m_deform_vertex_vbo);
-    glBufferData(GL_ARRAY_BUFFER, m_model.m_vertices.size() * sizeof(Vertex), nullptr, GL_STATIC_DRAW);
+    // Keep vertex array pointed at the output arena when the arena gets reallocated.
+    Mesh_skinning_batch::register_output_user(*this);
+}
 
-    // Register vertex attributes.
-    // @COPYPASTA.
-    glEnableVertexAttribArray(0);
-    glEnableVertexAttribArray(1);
-    glEnableVertexAttribArray(2);
-    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE,
-                          sizeof(Vertex), reinterpret_cast<void*>(offsetof(Vertex, position)));
-    glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE,
-                          sizeof(Vertex), reinterpret_cast<void*>(offsetof(Vertex, normal)));
-    glVertexAttribPointer(2, 2, GL_FLOAT, GL_FALSE,
-                          sizeof(Vertex), reinterpret_cast<void*>(offsetof(Vertex, tex_coord)));
+BT::Deformed_model::~Deformed_model()
+{
+    // @NOTE: The skinning batch keeps a raw pointer to this, so unregister before anything else.
+    Mesh_skinning_batch::unregister_output_user(*this);
+    Mesh_skinning_batch::free_output_range(m_output_range);
+    get_main_gl_state_cache().delete_vertex_array(m_deform_vertex_vao);
+}
 
-    // Unbind.
-    glBindBuffer(GL_ARRAY_BUFFER, 0);
-    glBindVertexArray(0);
+void BT::Deformed_model::set_skinning_mode(Skinning_mode mode, cpu_skinning::Kernel cpu_kernel)
+{
+    if (cpu_kernel == cpu_skinning::KERNEL_AVX2 && !cpu_skinning::is_avx2_supported())
+    {
+        BT_WARN("AVX2 CPU skinning not supported. Falling back to scalar.");
+        cpu_kernel = cpu_skinning::KERNEL_SCALAR;
+    }
 
-    // Create ssbo for storing joint matrices.
-    glGenBuffers(1, &m_mesh_joint_deform_data_ssbo);
-    glBindBuffer(GL_SHADER_STORAGE_BUFFER, m_mesh_joint_deform_data_ssbo);
-    glBufferData(GL_SHADER_STORAGE_BUFFER, k_max_num_joints * sizeof(mat4), nullptr, GL_DYNAMIC_COPY);
-    glBindBuffer(GL_SHADER_STORAGE_BUFFER, 0);
+    m_skinning_mode = mode;
+    m_cpu_kernel = cpu_kernel;
+
+    if (m_skinning_mode == SKINNING_MODE_GPU)
+    {   // Release CPU-side buffers.
+        m_cpu_palette = {};
+        m_cpu_deformed_vertices = {};
+    }
 }
 
-BT::Deformed_model::~Deformed_model()
+void BT::Deformed_model::submit_compute_deform(vector<mat4s>&& joint_matrices)
 {
-    glDeleteBuffers(1, &m_deform_vertex_vbo);
-    glDeleteVertexArrays(1, &m_deform_vertex_vao);
+    if (m_skinning_mode == SKINNING_MODE_GPU)
+    {
+        Mesh_skinning_batch::submit(*this, std::move(joint_matrices));
+        return;
+    }
+
+    // CPU skinning.
+    m_cpu_palette.resize(joint_matrices.size());
+    for (size_t i = 0; i < joint_matrices.size(); i++)
+        cpu_skinning::calc_palette_entry(joint_matrices[i].raw, m_cpu_palette[i]);
+
+    m_cpu_deformed_vertices.resize(m_model.m_vertices.size());
+    cpu_skinning::skin_vertices_parallel(m_cpu_kernel,
+                                         m_model.m_vertices.data(),
+                                         m_model.m_vert_skin_datas.data(),
+                                         m_cpu_palette.data(),
+                                         m_cpu_deformed_vertices.size(),
+                                         m_cpu_deformed_vertices.data());
+
+    // Upload into this model's range in the output arena.
+    glBindBuffer(GL_ARRAY_BUFFER, Mesh_skinning_batch::get_output_vertex_buffer());
+    glBufferSubData(GL_ARRAY_BUFFER,
+                    m_output_range.base * sizeof(Vertex),
+                    m_cpu_deformed_vertices.size() * sizeof(Vertex),
+                    m_cpu_deformed_vertices.data());
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
 }
 
-void BT::Deformed_model::dispatch_compute_deform(vector<mat4s>&& joint_matrices)
+void BT::Deformed_model::setup_deform_vertex_vao()
 {
-    // Upload joint matrices to GPU.
-    glBindBuffer(GL_SHADER_STORAGE_BUFFER, m_mesh_joint_deform_data_ssbo);
-    glBufferSubData(GL_SHADER_STORAGE_BUFFER, 0, joint_matrices.size() * sizeof(mat4), joint_matrices.data());
-    glBindBuffer(GL_SHADER_STORAGE_BUFFER, 0);
-
-    // Dispatch compute.
-    glBindBuffer(GL_SHADER_STORAGE_BUFFER, m_model.m_model_vertex_vbo);
-    glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 0, m_model.m_model_vertex_vbo);
-    glBindBuffer(GL_SHADER_STORAGE_BUFFER, m_model.m_model_vertex_skin_datas_buffer);
-    glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 1, m_model.m_model_vertex_skin_datas_buffer);
-    glBindBuffer(GL_SHADER_STORAGE_BUFFER, m_mesh_joint_deform_data_ssbo);
-    glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 2, m_mesh_joint_deform_data_ssbo);
-    glBindBuffer(GL_SHADER_STORAGE_BUFFER, m_deform_vertex_vbo);
-    glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 3, m_deform_vertex_vbo);
-    glBindBuffer(GL_SHADER_STORAGE_BUFFER, 0);
-
-    static auto& s_shader{ *Shader_bank::get_shader("skinned_mesh_compute") };
-    s_shader.bind();
-    size_t num_vertices{ m_model.m_vertices.size() };
-    s_shader.set_uint("num_vertices", num_vertices);
-    glDispatchCompute(std::ceilf(static_cast<float_t>(num_vertices)
-                                 / 256.0f),  // @NOTE: Must match compute shader `local_size_x`.
-                      1,
-                      1);
-    s_shader.unbind();
-
-    glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 0, 0);
-    glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 1, 0);
-    glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 2, 0);
-    glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 3, 0);
+    size_t base_offset{ m_output_range.base * sizeof(Vertex) };
+
+    get_main_gl_state_cache().bind_vertex_array(m_deform_vertex_vao);
+    glBindBuffer(GL_ARRAY_BUFFER, Mesh_skinning_batch::get_output_vertex_buffer());
+
+    // Register vertex attributes.
+    // @COPYPASTA.
+    glEnableVertexAttribArray(0);
+    glEnableVertexAttribArray(1);
+    glEnableVertexAttribArray(2);
+    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, sizeof(Vertex),
+                          reinterpret_cast<void*>(base_offset + offsetof(Vertex, position)));
+    glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, sizeof(Vertex),
+                          reinterpret_cast<void*>(base_offset + offsetof(Vertex, normal)));
+    glVertexAttribPointer(2, 2, GL_FLOAT, GL_FALSE, sizeof(Vertex),
+                          reinterpret_cast<void*>(base_offset + offsetof(Vertex, tex_coord)));
+
+    // Unbind.
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+    get_main_gl_state_cache().bind_vertex_array(0);
 }
 
 std::string BT::Deformed_model::get_model_name() const
@@ -1229,14 +1499,27 @@ std::string BT::Deformed_model::get_model_name() const
 void BT::Deformed_model::render(mat4 transform, Material_ifc* override_material /*= nullptr*/) const
 {
     // @NOTE: All meshes share the same vertices, just use different indices.
-    glBindVertexArray(m_deform_vertex_vao);
+    get_main_gl_state_cache().bind_vertex_array(m_deform_vertex_vao);
 
     for (auto& mesh : m_model.m_meshes)  // Use the regular model index buffers.
     {
         mesh.render_mesh(transform, override_material);
     }
 
-    glBindVertexArray(0);
+    get_main_gl_state_cache().bind_vertex_array(0);
+}
+
+void BT::Deformed_model::emplace_draws(Render_layer layer,
+                                       mat4 transform,
+                                       uint32_t lod_level,
+                                       Render_queue& render_queue) const
+{
+    (void)lod_level;  // Simplified levels don't get skinned, so always full detail.
+
+    for (auto& mesh : m_model.m_meshes)  // Use the regular model index buffers.
+    {
+        mesh.emplace_draw(layer, m_deform_vertex_vao, transform, 0, render_queue);
+    }
 }
 
 
@@ -1281,6 +1564,34 @@ string BT::Model_bank::get_model_name(Model const* model_ptr)
     return model_name;
 }
 
+void BT::Model_bank::pack_models_into_geometry_arenas()
+{
+    for (auto& [name, model] : s_models)
+    {
+        if (model->is_in_geometry_arena())
+            continue;
+
+        auto placement{ s_geometry_arena_packer.place(
+            static_cast<uint32_t>(model->get_vertices().size()),
+            model->calc_num_arena_indices()) };
+        if (placement.arena_idx == s_geometry_arenas.size())
+        {   // Packer started a new arena.
+            auto const& arena_ranges{ s_geometry_arena_packer.get_arenas().back() };
+            s_geometry_arenas.emplace_back(std::make_unique<Geometry_arena>(
+                arena_ranges.vertex_allocator.get_capacity(),
+                arena_ranges.index_allocator.get_capacity()));
+        }
+
+        model->pack_into_geometry_arena(*s_geometry_arenas[placement.arena_idx],
+                                        placement.base_vertex,
+                                        placement.first_index);
+    }
+
+    BT_TRACEF("Packed %zu models into %zu geometry arenas.",
+              s_models.size(),
+              s_geometry_arenas.size());
+}
+
 vector<string> BT::Model_bank::get_all_model_names()
 {
     vector<string> model_names;
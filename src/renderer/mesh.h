@@ -1,7 +1,12 @@
 #pragma once
 
 #include "btglm.h"
+#include "cpu_skinning.h"
+#include "geometry_arena.h"
 #include "material.h"
+#include "mesh_skinning_batch.h"
+#include "render_layer.h"
+#include "render_queue.h"
 #include <string>
 #include "model_animator.h"
 #include <unordered_map>
@@ -24,6 +29,9 @@ struct AA_bounding_box
 
     void reset();
     void feed_position(vec3 position);
+
+    /// Calculates the AABB enclosing this AABB's 8 corners after transforming by `transform`.
+    void calc_transformed(mat4 transform, AA_bounding_box& out_aabb) const;
 };
 
 class Mesh
@@ -32,17 +40,72 @@ public:
     Mesh(vector<uint32_t>&& indices, string const& material_name);
     ~Mesh();
 
+    /// Max LOD levels including full detail level 0. LOD level goes in the low bits of the sort id
+    /// of draws, so that draws of the same level stay next to each other for instancing.
+    static constexpr uint32_t k_max_lod_levels{ 4 };
+
     void render_mesh(mat4 transform, Material_ifc* override_material = nullptr) const;
+    void emplace_draw(Render_layer layer,
+                      uint32_t vertex_vao,
+                      mat4 transform,
+                      uint32_t lod_level,
+                      Render_queue& render_queue) const;
 
+    /// Same as `emplace_draw()`, but draws from the copy of this mesh in a geometry arena.
+    void emplace_arena_draw(Render_layer layer,
+                            Geometry_arena const& arena,
+                            uint32_t base_vertex,
+                            mat4 transform,
+                            uint32_t lod_level,
+                            Render_queue& render_queue) const;
+
+    /// Full detail indices.
     vector<uint32_t> const& get_indices() const;
 
+    /// Replaces full detail indices (e.g. after reordering them). Only before LOD levels are set.
+    void set_indices(vector<uint32_t>&& indices);
+
+    /// Sets simplified indices of LOD levels 1 and up, and reuploads the index buffer with all
+    /// levels back to back (full detail first).
+    void set_lod_levels(vector<vector<uint32_t>> const& lod_level_indices);
+    uint32_t get_num_lod_levels() const { return static_cast<uint32_t>(m_lod_ranges.size()); }
+    vector<uint32_t> const& get_lod_indices() const { return m_lod_indices; }
+    uint32_t get_num_lod_indices(uint32_t lod_level) const
+    {
+        return m_lod_ranges[lod_level].num_indices;
+    }
+
+    void set_arena_first_index(uint32_t first_index) { m_arena_first_index = first_index; }
+
+    Material_ifc* get_material() const { return m_material; }
+
+    /// Reserves a mesh sort id for geometry that isn't a `Mesh` (e.g. static batches). Released
+    /// ids get reused first, so that rebuilding geometry doesn't keep growing the ids.
+    static uint32_t acquire_sort_id();
+    static void release_sort_id(uint32_t sort_id);
+
 private:
     // Mesh data.
     vector<uint32_t> m_indices;
     Material_ifc*    m_material;
     AA_bounding_box  m_mesh_aabb;  // @UNUSED: Unknown whether to get this used or not.
 
+    // LOD levels (level 0 is `m_indices`). Ranges are in the index buffer layout.
+    struct Lod_range
+    {
+        uint32_t first_index;
+        uint32_t num_indices;
+    };
+    vector<uint32_t>  m_lod_indices;  // Levels 1 and up, back to back.
+    vector<Lod_range> m_lod_ranges;
+
     uint32_t m_mesh_index_ebo;
+    uint32_t m_mesh_sort_id;
+    uint32_t m_arena_first_index{ 0 };  // Only valid if owning model is in a geometry arena.
+                                        // Points to the start of all LOD levels.
+
+    inline static uint32_t s_next_mesh_sort_id{ 0 };
+    inline static vector<uint32_t> s_free_mesh_sort_ids;
 };
 
 struct Vertex
@@ -65,6 +128,11 @@ public:
     virtual std::string get_type_str() const = 0;
     virtual std::string get_model_name() const = 0;
     virtual void render(mat4 transform, Material_ifc* override_material = nullptr) const = 0;
+    virtual void emplace_draws(Render_layer layer,
+                               mat4 transform,
+                               uint32_t lod_level,
+                               Render_queue& render_queue) const = 0;
+    virtual AA_bounding_box const& get_aabb() const = 0;
 };
 
 class Model : public Renderable_ifc
@@ -80,9 +148,31 @@ public:
     std::string get_type_str() const override { return "Model"; }
     std::string get_model_name() const override;
     void render(mat4 transform, Material_ifc* override_material = nullptr) const override;
+    void emplace_draws(Render_layer layer,
+                       mat4 transform,
+                       uint32_t lod_level,
+                       Render_queue& render_queue) const override;
+    AA_bounding_box const& get_aabb() const override { return m_model_aabb; }
+
+    uint32_t get_num_lod_levels() const { return static_cast<uint32_t>(m_lod_errors.size()); }
+
+    /// Estimated max distance of LOD level's surface from the full detail surface (model space).
+    float_t get_lod_error(uint32_t lod_level) const { return m_lod_errors[lod_level]; }
 
     vector<Model_joint_animation> const& get_joint_animations() const;
     pair<vector<Vertex> const&, vector<uint32_t>> get_all_vertices_and_indices() const;
+    vector<Vertex> const& get_vertices() const { return m_vertices; }
+    vector<Mesh> const& get_meshes() const { return m_meshes; }
+
+    /// Number of indices this model takes up in a geometry arena (all meshes w/ LOD levels).
+    uint32_t calc_num_arena_indices() const;
+
+    /// Copies vertices and indices into `arena` at the ranges starting at `base_vertex` and
+    /// `first_index`, so that static draws of this model come from it.
+    void pack_into_geometry_arena(Geometry_arena& arena,
+                                  uint32_t base_vertex,
+                                  uint32_t first_index);
+    bool is_in_geometry_arena() const { return (m_geometry_arena != nullptr); }
 
 private:
     // @NOTE: These meshes should have some kind of offset inside them, but just
@@ -101,10 +191,30 @@ private:
     
     uint32_t m_model_vertex_skin_datas_buffer{ 0 };  // 0 if no vertex skin data.
 
+    Geometry_arena const* m_geometry_arena{ nullptr };
+    uint32_t m_arena_base_vertex{ 0 };
+
+    // LOD levels.
+    static constexpr float_t k_lod_max_relative_error{ 0.02f };  // Of model AABB diagonal.
+    static constexpr float_t k_lod_min_reduction{ 0.8f };  // Max index ratio to previous level.
+    vector<float_t> m_lod_errors{ 0.0f };
+
+    /// Simplifies each level from the previous level down to half the indices, until the error
+    /// bound is hit or it stops reducing enough to be worth a level.
+    void generate_lod_levels(string const& fname);
+
+    /// Import stage: reorders each mesh's triangles for the post-transform vertex cache, then
+    /// reorders vertices (and skin datas) into first-use order for vertex fetch locality.
+    void optimize_vertex_cache_and_fetch(string const& fname);
+
+    /// Uploads vertices as `Compact_vertex` into the model's vertex buffer.
+    void upload_vertex_buffers();
+
     void load_obj_as_meshes(string const& fname, string const& material_name);
     void load_gltf2_as_meshes(string const& fname, string const& material_name);
 
     friend class Deformed_model;
+    friend class Mesh_skinning_batch;
     friend class Model_animator;
 };
 
@@ -114,20 +224,62 @@ public:
     Deformed_model(Model const& model);
     ~Deformed_model();
 
-    void dispatch_compute_deform(vector<mat4s>&& joint_matrices);
+    // @NOTE: Registered by address w/ the skinning batch, so no copying or moving.
+    Deformed_model(const Deformed_model&)            = delete;
+    Deformed_model(Deformed_model&&)                 = delete;
+    Deformed_model& operator=(const Deformed_model&) = delete;
+    Deformed_model& operator=(Deformed_model&&)      = delete;
+
+    enum Skinning_mode
+    {
+        SKINNING_MODE_GPU,  // Skinned in the batched compute dispatch.
+        SKINNING_MODE_CPU,  // Skinned on the CPU, then uploaded into the output arena range.
+    };
+
+    void set_skinning_mode(Skinning_mode mode, cpu_skinning::Kernel cpu_kernel);
+    Skinning_mode get_skinning_mode() const { return m_skinning_mode; }
+
+    Model const& get_source_model() const { return m_model; }
+
+    /// Submits joint matrices to get skinned in the next `Mesh_skinning_batch::dispatch()`.
+    /// In CPU skinning mode, skins and uploads right away instead.
+    void submit_compute_deform(vector<mat4s>&& joint_matrices);
+
+    /// Latest CPU skinned vertices. Empty unless in CPU skinning mode.
+    vector<Vertex> const& get_cpu_deformed_vertices() const { return m_cpu_deformed_vertices; }
 
     std::string get_type_str() const override { return "Deformed_model"; }
     std::string get_model_name() const override;
     void render(mat4 transform, Material_ifc* override_material = nullptr) const override;
+    void emplace_draws(Render_layer layer,
+                       mat4 transform,
+                       uint32_t lod_level,
+                       Render_queue& render_queue) const override;
+
+    // @NOTE: Uses the bind pose bounds of the source model. Deformed vertices may go outside of
+    //        these bounds, so pad the result if it's used for anything visibility related.
+    AA_bounding_box const& get_aabb() const override { return m_model.m_model_aabb; }
 
 private:
     Model const& m_model;
 
     uint32_t m_deform_vertex_vao;
-    uint32_t m_deform_vertex_vbo;
 
-    static constexpr size_t k_max_num_joints{ 128 };  // @NOTE: Must match `skinned_mesh.comp`.
-    uint32_t m_mesh_joint_deform_data_ssbo;
+    Skinning_mode m_skinning_mode{ SKINNING_MODE_GPU };
+    cpu_skinning::Kernel m_cpu_kernel{ cpu_skinning::KERNEL_SCALAR };
+    vector<cpu_skinning::Palette_entry> m_cpu_palette;
+    vector<Vertex> m_cpu_deformed_vertices;
+
+    // Ranges in the skinning batch's input/output arenas.
+    Mesh_skinning_batch::Vertex_range m_input_range;
+    Mesh_skinning_batch::Vertex_range m_output_range;
+
+    /// Points vertex attributes to this model's range in the output arena.
+    void setup_deform_vertex_vao();
+
+    static constexpr size_t k_max_num_joints{ 128 };  // Sanity limit of joints per instance.
+
+    friend class Mesh_skinning_batch;
 };
 
 // @COPYPASTA: See "material.h"
@@ -139,8 +291,18 @@ public:
     static string get_model_name(Model const* model_ptr);
     static vector<string> get_all_model_names();
 
+    /// Packs all models into a few large geometry arenas, so that static draws can be merged into
+    /// multi-draw indirect calls. Call once all models are emplaced.
+    static void pack_models_into_geometry_arenas();
+
 private:
     inline static vector<pair<string, unique_ptr<Model>>> s_models;
+
+    static constexpr uint32_t k_arena_vertex_capacity{ 1 << 20 };
+    static constexpr uint32_t k_arena_index_capacity{ 1 << 22 };
+    inline static Geometry_arena_packer s_geometry_arena_packer{ k_arena_vertex_capacity,
+                                                                 k_arena_index_capacity };
+    inline static vector<unique_ptr<Geometry_arena>> s_geometry_arenas;
 };
 
 }  // namespace BT
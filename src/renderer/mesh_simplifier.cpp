@@ -0,0 +1,371 @@
+#include "mesh_simplifier.h"
+
+#include "btglm.h"
+#include "mesh.h"
+#include <algorithm>
+#include <cmath>
+#include <numeric>
+#include <unordered_map>
+
+
+namespace
+{
+
+using namespace BT;
+
+/// Sum of squared distances to planes (`ax + by + cz + d = 0`), weighted by triangle area.
+struct Quadric
+{
+    double a2{ 0.0 }, ab{ 0.0 }, ac{ 0.0 }, ad{ 0.0 };
+    double b2{ 0.0 }, bc{ 0.0 }, bd{ 0.0 };
+    double c2{ 0.0 }, cd{ 0.0 };
+    double d2{ 0.0 };
+    double weight{ 0.0 };
+
+    void add_plane(vec3 normal, float_t d, double plane_weight)
+    {
+        double a{ normal[0] };
+        double b{ normal[1] };
+        double c{ normal[2] };
+        a2 += a * a * plane_weight;
+        ab += a * b * plane_weight;
+        ac += a * c * plane_weight;
+        ad += a * d * plane_weight;
+        b2 += b * b * plane_weight;
+        bc += b * c * plane_weight;
+        bd += b * d * plane_weight;
+        c2 += c * c * plane_weight;
+        cd += c * d * plane_weight;
+        d2 += d * d * plane_weight;
+        weight += plane_weight;
+    }
+
+    void add(Quadric const& other)
+    {
+        a2 += other.a2; ab += other.ab; ac += other.ac; ad += other.ad;
+        b2 += other.b2; bc += other.bc; bd += other.bd;
+        c2 += other.c2; cd += other.cd;
+        d2 += other.d2;
+        weight += other.weight;
+    }
+
+    double eval(vec3 const position) const
+    {
+        double x{ position[0] };
+        double y{ position[1] };
+        double z{ position[2] };
+        return (a2 * x * x + 2.0 * ab * x * y + 2.0 * ac * x * z + 2.0 * ad * x +
+                b2 * y * y + 2.0 * bc * y * z + 2.0 * bd * y +
+                c2 * z * z + 2.0 * cd * z +
+                d2);
+    }
+};
+
+/// Collapse of `from` vertex onto `to` vertex.
+struct Collapse
+{
+    double cost;  // Squared distance.
+    uint32_t from;
+    uint32_t to;
+
+    bool operator<(Collapse const& other) const
+    {   // @NOTE: Ties broken by vertex idx so that results are deterministic.
+        if (cost != other.cost)
+            return cost < other.cost;
+        if (from != other.from)
+            return from < other.from;
+        return to < other.to;
+    }
+};
+
+void calc_triangle_normal(vec3 const p0, vec3 const p1, vec3 const p2, vec3 out_normal)
+{
+    vec3 edge1;
+    vec3 edge2;
+    glm_vec3_sub(const_cast<float_t*>(p1), const_cast<float_t*>(p0), edge1);
+    glm_vec3_sub(const_cast<float_t*>(p2), const_cast<float_t*>(p0), edge2);
+    glm_vec3_cross(edge1, edge2, out_normal);
+}
+
+/// Locks vertices on mesh borders (edges used by only one triangle) and on attribute seams
+/// (vertices that share a position with another vertex).
+void find_locked_vertices(vector<Vertex> const& vertices,
+                          vector<uint32_t> const& indices,
+                          vector<uint8_t>& out_locked)
+{
+    out_locked.assign(vertices.size(), 0);
+
+    // Seams.
+    vector<uint32_t> sorted_vertex_idxs(vertices.size());
+    std::iota(sorted_vertex_idxs.begin(), sorted_vertex_idxs.end(), 0u);
+    auto position_less = [&](uint32_t a, uint32_t b) {
+        return std::lexicographical_compare(vertices[a].position, vertices[a].position + 3,
+                                            vertices[b].position, vertices[b].position + 3);
+    };
+    std::sort(sorted_vertex_idxs.begin(), sorted_vertex_idxs.end(), position_less);
+    for (size_t i = 1; i < sorted_vertex_idxs.size(); i++)
+    {
+        uint32_t prev_idx{ sorted_vertex_idxs[i - 1] };
+        uint32_t idx{ sorted_vertex_idxs[i] };
+        if (!position_less(prev_idx, idx))
+        {   // Same position.
+            out_locked[prev_idx] = 1;
+            out_locked[idx] = 1;
+        }
+    }
+
+    // Borders.
+    std::unordered_map<uint64_t, uint32_t> edge_counts;
+    edge_counts.reserve(indices.size());
+    for (size_t i = 0; i + 2 < indices.size(); i += 3)
+    for (size_t j = 0; j < 3; j++)
+    {
+        uint32_t a{ indices[i + j] };
+        uint32_t b{ indices[i + (j + 1) % 3] };
+        uint64_t key{ (static_cast<uint64_t>(std::min(a, b)) << 32) | std::max(a, b) };
+        edge_counts[key]++;
+    }
+
+    for (auto const& [key, count] : edge_counts)
+        if (count == 1)
+        {
+            out_locked[static_cast<uint32_t>(key >> 32)] = 1;
+            out_locked[static_cast<uint32_t>(key & 0xFFFFFFFF)] = 1;
+        }
+}
+
+/// Checks that moving `from` onto `to` doesn't flip any of the triangles around `from` that stay.
+bool is_collapse_flip_free(vector<Vertex> const& vertices,
+                           vector<uint32_t> const& tri_indices,
+                           uint32_t const* adj_tris,
+                           size_t num_adj_tris,
+                           uint32_t from,
+                           uint32_t to)
+{
+    for (size_t i = 0; i < num_adj_tris; i++)
+    {
+        uint32_t const* tri{ &tri_indices[adj_tris[i] * 3] };
+        if (tri[0] == to || tri[1] == to || tri[2] == to)
+            continue;  // Gets removed by the collapse.
+
+        float_t const* positions_before[3];
+        float_t const* positions_after[3];
+        for (size_t j = 0; j < 3; j++)
+        {
+            positions_before[j] = vertices[tri[j]].position;
+            positions_after[j] = vertices[tri[j] == from ? to : tri[j]].position;
+        }
+
+        vec3 normal_before;
+        vec3 normal_after;
+        calc_triangle_normal(positions_before[0],
+                             positions_before[1],
+                             positions_before[2],
+                             normal_before);
+        calc_triangle_normal(positions_after[0],
+                             positions_after[1],
+                             positions_after[2],
+                             normal_after);
+        if (glm_vec3_dot(normal_before, normal_after) <= 0.0f)
+            return false;
+    }
+
+    return true;
+}
+
+}  // namespace
+
+
+BT::mesh_simplifier::Result BT::mesh_simplifier::simplify(vector<Vertex> const& vertices,
+                                                          vector<uint32_t> const& indices,
+                                                          size_t target_num_indices,
+                                                          float_t max_error)
+{
+    Result result;
+    result.indices = indices;
+    if (indices.size() <= target_num_indices)
+        return result;
+
+    vector<uint8_t> locked;
+    find_locked_vertices(vertices, indices, locked);
+
+    // Vertex quadrics from adjacent triangle planes.
+    vector<Quadric> quadrics(vertices.size());
+    for (size_t i = 0; i + 2 < indices.size(); i += 3)
+    {
+        vec3 normal;
+        calc_triangle_normal(vertices[indices[i + 0]].position,
+                             vertices[indices[i + 1]].position,
+                             vertices[indices[i + 2]].position,
+                             normal);
+        float_t double_area{ glm_vec3_norm(normal) };
+        if (double_area <= 0.0f)
+            continue;
+
+        glm_vec3_scale(normal, 1.0f / double_area, normal);
+        float_t d{ -glm_vec3_dot(normal, const_cast<float_t*>(vertices[indices[i]].position)) };
+        for (size_t j = 0; j < 3; j++)
+            quadrics[indices[i + j]].add_plane(normal, d, double_area * 0.5);
+    }
+
+    double max_error_sq{ static_cast<double>(max_error) * max_error };
+    double result_error_sq{ 0.0 };
+
+    auto& tri_indices{ result.indices };
+    vector<uint32_t> adj_offsets;
+    vector<uint32_t> adj_tris;
+    vector<Collapse> collapses;
+    vector<uint8_t> touched;
+
+    // Collapse in passes. Each pass does the cheapest collapses that don't touch each other's
+    // neighborhoods, so that the adjacency only needs to be rebuilt between passes.
+    while (tri_indices.size() > target_num_indices)
+    {
+        size_t num_tris{ tri_indices.size() / 3 };
+
+        // Vertex to triangle adjacency.
+        adj_offsets.assign(vertices.size() + 1, 0);
+        for (uint32_t idx : tri_indices)
+            adj_offsets[idx + 1]++;
+        for (size_t i = 1; i < adj_offsets.size(); i++)
+            adj_offsets[i] += adj_offsets[i - 1];
+
+        adj_tris.resize(tri_indices.size());
+        {
+            vector<uint32_t> write_offsets(adj_offsets.begin(), adj_offsets.end() - 1);
+            for (size_t i = 0; i < tri_indices.size(); i++)
+                adj_tris[write_offsets[tri_indices[i]]++] = static_cast<uint32_t>(i / 3);
+        }
+
+        // Collapse candidates along triangle edges.
+        collapses.clear();
+        for (size_t i = 0; i < tri_indices.size(); i += 3)
+        for (size_t j = 0; j < 3; j++)
+        {
+            uint32_t a{ tri_indices[i + j] };
+            uint32_t b{ tri_indices[i + (j + 1) % 3] };
+            for (auto [from, to] : { std::pair{ a, b }, std::pair{ b, a } })
+            {
+                if (locked[from])
+                    continue;
+
+                Quadric quadric{ quadrics[from] };
+                quadric.add(quadrics[to]);
+                double cost{ std::max(0.0, quadric.eval(vertices[to].position)) /
+                             std::max(quadric.weight, 1e-12) };
+                if (cost <= max_error_sq)
+                    collapses.push_back({ cost, from, to });
+            }
+        }
+
+        std::sort(collapses.begin(), collapses.end());
+
+        // Do collapses.
+        touched.assign(vertices.size(), 0);
+        size_t num_tris_removed{ 0 };
+        size_t num_collapses_done{ 0 };
+        for (auto const& collapse : collapses)
+        {
+            if ((num_tris - num_tris_removed) * 3 <= target_num_indices)
+                break;
+            if (touched[collapse.from] || touched[collapse.to])
+                continue;
+
+            uint32_t const* from_adj_tris{ &adj_tris[adj_offsets[collapse.from]] };
+            size_t num_from_adj_tris{ adj_offsets[collapse.from + 1] -
+                                      adj_offsets[collapse.from] };
+            if (!is_collapse_flip_free(vertices,
+                                       tri_indices,
+                                       from_adj_tris,
+                                       num_from_adj_tris,
+                                       collapse.from,
+                                       collapse.to))
+                continue;
+
+            // Move `from` onto `to`, and lock the neighborhood until the next pass.
+            for (size_t i = 0; i < num_from_adj_tris; i++)
+            {
+                uint32_t* tri{ &tri_indices[from_adj_tris[i] * 3] };
+                bool removes_tri{ tri[0] == collapse.to ||
+                                  tri[1] == collapse.to ||
+                                  tri[2] == collapse.to };
+                num_tris_removed += (removes_tri ? 1 : 0);
+
+                for (size_t j = 0; j < 3; j++)
+                {
+                    touched[tri[j]] = 1;
+                    if (tri[j] == collapse.from)
+                        tri[j] = collapse.to;
+                }
+            }
+
+            quadrics[collapse.to].add(quadrics[collapse.from]);
+            result_error_sq = std::max(result_error_sq, collapse.cost);
+            num_collapses_done++;
+        }
+
+        if (num_collapses_done == 0)
+            break;  // Nothing left under the error bound.
+
+        // Remove collapsed triangles.
+        size_t write_idx{ 0 };
+        for (size_t i = 0; i < tri_indices.size(); i += 3)
+        {
+            uint32_t a{ tri_indices[i + 0] };
+            uint32_t b{ tri_indices[i + 1] };
+            uint32_t c{ tri_indices[i + 2] };
+            if (a == b || b == c || c == a)
+                continue;
+
+            tri_indices[write_idx++] = a;
+            tri_indices[write_idx++] = b;
+            tri_indices[write_idx++] = c;
+        }
+        tri_indices.resize(write_idx);
+    }
+
+    result.error = static_cast<float_t>(std::sqrt(result_error_sq));
+    return result;
+}
+
+BT::mesh_simplifier::Lod_levels BT::mesh_simplifier::generate_lod_levels(
+    vector<Vertex> const& vertices,
+    vector<vector<uint32_t>> const& mesh_indices,
+    uint32_t max_num_levels,
+    float_t max_error,
+    float_t min_reduction)
+{
+    Lod_levels lod_levels;
+    lod_levels.mesh_level_indices.resize(mesh_indices.size());
+
+    vector<vector<uint32_t>> prev_level_indices{ mesh_indices };
+    size_t prev_num_indices{ 0 };
+    for (auto const& indices : mesh_indices)
+        prev_num_indices += indices.size();
+
+    while (lod_levels.errors.size() < max_num_levels)
+    {
+        vector<vector<uint32_t>> level_indices;
+        size_t num_indices{ 0 };
+        float_t level_error{ 0.0f };
+        for (auto const& indices : prev_level_indices)
+        {
+            auto result{ simplify(vertices, indices, (indices.size() / 6) * 3, max_error) };
+            num_indices += result.indices.size();
+            level_error = std::max(level_error, result.error);
+            level_indices.emplace_back(std::move(result.indices));
+        }
+
+        if (num_indices > prev_num_indices * min_reduction)
+            break;  // Not worth a level.
+
+        lod_levels.errors.emplace_back(lod_levels.errors.back() + level_error);
+        for (size_t i = 0; i < mesh_indices.size(); i++)
+            lod_levels.mesh_level_indices[i].emplace_back(level_indices[i]);
+
+        prev_level_indices = std::move(level_indices);
+        prev_num_indices = num_indices;
+    }
+
+    return lod_levels;
+}
@@ -0,0 +1,56 @@
+#pragma once
+
+#include "btglm.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+using std::vector;
+
+
+namespace BT
+{
+
+struct Vertex;
+
+/// Error bounded edge collapse simplification for generating mesh LOD levels.
+namespace mesh_simplifier
+{
+
+struct Result
+{
+    vector<uint32_t> indices;
+    float_t error{ 0.0f };  // Estimated max distance from the input surface (model space units).
+};
+
+/// Simplifies triangle list `indices` with half edge collapses in order of quadric error, until
+/// there are `target_num_indices` or less indices, or the next collapse would go over `max_error`.
+/// Collapses only move a vertex onto one of its neighbors, so the result still indexes into
+/// `vertices` and can share the same vertex buffer.
+// @NOTE: Border vertices and vertices that share their position with other vertices (normal or
+//        tex coord seams) are locked so that no holes or cracks open up.
+Result simplify(vector<Vertex> const& vertices,
+                vector<uint32_t> const& indices,
+                size_t target_num_indices,
+                float_t max_error);
+
+struct Lod_levels
+{
+    vector<vector<vector<uint32_t>>> mesh_level_indices;  // Per mesh, LOD levels 1 and up.
+    vector<float_t> errors{ 0.0f };  // Per LOD level, including full detail level 0.
+};
+
+/// Generates up to `max_num_levels` LOD levels (including full detail level 0) for the meshes of a
+/// model, which all index into `vertices`. Each level simplifies the previous level to half the
+/// indices w/ `max_error`, and the last level is the first one that doesn't get to
+/// `min_reduction` times the indices of the previous level (summed over all meshes).
+// @NOTE: Levels get simplified from the previous level, so errors add up.
+Lod_levels generate_lod_levels(vector<Vertex> const& vertices,
+                               vector<vector<uint32_t>> const& mesh_indices,
+                               uint32_t max_num_levels,
+                               float_t max_error,
+                               float_t min_reduction);
+
+}  // namespace mesh_simplifier
+}  // namespace BT
@@ -0,0 +1,285 @@
+#include "mesh_skinning_batch.h"
+
+#include "btglm.h"
+#include "btlogger.h"
+#include "glad/glad.h"
+#include "mesh.h"
+#include "shader.h"
+#include "vertex_formats.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+
+
+BT::Mesh_skinning_batch::Vertex_range BT::Mesh_skinning_batch::acquire_input_range(
+    Model const& model)
+{
+    auto it{ s_input_ranges.find(&model) };
+    if (it != s_input_ranges.end())
+        return it->second;
+
+    // Upload model into input arena.
+    assert(model.m_vert_skin_datas.size() == model.m_vertices.size());
+    Vertex_range range{ s_input_count, static_cast<uint32_t>(model.m_vertices.size()) };
+
+    if (range.base + range.count > s_input_capacity)
+    {   // Grow arena.
+        uint32_t new_capacity{ std::max(range.base + range.count, s_input_capacity * 2) };
+        grow_buffer(s_input_vertex_buffer,
+                    GL_SHADER_STORAGE_BUFFER,
+                    s_input_count * sizeof(Compact_skinning_vertex),
+                    new_capacity * sizeof(Compact_skinning_vertex),
+                    GL_STATIC_DRAW);
+        grow_buffer(s_input_skin_data_buffer,
+                    GL_SHADER_STORAGE_BUFFER,
+                    s_input_count * sizeof(Compact_vertex_skin_data),
+                    new_capacity * sizeof(Compact_vertex_skin_data),
+                    GL_STATIC_DRAW);
+        s_input_capacity = new_capacity;
+    }
+
+    // @NOTE: Input is stored compact (see "vertex_formats.h") and gets unpacked in the compute
+    //        shader. Output stays as full `Vertex` since it's read by the regular vertex shaders.
+    auto compact_vertices{ vertex_formats::make_compact_skinning_vertices(
+        model.m_vertices.data(), model.m_vertices.size()) };
+    auto compact_skin_datas{ vertex_formats::make_compact_skin_datas(
+        model.m_vert_skin_datas.data(), model.m_vert_skin_datas.size()) };
+
+    glBindBuffer(GL_SHADER_STORAGE_BUFFER, s_input_vertex_buffer);
+    glBufferSubData(GL_SHADER_STORAGE_BUFFER,
+                    range.base * sizeof(Compact_skinning_vertex),
+                    range.count * sizeof(Compact_skinning_vertex),
+                    compact_vertices.data());
+    glBindBuffer(GL_SHADER_STORAGE_BUFFER, s_input_skin_data_buffer);
+    glBufferSubData(GL_SHADER_STORAGE_BUFFER,
+                    range.base * sizeof(Compact_vertex_skin_data),
+                    range.count * sizeof(Compact_vertex_skin_data),
+                    compact_skin_datas.data());
+    glBindBuffer(GL_SHADER_STORAGE_BUFFER, 0);
+
+    s_input_count += range.count;
+    s_input_ranges.emplace(&model, range);
+
+    return range;
+}
+
+BT::Mesh_skinning_batch::Vertex_range BT::Mesh_skinning_batch::allocate_output_range(
+    uint32_t num_vertices)
+{
+    // Look for first fitting free range.
+    for (size_t i = 0; i < s_output_free_ranges.size(); i++)
+    {
+        auto& free_range{ s_output_free_ranges[i] };
+        if (free_range.count >= num_vertices)
+        {
+            Vertex_range range{ free_range.base, num_vertices };
+            free_range.base += num_vertices;
+            free_range.count -= num_vertices;
+            if (free_range.count == 0)
+                s_output_free_ranges.erase(s_output_free_ranges.begin() + i);
+            return range;
+        }
+    }
+
+    // Append to end of arena.
+    Vertex_range range{ s_output_count, num_vertices };
+    if (range.base + range.count > s_output_capacity)
+    {   // Grow arena.
+        uint32_t new_capacity{ std::max(range.base + range.count, s_output_capacity * 2) };
+        grow_buffer(s_output_vertex_buffer,
+                    GL_ARRAY_BUFFER,
+                    s_output_count * sizeof(Vertex),
+                    new_capacity * sizeof(Vertex),
+                    GL_DYNAMIC_COPY);
+        s_output_capacity = new_capacity;
+
+        // Point all users' vertex arrays to the new buffer.
+        for (auto user : s_output_users)
+            user->setup_deform_vertex_vao();
+    }
+    s_output_count += range.count;
+
+    return range;
+}
+
+void BT::Mesh_skinning_batch::free_output_range(Vertex_range range)
+{
+    if (range.count == 0)
+        return;
+
+    // Insert free range and merge with neighbors.
+    s_output_free_ranges.emplace_back(range);
+    std::sort(s_output_free_ranges.begin(),
+              s_output_free_ranges.end(),
+              [](Vertex_range const& a, Vertex_range const& b) { return a.base < b.base; });
+
+    std::vector<Vertex_range> merged_ranges;
+    merged_ranges.reserve(s_output_free_ranges.size());
+    for (auto const& free_range : s_output_free_ranges)
+    {
+        if (!merged_ranges.empty() &&
+            merged_ranges.back().base + merged_ranges.back().count == free_range.base)
+            merged_ranges.back().count += free_range.count;
+        else
+            merged_ranges.emplace_back(free_range);
+    }
+
+    // Give back tail of arena.
+    if (!merged_ranges.empty() &&
+        merged_ranges.back().base + merged_ranges.back().count == s_output_count)
+    {
+        s_output_count = merged_ranges.back().base;
+        merged_ranges.pop_back();
+    }
+
+    s_output_free_ranges = std::move(merged_ranges);
+}
+
+void BT::Mesh_skinning_batch::register_output_user(Deformed_model& deformed_model)
+{
+    assert(std::find(s_output_users.begin(), s_output_users.end(), &deformed_model) ==
+           s_output_users.end());
+    s_output_users.emplace_back(&deformed_model);
+}
+
+void BT::Mesh_skinning_batch::unregister_output_user(Deformed_model& deformed_model)
+{
+    auto it{ std::find(s_output_users.begin(), s_output_users.end(), &deformed_model) };
+    if (it == s_output_users.end())
+    {
+        BT_ERROR("Deformed model was not registered as an output user.");
+        assert(false);
+        return;
+    }
+
+    s_output_users.erase(it);
+}
+
+uint32_t BT::Mesh_skinning_batch::get_output_vertex_buffer()
+{
+    return s_output_vertex_buffer;
+}
+
+void BT::Mesh_skinning_batch::submit(Deformed_model const& deformed_model,
+                                     std::vector<mat4s>&& joint_matrices)
+{
+    if (joint_matrices.size() > Deformed_model::k_max_num_joints)
+    {
+        BT_ERRORF("Too many joints submitted for skinning: %zu", joint_matrices.size());
+        assert(false);
+        return;
+    }
+
+    auto input_range{ deformed_model.m_input_range };
+    auto output_range{ deformed_model.m_output_range };
+    assert(input_range.count == output_range.count);
+
+    s_instances.emplace_back(input_range.base,
+                             output_range.base,
+                             output_range.count,
+                             static_cast<uint32_t>(s_palette.size()));
+
+    // Calc normal matrices once per joint instead of once per vertex in the shader.
+    s_palette.reserve(s_palette.size() + joint_matrices.size());
+    for (auto& joint_matrix : joint_matrices)
+        cpu_skinning::calc_palette_entry(joint_matrix.raw, s_palette.emplace_back());
+    s_max_instance_num_vertices = std::max(s_max_instance_num_vertices, output_range.count);
+}
+
+bool BT::Mesh_skinning_batch::dispatch()
+{
+    s_num_instances_last_dispatch = s_instances.size();
+    s_num_vertices_last_dispatch = 0;
+    for (auto const& instance : s_instances)
+        s_num_vertices_last_dispatch += instance.num_vertices;
+
+    if (s_instances.empty())
+        return false;
+
+    if (s_palette_buffer == 0)
+    {
+        glGenBuffers(1, &s_palette_buffer);
+        glGenBuffers(1, &s_instance_buffer);
+    }
+
+    // Upload palette and instance table (orphaning last frame's storage).
+    glBindBuffer(GL_SHADER_STORAGE_BUFFER, s_palette_buffer);
+    glBufferData(GL_SHADER_STORAGE_BUFFER,
+                 s_palette.size() * sizeof(Gpu_palette_entry),
+                 s_palette.data(),
+                 GL_STREAM_DRAW);
+    glBindBuffer(GL_SHADER_STORAGE_BUFFER, s_instance_buffer);
+    glBufferData(GL_SHADER_STORAGE_BUFFER,
+                 s_instances.size() * sizeof(Gpu_instance),
+                 s_instances.data(),
+                 GL_STREAM_DRAW);
+    glBindBuffer(GL_SHADER_STORAGE_BUFFER, 0);
+
+    // Dispatch compute.
+    glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 0, s_input_vertex_buffer);
+    glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 1, s_input_skin_data_buffer);
+    glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 2, s_palette_buffer);
+    glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 3, s_output_vertex_buffer);
+    glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 4, s_instance_buffer);
+
+    static auto& s_shader{ *Shader_bank::get_shader("skinned_mesh_compute") };
+    s_shader.bind();
+    // @NOTE: One row of work groups per instance. Must match compute shader `local_size_x`.
+    glDispatchCompute(static_cast<uint32_t>(
+                          std::ceilf(static_cast<float_t>(s_max_instance_num_vertices) / 256.0f)),
+                      static_cast<uint32_t>(s_instances.size()),
+                      1);
+    s_shader.unbind();
+
+    glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 0, 0);
+    glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 1, 0);
+    glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 2, 0);
+    glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 3, 0);
+    glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 4, 0);
+
+    // Clear for next frame.
+    s_palette.clear();
+    s_instances.clear();
+    s_max_instance_num_vertices = 0;
+
+    return true;
+}
+
+size_t BT::Mesh_skinning_batch::get_num_instances_last_dispatch()
+{
+    return s_num_instances_last_dispatch;
+}
+
+size_t BT::Mesh_skinning_batch::get_num_vertices_last_dispatch()
+{
+    return s_num_vertices_last_dispatch;
+}
+
+void BT::Mesh_skinning_batch::grow_buffer(uint32_t& buffer,
+                                          uint32_t target,
+                                          size_t old_size_bytes,
+                                          size_t new_size_bytes,
+                                          uint32_t usage)
+{
+    uint32_t new_buffer;
+    glGenBuffers(1, &new_buffer);
+    glBindBuffer(target, new_buffer);
+    glBufferData(target, new_size_bytes, nullptr, usage);
+    glBindBuffer(target, 0);
+
+    if (buffer != 0)
+    {   // Keep old contents.
+        if (old_size_bytes > 0)
+        {
+            glBindBuffer(GL_COPY_READ_BUFFER, buffer);
+            glBindBuffer(GL_COPY_WRITE_BUFFER, new_buffer);
+            glCopyBufferSubData(GL_COPY_READ_BUFFER, GL_COPY_WRITE_BUFFER, 0, 0, old_size_bytes);
+            glBindBuffer(GL_COPY_READ_BUFFER, 0);
+            glBindBuffer(GL_COPY_WRITE_BUFFER, 0);
+        }
+        glDeleteBuffers(1, &buffer);
+    }
+
+    buffer = new_buffer;
+}
@@ -0,0 +1,102 @@
+#pragma once
+
+#include "btglm.h"
+#include "cpu_skinning.h"
+
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+
+namespace BT
+{
+
+class Model;
+class Deformed_model;
+
+/// Skins all deformed models in one compute dispatch per frame.
+/// All skinned models' input vertices live in one input arena, all deformed models' output
+/// vertices live in one output arena, and all submitted joint matrices get packed into one palette
+/// buffer along with a table of per-instance vertex ranges.
+// @COPYPASTA: Static class, similar to the banks (see "mesh.h").
+class Mesh_skinning_batch
+{
+public:
+    struct Vertex_range
+    {
+        uint32_t base{ 0 };
+        uint32_t count{ 0 };
+    };
+
+    /// Gets the range of `model`'s vertices in the input arena. Uploads the model's vertices and
+    /// skin data into the arena the first time.
+    static Vertex_range acquire_input_range(Model const& model);
+
+    /// Allocates a range in the output arena.
+    static Vertex_range allocate_output_range(uint32_t num_vertices);
+    static void free_output_range(Vertex_range range);
+
+    /// Registered deformed models get their vertex array re-setup if the output arena gets
+    /// reallocated. Deformed models must unregister before they're destroyed.
+    static void register_output_user(Deformed_model& deformed_model);
+    static void unregister_output_user(Deformed_model& deformed_model);
+
+    /// Vertex buffer that all deformed models' output vertex ranges are in.
+    static uint32_t get_output_vertex_buffer();
+
+    /// Adds a deformed model with its joint matrices to this frame's dispatch.
+    static void submit(Deformed_model const& deformed_model, std::vector<mat4s>&& joint_matrices);
+
+    /// Uploads the palette and instance table, then skins all submitted instances.
+    /// Returns false if nothing was submitted.
+    static bool dispatch();
+
+    /// Stats from the latest dispatch.
+    static size_t get_num_instances_last_dispatch();
+    static size_t get_num_vertices_last_dispatch();
+
+private:
+    struct Gpu_instance
+    {   // @NOTE: Must match `skinned_mesh.comp`.
+        uint32_t input_vertex_base;
+        uint32_t output_vertex_base;
+        uint32_t num_vertices;
+        uint32_t palette_base;
+    };
+
+    // Input arena (vertices + skin datas, same indexing).
+    inline static uint32_t s_input_vertex_buffer{ 0 };
+    inline static uint32_t s_input_skin_data_buffer{ 0 };
+    inline static uint32_t s_input_capacity{ 0 };
+    inline static uint32_t s_input_count{ 0 };
+    inline static std::unordered_map<Model const*, Vertex_range> s_input_ranges;
+
+    // Output arena.
+    inline static uint32_t s_output_vertex_buffer{ 0 };
+    inline static uint32_t s_output_capacity{ 0 };
+    inline static uint32_t s_output_count{ 0 };
+    inline static std::vector<Vertex_range> s_output_free_ranges;
+    inline static std::vector<Deformed_model*> s_output_users;
+
+    // @NOTE: Must match `skinned_mesh.comp`.
+    using Gpu_palette_entry = cpu_skinning::Palette_entry;
+
+    // Per frame.
+    inline static std::vector<Gpu_palette_entry> s_palette;
+    inline static std::vector<Gpu_instance> s_instances;
+    inline static uint32_t s_max_instance_num_vertices{ 0 };
+    inline static uint32_t s_palette_buffer{ 0 };
+    inline static uint32_t s_instance_buffer{ 0 };
+
+    // Stats.
+    inline static size_t s_num_instances_last_dispatch{ 0 };
+    inline static size_t s_num_vertices_last_dispatch{ 0 };
+
+    static void grow_buffer(uint32_t& buffer,
+                            uint32_t target,
+                            size_t old_size_bytes,
+                            size_t new_size_bytes,
+                            uint32_t usage);
+};
+
+}  // namespace BT
@@ -10,6 +10,7 @@
 #include <algorithm>
 #include <cmath>
 #include <cstddef>
+#include <utility>
 
 
 BT::Model_joint_animation_frame::Joint_local_transform
@@ -185,62 +186,41 @@ void BT::Model_joint_animation::calc_joint_matrices(float_t time,
 void BT::Model_joint_animation::get_joint_matrices_at_frame(
     uint32_t frame_idx,
     bool root_motion_zeroing,
+    Model_joint_mask const* joint_mask,
+    std::vector<mat4s>& joint_global_transform_scratch,
     std::vector<mat4s>& out_joint_matrices) const
-{   ////////////////////////////////////////////////////////////////////////////////////////////////
-    // @COPYPASTA below from `calc_joint_matrices()`
-    //   Note the commented out sections of code. This marks the parts that are removed from the
-    //   original source material. And then, lines with `// +` at the end are marked for showing
-    //   addition of the source material.
-    //
-    // @NOTE: So I think that the best thing to do here is just copy the contents of the
-    //   `calc_joint_matrices()` function and then instead of using `interpolate_fast()`, just
-    //   return the first one essentially. It'll just be copypasta for this run around but maybe in
-    //   the future a more efficient way for `get_joint_matrices_at_frame()` can be concocted when
-    //   the program demands the performance.  -Thea 2025/09/27
-    //
-    // @NOTE: Hey, I really don't like these copypastas. These really need some kind of
-    //   consolidation/abstraction for this!!!  -Thea 2025/11/26
-    ////////////////////////////////////////////////////////////////////////////////////////////////
-
-    // uint32_t frame_idx_a{ calc_frame_idx(time, loop, FLOOR) };
-    // uint32_t frame_idx_b{ calc_frame_idx(time, loop, CEIL) };
-
-    // float_t interp_t{ (time / k_frames_per_second)
-    //                   - std::floor(time / k_frames_per_second) };
-
-    // Allocate calculation cache.
-    std::vector<mat4s> joint_global_transform_cache;
-    joint_global_transform_cache.resize(m_model_skin.joints_sorted_breadth_first.size());
+{
+    auto const& joints{ m_model_skin.joints_sorted_breadth_first };
+    size_t num_joints{ joints.size() };
+    if (num_joints > 0 && joints[0].parent_idx != (uint32_t)-1)
+    {
+        logger::printe(logger::ERROR,
+                       "First joint parent is not null. Joint list probably not sorted. Aborting.");
+        assert(false);
+        return;
+    }
 
-    out_joint_matrices.resize(m_model_skin.joints_sorted_breadth_first.size());
+    // @NOTE: W/ a mask, only joints in the mask get written to. Others stay as whatever was there
+    //        before (or identity if newly allocated).
+    joint_global_transform_scratch.resize(num_joints);
+    out_joint_matrices.resize(num_joints, glms_mat4_identity());
 
-    // Calculate joint matrices.
-    for (size_t i = 0; i < m_model_skin.joints_sorted_breadth_first.size(); i++)
+    auto const& frame{ m_frames[frame_idx] };
+    size_t num_evaluated_joints{ joint_mask ? joint_mask->joint_idxs_sorted.size() : num_joints };
+    for (size_t i = 0; i < num_evaluated_joints; i++)
     {
-        auto& joint{ m_model_skin.joints_sorted_breadth_first[i] };
-        if (i == 0 && joint.parent_idx != (uint32_t)-1)
-        {
-            logger::printe(logger::ERROR,
-                           "First joint parent is not null. Joint list probably not sorted. Aborting.");
-            assert(false);
-            return;
-        }
+        uint32_t joint_idx{ joint_mask ? joint_mask->joint_idxs_sorted[i]
+                                       : static_cast<uint32_t>(i) };
+        assert(joint_idx < num_joints);
+        auto& joint{ joints[joint_idx] };
 
         // Calculate global transform (relative to parent bone -> model space).
+        auto local_joint_transform{ frame.joint_transforms_in_order[joint_idx] };  // Copy.
 
-        // auto local_joint_transform{
-        //     m_frames[frame_idx_a].joint_transforms_in_order[i].interpolate_fast(
-        //         m_frames[frame_idx_b].joint_transforms_in_order[i],
-        //         interp_t) };
-        auto& local_joint_transform{                                                            // +
-            const_cast<Model_joint_animation_frame::Joint_local_transform&>(                    // +
-                m_frames[frame_idx].joint_transforms_in_order[i])                               // +
-        };                                                                                      // +
-
-        if (i == 0 && root_motion_zeroing)                                                      // +
-        {   // Delete root motion (for XZ axes).                                                // +
-            local_joint_transform.position[0] = local_joint_transform.position[2] = 0;          // +
-        }                                                                                       // +
+        if (joint_idx == 0 && root_motion_zeroing)
+        {   // Delete root motion (for XZ axes).
+            local_joint_transform.position[0] = local_joint_transform.position[2] = 0;
+        }
 
         mat4 global_joint_transform;
         glm_translate_make(global_joint_transform, local_joint_transform.position);
@@ -250,31 +230,28 @@ void BT::Model_joint_animation::get_joint_matrices_at_frame(
         if (joint.parent_idx == (uint32_t)-1)
         {   // Use skin baseline transform.
             glm_mat4_mul(const_cast<vec4*>(m_model_skin.baseline_transform),
-                 global_joint_transform,
-                 global_joint_transform);
+                         global_joint_transform,
+                         global_joint_transform);
         }
         else
         {   // Use cached parent global trans to make global trans.
-            glm_mat4_mul(joint_global_transform_cache[joint.parent_idx].raw,
+            // @NOTE: Masks include all ancestors sorted breadth first, so parent is calculated.
+            glm_mat4_mul(joint_global_transform_scratch[joint.parent_idx].raw,
                          global_joint_transform,
                          global_joint_transform);
         }
 
         // Insert global transform into cache.
-        glm_mat4_copy(global_joint_transform, joint_global_transform_cache[i].raw);
+        glm_mat4_copy(global_joint_transform, joint_global_transform_scratch[joint_idx].raw);
 
         // Calculate joint matrix.
-        // @RANT: I hate how all the glm functions don't mark the params as const,
-        //   and also since they're not getting mutated! Aaaaggghhhh
-        // @RANT: I hate how the rant above was a rant!!! The amount of strenuous
-        //   work to get this whole shitshow working was insane!!!! Hahahahahahaha  -Thea 2025/07/20
         mat4 joint_matrix;
         glm_mat4_mul(const_cast<vec4*>(m_model_skin.inverse_global_transform),
                      global_joint_transform,
                      joint_matrix);
         glm_mat4_mul(joint_matrix,
                      const_cast<vec4*>(joint.inverse_bind_matrix),
-                     out_joint_matrices[i].raw);
+                     out_joint_matrices[joint_idx].raw);
     }
 }
 
@@ -288,10 +265,25 @@ void BT::Model_joint_animation::get_root_motion_delta_pos_at_frame(
 }
 
 
+namespace
+{
+
+std::atomic_uint64_t s_next_variables_generation{ 1 };
+
+}  // namespace
+
 BT::Model_animator::Model_animator(Model const& model, bool use_root_motion)
-    : m_model_animations{ model.m_animations }
-    , m_model_skin{ model.m_model_skin }
+    : Model_animator{ model.m_model_skin, model.m_animations, use_root_motion }
+{
+}
+
+BT::Model_animator::Model_animator(Model_skin const& model_skin,
+                                   std::vector<Model_joint_animation> const& model_animations,
+                                   bool use_root_motion)
+    : m_model_animations{ model_animations }
+    , m_model_skin{ model_skin }
     , m_is_using_root_motion{ use_root_motion }
+    , m_variables_generation{ s_next_variables_generation++ }
 {
 }
 
@@ -303,13 +295,15 @@ BT::Model_skin const& BT::Model_animator::get_model_skin() const
 void BT::Model_animator::configure_animator_states(
     std::vector<anim_tmpl_types::Animator_state> animator_states,
     std::vector<anim_tmpl_types::Animator_variable> animator_variables,
-    std::vector<anim_tmpl_types::Animator_state_transition> animator_state_transitions)
+    anim_tmpl_types::Compiled_state_transitions animator_state_transitions)
 {
     // Idk why I put this into a separate method instead of in the constructor but hey, here we are.
     // @NOTE: A lot of copying, but I'm @TEMP temporarily doing this for a looser interface.
     m_animator_states = animator_states;
     m_animator_variables = animator_variables;
+    m_variables_generation = s_next_variables_generation++;
     m_animator_state_transitions = animator_state_transitions;
+    assert(m_animator_state_transitions.state_offsets.size() == m_animator_states.size() + 1);
 }
 
 void BT::Model_animator::configure_anim_frame_action_controls(
@@ -319,12 +313,18 @@ void BT::Model_animator::configure_anim_frame_action_controls(
     // Idk why I put this into a separate method instead of in the constructor but hey, here we are.
     m_anim_frame_action_controls = anim_frame_action_controls;
 
+    // Force reapplying data writes/overrides on next update.
+    m_afa_applied_timeline_idx = (size_t)-1;
+
     m_anim_frame_action_data.map_animator_to_control_regions(*this, *m_anim_frame_action_controls);
 
     m_anim_frame_action_data.hitcapsule_group_set.replace_and_reregister(
         m_anim_frame_action_controls->data.hitcapsule_group_set_template,
         resp_entity_uuid);
     m_anim_frame_action_data.hitcapsule_group_set.connect_animator(*this);
+
+    // Hitcapsule groups got replaced, so their enabled flags need a resync.
+    m_anim_frame_action_data.mark_all_data_changed();
 }
 
 std::vector<BT::anim_tmpl_types::Animator_state> const&
@@ -390,57 +390,113 @@ BT::Model_joint_animation const& BT::Model_animator::get_model_animation(size_t
     return m_model_animations[idx];
 }
 
-void BT::Model_animator::set_bool_variable(std::string const& var_name, bool value)
+BT::anim_tmpl_types::Animator_variable_handle BT::Model_animator::find_variable_handle(
+    std::string const& var_name) const
 {
-    auto& var_handle{ find_animator_variable(var_name) };
+    for (size_t i = 0; i < m_animator_variables.size(); i++)
+        if (m_animator_variables[i].var_name == var_name)
+        {   // Found variable!
+            return { static_cast<uint32_t>(i), m_animator_variables[i].type };
+        }
 
-    if (var_handle.type != anim_tmpl_types::Animator_variable::TYPE_BOOL)
-    {
-        assert(false);
+    return {};
+}
+
+void BT::Model_animator::set_bool_variable(anim_tmpl_types::Animator_variable_handle handle,
+                                           bool value)
+{
+    auto anim_var{ get_animator_variable_by_handle(handle,
+                                                   anim_tmpl_types::Animator_variable::TYPE_BOOL) };
+    if (anim_var == nullptr)
         return;
-    }
 
-    var_handle.var_value = (value ? anim_tmpl_types::k_bool_true
-                                  : anim_tmpl_types::k_bool_false);
+    anim_var->var_value = (value ? anim_tmpl_types::k_bool_true
+                                 : anim_tmpl_types::k_bool_false);
 }
 
-void BT::Model_animator::set_int_variable(std::string const& var_name, int32_t value)
+void BT::Model_animator::set_int_variable(anim_tmpl_types::Animator_variable_handle handle,
+                                          int32_t value)
 {
-    auto& var_handle{ find_animator_variable(var_name) };
-
-    if (var_handle.type != anim_tmpl_types::Animator_variable::TYPE_INT)
-    {
-        assert(false);
+    auto anim_var{ get_animator_variable_by_handle(handle,
+                                                   anim_tmpl_types::Animator_variable::TYPE_INT) };
+    if (anim_var == nullptr)
         return;
-    }
 
-    var_handle.var_value = value;
+    anim_var->var_value = value;
 }
 
-void BT::Model_animator::set_float_variable(std::string const& var_name, float_t value)
+void BT::Model_animator::set_float_variable(anim_tmpl_types::Animator_variable_handle handle,
+                                            float_t value)
 {
-    auto& var_handle{ find_animator_variable(var_name) };
+    auto anim_var{ get_animator_variable_by_handle(handle,
+                                                   anim_tmpl_types::Animator_variable::TYPE_FLOAT) };
+    if (anim_var == nullptr)
+        return;
 
-    if (var_handle.type != anim_tmpl_types::Animator_variable::TYPE_FLOAT)
-    {
-        assert(false);
+    anim_var->var_value = value;
+}
+
+void BT::Model_animator::set_trigger_variable(anim_tmpl_types::Animator_variable_handle handle)
+{
+    auto anim_var{ get_animator_variable_by_handle(
+        handle, anim_tmpl_types::Animator_variable::TYPE_TRIGGER) };
+    if (anim_var == nullptr)
         return;
-    }
 
-    var_handle.var_value = value;
+    anim_var->var_value = anim_tmpl_types::k_trig_triggered;
 }
 
-void BT::Model_animator::set_trigger_variable(std::string const& var_name)
+bool BT::Model_animator::get_bool_variable(
+    anim_tmpl_types::Animator_variable_handle handle) const
 {
-    auto& var_handle{ find_animator_variable(var_name) };
+    auto anim_var{ get_animator_variable_by_handle(handle,
+                                                   anim_tmpl_types::Animator_variable::TYPE_BOOL) };
+    if (anim_var == nullptr)
+        return false;
 
-    if (var_handle.type != anim_tmpl_types::Animator_variable::TYPE_TRIGGER)
-    {
-        assert(false);
-        return;
-    }
+    return glm_eq(anim_var->var_value, anim_tmpl_types::k_bool_true);
+}
+
+int32_t BT::Model_animator::get_int_variable(
+    anim_tmpl_types::Animator_variable_handle handle) const
+{
+    auto anim_var{ get_animator_variable_by_handle(handle,
+                                                   anim_tmpl_types::Animator_variable::TYPE_INT) };
+    if (anim_var == nullptr)
+        return 0;
+
+    return static_cast<int32_t>(anim_var->var_value);
+}
 
-    var_handle.var_value = anim_tmpl_types::k_trig_triggered;
+float_t BT::Model_animator::get_float_variable(
+    anim_tmpl_types::Animator_variable_handle handle) const
+{
+    auto anim_var{ get_animator_variable_by_handle(handle,
+                                                   anim_tmpl_types::Animator_variable::TYPE_FLOAT) };
+    if (anim_var == nullptr)
+        return 0.0f;
+
+    return anim_var->var_value;
+}
+
+void BT::Model_animator::set_bool_variable(std::string const& var_name, bool value)
+{
+    set_bool_variable(find_animator_variable_handle_checked(var_name), value);
+}
+
+void BT::Model_animator::set_int_variable(std::string const& var_name, int32_t value)
+{
+    set_int_variable(find_animator_variable_handle_checked(var_name), value);
+}
+
+void BT::Model_animator::set_float_variable(std::string const& var_name, float_t value)
+{
+    set_float_variable(find_animator_variable_handle_checked(var_name), value);
+}
+
+void BT::Model_animator::set_trigger_variable(std::string const& var_name)
+{
+    set_trigger_variable(find_animator_variable_handle_checked(var_name));
 }
 
 void BT::Model_animator::set_time(float_t time)
@@ -474,70 +530,38 @@ void BT::Model_animator::update(Animator_timer_profile profile, float_t delta_ti
         {   // Keep track of whether state changes.
             prev_state_idx = curr_state_idx;
 
-            // Look for possible state transitions.
-            for (auto const& state_trans : m_animator_state_transitions)
-            for (auto from_state_idx : state_trans.from_to_state.first)
-            if (from_state_idx == curr_state_idx)
-            {   // Possible state transition.
-                bool do_transition{ false };
-                if (state_trans.condition_var_idx == anim_tmpl_types::k_on_anim_end_var_idx)
+            // Look for possible state transitions (only the current state's outgoing ones).
+            // @NOTE: A pass goes thru the transitions in template order, so after transitioning,
+            //        only the new state's transitions that come later in the template are still
+            //        checked in the same pass. The next pass starts over from the first one.
+            auto const& compiled{ m_animator_state_transitions };
+            uint32_t min_template_idx{ 0 };
+            bool transitioned;
+            do
+            {
+                transitioned = false;
+                assert(curr_state_idx + 1 < compiled.state_offsets.size());
+                for (uint32_t i = compiled.state_offsets[curr_state_idx];
+                     i < compiled.state_offsets[curr_state_idx + 1];
+                     i++)
                 {
-                    if (!state_changed)
-                    {   // Special ON_ANIM_END case.
-                        // @NOTE: Since this is frame dependent, we need to make sure that we're
-                        //        using the correct animation idx (hence `!state_changed` check).
-                        //        -Thea 2025/11/23
-                        auto const& model_anim{ m_model_animations[anim_state.animation_idx] };
-                        if (model_anim.calc_frame_idx(time_handle.load(),
-                                                      false,
-                                                      Model_joint_animation::FLOOR) ==
-                            model_anim.get_num_frames() - 1)
-                        {
-                            do_transition = true;
-                        }
-                    }
-                }
-                else
-                {   // Normal condition var.
-                    auto const& anim_var{ m_animator_variables[state_trans.condition_var_idx] };
-
-                    switch (state_trans.compare_operator)
-                    {
-                    case anim_tmpl_types::Animator_state_transition::COMP_EQ:
-                        do_transition = glm_eq(anim_var.var_value, state_trans.compare_value);
-                        break;
-
-                    case anim_tmpl_types::Animator_state_transition::COMP_NEQ:
-                        do_transition = !glm_eq(anim_var.var_value, state_trans.compare_value);
-                        break;
-
-                    case anim_tmpl_types::Animator_state_transition::COMP_LESS:
-                        do_transition = (anim_var.var_value < state_trans.compare_value);
-                        break;
-
-                    case anim_tmpl_types::Animator_state_transition::COMP_LEQ:
-                        do_transition = (anim_var.var_value <= state_trans.compare_value);
-                        break;
-
-                    case anim_tmpl_types::Animator_state_transition::COMP_GREATER:
-                        do_transition = (anim_var.var_value > state_trans.compare_value);
+                    auto const& predicate{ compiled.predicates[i] };
+                    if (predicate.template_idx < min_template_idx)
+                        continue;
+
+                    if (eval_transition_predicate(predicate,
+                                                  anim_state.animation_idx,
+                                                  time_handle.load(),
+                                                  state_changed))
+                    {   // Transition states!
+                        curr_state_idx = predicate.to_state;
+                        state_changed = true;
+                        min_template_idx = predicate.template_idx + 1;
+                        transitioned = true;
                         break;
-
-                    case anim_tmpl_types::Animator_state_transition::COMP_GEQ:
-                        do_transition = (anim_var.var_value >= state_trans.compare_value);
-                        break;
-
-                    default: assert(false); break;
                     }
                 }
-
-                if (do_transition)
-                {   // Transition states!
-                    curr_state_idx = state_trans.from_to_state.second;
-                    state_changed = true;
-                    break;
-                }
-            }
+            } while (transitioned);
         } while (prev_state_idx != curr_state_idx);
 
         // Erase all trigger activations!
@@ -566,35 +590,51 @@ void BT::Model_animator::update(Animator_timer_profile profile, float_t delta_ti
         auto current_action_timeline_idx{
             m_anim_frame_action_data.anim_state_idx_to_timeline_idx_map.at(m_current_state_idx)
         };
-        auto& afa_timeline{ m_anim_frame_action_controls->data
-                                .anim_frame_action_timelines[current_action_timeline_idx] };
-
-        m_anim_frame_action_data.clear_all_data_overrides();
+        auto const& compiled_timeline{
+            m_anim_frame_action_controls->compiled_timelines[current_action_timeline_idx] };
+        auto const& ctrl_items{ m_anim_frame_action_controls->data.control_items };
+
+        {   // Mark rising edge events whose rising edge (start_frame) is within prev/curr time.
+            using Event_trigger = anim_frame_action::Runtime_data_controls::Compiled_timeline
+                                      ::Event_trigger;
+            static auto const s_calc_rising_edge_time_fn = [](Event_trigger const& event_trigger) {
+                return event_trigger.frame
+                       / Model_joint_animation::k_frames_per_second
+                       ;//* state_speed;  <-- @TODO: Include this when it's not editor mode (I think is the best decision)!!!!
+            };
+
+            auto const& event_triggers{ compiled_timeline.event_triggers_sorted };
+            auto it{ std::upper_bound(event_triggers.begin(),
+                                      event_triggers.end(),
+                                      prev_time,
+                                      [](float_t time, Event_trigger const& event_trigger) {
+                                          return time < s_calc_rising_edge_time_fn(event_trigger);
+                                      }) };
+            for (; it != event_triggers.end() && s_calc_rising_edge_time_fn(*it) <= curr_time; it++)
+            {   // Add rising edge event trigger mark.
+                m_anim_frame_action_data
+                    .get_reeve_data_handle(ctrl_items[it->ctrl_item_idx].affecting_data_label)
+                    .mark_rising_edge();
+            }
+        }
 
-        for (auto const& region : afa_timeline.regions)
+        // Apply data writes/overrides, only when the active frame (or the tables) changed.
+        auto frame_idx = m_model_animations[m_animator_states[m_current_state_idx].animation_idx]
+                         .calc_frame_idx(curr_time,
+                                         m_animator_states[m_current_state_idx].loop,
+                                         Model_joint_animation::FLOOR);
+        if (m_afa_applied_timeline_idx != current_action_timeline_idx ||
+            m_afa_applied_frame_idx != frame_idx ||
+            m_afa_applied_generation != m_anim_frame_action_controls->compiled_timelines_generation)
         {
-            auto& ctrl_item{
-                m_anim_frame_action_controls->data.control_items[region.ctrl_item_idx] };
-            if (ctrl_item.type == anim_frame_action::CTRL_ITEM_TYPE_EVENT_TRIGGER)
-            {   // Check if rising edge (start_frame) of event is within prev_time/curr_time.
-                float_t rising_edge_time = region.start_frame
-                                           / Model_joint_animation::k_frames_per_second
-                                           ;//* state_speed;  <-- @TODO: Include this when it's not editor mode (I think is the best decision)!!!!
-                if (prev_time < rising_edge_time && rising_edge_time <= curr_time)
-                {   // Add rising edge event trigger mark.
-                    m_anim_frame_action_data
-                        .get_reeve_data_handle(ctrl_item.affecting_data_label)
-                        .mark_rising_edge();
-                }
-            }
-            else
-            {   // Check if time within frame bounds.
-                auto frame_idx = m_model_animations[m_animator_states[m_current_state_idx].animation_idx]
-                                 .calc_frame_idx(curr_time,
-                                                 m_animator_states[m_current_state_idx].loop,
-                                                 Model_joint_animation::FLOOR);
-                if (frame_idx >= region.start_frame && frame_idx < region.end_frame)
+            m_anim_frame_action_data.clear_all_data_overrides();
+
+            if (frame_idx < compiled_timeline.get_num_frames())
+                for (uint32_t i = compiled_timeline.frame_offsets[frame_idx];
+                     i < compiled_timeline.frame_offsets[frame_idx + 1];
+                     i++)
                 {   // Add override/write mutation.
+                    auto& ctrl_item{ ctrl_items[compiled_timeline.active_ctrl_item_idxs[i]] };
                     bool is_bool_type{ anim_frame_action::Runtime_controllable_data
                                            ::get_data_type(ctrl_item.affecting_data_label)
                                        == anim_frame_action::Runtime_controllable_data
@@ -637,7 +677,10 @@ void BT::Model_animator::update(Animator_timer_profile profile, float_t delta_ti
                             break;
                     }
                 }
-            }
+
+            m_afa_applied_timeline_idx = current_action_timeline_idx;
+            m_afa_applied_frame_idx = frame_idx;
+            m_afa_applied_generation = m_anim_frame_action_controls->compiled_timelines_generation;
         }
 
         // Update prev time.
@@ -673,33 +716,74 @@ bool BT::Model_animator::get_is_using_root_motion() const
     return m_is_using_root_motion;
 }
 
-void BT::Model_animator::get_anim_floored_frame_pose(Animator_timer_profile profile,
-                                                     std::vector<mat4s>& out_joint_matrices) const
+void BT::Model_animator::get_anim_floored_frame_pose(
+    Animator_timer_profile profile,
+    Model_joint_mask const* joint_mask,
+    std::vector<mat4s>& joint_global_transform_scratch,
+    std::vector<mat4s>& out_joint_matrices) const
 {
     auto& anim_state{ m_animator_states[m_current_state_idx] };
-    uint32_t frame_idx{
-        m_model_animations[anim_state.animation_idx]
-            .calc_frame_idx(get_profile_time_handle(profile).load(),
-                            anim_state.loop,
-                            Model_joint_animation::FLOOR) };
-    m_model_animations[anim_state.animation_idx].get_joint_matrices_at_frame(frame_idx,
-                                                                             false,
-                                                                             out_joint_matrices);
+    auto const& model_anim{ m_model_animations[anim_state.animation_idx] };
+    uint32_t frame_idx{ model_anim.calc_frame_idx(get_profile_time_handle(profile).load(),
+                                                  anim_state.loop,
+                                                  Model_joint_animation::FLOOR) };
+    model_anim.get_joint_matrices_at_frame(frame_idx,
+                                           false,
+                                           joint_mask,
+                                           joint_global_transform_scratch,
+                                           out_joint_matrices);
 }
 
 void BT::Model_animator::get_anim_floored_frame_pose_with_root_motion_zeroing(
     Animator_timer_profile profile,
+    Model_joint_mask const* joint_mask,
+    std::vector<mat4s>& joint_global_transform_scratch,
     std::vector<mat4s>& out_joint_matrices) const
 {
     auto& anim_state{ m_animator_states[m_current_state_idx] };
-    uint32_t frame_idx{
-        m_model_animations[anim_state.animation_idx]
-            .calc_frame_idx(get_profile_time_handle(profile).load(),
-                            anim_state.loop,
-                            Model_joint_animation::FLOOR) };
-    m_model_animations[anim_state.animation_idx].get_joint_matrices_at_frame(frame_idx,
-                                                                             true,
-                                                                             out_joint_matrices);
+    auto const& model_anim{ m_model_animations[anim_state.animation_idx] };
+    uint32_t frame_idx{ model_anim.calc_frame_idx(get_profile_time_handle(profile).load(),
+                                                  anim_state.loop,
+                                                  Model_joint_animation::FLOOR) };
+    model_anim.get_joint_matrices_at_frame(frame_idx,
+                                           true,
+                                           joint_mask,
+                                           joint_global_transform_scratch,
+                                           out_joint_matrices);
+}
+
+BT::Model_joint_mask BT::Model_animator::calc_joint_mask(
+    std::vector<uint32_t> const& required_joint_idxs) const
+{
+    auto const& joints{ m_model_skin.joints_sorted_breadth_first };
+
+    // Mark required joints and walk up their ancestor chains.
+    std::vector<bool> is_joint_needed(joints.size(), false);
+    for (uint32_t joint_idx : required_joint_idxs)
+    {
+        if (joint_idx >= joints.size())
+        {
+            BT_ERRORF("Joint idx %u out of range (num joints: %zu)", joint_idx, joints.size());
+            assert(false);
+            continue;
+        }
+
+        while (joint_idx != (uint32_t)-1 && !is_joint_needed[joint_idx])
+        {
+            is_joint_needed[joint_idx] = true;
+            joint_idx = joints[joint_idx].parent_idx;
+        }
+    }
+
+    // Write out in breadth first order.
+    Model_joint_mask joint_mask;
+    for (uint32_t i = 0; i < joints.size(); i++)
+        if (is_joint_needed[i])
+        {
+            joint_mask.joint_idxs_sorted.emplace_back(i);
+        }
+
+    return joint_mask;
 }
 
 void BT::Model_animator::get_anim_root_motion_delta_pos(Animator_timer_profile profile,
@@ -722,6 +806,61 @@ BT::Model_animator::get_anim_frame_action_data_handle()
     return m_anim_frame_action_data;
 }
 
+BT::Model_animator::Renderer_lod_tier BT::Model_animator::calc_renderer_lod_tier(
+    vec3 camera_position,
+    vec4 frustum_planes[6],
+    vec3 aabb_min,
+    vec3 aabb_max)
+{
+    vec3 padded_aabb[2];
+    glm_vec3_subs(aabb_min, k_renderer_lod_aabb_padding, padded_aabb[0]);
+    glm_vec3_adds(aabb_max, k_renderer_lod_aabb_padding, padded_aabb[1]);
+
+    if (!glm_aabb_frustum(padded_aabb, frustum_planes))
+        return RENDERER_LOD_TIER_OFFSCREEN;
+
+    // Distance from camera to closest point on bounds (0 if camera is inside).
+    vec3 closest_point;
+    glm_vec3_maxv(camera_position, padded_aabb[0], closest_point);
+    glm_vec3_minv(closest_point, padded_aabb[1], closest_point);
+    float_t distance{ glm_vec3_distance(camera_position, closest_point) };
+
+    for (uint32_t i = 0; i < RENDERER_LOD_TIER_OFFSCREEN; i++)
+        if (distance <= k_renderer_lod_tier_max_distances[i])
+            return static_cast<Renderer_lod_tier>(i);
+
+    assert(false);
+    return RENDERER_LOD_TIER_QUARTER;
+}
+
+void BT::Model_animator::set_renderer_lod_tier(Renderer_lod_tier lod_tier)
+{
+    assert(lod_tier < NUM_RENDERER_LOD_TIERS);
+    m_rend_lod_tier = lod_tier;
+}
+
+BT::Model_animator::Renderer_lod_tier BT::Model_animator::get_renderer_lod_tier() const
+{
+    return m_rend_lod_tier;
+}
+
+bool BT::Model_animator::tick_renderer_lod_pose_timer(float_t delta_time)
+{
+    if (m_rend_lod_tier == RENDERER_LOD_TIER_OFFSCREEN)
+    {   // Force a recalc as soon as this comes back on screen.
+        m_rend_lod_pose_timer = std::numeric_limits<float_t>::max();
+        return false;
+    }
+
+    m_rend_lod_pose_timer += delta_time;
+    if (m_rend_lod_pose_timer >= k_renderer_lod_tier_pose_intervals[m_rend_lod_tier])
+    {
+        m_rend_lod_pose_timer = 0.0f;
+        return true;
+    }
+    return false;
+}
+
 // Please ignore the const_cast's below!! (^_^;)
 
 BT::Model_animator::animator_time_t& BT::Model_animator::get_profile_time_handle(
@@ -753,16 +892,91 @@ BT::Model_animator::animator_time_t& BT::Model_animator::get_profile_prev_time_h
     }
 }
 
-BT::anim_tmpl_types::Animator_variable& BT::Model_animator::find_animator_variable(
-    std::string const& var_name)
+BT::anim_tmpl_types::Animator_variable_handle
+BT::Model_animator::find_animator_variable_handle_checked(std::string const& var_name) const
 {
-    for (auto& anim_var : m_animator_variables)
-        if (anim_var.var_name == var_name)
-        {   // Found variable!
-            return anim_var;
-        }
+    auto handle{ find_variable_handle(var_name) };
+    if (!handle.is_valid())
+    {   // Crash the program when don't find the var.
+        assert(false);
+        throw new std::exception(("Did not find var name: " + var_name).c_str());
+    }
 
-    // Crash the program when don't find the var.
-    assert(false);
-    throw new std::exception(("Did not find var name: " + var_name).c_str());
+    return handle;
+}
+
+BT::anim_tmpl_types::Animator_variable* BT::Model_animator::get_animator_variable_by_handle(
+    anim_tmpl_types::Animator_variable_handle handle,
+    anim_tmpl_types::Animator_variable::Type expected_type)
+{
+    return const_cast<anim_tmpl_types::Animator_variable*>(
+        std::as_const(*this).get_animator_variable_by_handle(handle, expected_type));
+}
+
+BT::anim_tmpl_types::Animator_variable const* BT::Model_animator::get_animator_variable_by_handle(
+    anim_tmpl_types::Animator_variable_handle handle,
+    anim_tmpl_types::Animator_variable::Type expected_type) const
+{
+    if (handle.var_idx >= m_animator_variables.size())
+    {
+        assert(false);
+        throw new std::exception("Invalid animator variable handle.");
+    }
+
+    auto const& anim_var{ m_animator_variables[handle.var_idx] };
+    if (anim_var.type != handle.type ||  // Handle resolved from a different template?
+        anim_var.type != expected_type)
+    {
+        assert(false);
+        return nullptr;
+    }
+
+    return &anim_var;
+}
+
+bool BT::Model_animator::eval_transition_predicate(
+    anim_tmpl_types::Transition_predicate const& predicate,
+    uint32_t anim_state_animation_idx,
+    float_t time,
+    bool state_changed) const
+{
+    if (predicate.condition_var_idx == anim_tmpl_types::k_on_anim_end_var_idx)
+    {
+        if (state_changed)
+            return false;
+
+        // Special ON_ANIM_END case.
+        // @NOTE: Since this is frame dependent, we need to make sure that we're
+        //        using the correct animation idx (hence `!state_changed` check).
+        //        -Thea 2025/11/23
+        auto const& model_anim{ m_model_animations[anim_state_animation_idx] };
+        return (model_anim.calc_frame_idx(time, false, Model_joint_animation::FLOOR) ==
+                model_anim.get_num_frames() - 1);
+    }
+
+    // Normal condition var.
+    float_t var_value{ m_animator_variables[predicate.condition_var_idx].var_value };
+
+    switch (predicate.compare_operator)
+    {
+    case anim_tmpl_types::Animator_state_transition::COMP_EQ:
+        return glm_eq(var_value, predicate.compare_value);
+
+    case anim_tmpl_types::Animator_state_transition::COMP_NEQ:
+        return !glm_eq(var_value, predicate.compare_value);
+
+    case anim_tmpl_types::Animator_state_transition::COMP_LESS:
+        return (var_value < predicate.compare_value);
+
+    case anim_tmpl_types::Animator_state_transition::COMP_LEQ:
+        return (var_value <= predicate.compare_value);
+
+    case anim_tmpl_types::Animator_state_transition::COMP_GREATER:
+        return (var_value > predicate.compare_value);
+
+    case anim_tmpl_types::Animator_state_transition::COMP_GEQ:
+        return (var_value >= predicate.compare_value);
+
+    default: assert(false); return false;
+    }
 }
@@ -3,6 +3,7 @@
 #include "../animation_frame_action_tool/runtime_data.h"
 #include "animator_template_types.h"
 #include "btglm.h"
+#include "model_joint_mask.h"
 #include "uuid/uuid.h"
 
 #include <atomic>
@@ -76,8 +77,14 @@ public:
                              bool loop,
                              bool root_motion_zeroing,
                              std::vector<mat4s>& out_joint_matrices) const;
+
+    /// Gets the joint matrices of frame `frame_idx`. W/ a `joint_mask`, only evaluates (and
+    /// writes) the joints in the mask. `joint_global_transform_scratch` is working space that
+    /// callers keep around, so that repeat calls don't allocate.
     void get_joint_matrices_at_frame(uint32_t frame_idx,
                                      bool root_motion_zeroing,
+                                     Model_joint_mask const* joint_mask,
+                                     std::vector<mat4s>& joint_global_transform_scratch,
                                      std::vector<mat4s>& out_joint_matrices) const;
     void get_root_motion_delta_pos_at_frame(uint32_t frame_idx,
                                             vec3& out_root_motion_delta_pos) const;
@@ -97,13 +104,16 @@ class Model_animator
 {
 public:
     Model_animator(Model const& model, bool use_root_motion);
+    Model_animator(Model_skin const& model_skin,
+                   std::vector<Model_joint_animation> const& model_animations,
+                   bool use_root_motion);
 
     Model_skin const& get_model_skin() const;
 
     void configure_animator_states(
         std::vector<anim_tmpl_types::Animator_state> animator_states,
         std::vector<anim_tmpl_types::Animator_variable> animator_variables,
-        std::vector<anim_tmpl_types::Animator_state_transition> animator_state_transitions);
+        anim_tmpl_types::Compiled_state_transitions animator_state_transitions);
 
     void configure_anim_frame_action_controls(
         anim_frame_action::Runtime_data_controls const* anim_frame_action_controls,
@@ -122,6 +132,25 @@ public:
     size_t get_model_animation_idx(std::string anim_name) const;
     Model_joint_animation const& get_model_animation(size_t idx) const;
 
+    /// Resolves a variable name into a handle. Returns an invalid handle if not found.
+    anim_tmpl_types::Animator_variable_handle find_variable_handle(
+        std::string const& var_name) const;
+
+    /// Changes every time the variables get (re)configured, and is never shared between two
+    /// animators. Resolved handles stay valid for as long as this stays the same.
+    uint64_t get_variables_generation() const { return m_variables_generation; }
+
+    /// Sets a variable inside the state machine via resolved handle.
+    void set_bool_variable(anim_tmpl_types::Animator_variable_handle handle, bool value);
+    void set_int_variable(anim_tmpl_types::Animator_variable_handle handle, int32_t value);
+    void set_float_variable(anim_tmpl_types::Animator_variable_handle handle, float_t value);
+    void set_trigger_variable(anim_tmpl_types::Animator_variable_handle handle);
+
+    /// Gets a variable inside the state machine via resolved handle.
+    bool get_bool_variable(anim_tmpl_types::Animator_variable_handle handle) const;
+    int32_t get_int_variable(anim_tmpl_types::Animator_variable_handle handle) const;
+    float_t get_float_variable(anim_tmpl_types::Animator_variable_handle handle) const;
+
     /// Sets a variable inside the state machine.
     void set_bool_variable(std::string const& var_name, bool value);
 
@@ -160,20 +189,54 @@ public:
     bool get_is_using_root_motion() const;
 
     /// Calculates the set of joint matrices, floored. Note this one will be faster.
+    /// W/ a `joint_mask`, only evaluates joints in the mask (see
+    /// `Model_joint_animation::get_joint_matrices_at_frame()`).
     void get_anim_floored_frame_pose(Animator_timer_profile profile,
+                                     Model_joint_mask const* joint_mask,
+                                     std::vector<mat4s>& joint_global_transform_scratch,
                                      std::vector<mat4s>& out_joint_matrices) const;
 
     /// Calculates the set of joint matrices, floored, with delta pos and zeroing from root motion.
     void get_anim_floored_frame_pose_with_root_motion_zeroing(
         Animator_timer_profile profile,
+        Model_joint_mask const* joint_mask,
+        std::vector<mat4s>& joint_global_transform_scratch,
         std::vector<mat4s>& out_joint_matrices) const;
 
+    /// Makes a joint mask of `required_joint_idxs` and all their ancestors.
+    Model_joint_mask calc_joint_mask(std::vector<uint32_t> const& required_joint_idxs) const;
+
     /// Gets the root motion delta pos of the current frame.
     void get_anim_root_motion_delta_pos(Animator_timer_profile profile,
                                         vec3& out_root_motion_delta_pos) const;
 
     anim_frame_action::Runtime_controllable_data& get_anim_frame_action_data_handle();
 
+    /// Level of detail tiers for renderer pose updates. Only affects the `RENDERER_PROFILE` pose
+    /// calculation. The simulation profile always updates at full rate.
+    enum Renderer_lod_tier : uint32_t
+    {
+        RENDERER_LOD_TIER_FULL = 0,
+        RENDERER_LOD_TIER_HALF,
+        RENDERER_LOD_TIER_QUARTER,
+        RENDERER_LOD_TIER_OFFSCREEN,  // Skips pose calc and skinning entirely.
+        NUM_RENDERER_LOD_TIERS
+    };
+
+    /// Selects the LOD tier from camera distance to `aabb` and whether `aabb` is inside the
+    /// frustum. `frustum_planes` is expected in the format of `glm_frustum_planes()`.
+    static Renderer_lod_tier calc_renderer_lod_tier(vec3 camera_position,
+                                                    vec4 frustum_planes[6],
+                                                    vec3 aabb_min,
+                                                    vec3 aabb_max);
+
+    void set_renderer_lod_tier(Renderer_lod_tier lod_tier);
+    Renderer_lod_tier get_renderer_lod_tier() const;
+
+    /// Advances the renderer LOD pose timer. Returns true if the renderer pose should be
+    /// recalculated this frame.
+    bool tick_renderer_lod_pose_timer(float_t delta_time);
+
 private:
     std::vector<Model_joint_animation> const& m_model_animations;
     Model_skin const& m_model_skin;
@@ -197,11 +260,48 @@ private:
 
     std::vector<anim_tmpl_types::Animator_state> m_animator_states;
     std::vector<anim_tmpl_types::Animator_variable> m_animator_variables;
-    std::vector<anim_tmpl_types::Animator_state_transition> m_animator_state_transitions;
+    uint64_t m_variables_generation;
+    anim_tmpl_types::Compiled_state_transitions m_animator_state_transitions;
     anim_frame_action::Runtime_data_controls const* m_anim_frame_action_controls{ nullptr };
     anim_frame_action::Runtime_controllable_data m_anim_frame_action_data;
 
-    anim_tmpl_types::Animator_variable& find_animator_variable(std::string const& var_name);
+    // Last applied AFA data writes/overrides (to skip reapplying when nothing changed).
+    size_t m_afa_applied_timeline_idx{ (size_t)-1 };
+    uint32_t m_afa_applied_frame_idx{ (uint32_t)-1 };
+    uint32_t m_afa_applied_generation{ 0 };
+
+    anim_tmpl_types::Animator_variable_handle find_animator_variable_handle_checked(
+        std::string const& var_name) const;
+    /// Returns nullptr if the handle's var isn't `expected_type`.
+    anim_tmpl_types::Animator_variable* get_animator_variable_by_handle(
+        anim_tmpl_types::Animator_variable_handle handle,
+        anim_tmpl_types::Animator_variable::Type expected_type);
+    anim_tmpl_types::Animator_variable const* get_animator_variable_by_handle(
+        anim_tmpl_types::Animator_variable_handle handle,
+        anim_tmpl_types::Animator_variable::Type expected_type) const;
+
+    bool eval_transition_predicate(anim_tmpl_types::Transition_predicate const& predicate,
+                                   uint32_t anim_state_animation_idx,
+                                   float_t time,
+                                   bool state_changed) const;
+
+    // Renderer LOD.
+    static constexpr float_t k_renderer_lod_tier_max_distances[RENDERER_LOD_TIER_OFFSCREEN]{
+        15.0f,  // FULL.
+        40.0f,  // HALF.
+        std::numeric_limits<float_t>::max(),  // QUARTER.
+    };
+    static constexpr float_t k_renderer_lod_tier_pose_intervals[RENDERER_LOD_TIER_OFFSCREEN]{
+        0.0f,                                               // FULL.
+        2.0f / Model_joint_animation::k_frames_per_second,  // HALF.
+        4.0f / Model_joint_animation::k_frames_per_second,  // QUARTER.
+    };
+    // @NOTE: Deformed meshes can go outside of their bind pose bounds, so pad the bounds so that
+    //        limbs don't freeze right at the edge of the screen.
+    static constexpr float_t k_renderer_lod_aabb_padding{ 1.0f };
+
+    Renderer_lod_tier m_rend_lod_tier{ RENDERER_LOD_TIER_FULL };
+    float_t m_rend_lod_pose_timer{ std::numeric_limits<float_t>::max() };  // Max forces first calc.
 };
 
 }  // namespace BT
@@ -0,0 +1,23 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+
+namespace BT
+{
+
+/// Subset of a skin's joints to evaluate, for consumers that don't need the whole skeleton (e.g.
+/// hitcapsules only need the bones they connect to).
+/// Made with `Model_animator::calc_joint_mask()`.
+struct Model_joint_mask
+{
+    /// Required joints plus all of their ancestors, sorted breadth first (same order as
+    /// `Model_skin::joints_sorted_breadth_first`) so parents always get evaluated before children.
+    std::vector<uint32_t> joint_idxs_sorted;
+
+    /// Empty mask means no joints are required.
+    bool is_empty() const { return joint_idxs_sorted.empty(); }
+};
+
+}  // namespace BT
@@ -0,0 +1,302 @@
+#include "occlusion_culler.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <xmmintrin.h>
+
+
+namespace
+{
+
+inline float_t horizontal_max(__m128 vals)
+{
+    __m128 swapped_pairs{ _mm_shuffle_ps(vals, vals, _MM_SHUFFLE(2, 3, 0, 1)) };
+    __m128 pair_maxs{ _mm_max_ps(vals, swapped_pairs) };
+    __m128 swapped_halves{ _mm_movehl_ps(pair_maxs, pair_maxs) };
+    return _mm_cvtss_f32(_mm_max_ss(pair_maxs, swapped_halves));
+}
+
+}  // namespace
+
+
+BT::Occlusion_culler::Occlusion_culler()
+{
+    m_depth_buffer.resize(k_width * k_height, 1.0f);
+    m_tile_max_depths.resize(k_num_tiles_x * k_num_tiles_y, 1.0f);
+    glm_mat4_identity(m_projection_view);
+}
+
+void BT::Occlusion_culler::begin_frame(mat4 projection_view)
+{
+    glm_mat4_copy(projection_view, m_projection_view);
+    std::fill(m_depth_buffer.begin(), m_depth_buffer.end(), 1.0f);
+    std::fill(m_tile_max_depths.begin(), m_tile_max_depths.end(), 1.0f);
+    m_stats = {};
+}
+
+void BT::Occlusion_culler::rasterize_occluder(float_t const* positions,
+                                              size_t position_stride,
+                                              size_t num_positions,
+                                              uint32_t const* indices,
+                                              size_t num_indices,
+                                              mat4 transform)
+{
+    m_stats.num_occluders++;
+    m_stats.num_occluder_triangles += num_indices / 3;
+
+    mat4 clip_transform;
+    glm_mat4_mul(m_projection_view, transform, clip_transform);
+
+    // Transform each position once (shared vertices are common).
+    m_clip_positions.resize(num_positions);
+    auto position_bytes{ reinterpret_cast<uint8_t const*>(positions) };
+    for (size_t i = 0; i < num_positions; i++)
+    {
+        auto position{ reinterpret_cast<float_t const*>(position_bytes + i * position_stride) };
+        vec4 position_w{ position[0], position[1], position[2], 1.0f };
+        glm_mat4_mulv(clip_transform, position_w, m_clip_positions[i].raw);
+    }
+
+    for (size_t i = 0; i + 2 < num_indices; i += 3)
+    {
+        rasterize_clip_triangle(m_clip_positions[indices[i + 0]].raw,
+                                m_clip_positions[indices[i + 1]].raw,
+                                m_clip_positions[indices[i + 2]].raw);
+    }
+}
+
+void BT::Occlusion_culler::finish_occluders()
+{
+    for (uint32_t tile_y = 0; tile_y < k_num_tiles_y; tile_y++)
+    for (uint32_t tile_x = 0; tile_x < k_num_tiles_x; tile_x++)
+    {
+        __m128 max_depths{ _mm_set1_ps(-1.0f) };
+        for (uint32_t row = 0; row < k_tile_size; row++)
+        {
+            float_t const* row_depths{
+                &m_depth_buffer[(tile_y * k_tile_size + row) * k_width + tile_x * k_tile_size] };
+            for (uint32_t col = 0; col < k_tile_size; col += 4)
+                max_depths = _mm_max_ps(max_depths, _mm_loadu_ps(row_depths + col));
+        }
+
+        m_tile_max_depths[tile_y * k_num_tiles_x + tile_x] = horizontal_max(max_depths);
+    }
+}
+
+bool BT::Occlusion_culler::is_visible(vec3 aabb_min, vec3 aabb_max)
+{
+    m_stats.num_tested++;
+
+    // Find screen space rect and nearest depth of the bounds.
+    constexpr float_t k_min_w{ 1e-5f };
+    float_t ndc_min_x{ std::numeric_limits<float_t>::max() };
+    float_t ndc_min_y{ std::numeric_limits<float_t>::max() };
+    float_t ndc_max_x{ std::numeric_limits<float_t>::lowest() };
+    float_t ndc_max_y{ std::numeric_limits<float_t>::lowest() };
+    float_t nearest_depth{ std::numeric_limits<float_t>::max() };
+
+    for (uint32_t i = 0; i < 8; i++)
+    {
+        vec4 corner{ (i & 0b001) ? aabb_max[0] : aabb_min[0],
+                     (i & 0b010) ? aabb_max[1] : aabb_min[1],
+                     (i & 0b100) ? aabb_max[2] : aabb_min[2],
+                     1.0f };
+        vec4 clip_corner;
+        glm_mat4_mulv(m_projection_view, corner, clip_corner);
+
+        if (clip_corner[3] < k_min_w || clip_corner[2] < -clip_corner[3])
+            return true;  // Crosses near plane.
+
+        float_t inv_w{ 1.0f / clip_corner[3] };
+        ndc_min_x = std::min(ndc_min_x, clip_corner[0] * inv_w);
+        ndc_min_y = std::min(ndc_min_y, clip_corner[1] * inv_w);
+        ndc_max_x = std::max(ndc_max_x, clip_corner[0] * inv_w);
+        ndc_max_y = std::max(ndc_max_y, clip_corner[1] * inv_w);
+        nearest_depth = std::min(nearest_depth, clip_corner[2] * inv_w);
+    }
+
+    int32_t min_x{ static_cast<int32_t>(std::floor((ndc_min_x * 0.5f + 0.5f) * k_width)) };
+    int32_t min_y{ static_cast<int32_t>(std::floor((ndc_min_y * 0.5f + 0.5f) * k_height)) };
+    int32_t max_x{ static_cast<int32_t>(std::floor((ndc_max_x * 0.5f + 0.5f) * k_width)) };
+    int32_t max_y{ static_cast<int32_t>(std::floor((ndc_max_y * 0.5f + 0.5f) * k_height)) };
+    min_x = std::max(min_x, 0);
+    min_y = std::max(min_y, 0);
+    max_x = std::min(max_x, static_cast<int32_t>(k_width) - 1);
+    max_y = std::min(max_y, static_cast<int32_t>(k_height) - 1);
+    if (min_x > max_x || min_y > max_y)
+        return true;  // Off screen. Leave this to frustum culling.
+
+    // Check tiles first, then pixels of tiles that aren't fully in front of the bounds.
+    constexpr int32_t k_tile_size_i{ static_cast<int32_t>(k_tile_size) };
+    for (int32_t tile_y = min_y / k_tile_size_i; tile_y <= max_y / k_tile_size_i; tile_y++)
+    for (int32_t tile_x = min_x / k_tile_size_i; tile_x <= max_x / k_tile_size_i; tile_x++)
+    {
+        if (nearest_depth > m_tile_max_depths[tile_y * k_num_tiles_x + tile_x])
+            continue;
+
+        int32_t tile_min_x{ std::max(min_x, tile_x * k_tile_size_i) };
+        int32_t tile_min_y{ std::max(min_y, tile_y * k_tile_size_i) };
+        int32_t tile_max_x{ std::min(max_x, (tile_x + 1) * k_tile_size_i - 1) };
+        int32_t tile_max_y{ std::min(max_y, (tile_y + 1) * k_tile_size_i - 1) };
+        for (int32_t y = tile_min_y; y <= tile_max_y; y++)
+        for (int32_t x = tile_min_x; x <= tile_max_x; x++)
+            if (nearest_depth <= m_depth_buffer[y * k_width + x])
+                return true;
+    }
+
+    m_stats.num_occluded++;
+    return false;
+}
+
+void BT::Occlusion_culler::rasterize_clip_triangle(vec4 clip_v0, vec4 clip_v1, vec4 clip_v2)
+{
+    float_t* clip_verts[3]{ clip_v0, clip_v1, clip_v2 };
+
+    // Clip against near plane (inside is `z >= -w`).
+    float_t near_dists[3]{ clip_v0[2] + clip_v0[3],
+                           clip_v1[2] + clip_v1[3],
+                           clip_v2[2] + clip_v2[3] };
+
+    vec4 clipped_verts[4];
+    size_t num_clipped_verts{ 0 };
+    for (size_t i = 0; i < 3; i++)
+    {
+        size_t next_i{ (i + 1) % 3 };
+        bool is_inside{ near_dists[i] >= 0.0f };
+        bool is_next_inside{ near_dists[next_i] >= 0.0f };
+
+        if (is_inside)
+            glm_vec4_copy(clip_verts[i], clipped_verts[num_clipped_verts++]);
+
+        if (is_inside != is_next_inside)
+        {
+            float_t t{ near_dists[i] / (near_dists[i] - near_dists[next_i]) };
+            glm_vec4_lerp(clip_verts[i], clip_verts[next_i], t, clipped_verts[num_clipped_verts++]);
+        }
+    }
+
+    if (num_clipped_verts < 3)
+        return;  // Fully behind near plane.
+
+    // Project to screen.
+    constexpr float_t k_min_w{ 1e-5f };
+    Screen_vertex screen_verts[4];
+    for (size_t i = 0; i < num_clipped_verts; i++)
+    {
+        if (clipped_verts[i][3] < k_min_w)
+            return;  // Degenerate projection.
+
+        float_t inv_w{ 1.0f / clipped_verts[i][3] };
+        screen_verts[i] = {
+            .x = (clipped_verts[i][0] * inv_w * 0.5f + 0.5f) * k_width,
+            .y = (clipped_verts[i][1] * inv_w * 0.5f + 0.5f) * k_height,
+            .z = clipped_verts[i][2] * inv_w,
+        };
+    }
+
+    // Triangle fan (clipping makes at most a quad).
+    for (size_t i = 1; i + 1 < num_clipped_verts; i++)
+        rasterize_screen_triangle(screen_verts[0], screen_verts[i], screen_verts[i + 1]);
+}
+
+void BT::Occlusion_culler::rasterize_screen_triangle(Screen_vertex v0,
+                                                     Screen_vertex v1,
+                                                     Screen_vertex v2)
+{
+    constexpr float_t k_min_area{ 1e-6f };
+    float_t area{ (v1.x - v0.x) * (v2.y - v0.y) - (v2.x - v0.x) * (v1.y - v0.y) };
+    if (std::abs(area) < k_min_area)
+        return;
+
+    if (area < 0.0f)
+    {   // Double sided, so flip to positive winding.
+        std::swap(v1, v2);
+        area = -area;
+    }
+
+    // Pixels whose centers can be inside the triangle.
+    int32_t min_x{ static_cast<int32_t>(std::ceil(std::min({ v0.x, v1.x, v2.x }) - 0.5f)) };
+    int32_t min_y{ static_cast<int32_t>(std::ceil(std::min({ v0.y, v1.y, v2.y }) - 0.5f)) };
+    int32_t max_x{ static_cast<int32_t>(std::floor(std::max({ v0.x, v1.x, v2.x }) - 0.5f)) };
+    int32_t max_y{ static_cast<int32_t>(std::floor(std::max({ v0.y, v1.y, v2.y }) - 0.5f)) };
+    min_x = std::max(min_x, 0);
+    min_y = std::max(min_y, 0);
+    max_x = std::min(max_x, static_cast<int32_t>(k_width) - 1);
+    max_y = std::min(max_y, static_cast<int32_t>(k_height) - 1);
+    if (min_x > max_x || min_y > max_y)
+        return;
+
+    m_stats.num_rasterized_triangles++;
+
+    // Edge functions `a * x + b * y + c` (>= 0 is inside) for edges 0->1, 1->2, 2->0.
+    // @NOTE: Coverage is conservative (inner coverage): each edge is pushed inward by half a pixel
+    //        along both axes, so that evaluating it at a pixel center gives the value at the pixel
+    //        corner furthest out. Only pixels fully inside the triangle get written, so occluders
+    //        never hide things thru gaps at their silhouettes.
+    Screen_vertex const* edge_verts[3][2]{ { &v0, &v1 }, { &v1, &v2 }, { &v2, &v0 } };
+    __m128 edge_as[3];
+    float_t edge_bs[3];
+    float_t edge_cs[3];
+    for (size_t i = 0; i < 3; i++)
+    {
+        auto const& from{ *edge_verts[i][0] };
+        auto const& to{ *edge_verts[i][1] };
+        float_t a{ -(to.y - from.y) };
+        float_t b{ to.x - from.x };
+        edge_as[i] = _mm_set1_ps(a);
+        edge_bs[i] = b;
+        edge_cs[i] = -(a * from.x + b * from.y) - 0.5f * (std::abs(a) + std::abs(b));
+    }
+
+    // Depth plane `z = dz_dx * x + dz_dy * y + z_c` (NDC depth is linear in screen space).
+    float_t inv_area{ 1.0f / area };
+    float_t dz_dx{ ((v1.z - v0.z) * (v2.y - v0.y) - (v2.z - v0.z) * (v1.y - v0.y)) * inv_area };
+    float_t dz_dy{ ((v2.z - v0.z) * (v1.x - v0.x) - (v1.z - v0.z) * (v2.x - v0.x)) * inv_area };
+    float_t z_c{ v0.z - dz_dx * v0.x - dz_dy * v0.y };
+
+    // Write the farthest depth of the triangle over each pixel (conservative too), not the center.
+    z_c += 0.5f * (std::abs(dz_dx) + std::abs(dz_dy));
+    __m128 dz_dx_4{ _mm_set1_ps(dz_dx) };
+
+    __m128 const lane_offsets{ _mm_setr_ps(0.5f, 1.5f, 2.5f, 3.5f) };
+    __m128 const zeros{ _mm_setzero_ps() };
+
+    // @NOTE: Start x is aligned down to a lane group. Lanes outside of the triangle get masked off
+    //        by the edge tests, and `k_width` is a multiple of 4 so lane groups never go off row.
+    int32_t start_x{ min_x & ~3 };
+    for (int32_t y = min_y; y <= max_y; y++)
+    {
+        float_t pixel_y{ y + 0.5f };
+        __m128 row_edges[3];
+        for (size_t i = 0; i < 3; i++)
+            row_edges[i] = _mm_set1_ps(edge_bs[i] * pixel_y + edge_cs[i]);
+        __m128 row_z{ _mm_set1_ps(dz_dy * pixel_y + z_c) };
+
+        float_t* row_depths{ &m_depth_buffer[y * k_width] };
+        for (int32_t x = start_x; x <= max_x; x += 4)
+        {
+            __m128 pixel_xs{ _mm_add_ps(_mm_set1_ps(static_cast<float_t>(x)), lane_offsets) };
+
+            __m128 inside{ _mm_cmpge_ps(_mm_add_ps(_mm_mul_ps(edge_as[0], pixel_xs), row_edges[0]),
+                                        zeros) };
+            inside = _mm_and_ps(inside,
+                                _mm_cmpge_ps(_mm_add_ps(_mm_mul_ps(edge_as[1], pixel_xs),
+                                                        row_edges[1]),
+                                             zeros));
+            inside = _mm_and_ps(inside,
+                                _mm_cmpge_ps(_mm_add_ps(_mm_mul_ps(edge_as[2], pixel_xs),
+                                                        row_edges[2]),
+                                             zeros));
+            if (_mm_movemask_ps(inside) == 0)
+                continue;
+
+            __m128 depths{ _mm_add_ps(_mm_mul_ps(dz_dx_4, pixel_xs), row_z) };
+            __m128 old_depths{ _mm_loadu_ps(row_depths + x) };
+            __m128 new_depths{ _mm_min_ps(old_depths, depths) };
+            _mm_storeu_ps(row_depths + x,
+                          _mm_or_ps(_mm_and_ps(inside, new_depths),
+                                    _mm_andnot_ps(inside, old_depths)));
+        }
+    }
+}
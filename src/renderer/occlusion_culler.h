@@ -0,0 +1,89 @@
+#pragma once
+
+#include "cglm/cglm.h"
+#include "cglm/types-struct.h"
+#include <cmath>
+#include <cstdint>
+#include <vector>
+
+using std::vector;
+
+
+namespace BT
+{
+
+/// Culls bounds hidden behind occluder meshes with a low resolution software depth buffer.
+/// Occluder triangles are rasterized 4 pixels at a time with SSE, then a max depth per tile gets
+/// built so that most occludee bounds can be rejected without touching single pixels.
+// @NOTE: Doesn't touch any graphics API state, so it can run (and be benchmarked) headless. Results
+//        only depend on the inputs and their order, so they're deterministic. Only depends on cglm,
+//        so that it also builds outside of the engine (see "benchmarks/headless/").
+class Occlusion_culler
+{
+public:
+    static constexpr uint32_t k_width{ 256 };
+    static constexpr uint32_t k_height{ 144 };
+    static constexpr uint32_t k_tile_size{ 8 };
+    static constexpr uint32_t k_num_tiles_x{ k_width / k_tile_size };
+    static constexpr uint32_t k_num_tiles_y{ k_height / k_tile_size };
+    static_assert(k_width % k_tile_size == 0 && k_height % k_tile_size == 0);
+    static_assert(k_tile_size % 4 == 0, "Tile rows must be whole SIMD lane groups.");
+
+    Occlusion_culler();
+
+    /// Clears the depth buffer and sets up the view for the next occluders and tests.
+    // @NOTE: Depth is NDC depth (OpenGL convention), so clear depth is 1.0 (the far plane).
+    void begin_frame(mat4 projection_view);
+
+    /// Rasterizes triangle list into the depth buffer. `positions` points to the first vertex
+    /// position, and each next position is `position_stride` bytes after.
+    // @NOTE: Triangles are rasterized double sided, and clipped against the near plane. Only
+    //        pixels fully inside a triangle get written, w/ the triangle's farthest depth over the
+    //        pixel, so occluders never hide more than they cover. Pixels along edges shared by two
+    //        triangles don't get written either, so occluders w/ few, big triangles work best.
+    void rasterize_occluder(float_t const* positions,
+                            size_t position_stride,
+                            size_t num_positions,
+                            uint32_t const* indices,
+                            size_t num_indices,
+                            mat4 transform);
+
+    /// Builds the tile max depths. Call after all occluders are rasterized and before testing.
+    void finish_occluders();
+
+    /// Returns false if the world space AABB is fully behind the rasterized occluders.
+    // @NOTE: Bounds that cross the near plane or leave the screen are kept visible (conservative).
+    bool is_visible(vec3 aabb_min, vec3 aabb_max);
+
+    struct Stats
+    {
+        size_t num_occluders{ 0 };
+        size_t num_occluder_triangles{ 0 };
+        size_t num_rasterized_triangles{ 0 };  // After near plane clipping and size rejection.
+        size_t num_tested{ 0 };
+        size_t num_occluded{ 0 };
+    };
+    Stats const& get_stats() const { return m_stats; }
+
+    /// Depth buffer (`k_width` * `k_height`, row major, row 0 at NDC y -1) for debugging.
+    vector<float_t> const& get_depth_buffer() const { return m_depth_buffer; }
+
+private:
+    mat4 m_projection_view;
+    vector<float_t> m_depth_buffer;
+    vector<float_t> m_tile_max_depths;
+    vector<vec4s> m_clip_positions;  // Scratch for transformed occluder positions.
+    Stats m_stats;
+
+    struct Screen_vertex
+    {
+        float_t x;  // Pixels.
+        float_t y;  // Pixels.
+        float_t z;  // NDC depth.
+    };
+
+    void rasterize_clip_triangle(vec4 clip_v0, vec4 clip_v1, vec4 clip_v2);
+    void rasterize_screen_triangle(Screen_vertex v0, Screen_vertex v1, Screen_vertex v2);
+};
+
+}  // namespace BT
@@ -0,0 +1,366 @@
+#include "ray_picker.h"
+
+#include "mesh.h"
+#include "render_object.h"
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <limits>
+
+
+void BT::Ray_picker::build(vector<Render_object*> const& rend_objs,
+                           vector<uint8_t> const& visible,
+                           Render_layer active_layers)
+{
+    assert(rend_objs.size() == visible.size());
+    m_rend_objs = &rend_objs;
+
+    // Collect items.
+    m_items.clear();
+    for (size_t i = 0; i < rend_objs.size(); i++)
+    {
+        auto rend_obj{ rend_objs[i] };
+        if (!visible[i] || !(rend_obj->get_layer() & active_layers))
+            continue;
+
+        AA_bounding_box world_aabb;
+        rend_obj->calc_world_aabb(world_aabb);
+
+        Item item;
+        glm_vec3_copy(world_aabb.min, item.aabb_min);
+        glm_vec3_copy(world_aabb.max, item.aabb_max);
+        glm_vec3_center(world_aabb.min, world_aabb.max, item.centroid);
+        item.rend_obj_idx = static_cast<uint32_t>(i);
+        m_items.emplace_back(item);
+    }
+
+    // Build tree.
+    m_nodes.clear();
+    if (!m_items.empty())
+    {
+        m_nodes.reserve(m_items.size() * 2);
+        m_nodes.emplace_back();
+        build_node_recursive(0, 0, static_cast<uint32_t>(m_items.size()));
+    }
+}
+
+void BT::Ray_picker::clear()
+{
+    m_rend_objs = nullptr;
+    m_nodes.clear();
+    m_items.clear();
+}
+
+BT::Ray_picker::Pick_result BT::Ray_picker::pick(vec3 ray_origin, vec3 ray_dir) const
+{
+    Pick_result result;
+    if (m_nodes.empty())
+        return result;
+
+    assert(m_rend_objs != nullptr);
+
+    vec3 inv_ray_dir{ 1.0f / ray_dir[0], 1.0f / ray_dir[1], 1.0f / ray_dir[2] };
+    float_t closest_distance{ std::numeric_limits<float_t>::max() };
+
+    // Traverse.
+    uint32_t node_stack[k_max_traversal_depth];
+    size_t stack_size{ 0 };
+    node_stack[stack_size++] = 0;
+
+    while (stack_size > 0)
+    {
+        auto const& node{ m_nodes[node_stack[--stack_size]] };
+
+        float_t node_distance;
+        if (!intersect_ray_aabb(ray_origin,
+                                inv_ray_dir,
+                                const_cast<float_t*>(node.aabb_min),
+                                const_cast<float_t*>(node.aabb_max),
+                                closest_distance,
+                                node_distance))
+            continue;
+
+        if (node.num_items == 0)
+        {   // Push children (near child last so it gets popped first).
+            assert(stack_size + 2 <= k_max_traversal_depth);
+            uint32_t left_idx{ node.left_or_first_idx };
+            uint32_t right_idx{ node.left_or_first_idx + 1 };
+
+            float_t left_distance{ 0.0f };
+            float_t right_distance{ 0.0f };
+            bool hit_left{ intersect_ray_aabb(ray_origin,
+                                              inv_ray_dir,
+                                              const_cast<float_t*>(m_nodes[left_idx].aabb_min),
+                                              const_cast<float_t*>(m_nodes[left_idx].aabb_max),
+                                              closest_distance,
+                                              left_distance) };
+            bool hit_right{ intersect_ray_aabb(ray_origin,
+                                               inv_ray_dir,
+                                               const_cast<float_t*>(m_nodes[right_idx].aabb_min),
+                                               const_cast<float_t*>(m_nodes[right_idx].aabb_max),
+                                               closest_distance,
+                                               right_distance) };
+
+            if (hit_left && hit_right && left_distance < right_distance)
+                std::swap(left_idx, right_idx);  // Left is nearer, so push it last.
+            else if (!hit_left)
+                left_idx = (uint32_t)-1;
+            if (!hit_right)
+                right_idx = (uint32_t)-1;
+
+            for (uint32_t child_idx : { left_idx, right_idx })
+                if (child_idx != (uint32_t)-1)
+                    node_stack[stack_size++] = child_idx;
+            continue;
+        }
+
+        // Test items in leaf.
+        for (uint32_t i = 0; i < node.num_items; i++)
+        {
+            auto const& item{ m_items[node.left_or_first_idx + i] };
+
+            float_t item_distance;
+            if (!intersect_ray_aabb(ray_origin,
+                                    inv_ray_dir,
+                                    const_cast<float_t*>(item.aabb_min),
+                                    const_cast<float_t*>(item.aabb_max),
+                                    closest_distance,
+                                    item_distance))
+                continue;
+
+            auto rend_obj{ (*m_rend_objs)[item.rend_obj_idx] };
+            auto deformed_model{ rend_obj->get_deformed_model() };
+
+            Model const* model;
+            vector<Vertex> const* override_vertices{ nullptr };
+            if (deformed_model == nullptr)
+            {
+                model = static_cast<Model const*>(rend_obj->get_renderable());
+            }
+            else if (deformed_model->get_skinning_mode() == Deformed_model::SKINNING_MODE_CPU &&
+                     !deformed_model->get_cpu_deformed_vertices().empty())
+            {
+                model = &deformed_model->get_source_model();
+                override_vertices = &deformed_model->get_cpu_deformed_vertices();
+            }
+            else
+            {   // GPU skinned vertices aren't available CPU-side, so can't test exactly.
+                // @NOTE: Bind pose bounds don't enclose all deformations, so this check is only
+                //        a heuristic for whether the deformed model could be in the way.
+                result.exact = false;
+                continue;
+            }
+
+            float_t hit_distance;
+            if (intersect_ray_model(ray_origin,
+                                    ray_dir,
+                                    *model,
+                                    override_vertices,
+                                    rend_obj->render_transform(),
+                                    closest_distance,
+                                    hit_distance))
+            {
+                closest_distance     = hit_distance;
+                result.rend_obj_idx  = item.rend_obj_idx;
+                result.distance      = hit_distance;
+            }
+        }
+    }
+
+    return result;
+}
+
+void BT::Ray_picker::calc_ray_from_pixel(mat4 projection_view,
+                                         float_t x,
+                                         float_t y,
+                                         float_t width,
+                                         float_t height,
+                                         vec3& out_ray_origin,
+                                         vec3& out_ray_dir)
+{
+    mat4 inv_projection_view;
+    glm_mat4_inv(projection_view, inv_projection_view);
+
+    // @NOTE: Projection matrices have the neg-Y fix, so framebuffer rows line up with cursor y.
+    float_t ndc_x{ (x + 0.5f) / width * 2.0f - 1.0f };
+    float_t ndc_y{ (y + 0.5f) / height * 2.0f - 1.0f };
+
+    vec4 near_point{ ndc_x, ndc_y, -1.0f, 1.0f };
+    vec4 far_point{ ndc_x, ndc_y, 1.0f, 1.0f };
+    glm_mat4_mulv(inv_projection_view, near_point, near_point);
+    glm_mat4_mulv(inv_projection_view, far_point, far_point);
+    glm_vec4_scale(near_point, 1.0f / near_point[3], near_point);
+    glm_vec4_scale(far_point, 1.0f / far_point[3], far_point);
+
+    glm_vec3(near_point, out_ray_origin);
+    vec3 far_point_xyz;
+    glm_vec3(far_point, far_point_xyz);
+    glm_vec3_sub(far_point_xyz, out_ray_origin, out_ray_dir);
+    glm_vec3_normalize(out_ray_dir);
+}
+
+void BT::Ray_picker::build_node_recursive(uint32_t node_idx,
+                                          uint32_t first_item_idx,
+                                          uint32_t num_items)
+{
+    {   // Calc node bounds.
+        auto& node{ m_nodes[node_idx] };
+        glm_vec3_copy(m_items[first_item_idx].aabb_min, node.aabb_min);
+        glm_vec3_copy(m_items[first_item_idx].aabb_max, node.aabb_max);
+        for (uint32_t i = 1; i < num_items; i++)
+        {
+            auto const& item{ m_items[first_item_idx + i] };
+            glm_vec3_minv(node.aabb_min, const_cast<float_t*>(item.aabb_min), node.aabb_min);
+            glm_vec3_maxv(node.aabb_max, const_cast<float_t*>(item.aabb_max), node.aabb_max);
+        }
+
+        if (num_items <= k_max_leaf_items)
+        {   // Make leaf.
+            node.left_or_first_idx = first_item_idx;
+            node.num_items         = num_items;
+            return;
+        }
+    }
+
+    // Split at median centroid along the longest axis of the centroid bounds.
+    vec3 centroid_min;
+    vec3 centroid_max;
+    glm_vec3_copy(m_items[first_item_idx].centroid, centroid_min);
+    glm_vec3_copy(m_items[first_item_idx].centroid, centroid_max);
+    for (uint32_t i = 1; i < num_items; i++)
+    {
+        auto& item{ m_items[first_item_idx + i] };
+        glm_vec3_minv(centroid_min, item.centroid, centroid_min);
+        glm_vec3_maxv(centroid_max, item.centroid, centroid_max);
+    }
+
+    vec3 centroid_extents;
+    glm_vec3_sub(centroid_max, centroid_min, centroid_extents);
+    size_t split_axis{ 0 };
+    if (centroid_extents[1] > centroid_extents[split_axis])
+        split_axis = 1;
+    if (centroid_extents[2] > centroid_extents[split_axis])
+        split_axis = 2;
+
+    uint32_t num_left_items{ num_items / 2 };
+    auto items_begin{ m_items.begin() + first_item_idx };
+    std::nth_element(items_begin,
+                     items_begin + num_left_items,
+                     items_begin + num_items,
+                     [split_axis](Item const& a, Item const& b) {
+                         return a.centroid[split_axis] < b.centroid[split_axis];
+                     });
+
+    // Create children.
+    // @NOTE: `m_nodes` may reallocate here, so re-fetch node after.
+    uint32_t left_idx{ static_cast<uint32_t>(m_nodes.size()) };
+    m_nodes.emplace_back();
+    m_nodes.emplace_back();
+    m_nodes[node_idx].left_or_first_idx = left_idx;
+    m_nodes[node_idx].num_items         = 0;
+
+    build_node_recursive(left_idx, first_item_idx, num_left_items);
+    build_node_recursive(left_idx + 1, first_item_idx + num_left_items, num_items - num_left_items);
+}
+
+bool BT::Ray_picker::intersect_ray_aabb(vec3 ray_origin,
+                                        vec3 inv_ray_dir,
+                                        vec3 aabb_min,
+                                        vec3 aabb_max,
+                                        float_t max_distance,
+                                        float_t& out_distance)
+{   // Slab test.
+    float_t t_min{ 0.0f };
+    float_t t_max{ max_distance };
+    for (size_t axis = 0; axis < 3; axis++)
+    {
+        float_t t0{ (aabb_min[axis] - ray_origin[axis]) * inv_ray_dir[axis] };
+        float_t t1{ (aabb_max[axis] - ray_origin[axis]) * inv_ray_dir[axis] };
+        if (t0 > t1)
+            std::swap(t0, t1);
+
+        t_min = std::max(t_min, t0);
+        t_max = std::min(t_max, t1);
+        if (t_min > t_max)
+            return false;
+    }
+
+    out_distance = t_min;
+    return true;
+}
+
+bool BT::Ray_picker::intersect_ray_model(vec3 ray_origin,
+                                         vec3 ray_dir,
+                                         Model const& model,
+                                         vector<Vertex> const* override_vertices,
+                                         mat4 transform,
+                                         float_t max_distance,
+                                         float_t& out_distance)
+{
+    auto const& vertices{ override_vertices != nullptr ? *override_vertices
+                                                       : model.get_vertices() };
+
+    // Bring ray into model space instead of transforming every vertex.
+    // @NOTE: Direction isn't renormalized, so hit distances stay in world space units.
+    mat4 inv_transform;
+    glm_mat4_inv(transform, inv_transform);
+
+    vec3 local_origin;
+    vec3 local_dir;
+    glm_mat4_mulv3(inv_transform, ray_origin, 1.0f, local_origin);
+    glm_mat4_mulv3(inv_transform, ray_dir, 0.0f, local_dir);
+
+    // Mirroring transforms flip the winding order, which flips which side is the front face.
+    float_t front_face_sign{ glm_mat4_det(transform) < 0.0f ? -1.0f : 1.0f };
+
+    constexpr float_t k_epsilon{ 1e-7f };
+    bool hit{ false };
+    float_t closest_distance{ max_distance };
+
+    for (auto const& mesh : model.get_meshes())
+    {
+        auto const& indices{ mesh.get_indices() };
+        for (size_t i = 0; i + 2 < indices.size(); i += 3)
+        {   // Möller-Trumbore.
+            float_t* v0{ const_cast<float_t*>(vertices[indices[i + 0]].position) };
+            float_t* v1{ const_cast<float_t*>(vertices[indices[i + 1]].position) };
+            float_t* v2{ const_cast<float_t*>(vertices[indices[i + 2]].position) };
+
+            vec3 edge1;
+            vec3 edge2;
+            glm_vec3_sub(v1, v0, edge1);
+            glm_vec3_sub(v2, v0, edge2);
+
+            vec3 p;
+            glm_vec3_cross(local_dir, edge2, p);
+            float_t det{ glm_vec3_dot(edge1, p) * front_face_sign };
+            if (det < k_epsilon)
+                continue;  // Back facing or parallel (same as back face culling in picking pass).
+
+            float_t inv_det{ front_face_sign / det };
+
+            vec3 s;
+            glm_vec3_sub(local_origin, v0, s);
+            float_t u{ glm_vec3_dot(s, p) * inv_det };
+            if (u < 0.0f || u > 1.0f)
+                continue;
+
+            vec3 q;
+            glm_vec3_cross(s, edge1, q);
+            float_t v{ glm_vec3_dot(local_dir, q) * inv_det };
+            if (v < 0.0f || u + v > 1.0f)
+                continue;
+
+            float_t t{ glm_vec3_dot(edge2, q) * inv_det };
+            if (t > 0.0f && t < closest_distance)
+            {
+                closest_distance = t;
+                hit              = true;
+            }
+        }
+    }
+
+    if (hit)
+        out_distance = closest_distance;
+    return hit;
+}
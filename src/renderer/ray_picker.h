@@ -0,0 +1,102 @@
+#pragma once
+
+#include "btglm.h"
+#include "render_layer.h"
+#include <cstdint>
+#include <vector>
+
+using std::vector;
+
+
+namespace BT
+{
+
+class Model;
+class Render_object;
+struct Vertex;
+
+/// Picks render objects on the CPU by casting a ray against a BVH of render object world bounds,
+/// then doing exact ray-triangle tests on the meshes of candidate render objects.
+/// Triangles are culled the same way as the picking framebuffer pass (back faces skipped), so the
+/// result matches what the GPU path would read back.
+class Ray_picker
+{
+public:
+    static constexpr uint32_t k_no_pick_idx{ (uint32_t)-1 };
+
+    struct Pick_result
+    {
+        /// False if a candidate couldn't be tested exactly on the CPU (e.g. a GPU skinned deformed
+        /// model), and picking should fall back to the GPU path.
+        bool exact{ true };
+        uint32_t rend_obj_idx{ k_no_pick_idx };  // Index into `rend_objs` passed to `build()`.
+        float_t distance{ 0.0f };                // Ray parameter (`origin + distance * dir`).
+    };
+
+    /// Builds BVH over render objects where `visible[i] != 0` and in `active_layers`.
+    // @NOTE: Render objects must stay checked out until done picking.
+    void build(vector<Render_object*> const& rend_objs,
+               vector<uint8_t> const& visible,
+               Render_layer active_layers);
+
+    /// Forgets the render objects passed to `build()`. Call before returning them.
+    void clear();
+
+    /// Finds the closest render object hit by the ray.
+    Pick_result pick(vec3 ray_origin, vec3 ray_dir) const;
+
+    /// Calculates world space ray going thru the center of framebuffer pixel (`x`, `y`).
+    static void calc_ray_from_pixel(mat4 projection_view,
+                                    float_t x,
+                                    float_t y,
+                                    float_t width,
+                                    float_t height,
+                                    vec3& out_ray_origin,
+                                    vec3& out_ray_dir);
+
+private:
+    struct Node
+    {
+        vec3 aabb_min;
+        vec3 aabb_max;
+        uint32_t left_or_first_idx;  // Left child idx if inner node (right is `+ 1`), else first
+                                     // item idx.
+        uint32_t num_items;          // 0 if inner node.
+    };
+
+    struct Item
+    {
+        vec3 aabb_min;
+        vec3 aabb_max;
+        vec3 centroid;
+        uint32_t rend_obj_idx;
+    };
+
+    vector<Render_object*> const* m_rend_objs{ nullptr };
+    vector<Node> m_nodes;
+    vector<Item> m_items;
+
+    static constexpr uint32_t k_max_leaf_items{ 2 };
+    static constexpr size_t k_max_traversal_depth{ 64 };
+
+    void build_node_recursive(uint32_t node_idx, uint32_t first_item_idx, uint32_t num_items);
+
+    static bool intersect_ray_aabb(vec3 ray_origin,
+                                   vec3 inv_ray_dir,
+                                   vec3 aabb_min,
+                                   vec3 aabb_max,
+                                   float_t max_distance,
+                                   float_t& out_distance);
+
+    /// Exact test against the triangles of `model` placed at `transform`. Vertices default to the
+    /// model's own (bind pose) vertices.
+    static bool intersect_ray_model(vec3 ray_origin,
+                                    vec3 ray_dir,
+                                    Model const& model,
+                                    vector<Vertex> const* override_vertices,
+                                    mat4 transform,
+                                    float_t max_distance,
+                                    float_t& out_distance);
+};
+
+}  // namespace BT
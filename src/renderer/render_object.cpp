@@ -5,6 +5,7 @@
 #include "btglm.h"
 #include "btlogger.h"
 #include "mesh.h"
+#include <algorithm>
 
 
 BT::Render_object::Render_object(Render_layer layer)
@@ -44,7 +45,72 @@ void BT::Render_object::render(Render_layer active_layers,
     }
 }
 
-BT::UUID BT::Render_object_pool::emplace(Render_object&& rend_obj)
+void BT::Render_object::emplace_draws(Render_layer active_layers, Render_queue& render_queue)
+{
+    if (m_layer & active_layers)
+    {
+        m_renderable->emplace_draws(m_layer, m_render_transform, m_lod_level, render_queue);
+    }
+}
+
+void BT::Render_object::update_lod_level(Lod_view const& lod_view)
+{
+    if (m_deformed_model != nullptr)
+    {   // Deformed models only draw full detail.
+        m_lod_level = 0;
+        return;
+    }
+
+    auto const& model{ *static_cast<Model const*>(m_renderable) };
+    uint32_t num_lod_levels{ model.get_num_lod_levels() };
+    if (num_lod_levels <= 1)
+    {
+        m_lod_level = 0;
+        return;
+    }
+
+    // Project errors from the closest point of the world bounds.
+    float_t distance{ 1.0f };
+    if (!lod_view.is_orthographic)
+    {
+        AA_bounding_box world_aabb;
+        calc_world_aabb(world_aabb);
+
+        vec3 closest_point;
+        for (size_t i = 0; i < 3; i++)
+            closest_point[i] = glm_clamp(lod_view.camera_position[i],
+                                         world_aabb.min[i],
+                                         world_aabb.max[i]);
+
+        constexpr float_t k_min_distance{ 0.01f };
+        distance = std::max(glm_vec3_distance(const_cast<float_t*>(lod_view.camera_position),
+                                              closest_point),
+                            k_min_distance);
+    }
+
+    float_t max_scale{ std::max({ glm_vec3_norm(m_render_transform[0]),
+                                  glm_vec3_norm(m_render_transform[1]),
+                                  glm_vec3_norm(m_render_transform[2]) }) };
+    float_t error_to_pixels{ max_scale * lod_view.pixels_per_unit / distance };
+
+    uint32_t lod_level{ std::min(m_lod_level, num_lod_levels - 1) };
+    while (lod_level > 0 &&
+           model.get_lod_error(lod_level) * error_to_pixels > lod_view.max_pixel_error)
+        lod_level--;
+    while (lod_level + 1 < num_lod_levels &&
+           model.get_lod_error(lod_level + 1) * error_to_pixels <
+               lod_view.max_pixel_error * lod_view.hysteresis_ratio)
+        lod_level++;
+
+    m_lod_level = lod_level;
+}
+
+void BT::Render_object::calc_world_aabb(AA_bounding_box& out_aabb) const
+{
+    m_renderable->get_aabb().calc_transformed(const_cast<vec4*>(m_render_transform), out_aabb);
+}
+
+BT::Render_object_handle BT::Render_object_pool::emplace(Render_object&& rend_obj)
 {
     UUID uuid{ rend_obj.get_uuid() };
     if (uuid.is_nil())
@@ -61,28 +127,81 @@ BT::UUID BT::Render_object_pool::emplace(Render_object&& rend_obj)
     }
 
     wait_until_free_then_block();
-    auto emplace_success{ m_render_objects.emplace(uuid, std::move(rend_obj)).second };
+
+    // Get slot.
+    uint32_t slot_idx;
+    if (!m_free_slot_idxs.empty())
+    {
+        slot_idx = m_free_slot_idxs.back();
+        m_free_slot_idxs.pop_back();
+    }
+    else
+    {
+        slot_idx = static_cast<uint32_t>(m_slots.size());
+        m_slots.emplace_back(0u, 0u);
+    }
+
+    // Append render object to end of dense array.
+    auto& slot{ m_slots[slot_idx] };
+    slot.dense_idx = static_cast<uint32_t>(m_render_objects.size());
+    m_render_objects.emplace_back(std::move(rend_obj));
+    m_dense_idx_to_slot_idx.emplace_back(slot_idx);
+
+    Render_object_handle handle{ slot_idx, slot.generation };
+    auto emplace_success{ m_uuid_to_handle.emplace(uuid, handle).second };
     assert(emplace_success);  // @TODO: If emplace fails, try generating another UUID.
+
     unblock();
 
-    return uuid;
+    return handle;
 }
 
-void BT::Render_object_pool::remove(UUID key)
+void BT::Render_object_pool::remove(Render_object_handle handle)
 {
     wait_until_free_then_block();
-    if (m_render_objects.find(key) == m_render_objects.end())
+    if (!is_handle_valid(handle))
     {
-        // Fail bc key was invalid.
-        logger::printef(logger::ERROR, "Render object key %llu does not exist", key);
+        // Fail bc handle was invalid.
+        logger::printef(logger::ERROR,
+                        "Render object handle (slot %u, generation %u) does not exist",
+                        handle.slot_idx,
+                        handle.generation);
         assert(false);
+        unblock();
         return;
     }
 
-    m_render_objects.erase(key);
+    auto& slot{ m_slots[handle.slot_idx] };
+    uint32_t dense_idx{ slot.dense_idx };
+    m_uuid_to_handle.erase(m_render_objects[dense_idx].get_uuid());
+
+    // Swap last render object into removed spot to keep the array dense.
+    uint32_t last_dense_idx{ static_cast<uint32_t>(m_render_objects.size() - 1) };
+    if (dense_idx != last_dense_idx)
+    {
+        m_render_objects[dense_idx] = std::move(m_render_objects[last_dense_idx]);
+
+        uint32_t moved_slot_idx{ m_dense_idx_to_slot_idx[last_dense_idx] };
+        m_dense_idx_to_slot_idx[dense_idx] = moved_slot_idx;
+        m_slots[moved_slot_idx].dense_idx = dense_idx;
+    }
+    m_render_objects.pop_back();
+    m_dense_idx_to_slot_idx.pop_back();
+
+    // Invalidate handles to this slot and free it.
+    slot.generation++;
+    m_free_slot_idxs.emplace_back(handle.slot_idx);
+
     unblock();
 }
 
+bool BT::Render_object_pool::is_handle_valid(Render_object_handle handle) const
+{
+    return (!handle.is_nil() &&
+            handle.slot_idx < m_slots.size() &&
+            m_slots[handle.slot_idx].generation == handle.generation);
+}
+
 vector<BT::Render_object*> BT::Render_object_pool::checkout_all_render_objs()
 {
     wait_until_free_then_block();
@@ -90,53 +209,85 @@ vector<BT::Render_object*> BT::Render_object_pool::checkout_all_render_objs()
     vector<Render_object*> all_rend_objs;
     all_rend_objs.reserve(m_render_objects.size());
 
-    for (auto it = m_render_objects.begin(); it != m_render_objects.end(); it++)
+    for (auto& rend_obj : m_render_objects)
     {
-        all_rend_objs.emplace_back(&it->second);
+        all_rend_objs.emplace_back(&rend_obj);
     }
 
     return all_rend_objs;
 }
 
-vector<BT::Render_object*> BT::Render_object_pool::checkout_render_obj_by_key(vector<UUID>&& keys)
+void BT::Render_object_pool::return_render_objs(vector<Render_object*>&& render_objs)
+{
+    // Assumed that this is the end of using the renderobject list.
+    // @TODO: Prevent misuse of this function.
+    // (@IDEA: Make it so that instead of a vector use a class that has a release function or a dtor)
+    // @COPYPASTA: See `game_object.cpp`
+    (void)render_objs;
+    unblock();
+}
+
+BT::Render_object* BT::Render_object_pool::checkout_render_obj(Render_object_handle handle)
 {
     wait_until_free_then_block();
+    return find_render_obj(handle);
+}
 
-    vector<Render_object*> some_rend_objs;
-    some_rend_objs.reserve(keys.size());
+void BT::Render_object_pool::return_render_obj(Render_object* render_obj)
+{
+    (void)render_obj;
+    unblock();
+}
 
-    for (auto key : keys)
+void BT::Render_object_pool::checkout_render_objs(std::span<Render_object_handle const> handles,
+                                                  std::span<Render_object*> out_render_objs)
+{
+    assert(handles.size() == out_render_objs.size());
+
+    wait_until_free_then_block();
+    for (size_t i = 0; i < handles.size(); i++)
     {
-        if (key.is_nil())
-        {
-            logger::printe(logger::WARN, "Render object UUID is invalid");
-            assert(false);
-        }
-        else if (m_render_objects.find(key) == m_render_objects.end())
-        {
-            logger::printef(logger::WARN, "Render object UUID %s does not exist", UUID_helper::to_pretty_repr(key).c_str());
-            assert(false);
-        }
-        else
-        {
-            // Checkout render object.
-            some_rend_objs.emplace_back(&m_render_objects.at(key));
-        }
+        out_render_objs[i] = find_render_obj(handles[i]);
     }
-
-    return some_rend_objs;
 }
 
-void BT::Render_object_pool::return_render_objs(vector<Render_object*>&& render_objs)
+void BT::Render_object_pool::return_render_objs(std::span<Render_object* const> render_objs)
 {
-    // Assumed that this is the end of using the renderobject list.
-    // @TODO: Prevent misuse of this function.
-    // (@IDEA: Make it so that instead of a vector use a class that has a release function or a dtor)
-    // @COPYPASTA: See `game_object.cpp`
     (void)render_objs;
     unblock();
 }
 
+BT::Render_object_handle BT::Render_object_pool::get_handle(Render_object const& rend_obj) const
+{
+    assert(&rend_obj >= m_render_objects.data() &&
+           &rend_obj < m_render_objects.data() + m_render_objects.size());
+
+    uint32_t dense_idx{ static_cast<uint32_t>(&rend_obj - m_render_objects.data()) };
+    uint32_t slot_idx{ m_dense_idx_to_slot_idx[dense_idx] };
+    return { slot_idx, m_slots[slot_idx].generation };
+}
+
+BT::Render_object* BT::Render_object_pool::find_render_obj(Render_object_handle handle)
+{
+    if (handle.is_nil())
+    {
+        logger::printe(logger::WARN, "Render object handle is invalid");
+        assert(false);
+        return nullptr;
+    }
+    else if (!is_handle_valid(handle))
+    {
+        logger::printef(logger::WARN,
+                        "Render object handle (slot %u, generation %u) does not exist",
+                        handle.slot_idx,
+                        handle.generation);
+        assert(false);
+        return nullptr;
+    }
+
+    return &m_render_objects[m_slots[handle.slot_idx].dense_idx];
+}
+
 size_t BT::Render_object_pool::get_num_render_objects() const
 {
     return m_render_objects.size();
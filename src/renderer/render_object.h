@@ -7,15 +7,19 @@
 #include "material.h"
 #include "mesh.h"
 #include "model_animator.h"
+#include "render_object_handle.h"
 #include <atomic>
 #include <memory>
+#include <span>
 #include <string>
+#include <unordered_map>
 #include <vector>
 
 using std::atomic_bool;
 using std::atomic_uint64_t;
 using std::string;
 using std::unique_ptr;
+using std::unordered_map;
 using std::vector;
 
 
@@ -25,12 +29,23 @@ namespace BT
 class Game_object;
 class Physics_object;
 
+/// View info for picking LOD levels of render objects.
+struct Lod_view
+{
+    vec3 camera_position;
+    float_t pixels_per_unit;   // Screen pixels per world unit at distance 1 (or any if ortho).
+    bool is_orthographic;
+    float_t max_pixel_error;   // Max projected LOD error allowed.
+    float_t hysteresis_ratio;  // Switching to a coarser level needs error under `max * ratio`.
+};
+
 class Render_object : public UUID_ifc
 {
 public:
     Render_object(Render_layer layer);
 
     Renderable_ifc const* get_renderable() { return m_renderable; }
+    Render_layer get_layer() const { return m_layer; }
 
     void set_model(Model const* model)
     {
@@ -58,36 +73,88 @@ public:
     }
     Model_animator* get_model_animator() { return m_model_animator.get(); }
 
+    void set_occluder(bool is_occluder) { m_is_occluder = is_occluder; }
+    bool is_occluder() const { return m_is_occluder; }
+
+    /// Static render objects get drawn as part of the renderer's static batches instead of on
+    /// their own. Only applies to non-deformed models.
+    void set_static(bool is_static) { m_is_static = is_static; }
+    bool is_static() const { return m_is_static; }
+
+    /// Picks the coarsest LOD level whose error projects to under the max pixel error of
+    /// `lod_view`. Going coarser needs a lower error than going finer, so that render objects
+    /// around a switch distance don't flicker between levels.
+    void update_lod_level(Lod_view const& lod_view);
+    void reset_lod_level() { m_lod_level = 0; }
+    uint32_t get_lod_level() const { return m_lod_level; }
+
     /// Read and write handle for render transform.
     vec4* render_transform() { return m_render_transform; }
 
+    /// Calculates the world space bounds of the renderable using the render transform.
+    void calc_world_aabb(AA_bounding_box& out_aabb) const;
+
     void render(Render_layer active_layers,
                 Material_ifc* override_material = nullptr);
 
+    /// Adds draws of the renderable to `render_queue` if in `active_layers`.
+    void emplace_draws(Render_layer active_layers, Render_queue& render_queue);
+
 private:
     Render_layer m_layer;
     Renderable_ifc const* m_renderable;
     unique_ptr<Deformed_model> m_deformed_model{ nullptr };  // For owning a deformed model (since models are stored in a bank).
     unique_ptr<Model_animator> m_model_animator{ nullptr };
+    bool m_is_occluder{ false };
+    bool m_is_static{ false };
+    uint32_t m_lod_level{ 0 };
 
     mat4 m_render_transform = GLM_MAT4_IDENTITY_INIT;
 };
 
 // @COPYPASTA: Not quite copypasta. It's a little bit different.
+/// Generational slot map of render objects. Render objects are stored densely, and handles point
+/// to slots which point to the render object's current dense index.
 class Render_object_pool
 {
 public:
-    UUID emplace(Render_object&& rend_obj);
-    void remove(UUID key);
+    Render_object_handle emplace(Render_object&& rend_obj);
+    void remove(Render_object_handle handle);
+    bool is_handle_valid(Render_object_handle handle) const;
+
     vector<Render_object*> checkout_all_render_objs();
-    vector<Render_object*> checkout_render_obj_by_key(vector<UUID>&& keys);
     void return_render_objs(vector<Render_object*>&& render_objs);
 
+    /// Checks out a single render object. Return with `return_render_obj()`.
+    Render_object* checkout_render_obj(Render_object_handle handle);
+    void return_render_obj(Render_object* render_obj);
+
+    /// Checks out render objects of `handles` into `out_render_objs` (same size) without
+    /// allocating. Return with `return_render_objs()`.
+    void checkout_render_objs(std::span<Render_object_handle const> handles,
+                              std::span<Render_object*> out_render_objs);
+    void return_render_objs(std::span<Render_object* const> render_objs);
+
+    /// Gets handle of a render object in this pool (e.g. one from `checkout_all_render_objs()`).
+    Render_object_handle get_handle(Render_object const& rend_obj) const;
+
     /// Gets number of render objects in this pool.
     size_t get_num_render_objects() const;
 
 private:
-    unordered_map<UUID, Render_object> m_render_objects;
+    struct Slot
+    {
+        uint32_t dense_idx;
+        uint32_t generation;
+    };
+
+    vector<Render_object> m_render_objects;  // Dense.
+    vector<uint32_t> m_dense_idx_to_slot_idx;
+    vector<Slot> m_slots;
+    vector<uint32_t> m_free_slot_idxs;
+    unordered_map<UUID, Render_object_handle> m_uuid_to_handle;  // Catches duplicate UUIDs.
+
+    Render_object* find_render_obj(Render_object_handle handle);
 
     // Synchronization.
     atomic_bool m_blocked{ false };
@@ -0,0 +1,23 @@
+#pragma once
+
+#include <cstdint>
+
+
+namespace BT
+{
+
+/// Stable reference to a render object inside `Render_object_pool`.
+/// Once the render object is removed, the handle becomes stale (generation mismatch) instead of
+/// pointing to whatever render object reuses the slot.
+struct Render_object_handle
+{
+    static constexpr uint32_t k_invalid_slot_idx{ (uint32_t)-1 };
+
+    uint32_t slot_idx{ k_invalid_slot_idx };
+    uint32_t generation{ 0 };
+
+    bool is_nil() const { return (slot_idx == k_invalid_slot_idx); }
+    bool operator==(Render_object_handle const& other) const = default;
+};
+
+}  // namespace BT
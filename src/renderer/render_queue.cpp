@@ -0,0 +1,350 @@
+#include "render_queue.h"
+
+#include "glad/glad.h"
+#include "gl_state_cache.h"
+#include "material.h"
+#include "shader.h"
+#include "stream_buffer.h"
+#include <algorithm>
+#include <cassert>
+#include <cstring>
+
+
+namespace
+{
+
+void set_use_instance_transforms(BT::Material_ifc const& material, bool use)
+{
+    auto const& shader{ material.get_shader() };
+    shader.set_int(shader.get_uniform_location(BT::Shader::UNIFORM_USE_INSTANCE_TRANSFORMS),
+                   use ? 1 : 0);
+}
+
+}  // namespace
+
+
+uint64_t BT::Render_queue::make_sort_key(Render_layer layer,
+                                         uint16_t shader_id,
+                                         uint16_t material_id,
+                                         uint32_t mesh_id)
+{
+    assert(mesh_id <= 0xFFFFFF);
+    return ((static_cast<uint64_t>(layer) << 56) |
+            (static_cast<uint64_t>(shader_id) << 40) |
+            (static_cast<uint64_t>(material_id) << 24) |
+            (static_cast<uint64_t>(mesh_id) & 0xFFFFFF));
+}
+
+uint16_t BT::Render_queue::get_shader_id_from_sort_key(uint64_t sort_key)
+{
+    return static_cast<uint16_t>((sort_key >> 40) & 0xFFFF);
+}
+
+void BT::Render_queue::clear()
+{
+    m_draw_items.clear();
+}
+
+void BT::Render_queue::emplace_draw(Render_layer layer,
+                                    Material_ifc& material,
+                                    uint32_t mesh_id,
+                                    uint32_t vertex_vao,
+                                    uint32_t index_ebo,
+                                    uint32_t num_indices,
+                                    mat4 transform,
+                                    uint32_t first_index /*= 0*/,
+                                    int32_t base_vertex /*= 0*/)
+{
+    emplace_draw_item(Draw_item{ make_sort_key(layer,
+                                               material.get_shader().get_sort_id(),
+                                               material.get_material_sort_id(),
+                                               mesh_id),
+                                 &material,
+                                 vertex_vao,
+                                 index_ebo,
+                                 num_indices,
+                                 transform,
+                                 first_index,
+                                 base_vertex });
+}
+
+void BT::Render_queue::emplace_draw_item(Draw_item const& draw_item)
+{
+    m_draw_items.emplace_back(draw_item);
+}
+
+void BT::Render_queue::sort()
+{
+    std::sort(m_draw_items.begin(),
+              m_draw_items.end(),
+              [](Draw_item const& a, Draw_item const& b) { return a.sort_key < b.sort_key; });
+    build_instance_batches();
+    build_multi_draw_groups();
+}
+
+BT::Render_queue::Stats BT::Render_queue::calc_stats() const
+{
+    Stats stats;
+
+    Material_ifc* prev_material{ nullptr };
+    uint32_t prev_vao{ 0 };
+    for (size_t i = 0; i < m_instance_batches.size(); i++)
+    {
+        auto const& batch{ m_instance_batches[i] };
+        auto const& draw_item{ m_draw_items[batch.first_draw_item_idx] };
+
+        if (i == 0 ||
+            get_shader_id_from_sort_key(draw_item.sort_key) !=
+                get_shader_id_from_sort_key(
+                    m_draw_items[m_instance_batches[i - 1].first_draw_item_idx].sort_key))
+            stats.num_shader_changes++;
+
+        if (draw_item.material != prev_material)
+        {
+            stats.num_material_binds++;
+            prev_material = draw_item.material;
+        }
+
+        if (draw_item.vertex_vao != prev_vao)
+        {
+            stats.num_vao_binds++;
+            prev_vao = draw_item.vertex_vao;
+        }
+
+        stats.num_draws++;
+        stats.num_instances += batch.num_instances;
+    }
+
+    return stats;
+}
+
+void BT::Render_queue::submit_draws(Stream_buffer& stream_buffer)
+{
+    m_stats_last_submit = calc_stats();
+
+    bool use_instancing{ m_instancing_enabled && !m_instance_transforms.empty() &&
+                         upload_instance_transforms(stream_buffer) };
+
+    Stream_buffer::Allocation indirect_commands_allocation;
+    if (use_instancing && m_multi_draw_indirect_enabled)
+    {
+        indirect_commands_allocation = stream_buffer.allocate(
+            m_indirect_commands.size() * sizeof(Draw_elements_indirect_command));
+        if (indirect_commands_allocation.data != nullptr)
+            memcpy(indirect_commands_allocation.data,
+                   m_indirect_commands.data(),
+                   indirect_commands_allocation.size);
+    }
+
+    if (indirect_commands_allocation.data != nullptr)
+    {
+        glBindBuffer(GL_DRAW_INDIRECT_BUFFER, stream_buffer.get_buffer());
+        submit_multi_draw_groups(indirect_commands_allocation.offset);
+        glBindBuffer(GL_DRAW_INDIRECT_BUFFER, 0);
+        m_stats_last_submit.num_draws = m_multi_draw_groups.size();
+    }
+    else
+    {
+        submit_instance_batches(use_instancing);
+    }
+
+    // Unbind.
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
+    get_main_gl_state_cache().bind_vertex_array(0);
+    glBindBufferBase(GL_SHADER_STORAGE_BUFFER, Shader::k_instance_transforms_ssbo_binding, 0);
+}
+
+void BT::Render_queue::build_instance_batches()
+{
+    m_instance_batches.clear();
+    m_instance_transforms.resize(m_draw_items.size());
+
+    for (size_t i = 0; i < m_draw_items.size(); i++)
+    {
+        auto const& draw_item{ m_draw_items[i] };
+        glm_mat4_copy(draw_item.transform, m_instance_transforms[i].raw);
+
+        bool can_join_batch{ false };
+        if (m_instancing_enabled && !m_instance_batches.empty())
+        {   // Check if same mesh, material, and vertex array as previous batch.
+            auto const& batch_draw_item{
+                m_draw_items[m_instance_batches.back().first_draw_item_idx] };
+            can_join_batch = (draw_item.sort_key == batch_draw_item.sort_key &&
+                              draw_item.material == batch_draw_item.material &&
+                              draw_item.vertex_vao == batch_draw_item.vertex_vao &&
+                              draw_item.index_ebo == batch_draw_item.index_ebo &&
+                              draw_item.num_indices == batch_draw_item.num_indices &&
+                              draw_item.first_index == batch_draw_item.first_index &&
+                              draw_item.base_vertex == batch_draw_item.base_vertex);
+        }
+
+        if (can_join_batch)
+            m_instance_batches.back().num_instances++;
+        else
+            m_instance_batches.emplace_back(static_cast<uint32_t>(i), 1u);
+    }
+}
+
+void BT::Render_queue::build_multi_draw_groups()
+{
+    m_indirect_commands.clear();
+    m_multi_draw_groups.clear();
+
+    Draw_item const* prev_draw_item{ nullptr };
+    for (auto const& batch : m_instance_batches)
+    {
+        auto const& draw_item{ m_draw_items[batch.first_draw_item_idx] };
+
+        // @NOTE: Base instance points to the batch's transforms in the instance transforms SSBO.
+        m_indirect_commands.emplace_back(draw_item.num_indices,
+                                         batch.num_instances,
+                                         draw_item.first_index,
+                                         draw_item.base_vertex,
+                                         batch.first_draw_item_idx);
+
+        bool can_join_group{ prev_draw_item != nullptr &&
+                             draw_item.material == prev_draw_item->material &&
+                             draw_item.vertex_vao == prev_draw_item->vertex_vao &&
+                             draw_item.index_ebo == prev_draw_item->index_ebo };
+        if (can_join_group)
+            m_multi_draw_groups.back().num_commands++;
+        else
+            m_multi_draw_groups.emplace_back(
+                static_cast<uint32_t>(m_indirect_commands.size() - 1), 1u);
+
+        prev_draw_item = &draw_item;
+    }
+}
+
+void BT::Render_queue::submit_instance_batches(bool use_instancing)
+{
+    Material_ifc* bound_material{ nullptr };
+    uint32_t bound_vao{ 0 };
+    uint32_t bound_ebo{ 0 };
+    for (auto const& batch : m_instance_batches)
+    {
+        auto const& draw_item{ m_draw_items[batch.first_draw_item_idx] };
+
+        if (draw_item.material != bound_material)
+        {   // Switch material.
+            if (bound_material != nullptr)
+            {
+                if (use_instancing)
+                    set_use_instance_transforms(*bound_material, false);
+                bound_material->unbind_material();
+            }
+            draw_item.material->bind_material_shared();
+            if (use_instancing)
+                set_use_instance_transforms(*draw_item.material, true);
+            bound_material = draw_item.material;
+        }
+
+        if (draw_item.vertex_vao != bound_vao)
+        {   // @NOTE: Element array buffer binding is part of VAO state, so it needs rebinding too.
+            get_main_gl_state_cache().bind_vertex_array(draw_item.vertex_vao);
+            bound_vao = draw_item.vertex_vao;
+            bound_ebo = 0;
+        }
+
+        if (draw_item.index_ebo != bound_ebo)
+        {
+            glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, draw_item.index_ebo);
+            bound_ebo = draw_item.index_ebo;
+        }
+
+        auto indices_offset{
+            reinterpret_cast<void*>(static_cast<size_t>(draw_item.first_index) * sizeof(uint32_t))
+        };
+        if (use_instancing)
+        {
+            glDrawElementsInstancedBaseVertexBaseInstance(GL_TRIANGLES,
+                                                          draw_item.num_indices,
+                                                          GL_UNSIGNED_INT,
+                                                          indices_offset,
+                                                          batch.num_instances,
+                                                          draw_item.base_vertex,
+                                                          batch.first_draw_item_idx);
+        }
+        else
+        {   // Draw each instance of batch with its own transform.
+            for (uint32_t i = 0; i < batch.num_instances; i++)
+            {
+                bound_material->set_material_transform(
+                    m_draw_items[batch.first_draw_item_idx + i].transform);
+                glDrawElementsBaseVertex(GL_TRIANGLES,
+                                         draw_item.num_indices,
+                                         GL_UNSIGNED_INT,
+                                         indices_offset,
+                                         draw_item.base_vertex);
+            }
+        }
+    }
+
+    if (bound_material != nullptr)
+    {
+        if (use_instancing)
+            set_use_instance_transforms(*bound_material, false);
+        bound_material->unbind_material();
+    }
+}
+
+void BT::Render_queue::submit_multi_draw_groups(size_t indirect_commands_offset)
+{
+    Material_ifc* bound_material{ nullptr };
+    uint32_t bound_vao{ 0 };
+    for (auto const& group : m_multi_draw_groups)
+    {
+        auto const& draw_item{
+            m_draw_items[m_instance_batches[group.first_command_idx].first_draw_item_idx] };
+
+        if (draw_item.material != bound_material)
+        {   // Switch material.
+            if (bound_material != nullptr)
+            {
+                set_use_instance_transforms(*bound_material, false);
+                bound_material->unbind_material();
+            }
+            draw_item.material->bind_material_shared();
+            set_use_instance_transforms(*draw_item.material, true);
+            bound_material = draw_item.material;
+        }
+
+        if (draw_item.vertex_vao != bound_vao)
+        {
+            get_main_gl_state_cache().bind_vertex_array(draw_item.vertex_vao);
+            bound_vao = draw_item.vertex_vao;
+        }
+        glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, draw_item.index_ebo);
+
+        glMultiDrawElementsIndirect(
+            GL_TRIANGLES,
+            GL_UNSIGNED_INT,
+            reinterpret_cast<void*>(indirect_commands_offset +
+                                    group.first_command_idx *
+                                        sizeof(Draw_elements_indirect_command)),
+            group.num_commands,
+            0);
+    }
+
+    if (bound_material != nullptr)
+    {
+        set_use_instance_transforms(*bound_material, false);
+        bound_material->unbind_material();
+    }
+}
+
+bool BT::Render_queue::upload_instance_transforms(Stream_buffer& stream_buffer)
+{
+    auto allocation{ stream_buffer.allocate(m_instance_transforms.size() * sizeof(mat4s)) };
+    if (allocation.data == nullptr)
+        return false;
+
+    memcpy(allocation.data, m_instance_transforms.data(), allocation.size);
+
+    glBindBufferRange(GL_SHADER_STORAGE_BUFFER,
+                      Shader::k_instance_transforms_ssbo_binding,
+                      stream_buffer.get_buffer(),
+                      allocation.offset,
+                      allocation.size);
+    return true;
+}
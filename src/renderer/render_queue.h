@@ -0,0 +1,148 @@
+#pragma once
+
+#include "btglm.h"
+#include "render_layer.h"
+
+#include <cstdint>
+#include <vector>
+
+using std::vector;
+
+
+namespace BT
+{
+
+class Material_ifc;
+class Stream_buffer;
+
+/// Draw list of all meshes to render in a pass, sorted by key so that shader and material state
+/// only get bound when they change between draws.
+/// Consecutive draws of the same mesh with the same material and vertex array get grouped into
+/// instance batches, drawn with one instanced draw call reading transforms from an SSBO.
+/// Building, sorting and batching the draw list does not touch OpenGL, only `submit_draws()` does.
+/// Instance transforms get written into the frame's region of a persistently mapped stream buffer.
+/// Consecutive instance batches sharing material and geometry buffers (e.g. static models packed
+/// into the same geometry arena) get merged into one multi-draw indirect call.
+class Render_queue
+{
+public:
+    struct Draw_item
+    {
+        uint64_t sort_key;
+        Material_ifc* material;
+        uint32_t vertex_vao;
+        uint32_t index_ebo;
+        uint32_t num_indices;
+        vec4* transform;  // Must stay alive until `submit_draws()`.
+        uint32_t first_index;
+        int32_t base_vertex;
+    };
+
+    /// Range of draw items drawn with one draw call. Instance transforms of the batch are at
+    /// [`first_draw_item_idx`, `first_draw_item_idx + num_instances`) in the transforms array.
+    struct Instance_batch
+    {
+        uint32_t first_draw_item_idx;
+        uint32_t num_instances;
+    };
+
+    /// @NOTE: Layout is fixed by `glMultiDrawElementsIndirect()`.
+    struct Draw_elements_indirect_command
+    {
+        uint32_t count;
+        uint32_t instance_count;
+        uint32_t first_index;
+        int32_t base_vertex;
+        uint32_t base_instance;
+    };
+
+    /// Consecutive instance batches with the same material, vertex array and index buffer. Their
+    /// commands are at [`first_command_idx`, `first_command_idx + num_commands`).
+    struct Multi_draw_group
+    {
+        uint32_t first_command_idx;
+        uint32_t num_commands;
+    };
+
+    struct Stats
+    {
+        size_t num_draws{ 0 };  // Draw calls.
+        size_t num_instances{ 0 };
+        size_t num_shader_changes{ 0 };
+        size_t num_material_binds{ 0 };
+        size_t num_vao_binds{ 0 };
+    };
+
+    /// Sort key layout (MSB to LSB): layer (8 bits), shader (16 bits), material (16 bits),
+    /// mesh (24 bits).
+    static uint64_t make_sort_key(Render_layer layer,
+                                  uint16_t shader_id,
+                                  uint16_t material_id,
+                                  uint32_t mesh_id);
+    static uint16_t get_shader_id_from_sort_key(uint64_t sort_key);
+
+    void clear();
+    void emplace_draw(Render_layer layer,
+                      Material_ifc& material,
+                      uint32_t mesh_id,
+                      uint32_t vertex_vao,
+                      uint32_t index_ebo,
+                      uint32_t num_indices,
+                      mat4 transform,
+                      uint32_t first_index = 0,
+                      int32_t base_vertex  = 0);
+
+    /// Adds a draw item w/ its sort key already made.
+    void emplace_draw_item(Draw_item const& draw_item);
+
+    /// Sorts draw items, then groups them into instance batches and multi-draw groups.
+    void sort();
+
+    vector<Draw_item> const& get_draw_items() const { return m_draw_items; }
+    vector<Instance_batch> const& get_instance_batches() const { return m_instance_batches; }
+    vector<mat4s> const& get_instance_transforms() const { return m_instance_transforms; }
+    vector<Draw_elements_indirect_command> const& get_indirect_commands() const
+    {
+        return m_indirect_commands;
+    }
+    vector<Multi_draw_group> const& get_multi_draw_groups() const { return m_multi_draw_groups; }
+
+    /// With instancing off, every draw item is its own batch and sets its transform as a uniform.
+    void set_instancing_enabled(bool enabled) { m_instancing_enabled = enabled; }
+    bool get_instancing_enabled() const { return m_instancing_enabled; }
+
+    /// Multi-draw indirect only gets used if instancing is on too.
+    void set_multi_draw_indirect_enabled(bool enabled) { m_multi_draw_indirect_enabled = enabled; }
+    bool get_multi_draw_indirect_enabled() const { return m_multi_draw_indirect_enabled; }
+
+    /// Counts the state changes that `submit_draws()` would do with the current draw list.
+    Stats calc_stats() const;
+
+    /// Binds state on transitions and draws all instance batches in order.
+    /// Falls back to non-instanced draws if the instance transforms don't fit in `stream_buffer`.
+    void submit_draws(Stream_buffer& stream_buffer);
+
+    /// Stats from the latest `submit_draws()`.
+    Stats const& get_stats_last_submit() const { return m_stats_last_submit; }
+
+private:
+    vector<Draw_item> m_draw_items;
+    vector<Instance_batch> m_instance_batches;
+    vector<mat4s> m_instance_transforms;  // Same order as draw items.
+    vector<Draw_elements_indirect_command> m_indirect_commands;  // One per instance batch.
+    vector<Multi_draw_group> m_multi_draw_groups;
+    bool m_instancing_enabled{ true };
+    bool m_multi_draw_indirect_enabled{ true };
+    Stats m_stats_last_submit;
+
+    void build_instance_batches();
+    void build_multi_draw_groups();
+
+    void submit_instance_batches(bool use_instancing);
+    void submit_multi_draw_groups(size_t indirect_commands_offset);
+
+    /// Returns false if there wasn't enough space.
+    bool upload_instance_transforms(Stream_buffer& stream_buffer);
+};
+
+}  // namespace BT
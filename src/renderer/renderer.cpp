@@ -52,6 +52,93 @@ BT::Render_object_pool& BT::Renderer::get_render_object_pool()
     return m_pimpl->get_render_object_pool();
 }
 
+// Render stats.
+BT::Renderer::Render_stats BT::Renderer::get_render_stats() const
+{
+    return m_pimpl->get_render_stats();
+}
+
+// Instancing.
+void BT::Renderer::set_instancing_enabled(bool enabled)
+{
+    m_pimpl->set_instancing_enabled(enabled);
+}
+
+bool BT::Renderer::get_instancing_enabled() const
+{
+    return m_pimpl->get_instancing_enabled();
+}
+
+void BT::Renderer::set_multi_draw_indirect_enabled(bool enabled)
+{
+    m_pimpl->set_multi_draw_indirect_enabled(enabled);
+}
+
+bool BT::Renderer::get_multi_draw_indirect_enabled() const
+{
+    return m_pimpl->get_multi_draw_indirect_enabled();
+}
+
+void BT::Renderer::set_occlusion_culling_enabled(bool enabled)
+{
+    m_pimpl->set_occlusion_culling_enabled(enabled);
+}
+
+bool BT::Renderer::get_occlusion_culling_enabled() const
+{
+    return m_pimpl->get_occlusion_culling_enabled();
+}
+
+void BT::Renderer::set_lod_enabled(bool enabled)
+{
+    m_pimpl->set_lod_enabled(enabled);
+}
+
+bool BT::Renderer::get_lod_enabled() const
+{
+    return m_pimpl->get_lod_enabled();
+}
+
+void BT::Renderer::set_static_batching_enabled(bool enabled)
+{
+    m_pimpl->set_static_batching_enabled(enabled);
+}
+
+bool BT::Renderer::get_static_batching_enabled() const
+{
+    return m_pimpl->get_static_batching_enabled();
+}
+
+void BT::Renderer::set_dynamic_resolution_enabled(bool enabled)
+{
+    m_pimpl->set_dynamic_resolution_enabled(enabled);
+}
+
+bool BT::Renderer::get_dynamic_resolution_enabled() const
+{
+    return m_pimpl->get_dynamic_resolution_enabled();
+}
+
+void BT::Renderer::set_gl_state_cache_enabled(bool enabled)
+{
+    m_pimpl->set_gl_state_cache_enabled(enabled);
+}
+
+bool BT::Renderer::get_gl_state_cache_enabled() const
+{
+    return m_pimpl->get_gl_state_cache_enabled();
+}
+
+void BT::Renderer::set_cpu_picking_enabled(bool enabled)
+{
+    m_pimpl->set_cpu_picking_enabled(enabled);
+}
+
+bool BT::Renderer::get_cpu_picking_enabled() const
+{
+    return m_pimpl->get_cpu_picking_enabled();
+}
+
 // App settings.
 void BT::Renderer::save_state_to_app_settings() const
 {
@@ -49,6 +49,65 @@ public:
 
     // Create image texture.
 
+    // Render stats.
+    // @NOTE: Render object counts don't include static batched render objects. Those get culled
+    //        (and counted) per static batch.
+    struct Render_stats
+    {
+        size_t num_visible_render_objs{ 0 };
+        size_t num_culled_render_objs{ 0 };
+        size_t num_occluded_render_objs{ 0 };  // Not included in culled count.
+        size_t num_occluders{ 0 };
+        float_t occlusion_cull_time{ 0.0f };  // Seconds.
+        size_t num_reduced_lod_render_objs{ 0 };  // Visible render objects not at full detail.
+        size_t num_static_batches{ 0 };
+        size_t num_culled_static_batches{ 0 };
+        size_t num_occluded_static_batches{ 0 };  // Not included in culled count.
+        size_t num_static_batched_render_objs{ 0 };
+        float_t render_scale{ 1.0f };  // Dynamic resolution scale of the scene render.
+        float_t scene_gpu_time{ 0.0f };  // Seconds. Scene draws, from a few frames ago.
+        size_t num_draw_calls{ 0 };
+        size_t num_instances{ 0 };
+        size_t num_cpu_picks{ 0 };
+        size_t num_gpu_picks{ 0 };  // Picks that fell back to the picking framebuffer.
+        size_t stream_buffer_bytes_used{ 0 };
+        size_t num_stream_buffer_waits{ 0 };
+        size_t num_gl_state_calls{ 0 };  // Last frame, that went thru to GL.
+        size_t num_gl_state_calls_skipped{ 0 };  // Last frame, redundant so filtered out.
+        float_t cpu_skinning_vertices_per_second{ 0.0f };  // Latest CPU skinned render object.
+    };
+    Render_stats get_render_stats() const;
+
+    // Instancing (off draws every mesh of every render object separately, for comparing).
+    void set_instancing_enabled(bool enabled);
+    bool get_instancing_enabled() const;
+    void set_multi_draw_indirect_enabled(bool enabled);
+    bool get_multi_draw_indirect_enabled() const;
+
+    // Occlusion culling (objects marked as occluders hide other render objects behind them).
+    void set_occlusion_culling_enabled(bool enabled);
+    bool get_occlusion_culling_enabled() const;
+
+    // LOD (off draws every model at full detail, for comparing).
+    void set_lod_enabled(bool enabled);
+    bool get_lod_enabled() const;
+
+    // Static batching (off draws static render objects on their own, for comparing).
+    void set_static_batching_enabled(bool enabled);
+    bool get_static_batching_enabled() const;
+
+    // Dynamic resolution (off always renders the scene at full viewport resolution).
+    void set_dynamic_resolution_enabled(bool enabled);
+    bool get_dynamic_resolution_enabled() const;
+
+    // GL state cache (off issues every GL state call, even redundant ones, for comparing).
+    void set_gl_state_cache_enabled(bool enabled);
+    bool get_gl_state_cache_enabled() const;
+
+    // Picking (off always uses the picking framebuffer, for comparing).
+    void set_cpu_picking_enabled(bool enabled);
+    bool get_cpu_picking_enabled() const;
+
     // App settings.
     void save_state_to_app_settings() const;
 
@@ -14,28 +14,36 @@
 #include "../input_handler/input_handler.h"
 #include "btglm.h"
 #include "btlogger.h"
+#include "cpu_skinning.h"
 #include "debug_render_job.h"
 #include "entt/entity/entity.hpp"
 #include "game_system_logic/entity_container.h"
 #include "game_system_logic/component/render_object_settings.h"
 #include "game_system_logic/system/imgui_render_transform_hierarchy_window.h"
+#include "gl_state_cache.h"
 #include "material.h"
 #include "material_impl_debug_picking.h"
 #include "material_impl_debug_lines.h"
+#include "material_impl_post_process.h"
+#include "mesh_skinning_batch.h"
 #include "render_object.h"
 #include "renderer.h"
 #include "renderer/model_animator.h"
 #include "service_finder/service_finder.h"
 #include "settings/settings.h"
+#include "shader.h"
 #include "stb_image.h"
 #define STB_IMAGE_RESIZE_IMPLEMENTATION
 #include "stb_image_resize2.h"
 #include "texture.h"
+#include "timer/timer.h"
 
 #include <array>
 #include <algorithm>
 #include <memory>
 #include <cassert>
+#include <cmath>
+#include <cstring>
 #include <gl/gl.h>
 #include <mutex>
 #include <sstream>
@@ -167,11 +175,16 @@ BT::Renderer::Impl::Impl(Renderer& renderer, ImGui_renderer& imgui_renderer, Inp
 
     calc_window_dim_pos_and_apply_window_hints();
     create_window_with_gfx_context(title);
+    set_main_gl_state_cache(
+        std::make_unique<Gl_state_cache>(std::make_unique<Gl_state_backend_opengl>()));
 
     setup_imgui();
     create_ldr_fbo();
     create_hdr_fbo();
     create_picking_fbo();
+    create_camera_ubo();
+    create_gpu_timer_queries();
+    m_stream_buffer = std::make_unique<Stream_buffer>(k_stream_buffer_region_size);
 
     m_camera.set_callbacks(
         [&](bool lock) {
@@ -197,6 +210,10 @@ BT::Renderer::Impl::Impl(Renderer& renderer, ImGui_renderer& imgui_renderer, Inp
 
 BT::Renderer::Impl::~Impl()
 {
+    m_stream_buffer.reset();
+    m_static_batches.clear();
+    glDeleteQueries(k_num_gpu_timer_queries, m_gpu_timer_queries);
+
     ImGui_ImplOpenGL3_Shutdown();
     ImGui_ImplGlfw_Shutdown();
     ImGui::DestroyContext();
@@ -231,11 +248,23 @@ void BT::Renderer::Impl::render(float_t delta_time)
         create_picking_fbo();
         m_camera.set_aspect_ratio(m_main_viewport_dims.width,
                                   m_main_viewport_dims.height);
+        m_dynamic_resolution.reset();
     }
 
+    // Count GL state calls per frame, and don't trust state from last frame (eg. ImGui).
+    auto& gl_state{ get_main_gl_state_cache() };
+    gl_state.begin_frame();
+    m_render_stats.num_gl_state_calls         = gl_state.get_stats_last_frame().num_issued;
+    m_render_stats.num_gl_state_calls_skipped = gl_state.get_stats_last_frame().num_skipped;
+    m_render_stats.cpu_skinning_vertices_per_second =
+        cpu_skinning::get_vertices_per_second_last_skin();
+
+    update_dynamic_resolution();
+
     // Update camera.
     m_camera.update_frontend(m_input_handler.get_input_state(), delta_time);
     m_camera.update_camera_matrices();
+    upload_camera_ubo();
 
     // Update skeletal animations.
     bool dispatched_mesh_skinning{
@@ -243,6 +272,7 @@ void BT::Renderer::Impl::render(float_t delta_time)
 
     // Render new frame.
     begin_new_display_frame();
+    m_stream_buffer->begin_frame();
     if (dispatched_mesh_skinning)
     {
         memory_barrier_for_mesh_skinning();
@@ -250,12 +280,24 @@ void BT::Renderer::Impl::render(float_t delta_time)
 
     render_scene_to_hdr_framebuffer();
     if (is_requesting_picking())
-    {
-        render_scene_to_picking_framebuffer();
+    {   // Try CPU picking first, and only use GPU picking if it couldn't give an exact answer.
+        if (!m_cpu_picking_enabled || !pick_scene_with_cpu_ray())
+        {
+            render_scene_to_picking_framebuffer();
+            m_render_stats.num_gpu_picks++;
+        }
+        else
+        {
+            m_render_stats.num_cpu_picks++;
+        }
     }
 
     render_hdr_color_to_ldr_framebuffer();
     render_debug_views_to_ldr_framebuffer(delta_time);
+    m_stream_buffer->end_frame();
+    auto const& stream_buffer_stats{ m_stream_buffer->get_stats() };
+    m_render_stats.stream_buffer_bytes_used = stream_buffer_stats.bytes_allocated_last_frame;
+    m_render_stats.num_stream_buffer_waits  = stream_buffer_stats.num_fence_waits;
     render_imgui(delta_time);
 
     present_display_frame();
@@ -664,17 +706,78 @@ void BT::Renderer::Impl::render_imgui(float_t delta_time)
     }
 }
 
+// Dynamic resolution.
+void BT::Renderer::Impl::create_gpu_timer_queries()
+{
+    glGenQueries(k_num_gpu_timer_queries, m_gpu_timer_queries);
+}
+
+void BT::Renderer::Impl::update_dynamic_resolution()
+{
+    size_t query_idx{ m_next_gpu_timer_query_idx };
+    if (m_gpu_timer_queries_pending[query_idx])
+    {   // Read without stalling. If not done yet, it gets skipped for timing this frame.
+        int32_t available{ GL_FALSE };
+        glGetQueryObjectiv(m_gpu_timer_queries[query_idx], GL_QUERY_RESULT_AVAILABLE, &available);
+        if (available)
+        {
+            uint64_t elapsed_ns{ 0 };
+            glGetQueryObjectui64v(m_gpu_timer_queries[query_idx], GL_QUERY_RESULT, &elapsed_ns);
+            m_gpu_timer_queries_pending[query_idx] = false;
+
+            float_t gpu_time{ static_cast<float_t>(elapsed_ns * 1e-9) };
+            m_render_stats.scene_gpu_time = gpu_time;
+            if (m_dynamic_resolution_enabled)
+                m_dynamic_resolution.submit_frame_time(gpu_time);
+        }
+    }
+
+    if (!m_dynamic_resolution_enabled)
+        m_dynamic_resolution.reset();
+
+    m_dynamic_resolution.calc_scaled_dims(m_main_viewport_dims.width,
+                                          m_main_viewport_dims.height,
+                                          m_hdr_render_dims.width,
+                                          m_hdr_render_dims.height);
+    m_render_stats.render_scale = m_dynamic_resolution.get_render_scale();
+}
+
 // Skeletal animation compute.
 bool BT::Renderer::Impl::update_animators_and_compute_mesh_skinning(float_t delta_time)
 {
     bool mutated{ false };
 
+    // Camera info for animator LOD selection.
+    vec3 camera_position;
+    m_camera.get_position(camera_position);
+
+    mat4 projection;
+    mat4 view;
+    mat4 projection_view;
+    m_camera.fetch_calculated_camera_matrices(projection, view, projection_view);
+
+    vec4 frustum_planes[6];
+    glm_frustum_planes(projection_view, frustum_planes);
+
     auto rend_objs{ m_rend_obj_pool.checkout_all_render_objs() };
     for (auto rend_obj : rend_objs)
         if (rend_obj->get_deformed_model() != nullptr)
         {
             auto& animator{ *rend_obj->get_model_animator() };
-            animator.update(Model_animator::RENDERER_PROFILE, delta_time);
+            animator.update(Model_animator::RENDERER_PROFILE, delta_time);  // Time always advances.
+
+            AA_bounding_box world_aabb;
+            rend_obj->calc_world_aabb(world_aabb);
+            animator.set_renderer_lod_tier(
+                Model_animator::calc_renderer_lod_tier(camera_position,
+                                                       frustum_planes,
+                                                       world_aabb.min,
+                                                       world_aabb.max));
+
+            if (!animator.tick_renderer_lod_pose_timer(delta_time))
+            {   // Keep last skinned pose (or skip entirely if offscreen).
+                continue;
+            }
 
             std::vector<mat4s> joint_matrices;
             if (animator.get_is_using_root_motion())
@@ -683,10 +786,12 @@ bool BT::Renderer::Impl::update_animators_and_compute_mesh_skinning(float_t delt
             else
                 animator.calc_anim_pose(Model_animator::RENDERER_PROFILE, joint_matrices);
 
-            rend_obj->get_deformed_model()->dispatch_compute_deform(std::move(joint_matrices));
-
-            mutated = true;
+            rend_obj->get_deformed_model()->submit_compute_deform(std::move(joint_matrices));
         }
+
+    // Skin all submitted deformed models at once.
+    mutated = Mesh_skinning_batch::dispatch();
+
     m_rend_obj_pool.return_render_objs(std::move(rend_objs));
 
     return mutated;
@@ -699,9 +804,40 @@ void BT::Renderer::Impl::memory_barrier_for_mesh_skinning()
 }
 
 
+// Per-frame camera uniforms.
+void BT::Renderer::Impl::create_camera_ubo()
+{
+    assert(m_camera_ubo == 0);
+
+    glGenBuffers(1, &m_camera_ubo);
+    glBindBuffer(GL_UNIFORM_BUFFER, m_camera_ubo);
+    glBufferData(GL_UNIFORM_BUFFER, sizeof(Gpu_camera_data), nullptr, GL_DYNAMIC_DRAW);
+    glBindBuffer(GL_UNIFORM_BUFFER, 0);
+
+    // @NOTE: Stays bound for the lifetime of the renderer.
+    glBindBufferBase(GL_UNIFORM_BUFFER, Shader::k_camera_ubo_binding, m_camera_ubo);
+}
+
+void BT::Renderer::Impl::upload_camera_ubo()
+{
+    Gpu_camera_data camera_data;
+    m_camera.fetch_calculated_camera_matrices(camera_data.projection.raw,
+                                              camera_data.view.raw,
+                                              camera_data.projection_view.raw);
+    vec3 camera_position;
+    m_camera.get_position(camera_position);
+    glm_vec4(camera_position, 1.0f, camera_data.position.raw);
+
+    glBindBuffer(GL_UNIFORM_BUFFER, m_camera_ubo);
+    glBufferSubData(GL_UNIFORM_BUFFER, 0, sizeof(Gpu_camera_data), &camera_data);
+    glBindBuffer(GL_UNIFORM_BUFFER, 0);
+}
+
 // Display rendering.
 void BT::Renderer::Impl::create_ldr_fbo()  // @COPYPASTA: see `create_hdr_fbo()`.
 {
+    auto& gl_state{ get_main_gl_state_cache() };
+
     if (m_ldr_fbo != 0 || m_ldr_color_texture != 0 || m_ldr_depth_rbo != 0)
     {
         // Double check that everything is fully created prior to deleting to recreate.
@@ -711,11 +847,14 @@ void BT::Renderer::Impl::create_ldr_fbo()  // @COPYPASTA: see `create_hdr_fbo()`
         glDeleteFramebuffers(1, &m_ldr_fbo);
         glDeleteTextures(1, &m_ldr_color_texture);
         glDeleteRenderbuffers(1, &m_ldr_depth_rbo);
+
+        // Deleted objects may still be bound, and their names may get reused.
+        gl_state.invalidate();
     }
 
     // Create color texture.
     glGenTextures(1, &m_ldr_color_texture);
-    glBindTexture(GL_TEXTURE_2D, m_ldr_color_texture);
+    gl_state.bind_texture_2d(0, m_ldr_color_texture);
     glTexImage2D(GL_TEXTURE_2D,
                  0,
                  GL_RGBA8,
@@ -738,7 +877,7 @@ void BT::Renderer::Impl::create_ldr_fbo()  // @COPYPASTA: see `create_hdr_fbo()`
 
     // Create framebuffer.
     glGenFramebuffers(1, &m_ldr_fbo);
-    glBindFramebuffer(GL_FRAMEBUFFER, m_ldr_fbo);
+    gl_state.bind_framebuffer(GL_FRAMEBUFFER, m_ldr_fbo);
     glFramebufferTexture2D(GL_FRAMEBUFFER,
                            GL_COLOR_ATTACHMENT0,
                            GL_TEXTURE_2D,
@@ -754,13 +893,15 @@ void BT::Renderer::Impl::create_ldr_fbo()  // @COPYPASTA: see `create_hdr_fbo()`
         logger::printef(logger::ERROR, "Framebuffer incomplete.");
         assert(false);
     }
-    glBindFramebuffer(GL_FRAMEBUFFER, 0);
+    gl_state.bind_framebuffer(GL_FRAMEBUFFER, 0);
 }
 
 void BT::Renderer::Impl::begin_new_display_frame()
 {
+    auto& gl_state{ get_main_gl_state_cache() };
+
     // Configure main render target.
-    glViewport(0, 0, m_window_dims.width, m_window_dims.height);
+    gl_state.set_viewport(0, 0, m_window_dims.width, m_window_dims.height);
     // glClearColor(0.063f, 0.129f, 0.063f, 1.0f);
     glClearColor(0.0f, 0.0f, 0.0f, 1.0f);
     glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
@@ -768,28 +909,320 @@ void BT::Renderer::Impl::begin_new_display_frame()
 
 void BT::Renderer::Impl::render_scene_to_hdr_framebuffer()
 {
-    glEnable(GL_DEPTH_TEST);
-    glDepthFunc(GL_LEQUAL);
-    glDepthMask(GL_TRUE);
-    glEnable(GL_CULL_FACE);
-    glCullFace(GL_BACK);
-    glFrontFace(GL_CW);
-
-    glBindFramebuffer(GL_FRAMEBUFFER, m_hdr_fbo);
-    glViewport(0, 0, m_main_viewport_dims.width, m_main_viewport_dims.height);
+    auto& gl_state{ get_main_gl_state_cache() };
+
+    gl_state.set_capability(GL_DEPTH_TEST, true);
+    gl_state.set_depth_func(GL_LEQUAL);
+    gl_state.set_depth_mask(true);
+    gl_state.set_capability(GL_CULL_FACE, true);
+    gl_state.set_cull_face(GL_BACK);
+    gl_state.set_front_face(GL_CW);
+
+    gl_state.bind_framebuffer(GL_FRAMEBUFFER, m_hdr_fbo);
+    gl_state.set_viewport(0, 0, m_hdr_render_dims.width, m_hdr_render_dims.height);
     glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
 
     // Render scene.
     auto rend_objs{ m_rend_obj_pool.checkout_all_render_objs() };
-    for (auto rend_obj : rend_objs)
+
+    m_render_stats.num_static_batched_render_objs = update_static_batches(rend_objs);
+    m_render_stats.num_static_batches = m_static_batches.size();
+
+    size_t num_visible{ cull_render_objs(rend_objs, m_rend_objs_visible) };
+    for (size_t i = 0; i < rend_objs.size(); i++)
+        if (m_rend_objs_static_batched[i] && m_rend_objs_visible[i])
+            num_visible--;
+    m_render_stats.num_visible_render_objs = num_visible;
+    m_render_stats.num_culled_render_objs =
+        rend_objs.size() - m_render_stats.num_static_batched_render_objs - num_visible;
+
+    m_render_stats.num_occluded_render_objs = 0;
+    m_render_stats.num_occluders = 0;
+    m_render_stats.occlusion_cull_time = 0.0f;
+    if (m_occlusion_culling_enabled)
+    {
+        Timer occlusion_cull_timer;
+        occlusion_cull_timer.start_timer();
+        size_t num_occluded{ occlusion_cull_render_objs(rend_objs, m_rend_objs_visible) };
+        m_render_stats.num_occluded_render_objs = num_occluded;
+        m_render_stats.num_visible_render_objs -= num_occluded;
+        m_render_stats.num_occluders = m_occlusion_culler.get_stats().num_occluders;
+        m_render_stats.occlusion_cull_time = occlusion_cull_timer.calc_delta_time();
+    }
+
+    m_render_stats.num_reduced_lod_render_objs =
+        update_render_obj_lod_levels(rend_objs, m_rend_objs_visible);
+
+    m_render_queue.clear();
+    for (size_t i = 0; i < rend_objs.size(); i++)
+        if (m_rend_objs_visible[i] && !m_rend_objs_static_batched[i])
+        {
+            rend_objs[i]->emplace_draws(m_active_render_layers, m_render_queue);
+        }
+    emplace_static_batch_draws(m_occlusion_culling_enabled);
+    m_render_queue.sort();
+
+    // Time the draws on the GPU, unless the GPU hasn't finished with this query yet.
+    uint32_t gpu_timer_query{ m_gpu_timer_queries[m_next_gpu_timer_query_idx] };
+    bool time_draws{ !m_gpu_timer_queries_pending[m_next_gpu_timer_query_idx] };
+    if (time_draws)
+        glBeginQuery(GL_TIME_ELAPSED, gpu_timer_query);
+    m_render_queue.submit_draws(*m_stream_buffer);
+    if (time_draws)
     {
-        rend_obj->render(m_active_render_layers);
+        glEndQuery(GL_TIME_ELAPSED);
+        m_gpu_timer_queries_pending[m_next_gpu_timer_query_idx] = true;
     }
+    m_next_gpu_timer_query_idx = (m_next_gpu_timer_query_idx + 1) % k_num_gpu_timer_queries;
+
+    auto const& queue_stats{ m_render_queue.get_stats_last_submit() };
+    m_render_stats.num_draw_calls = queue_stats.num_draws;
+    m_render_stats.num_instances = queue_stats.num_instances;
     m_rend_obj_pool.return_render_objs(std::move(rend_objs));
 
-    glBindFramebuffer(GL_FRAMEBUFFER, 0);
-    glDisable(GL_CULL_FACE);
-    glDisable(GL_DEPTH_TEST);
+    gl_state.bind_framebuffer(GL_FRAMEBUFFER, 0);
+    gl_state.set_capability(GL_CULL_FACE, false);
+    gl_state.set_capability(GL_DEPTH_TEST, false);
+}
+
+size_t BT::Renderer::Impl::cull_render_objs(vector<Render_object*> const& rend_objs,
+                                            vector<uint8_t>& out_visible)
+{
+    mat4 projection;
+    mat4 view;
+    mat4 projection_view;
+    m_camera.fetch_calculated_camera_matrices(projection, view, projection_view);
+
+    vec4 frustum_planes[6];
+    glm_frustum_planes(projection_view, frustum_planes);
+
+    // @NOTE: Deformed models use bind pose bounds, so pad them for deformed vertices going
+    //        outside of them (same padding as animator LOD selection).
+    constexpr float_t k_deformed_model_padding{ 1.0f };
+
+    m_frustum_culler.clear();
+    for (auto rend_obj : rend_objs)
+    {
+        AA_bounding_box world_aabb;
+        rend_obj->calc_world_aabb(world_aabb);
+        m_frustum_culler.emplace_bounds(world_aabb,
+                                        (rend_obj->get_deformed_model() != nullptr
+                                             ? k_deformed_model_padding
+                                             : 0.0f));
+    }
+
+    return m_frustum_culler.cull(frustum_planes, out_visible);
+}
+
+size_t BT::Renderer::Impl::occlusion_cull_render_objs(vector<Render_object*> const& rend_objs,
+                                                      vector<uint8_t>& in_out_visible)
+{
+    mat4 projection;
+    mat4 view;
+    mat4 projection_view;
+    m_camera.fetch_calculated_camera_matrices(projection, view, projection_view);
+
+    m_occlusion_culler.begin_frame(projection_view);
+
+    // Rasterize occluders.
+    // @NOTE: Deformed models are skipped since their bind pose doesn't match what gets drawn.
+    bool has_occluders{ false };
+    for (size_t i = 0; i < rend_objs.size(); i++)
+    {
+        auto rend_obj{ rend_objs[i] };
+        if (!in_out_visible[i] ||
+            !rend_obj->is_occluder() ||
+            !(rend_obj->get_layer() & m_active_render_layers) ||
+            rend_obj->get_deformed_model() != nullptr)
+            continue;
+
+        auto const& model{ *static_cast<Model const*>(rend_obj->get_renderable()) };
+        auto const& vertices{ model.get_vertices() };
+        if (vertices.empty())
+            continue;
+
+        for (auto const& mesh : model.get_meshes())
+        {
+            auto const& indices{ mesh.get_indices() };
+            m_occlusion_culler.rasterize_occluder(vertices[0].position,
+                                                  sizeof(Vertex),
+                                                  vertices.size(),
+                                                  indices.data(),
+                                                  indices.size(),
+                                                  rend_obj->render_transform());
+        }
+        has_occluders = true;
+    }
+
+    // @NOTE: Finished even w/o occluders, since static batches get tested against it later.
+    m_occlusion_culler.finish_occluders();
+    if (!has_occluders)
+        return 0;
+
+    // Test occludees.
+    constexpr float_t k_deformed_model_padding{ 1.0f };  // Same as frustum culling.
+
+    size_t num_occluded{ 0 };
+    for (size_t i = 0; i < rend_objs.size(); i++)
+    {
+        auto rend_obj{ rend_objs[i] };
+        if (!in_out_visible[i] || rend_obj->is_occluder() || m_rend_objs_static_batched[i])
+            continue;
+
+        AA_bounding_box world_aabb;
+        rend_obj->calc_world_aabb(world_aabb);
+        if (rend_obj->get_deformed_model() != nullptr)
+        {
+            glm_vec3_subs(world_aabb.min, k_deformed_model_padding, world_aabb.min);
+            glm_vec3_adds(world_aabb.max, k_deformed_model_padding, world_aabb.max);
+        }
+
+        if (!m_occlusion_culler.is_visible(world_aabb.min, world_aabb.max))
+        {
+            in_out_visible[i] = 0;
+            num_occluded++;
+        }
+    }
+
+    return num_occluded;
+}
+
+size_t BT::Renderer::Impl::update_render_obj_lod_levels(vector<Render_object*> const& rend_objs,
+                                                        vector<uint8_t> const& visible)
+{
+    mat4 projection;
+    mat4 view;
+    mat4 projection_view;
+    m_camera.fetch_calculated_camera_matrices(projection, view, projection_view);
+
+    Lod_view lod_view{
+        .pixels_per_unit  = std::abs(projection[1][1]) * m_hdr_render_dims.height * 0.5f,
+        .is_orthographic  = (projection[2][3] == 0.0f),
+        .max_pixel_error  = k_lod_max_pixel_error,
+        .hysteresis_ratio = k_lod_hysteresis_ratio,
+    };
+    m_camera.get_position(lod_view.camera_position);
+
+    size_t num_reduced{ 0 };
+    for (size_t i = 0; i < rend_objs.size(); i++)
+    {
+        if (!visible[i] || m_rend_objs_static_batched[i])
+            continue;
+
+        if (m_lod_enabled)
+            rend_objs[i]->update_lod_level(lod_view);
+        else
+            rend_objs[i]->reset_lod_level();
+
+        num_reduced += (rend_objs[i]->get_lod_level() > 0 ? 1 : 0);
+    }
+
+    return num_reduced;
+}
+
+size_t BT::Renderer::Impl::update_static_batches(vector<Render_object*> const& rend_objs)
+{
+    m_rend_objs_static_batched.assign(rend_objs.size(), 0);
+    if (!m_static_batching_enabled)
+    {
+        m_static_batches.clear();
+        m_static_batch_members.clear();
+        return 0;
+    }
+
+    // Find static render objects.
+    auto& members{ m_static_batch_members_scratch };
+    members.clear();
+    for (size_t i = 0; i < rend_objs.size(); i++)
+    {
+        auto rend_obj{ rend_objs[i] };
+        if (!rend_obj->is_static() || rend_obj->get_deformed_model() != nullptr)
+            continue;
+
+        m_rend_objs_static_batched[i] = 1;
+
+        Static_batch_member member{ .handle = m_rend_obj_pool.get_handle(*rend_obj) };
+        glm_mat4_copy(rend_obj->render_transform(), member.transform.raw);
+        members.emplace_back(member);
+    }
+
+    // Check if anything changed.
+    // @NOTE: Static render objects aren't supposed to move, but moving one (e.g. in the level
+    //        editor) still works, it just rebuilds all the batches.
+    bool changed{ members.size() != m_static_batch_members.size() };
+    for (size_t i = 0; !changed && i < members.size(); i++)
+    {
+        changed = (members[i].handle != m_static_batch_members[i].handle ||
+                   std::memcmp(&members[i].transform,
+                               &m_static_batch_members[i].transform,
+                               sizeof(mat4s)) != 0);
+    }
+
+    if (changed)
+    {   // Rebuild batches.
+        std::swap(m_static_batch_members, members);
+
+        vector<static_batcher::Source> sources;
+        sources.reserve(m_static_batch_members.size());
+        for (size_t i = 0; i < rend_objs.size(); i++)
+            if (m_rend_objs_static_batched[i])
+            {
+                auto rend_obj{ rend_objs[i] };
+                sources.emplace_back(static_batcher::make_model_source(
+                    *static_cast<Model const*>(rend_obj->get_renderable()),
+                    rend_obj->render_transform(),
+                    rend_obj->get_layer()));
+            }
+
+        auto merged_batches{ static_batcher::merge(
+            sources, k_static_batch_cell_size, k_static_batch_max_vertices) };
+        m_static_batches.clear();
+        for (auto const& merged_batch : merged_batches)
+            m_static_batches.emplace_back(std::make_unique<Static_batch>(merged_batch));
+
+        BT_TRACEF("Built %zu static batches from %zu static render objects.",
+                  m_static_batches.size(),
+                  sources.size());
+    }
+
+    return m_static_batch_members.size();
+}
+
+void BT::Renderer::Impl::emplace_static_batch_draws(bool occlusion_cull)
+{
+    mat4 projection;
+    mat4 view;
+    mat4 projection_view;
+    m_camera.fetch_calculated_camera_matrices(projection, view, projection_view);
+
+    vec4 frustum_planes[6];
+    glm_frustum_planes(projection_view, frustum_planes);
+
+    m_render_stats.num_culled_static_batches = 0;
+    m_render_stats.num_occluded_static_batches = 0;
+    for (auto const& static_batch : m_static_batches)
+    {
+        if (!(static_batch->get_layer() & m_active_render_layers))
+            continue;
+
+        auto const& world_aabb{ static_batch->get_world_aabb() };
+        vec3 box[2];
+        glm_vec3_copy(const_cast<float_t*>(world_aabb.min), box[0]);
+        glm_vec3_copy(const_cast<float_t*>(world_aabb.max), box[1]);
+        if (!glm_aabb_frustum(box, frustum_planes))
+        {
+            m_render_stats.num_culled_static_batches++;
+            continue;
+        }
+
+        if (occlusion_cull && !m_occlusion_culler.is_visible(box[0], box[1]))
+        {
+            m_render_stats.num_occluded_static_batches++;
+            continue;
+        }
+
+        static_batch->emplace_draw(m_render_queue);
+    }
 }
 
 bool BT::Renderer::Impl::is_requesting_picking()
@@ -808,24 +1241,70 @@ bool BT::Renderer::Impl::is_requesting_picking()
             !ImGuizmo::IsUsing());
 }
 
+bool BT::Renderer::Impl::pick_scene_with_cpu_ray()
+{
+    mat4 projection;
+    mat4 view;
+    mat4 projection_view;
+    m_camera.fetch_calculated_camera_matrices(projection, view, projection_view);
+
+    vec3 ray_origin;
+    vec3 ray_dir;
+    Ray_picker::calc_ray_from_pixel(projection_view,
+                                    m_input_handler.get_input_state().ui_cursor_pos.x.val,
+                                    m_input_handler.get_input_state().ui_cursor_pos.y.val,
+                                    m_main_viewport_dims.width,
+                                    m_main_viewport_dims.height,
+                                    ray_origin,
+                                    ray_dir);
+
+    auto rend_objs{ m_rend_obj_pool.checkout_all_render_objs() };
+    cull_render_objs(rend_objs, m_rend_objs_visible);
+
+    m_ray_picker.build(rend_objs, m_rend_objs_visible, m_active_render_layers);
+    auto pick_result{ m_ray_picker.pick(ray_origin, ray_dir) };
+
+    if (pick_result.exact)
+    {   // Set picked game object.
+        Render_object* picked_rend_obj{ nullptr };
+        if (pick_result.rend_obj_idx != Ray_picker::k_no_pick_idx)
+        {
+            picked_rend_obj = rend_objs[pick_result.rend_obj_idx];
+        }
+        find_owning_entity_and_set_as_selected(picked_rend_obj);
+    }
+
+    // Don't keep pointers to render objects that aren't checked out anymore.
+    m_ray_picker.clear();
+    m_rend_obj_pool.return_render_objs(std::move(rend_objs));
+
+    return pick_result.exact;
+}
+
 void BT::Renderer::Impl::render_scene_to_picking_framebuffer()
 {
-    glEnable(GL_DEPTH_TEST);
-    glDepthFunc(GL_LEQUAL);
-    glDepthMask(GL_TRUE);
-    glEnable(GL_CULL_FACE);
-    glCullFace(GL_BACK);
-    glFrontFace(GL_CW);
-
-    glBindFramebuffer(GL_FRAMEBUFFER, m_picking_fbo);
-    glViewport(0, 0, m_main_viewport_dims.width, m_main_viewport_dims.height);
+    auto& gl_state{ get_main_gl_state_cache() };
+
+    gl_state.set_capability(GL_DEPTH_TEST, true);
+    gl_state.set_depth_func(GL_LEQUAL);
+    gl_state.set_depth_mask(true);
+    gl_state.set_capability(GL_CULL_FACE, true);
+    gl_state.set_cull_face(GL_BACK);
+    gl_state.set_front_face(GL_CW);
+
+    gl_state.bind_framebuffer(GL_FRAMEBUFFER, m_picking_fbo);
+    gl_state.set_viewport(0, 0, m_main_viewport_dims.width, m_main_viewport_dims.height);
     glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
 
     auto rend_objs{ m_rend_obj_pool.checkout_all_render_objs() };
+    cull_render_objs(rend_objs, m_rend_objs_visible);
 
     // Render scene.
     for (size_t i = 0; i < rend_objs.size(); i++)
     {
+        if (!m_rend_objs_visible[i])
+            continue;
+
         auto rend_obj{ rend_objs[i] };
         static Material_debug_picking* s_picking_material{
             static_cast<Material_debug_picking*>(
@@ -862,9 +1341,9 @@ void BT::Renderer::Impl::render_scene_to_picking_framebuffer()
 
     m_rend_obj_pool.return_render_objs(std::move(rend_objs));
 
-    glBindFramebuffer(GL_FRAMEBUFFER, 0);
-    glDisable(GL_CULL_FACE);
-    glDisable(GL_DEPTH_TEST);
+    gl_state.bind_framebuffer(GL_FRAMEBUFFER, 0);
+    gl_state.set_capability(GL_CULL_FACE, false);
+    gl_state.set_capability(GL_DEPTH_TEST, false);
 }
 
 void BT::Renderer::Impl::find_owning_entity_and_set_as_selected(Render_object* render_object)
@@ -872,8 +1351,8 @@ void BT::Renderer::Impl::find_owning_entity_and_set_as_selected(Render_object* r
     entt::entity ecs_entity{ entt::null };
 
     if (render_object != nullptr)
-    {   // Use UUID of render obj to search.
-        auto rend_obj_uuid{ render_object->get_uuid() };
+    {   // Use handle of render obj to search.
+        auto rend_obj_handle{ m_rend_obj_pool.get_handle(*render_object) };
 
         auto view{ service_finder::find_service<Entity_container>()
                        .get_ecs_registry()
@@ -882,7 +1361,7 @@ void BT::Renderer::Impl::find_owning_entity_and_set_as_selected(Render_object* r
         for (auto view_entity : view)
         {
             if (view.get<component::Created_render_object_reference const>(view_entity)
-                    .render_obj_uuid_ref == rend_obj_uuid)
+                    .render_obj_handle == rend_obj_handle)
             {   // Found correct entity!
                 ecs_entity = view_entity;
                 break;
@@ -895,17 +1374,26 @@ void BT::Renderer::Impl::find_owning_entity_and_set_as_selected(Render_object* r
 
 void BT::Renderer::Impl::render_hdr_color_to_ldr_framebuffer()
 {
+    auto& gl_state{ get_main_gl_state_cache() };
+
     if (m_render_to_ldr)
     {
         // Assign ldr fbo.
-        glBindFramebuffer(GL_FRAMEBUFFER, m_ldr_fbo);
+        gl_state.bind_framebuffer(GL_FRAMEBUFFER, m_ldr_fbo);
     }
 
     // Render hdr framebuffer to main render target.
+    gl_state.set_viewport(0, 0, m_main_viewport_dims.width, m_main_viewport_dims.height);
     glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
 
-    // Use tonemapping shader.
+    // Use tonemapping shader (upscales the rendered part of the hdr framebuffer).
     static Material_ifc* s_post_process_material{ Material_bank::get_material("post_process") };
+    vec2 render_scale{
+        static_cast<float_t>(m_hdr_render_dims.width) / m_main_viewport_dims.width,
+        static_cast<float_t>(m_hdr_render_dims.height) / m_main_viewport_dims.height
+    };
+    static_cast<Material_impl_post_process*>(s_post_process_material)
+        ->set_render_scale(render_scale);
     s_post_process_material->bind_material(GLM_MAT4_ZERO);
     render_ndc_quad();
     s_post_process_material->unbind_material();
@@ -913,24 +1401,26 @@ void BT::Renderer::Impl::render_hdr_color_to_ldr_framebuffer()
     if (m_render_to_ldr)
     {
         // Unassign ldr fbo.
-        glBindFramebuffer(GL_FRAMEBUFFER, 0);
+        gl_state.bind_framebuffer(GL_FRAMEBUFFER, 0);
     }
 }
 
 void BT::Renderer::Impl::render_debug_views_to_ldr_framebuffer(float_t delta_time)
 {
-    glEnable(GL_DEPTH_TEST);
+    auto& gl_state{ get_main_gl_state_cache() };
+
+    gl_state.set_capability(GL_DEPTH_TEST, true);
 
     if (m_render_to_ldr)
     {
         // Assign ldr fbo.
-        glBindFramebuffer(GL_FRAMEBUFFER, m_ldr_fbo);
+        gl_state.bind_framebuffer(GL_FRAMEBUFFER, m_ldr_fbo);
     }
 
     // Copy depth buffer of hdr buffer over.
-    glBindFramebuffer(GL_READ_FRAMEBUFFER, m_hdr_fbo);
-    glBindFramebuffer(GL_DRAW_FRAMEBUFFER, m_render_to_ldr ? m_ldr_fbo : 0);
-    glBlitFramebuffer(0, 0, m_main_viewport_dims.width, m_main_viewport_dims.height,
+    gl_state.bind_framebuffer(GL_READ_FRAMEBUFFER, m_hdr_fbo);
+    gl_state.bind_framebuffer(GL_DRAW_FRAMEBUFFER, m_render_to_ldr ? m_ldr_fbo : 0);
+    glBlitFramebuffer(0, 0, m_hdr_render_dims.width, m_hdr_render_dims.height,
                       0, 0, m_main_viewport_dims.width, m_main_viewport_dims.height,
                       GL_DEPTH_BUFFER_BIT, GL_NEAREST);
 
@@ -938,27 +1428,31 @@ void BT::Renderer::Impl::render_debug_views_to_ldr_framebuffer(float_t delta_tim
     get_main_debug_mesh_pool().render_all_meshes();
 
     // Render debug lines.
-    auto lines_render_data{ get_main_debug_line_pool().calc_render_data(delta_time) };
+    auto lines_render_data{
+        get_main_debug_line_pool().calc_render_data(delta_time, *m_stream_buffer) };
     static Material_ifc* s_debug_lines_fore_material{
         Material_bank::get_material("debug_lines_fore_material") };
     static Material_ifc* s_debug_lines_back_material{
         Material_bank::get_material("debug_lines_back_material") };
-    for (auto material : { s_debug_lines_fore_material, s_debug_lines_back_material})
-    {
-        static_cast<Material_debug_lines*>(material)
-            ->set_lines_ssbo(lines_render_data.ssbo);
-        material->bind_material(GLM_MAT4_ZERO);
-        glDrawArraysInstanced(GL_LINES, 0, 2, lines_render_data.num_lines_to_render);
-        material->unbind_material();
-    }
+    if (lines_render_data.num_lines_to_render > 0)
+        for (auto material : { s_debug_lines_fore_material, s_debug_lines_back_material})
+        {
+            static_cast<Material_debug_lines*>(material)
+                ->set_lines_ssbo(lines_render_data.ssbo,
+                                 lines_render_data.ssbo_offset,
+                                 lines_render_data.ssbo_size);
+            material->bind_material(GLM_MAT4_ZERO);
+            glDrawArraysInstanced(GL_LINES, 0, 2, lines_render_data.num_lines_to_render);
+            material->unbind_material();
+        }
 
     if (m_render_to_ldr)
     {
         // Unassign ldr fbo.
-        glBindFramebuffer(GL_FRAMEBUFFER, 0);
+        gl_state.bind_framebuffer(GL_FRAMEBUFFER, 0);
     }
 
-    glDisable(GL_DEPTH_TEST);
+    gl_state.set_capability(GL_DEPTH_TEST, false);
 }
 
 void BT::Renderer::Impl::present_display_frame()
@@ -969,6 +1463,8 @@ void BT::Renderer::Impl::present_display_frame()
 // HDR rendering.
 void BT::Renderer::Impl::create_hdr_fbo()  // @COPYPASTA.
 {
+    auto& gl_state{ get_main_gl_state_cache() };
+
     if (m_hdr_fbo != 0 || m_hdr_color_texture != 0 || m_hdr_depth_rbo != 0)
     {
         // Double check that everything is fully created prior to deleting to recreate.
@@ -978,11 +1474,14 @@ void BT::Renderer::Impl::create_hdr_fbo()  // @COPYPASTA.
         glDeleteFramebuffers(1, &m_hdr_fbo);
         glDeleteTextures(1, &m_hdr_color_texture);
         glDeleteRenderbuffers(1, &m_hdr_depth_rbo);
+
+        // Deleted objects may still be bound, and their names may get reused.
+        gl_state.invalidate();
     }
 
     // Create color texture.
     glGenTextures(1, &m_hdr_color_texture);
-    glBindTexture(GL_TEXTURE_2D, m_hdr_color_texture);
+    gl_state.bind_texture_2d(0, m_hdr_color_texture);
     glTexImage2D(GL_TEXTURE_2D,
                  0,
                  GL_RGBA16F,
@@ -1005,7 +1504,7 @@ void BT::Renderer::Impl::create_hdr_fbo()  // @COPYPASTA.
 
     // Create framebuffer.
     glGenFramebuffers(1, &m_hdr_fbo);
-    glBindFramebuffer(GL_FRAMEBUFFER, m_hdr_fbo);
+    gl_state.bind_framebuffer(GL_FRAMEBUFFER, m_hdr_fbo);
     glFramebufferTexture2D(GL_FRAMEBUFFER,
                            GL_COLOR_ATTACHMENT0,
                            GL_TEXTURE_2D,
@@ -1021,7 +1520,7 @@ void BT::Renderer::Impl::create_hdr_fbo()  // @COPYPASTA.
         logger::printef(logger::ERROR, "Framebuffer incomplete.");
         assert(false);
     }
-    glBindFramebuffer(GL_FRAMEBUFFER, 0);
+    gl_state.bind_framebuffer(GL_FRAMEBUFFER, 0);
 
     Texture_bank::emplace_texture_2d("hdr_color_texture", m_hdr_color_texture, true);
 }
@@ -1054,6 +1553,8 @@ uint32_t BT::Renderer::Impl::rgb_chans_to_picking_idx(uint8_t* rgb_chans)
 
 void BT::Renderer::Impl::create_picking_fbo()  // @COPYPASTA.
 {
+    auto& gl_state{ get_main_gl_state_cache() };
+
     if (m_picking_fbo != 0 || m_picking_color_texture != 0 || m_picking_depth_rbo != 0)
     {
         // Double check that everything is fully created prior to deleting to recreate.
@@ -1063,11 +1564,14 @@ void BT::Renderer::Impl::create_picking_fbo()  // @COPYPASTA.
         glDeleteFramebuffers(1, &m_picking_fbo);
         glDeleteTextures(1, &m_picking_color_texture);
         glDeleteRenderbuffers(1, &m_picking_depth_rbo);
+
+        // Deleted objects may still be bound, and their names may get reused.
+        gl_state.invalidate();
     }
 
     // Create color texture.
     glGenTextures(1, &m_picking_color_texture);
-    glBindTexture(GL_TEXTURE_2D, m_picking_color_texture);
+    gl_state.bind_texture_2d(0, m_picking_color_texture);
     glTexImage2D(GL_TEXTURE_2D,
                  0,
                  GL_RGBA8,
@@ -1090,7 +1594,7 @@ void BT::Renderer::Impl::create_picking_fbo()  // @COPYPASTA.
 
     // Create framebuffer.
     glGenFramebuffers(1, &m_picking_fbo);
-    glBindFramebuffer(GL_FRAMEBUFFER, m_picking_fbo);
+    gl_state.bind_framebuffer(GL_FRAMEBUFFER, m_picking_fbo);
     glFramebufferTexture2D(GL_FRAMEBUFFER,
                            GL_COLOR_ATTACHMENT0,
                            GL_TEXTURE_2D,
@@ -1106,7 +1610,7 @@ void BT::Renderer::Impl::create_picking_fbo()  // @COPYPASTA.
         logger::printef(logger::ERROR, "Framebuffer incomplete.");
         assert(false);
     }
-    glBindFramebuffer(GL_FRAMEBUFFER, 0);
+    gl_state.bind_framebuffer(GL_FRAMEBUFFER, 0);
 
     Texture_bank::emplace_texture_2d("picking_color_texture", m_picking_color_texture, true);
 }
@@ -1116,6 +1620,7 @@ void BT::Renderer::Impl::render_ndc_cube()
 {
     static uint32_t vao{ 0 };
     static uint32_t vbo{ 0 };
+    auto& gl_state{ get_main_gl_state_cache() };
 
     if (vao == 0)
     {
@@ -1173,7 +1678,7 @@ void BT::Renderer::Impl::render_ndc_cube()
         glBufferData(GL_ARRAY_BUFFER, sizeof(vertices), vertices, GL_STATIC_DRAW);
 
         // Link vertex attributes.
-        glBindVertexArray(vao);
+        gl_state.bind_vertex_array(vao);
         glEnableVertexAttribArray(0);
         glVertexAttribPointer(0,
                               3,
@@ -1196,19 +1701,20 @@ void BT::Renderer::Impl::render_ndc_cube()
                               8 * sizeof(float_t),
                               reinterpret_cast<void*>(6 * sizeof(float_t)));
         glBindBuffer(GL_ARRAY_BUFFER, 0);
-        glBindVertexArray(0);
+        gl_state.bind_vertex_array(0);
     }
 
     // Render cube.
-    glBindVertexArray(vao);
+    gl_state.bind_vertex_array(vao);
     glDrawArrays(GL_TRIANGLES, 0, 36);
-    glBindVertexArray(0);
+    gl_state.bind_vertex_array(0);
 }
 
 void BT::Renderer::Impl::render_ndc_quad()
 {
     static uint32_t vao{ 0 };
     static uint32_t vbo{ 0 };
+    auto& gl_state{ get_main_gl_state_cache() };
 
     if (vao == 0)
     {
@@ -1224,7 +1730,7 @@ void BT::Renderer::Impl::render_ndc_quad()
         // Setup plane VAO.
         glGenVertexArrays(1, &vao);
         glGenBuffers(1, &vbo);
-        glBindVertexArray(vao);
+        gl_state.bind_vertex_array(vao);
         glBindBuffer(GL_ARRAY_BUFFER, vbo);
         glBufferData(GL_ARRAY_BUFFER, sizeof(vertices), &vertices, GL_STATIC_DRAW);
         glEnableVertexAttribArray(0);
@@ -1244,7 +1750,7 @@ void BT::Renderer::Impl::render_ndc_quad()
     }
 
     // Render quad.
-    glBindVertexArray(vao);
+    gl_state.bind_vertex_array(vao);
     glDrawArrays(GL_TRIANGLE_STRIP, 0, 4);
-    glBindVertexArray(0);
+    gl_state.bind_vertex_array(0);
 }
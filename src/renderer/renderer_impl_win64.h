@@ -2,12 +2,21 @@
 
 #include "../input_handler/input_handler.h"
 #include "camera.h"
+#include "dynamic_resolution.h"
+#include "frustum_culler.h"
+#include "gl_state_cache.h"
 #include "btglm.h"
 #include "imgui_renderer.h"
+#include "occlusion_culler.h"
+#include "ray_picker.h"
 #include "render_object.h"
+#include "render_queue.h"
 #include "renderer.h"
+#include "static_batcher.h"
+#include "stream_buffer.h"
 #include <cstdint>
 #include <functional>
+#include <memory>
 #include <string>
 
 using std::function;
@@ -38,6 +47,40 @@ public:
 
     Render_object_pool& get_render_object_pool();
 
+    Renderer::Render_stats get_render_stats() const { return m_render_stats; }
+
+    void set_instancing_enabled(bool enabled) { m_render_queue.set_instancing_enabled(enabled); }
+    bool get_instancing_enabled() const { return m_render_queue.get_instancing_enabled(); }
+    void set_multi_draw_indirect_enabled(bool enabled)
+    {
+        m_render_queue.set_multi_draw_indirect_enabled(enabled);
+    }
+    bool get_multi_draw_indirect_enabled() const
+    {
+        return m_render_queue.get_multi_draw_indirect_enabled();
+    }
+
+    void set_occlusion_culling_enabled(bool enabled) { m_occlusion_culling_enabled = enabled; }
+    bool get_occlusion_culling_enabled() const { return m_occlusion_culling_enabled; }
+
+    void set_lod_enabled(bool enabled) { m_lod_enabled = enabled; }
+    bool get_lod_enabled() const { return m_lod_enabled; }
+
+    void set_static_batching_enabled(bool enabled) { m_static_batching_enabled = enabled; }
+    bool get_static_batching_enabled() const { return m_static_batching_enabled; }
+
+    void set_dynamic_resolution_enabled(bool enabled) { m_dynamic_resolution_enabled = enabled; }
+    bool get_dynamic_resolution_enabled() const { return m_dynamic_resolution_enabled; }
+
+    void set_gl_state_cache_enabled(bool enabled)
+    {
+        get_main_gl_state_cache().set_enabled(enabled);
+    }
+    bool get_gl_state_cache_enabled() const { return get_main_gl_state_cache().get_enabled(); }
+
+    void set_cpu_picking_enabled(bool enabled) { m_cpu_picking_enabled = enabled; }
+    bool get_cpu_picking_enabled() const { return m_cpu_picking_enabled; }
+
     void save_state_to_app_settings() const;
 
     void render_imgui_game_view();
@@ -65,6 +108,18 @@ private:
 
     Camera m_camera;
 
+    // Per-frame camera uniforms.
+    struct Gpu_camera_data
+    {   // @NOTE: Must match `Camera_ubo` in shaders (std140).
+        mat4s projection;
+        mat4s view;
+        mat4s projection_view;
+        vec4s position;
+    };
+    uint32_t m_camera_ubo{ 0 };
+    void create_camera_ubo();
+    void upload_camera_ubo();
+
     // ImGui.
     void setup_imgui();
     void render_imgui(float_t delta_time);
@@ -73,6 +128,84 @@ private:
     Render_object_pool m_rend_obj_pool;
     Render_layer m_active_render_layers{ Render_layer::RENDER_LAYER_DEFAULT |
                                          Render_layer::RENDER_LAYER_LEVEL_EDITOR };
+    Render_queue m_render_queue;
+
+    // Per-frame streamed data (instance transforms, debug lines).
+    static constexpr size_t k_stream_buffer_region_size{ 8 * 1024 * 1024 };
+    std::unique_ptr<Stream_buffer> m_stream_buffer;
+
+    // Frustum culling.
+    Frustum_culler m_frustum_culler;
+    vector<uint8_t> m_rend_objs_visible;
+    Renderer::Render_stats m_render_stats;
+
+    /// Culls `rend_objs` against the camera frustum. Returns number of visible render objects.
+    size_t cull_render_objs(vector<Render_object*> const& rend_objs, vector<uint8_t>& out_visible);
+
+    // Occlusion culling.
+    Occlusion_culler m_occlusion_culler;
+    bool m_occlusion_culling_enabled{ true };
+
+    /// Rasterizes visible occluders, then hides visible render objects that are behind them.
+    /// Returns number of render objects that got hidden.
+    // @NOTE: Static batched render objects still get rasterized as occluders, but don't get
+    //        tested (their batches do, see `emplace_static_batch_draws()`).
+    size_t occlusion_cull_render_objs(vector<Render_object*> const& rend_objs,
+                                      vector<uint8_t>& in_out_visible);
+
+    // LOD selection.
+    static constexpr float_t k_lod_max_pixel_error{ 1.0f };
+    static constexpr float_t k_lod_hysteresis_ratio{ 0.75f };
+    bool m_lod_enabled{ true };
+
+    /// Updates LOD levels of visible render objects that aren't static batched. Returns number
+    /// not at full detail.
+    size_t update_render_obj_lod_levels(vector<Render_object*> const& rend_objs,
+                                        vector<uint8_t> const& visible);
+
+    // Static batching.
+    static constexpr size_t k_static_batch_max_vertices{ 1 << 20 };
+    static constexpr float_t k_static_batch_cell_size{ 32.0f };  // Grid cell size (world units).
+    bool m_static_batching_enabled{ true };
+    vector<std::unique_ptr<Static_batch>> m_static_batches;
+    vector<uint8_t> m_rend_objs_static_batched;
+
+    /// Static render objects (and their transforms) that the current batches were built from.
+    struct Static_batch_member
+    {
+        Render_object_handle handle;
+        mat4s transform;
+    };
+    vector<Static_batch_member> m_static_batch_members;
+    vector<Static_batch_member> m_static_batch_members_scratch;
+
+    /// Marks static render objects in `m_rend_objs_static_batched`, and rebuilds the static batches
+    /// if static render objects got added, removed or moved since they were built.
+    /// Returns number of static batched render objects.
+    size_t update_static_batches(vector<Render_object*> const& rend_objs);
+
+    /// Adds draws of static batches in the active layers that touch the camera frustum, and (w/
+    /// `occlusion_cull`) aren't behind the occluders rasterized this frame.
+    void emplace_static_batch_draws(bool occlusion_cull);
+
+    // Dynamic resolution.
+    static constexpr float_t k_dynamic_resolution_target_gpu_time{ 0.012f };
+    static constexpr size_t k_num_gpu_timer_queries{ 4 };  // Frames the GPU may lag behind.
+    Dynamic_resolution_controller m_dynamic_resolution{
+        Dynamic_resolution_controller::make_default_settings(k_dynamic_resolution_target_gpu_time)
+    };
+    bool m_dynamic_resolution_enabled{ true };
+    Window_dimensions m_hdr_render_dims{ 256, 256 };  // Part of the hdr fbo the scene renders to.
+
+    // Ring of GPU timer queries around the scene draws (results get read a few frames later).
+    uint32_t m_gpu_timer_queries[k_num_gpu_timer_queries]{};
+    bool m_gpu_timer_queries_pending[k_num_gpu_timer_queries]{};
+    size_t m_next_gpu_timer_query_idx{ 0 };
+    void create_gpu_timer_queries();
+
+    /// Feeds the oldest finished GPU timer query into the controller, then picks
+    /// `m_hdr_render_dims` from the render scale.
+    void update_dynamic_resolution();
 
     // Skeletal animation compute.
     bool update_animators_and_compute_mesh_skinning(float_t delta_time);
@@ -91,6 +224,7 @@ private:
     void begin_new_display_frame();
     void render_scene_to_hdr_framebuffer();
     bool is_requesting_picking();
+    bool pick_scene_with_cpu_ray();
     void render_scene_to_picking_framebuffer();
     void find_owning_entity_and_set_as_selected(Render_object* render_object);
     void render_hdr_color_to_ldr_framebuffer();
@@ -103,6 +237,10 @@ private:
     uint32_t m_hdr_depth_rbo{ 0 };
     void create_hdr_fbo();
 
+    // CPU picking.
+    Ray_picker m_ray_picker;
+    bool m_cpu_picking_enabled{ true };
+
     // Picking rendering.
     uint32_t m_picking_fbo{ 0 };
     uint32_t m_picking_color_texture{ 0 };
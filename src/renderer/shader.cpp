@@ -2,6 +2,9 @@
 
 #include "btlogger.h"
 #include "glad/glad.h"
+#include "gl_state_cache.h"
+#include "shader_binary_cache.h"
+#include "timer/timer.h"
 #include <cassert>
 #include <filesystem>
 #include <fstream>
@@ -13,9 +16,26 @@ using std::stringstream;
 
 BT::Shader::Shader(string const& vert_fname, string const& frag_fname)
 {
+    Timer load_timer;
+    load_timer.start_timer();
+
     string vertex_code{ read_shader_file(vert_fname) };
     string fragment_code{ read_shader_file(frag_fname) };
 
+    // Try loading from cache.
+    uint64_t cache_key{
+        shader_binary_cache::calc_program_key({ &vertex_code, &fragment_code }, "") };
+    m_shader_program = glCreateProgram();
+    if (shader_binary_cache::try_load_program(cache_key, m_shader_program))
+    {
+        cache_uniform_locations();
+        shader_binary_cache::record_program_load_time(true, load_timer.calc_delta_time());
+        return;
+    }
+
+    // Compile from source.
+    glDeleteProgram(m_shader_program);
+
     uint32_t vert_shader;
     uint32_t frag_shader;
     int32_t success;
@@ -49,6 +69,7 @@ BT::Shader::Shader(string const& vert_fname, string const& frag_fname)
 
     // Link into shader program.
     m_shader_program = glCreateProgram();
+    glProgramParameteri(m_shader_program, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE);
     glAttachShader(m_shader_program, vert_shader);
     glAttachShader(m_shader_program, frag_shader);
     glLinkProgram(m_shader_program);
@@ -59,16 +80,40 @@ BT::Shader::Shader(string const& vert_fname, string const& frag_fname)
         glGetShaderInfoLog(m_shader_program, 512, nullptr, info_log);
         logger::printef(logger::ERROR, "Program: Link failed: %s", info_log);
     }
+    else
+    {
+        shader_binary_cache::save_program(cache_key, m_shader_program);
+    }
+
+    cache_uniform_locations();
 
     // Cleanup.
     glDeleteShader(vert_shader);
     glDeleteShader(frag_shader);
+
+    shader_binary_cache::record_program_load_time(false, load_timer.calc_delta_time());
 }
 
 BT::Shader::Shader(string const& comp_fname)
 {
+    Timer load_timer;
+    load_timer.start_timer();
+
     string compute_code{ read_shader_file(comp_fname) };
 
+    // Try loading from cache.
+    uint64_t cache_key{ shader_binary_cache::calc_program_key({ &compute_code }, "") };
+    m_shader_program = glCreateProgram();
+    if (shader_binary_cache::try_load_program(cache_key, m_shader_program))
+    {
+        cache_uniform_locations();
+        shader_binary_cache::record_program_load_time(true, load_timer.calc_delta_time());
+        return;
+    }
+
+    // Compile from source.
+    glDeleteProgram(m_shader_program);
+
     uint32_t comp_shader;
     int32_t success;
     char info_log[512];
@@ -88,6 +133,7 @@ BT::Shader::Shader(string const& comp_fname)
 
     // Link into shader program.
     m_shader_program = glCreateProgram();
+    glProgramParameteri(m_shader_program, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE);
     glAttachShader(m_shader_program, comp_shader);
     glLinkProgram(m_shader_program);
 
@@ -97,9 +143,17 @@ BT::Shader::Shader(string const& comp_fname)
         glGetShaderInfoLog(m_shader_program, 512, nullptr, info_log);
         logger::printef(logger::ERROR, "Program: Link failed: %s", info_log);
     }
+    else
+    {
+        shader_binary_cache::save_program(cache_key, m_shader_program);
+    }
+
+    cache_uniform_locations();
 
     // Cleanup.
     glDeleteShader(comp_shader);
+
+    shader_binary_cache::record_program_load_time(false, load_timer.calc_delta_time());
 }
 
 BT::Shader::~Shader()
@@ -109,50 +163,129 @@ BT::Shader::~Shader()
 
 void BT::Shader::bind() const
 {
-    glUseProgram(m_shader_program);
+    get_main_gl_state_cache().use_program(m_shader_program);
 }
 
 void BT::Shader::unbind()
 {
-    glUseProgram(0);
+    get_main_gl_state_cache().use_program(0);
+}
+
+void BT::Shader::set_int(int32_t location, int32_t value) const
+{
+    glUniform1i(location, value);
+}
+
+void BT::Shader::set_float(int32_t location, float_t value) const
+{
+    glUniform1f(location, value);
+}
+
+void BT::Shader::set_vec3(int32_t location, vec3 value) const
+{
+    glUniform3fv(location, 1, value);
+}
+
+void BT::Shader::set_mat4(int32_t location, mat4 value) const
+{
+    glUniformMatrix4fv(location, 1, GL_FALSE, &value[0][0]);
+}
+
+void BT::Shader::bind_texture(int32_t location, int32_t texture_idx, uint32_t texture_buffer) const
+{
+    set_int(location, texture_idx);
+    get_main_gl_state_cache().bind_texture_2d(texture_idx, texture_buffer);
 }
 
 void BT::Shader::set_int(string const& param_name, int32_t value) const
 {
-    glUniform1i(glGetUniformLocation(m_shader_program, param_name.c_str()), value);
+    set_int(get_uniform_location(param_name), value);
 }
 
 void BT::Shader::set_uint(string const& param_name, uint32_t value) const
 {
-    glUniform1ui(glGetUniformLocation(m_shader_program, param_name.c_str()), value);
+    glUniform1ui(get_uniform_location(param_name), value);
 }
 
 void BT::Shader::set_float(string const& param_name, float_t value) const
 {
-    glUniform1f(glGetUniformLocation(m_shader_program, param_name.c_str()), value);
+    set_float(get_uniform_location(param_name), value);
 }
 
-void BT::Shader::set_vec3(string const& param_name, vec3 value) const
+void BT::Shader::set_vec2(string const& param_name, vec2 value) const
 {
-    glUniform3fv(glGetUniformLocation(m_shader_program, param_name.c_str()),
+    glUniform2fv(get_uniform_location(param_name),
                  1,
                  value);
 }
 
+void BT::Shader::set_vec3(string const& param_name, vec3 value) const
+{
+    set_vec3(get_uniform_location(param_name), value);
+}
+
 void BT::Shader::set_mat4(string const& param_name, mat4 value) const
 {
-    glUniformMatrix4fv(glGetUniformLocation(m_shader_program, param_name.c_str()),
-                       1,
-                       GL_FALSE,
-                       &value[0][0]);
+    set_mat4(get_uniform_location(param_name), value);
 }
 
 void BT::Shader::bind_texture(string const& param_name, int32_t texture_idx, uint32_t texture_buffer) const
 {
-    set_int(param_name, texture_idx);
-    glActiveTexture(GL_TEXTURE0 + texture_idx);
-    glBindTexture(GL_TEXTURE_2D, texture_buffer);
+    bind_texture(get_uniform_location(param_name), texture_idx, texture_buffer);
+}
+
+int32_t BT::Shader::get_uniform_location(string const& param_name) const
+{
+    auto it{ m_uniform_locations.find(param_name) };
+    if (it == m_uniform_locations.end())
+        return -1;  // @NOTE: Setting uniform at -1 is silently ignored, same as GL.
+
+    return it->second;
+}
+
+void BT::Shader::cache_uniform_locations()
+{
+    int32_t num_uniforms;
+    glGetProgramiv(m_shader_program, GL_ACTIVE_UNIFORMS, &num_uniforms);
+
+    char name_buffer[256];
+    for (int32_t i = 0; i < num_uniforms; i++)
+    {
+        int32_t name_length;
+        int32_t size;
+        uint32_t type;
+        glGetActiveUniform(m_shader_program,
+                           static_cast<uint32_t>(i),
+                           sizeof(name_buffer),
+                           &name_length,
+                           &size,
+                           &type,
+                           name_buffer);
+
+        int32_t location{ glGetUniformLocation(m_shader_program, name_buffer) };
+        if (location < 0)
+            continue;  // Uniform block member.
+
+        string name{ name_buffer, static_cast<size_t>(name_length) };
+        if (name.ends_with("[0]"))
+        {   // Allow looking up arrays by base name too.
+            m_uniform_locations.emplace(name.substr(0, name.size() - 3), location);
+        }
+        m_uniform_locations.emplace(std::move(name), location);
+    }
 
+    // Resolve per draw uniforms.
+    static char const* const k_builtin_uniform_names[NUM_BUILTIN_UNIFORMS]{
+        "model_transform",
+        "use_instance_transforms",
+        "color",
+        "color_image",
+        "tint_standable",
+        "tint_non_standable",
+        "sin_standable_angle",
+    };
+    for (uint32_t i = 0; i < NUM_BUILTIN_UNIFORMS; i++)
+        m_builtin_uniform_locations[i] = get_uniform_location(k_builtin_uniform_names[i]);
 }
 
 string BT::Shader::read_shader_file(string const& fname)
@@ -194,6 +327,7 @@ void BT::Shader_bank::emplace_shader(string const& name, unique_ptr<Shader>&& sh
         return;
     }
 
+    shader->m_sort_id = static_cast<uint16_t>(s_shaders.size());
     s_shaders.emplace_back(name, std::move(shader));
 }
 
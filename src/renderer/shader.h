@@ -3,12 +3,14 @@
 #include "btglm.h"
 #include <string>
 #include <memory>
+#include <unordered_map>
 #include <utility>
 #include <vector>
 
 using std::pair;
 using std::string;
 using std::unique_ptr;
+using std::unordered_map;
 using std::vector;
 
 
@@ -25,15 +27,64 @@ public:
     void bind() const;
     static void unbind();
 
+    /// Uniforms set per draw or per material switch. Their locations get looked up once at link
+    /// time (-1 if the shader doesn't have it), so setting them doesn't hash a name.
+    enum Builtin_uniform : uint32_t
+    {
+        UNIFORM_MODEL_TRANSFORM = 0,
+        UNIFORM_USE_INSTANCE_TRANSFORMS,
+        UNIFORM_COLOR,
+        UNIFORM_COLOR_IMAGE,
+        UNIFORM_TINT_STANDABLE,
+        UNIFORM_TINT_NON_STANDABLE,
+        UNIFORM_SIN_STANDABLE_ANGLE,
+        NUM_BUILTIN_UNIFORMS
+    };
+    int32_t get_uniform_location(Builtin_uniform uniform) const
+    {
+        return m_builtin_uniform_locations[uniform];
+    }
+
+    // Set by location (see `get_uniform_location()`).
+    void set_int(int32_t location, int32_t value) const;
+    void set_float(int32_t location, float_t value) const;
+    void set_vec3(int32_t location, vec3 value) const;
+    void set_mat4(int32_t location, mat4 value) const;
+    void bind_texture(int32_t location, int32_t texture_idx, uint32_t texture_buffer) const;
+
+    // Set by name. For editor and other rarely set uniforms.
     void set_int(string const& param_name, int32_t value) const;
     void set_uint(string const& param_name, uint32_t value) const;
     void set_float(string const& param_name, float_t value) const;
+    void set_vec2(string const& param_name, vec2 value) const;
     void set_vec3(string const& param_name, vec3 value) const;
     void set_mat4(string const& param_name, mat4 value) const;
     void bind_texture(string const& param_name, int32_t texture_idx, uint32_t texture_buffer) const;
 
+    /// Gets cached location of uniform `param_name`. -1 if not an active uniform.
+    int32_t get_uniform_location(string const& param_name) const;
+
+    /// Uniform buffer binding of camera data. Updated once per frame by the renderer.
+    // @NOTE: Must match `Camera_ubo` in shaders.
+    static constexpr uint32_t k_camera_ubo_binding{ 0 };
+
+    /// Shader storage buffer binding of per-instance transforms for instanced draws.
+    // @NOTE: Must match `Instance_transforms_ssbo` in shaders.
+    static constexpr uint32_t k_instance_transforms_ssbo_binding{ 5 };
+
+    /// Id of this shader in the shader bank (`k_invalid_sort_id` if not in the bank).
+    static constexpr uint16_t k_invalid_sort_id{ 0xFFFF };
+    uint16_t get_sort_id() const { return m_sort_id; }
+
 private:
     uint32_t m_shader_program;
+    uint16_t m_sort_id{ k_invalid_sort_id };
+    unordered_map<string, int32_t> m_uniform_locations;
+    int32_t m_builtin_uniform_locations[NUM_BUILTIN_UNIFORMS];
+
+    void cache_uniform_locations();
+
+    friend class Shader_bank;
 
     string read_shader_file(string const& fname);
 };
@@ -0,0 +1,190 @@
+#include "shader_binary_cache.h"
+
+#include "btlogger.h"
+#include "glad/glad.h"
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <vector>
+
+
+namespace
+{
+
+using namespace BT;
+
+constexpr char const* const k_cache_dir{ "shader_cache/" };
+constexpr uint32_t k_file_magic{ 0x42545342 };  // "BTSB"
+
+// @NOTE: Program binaries are usually well under 1 MiB, so anything past this is a corrupt file.
+constexpr uint32_t k_max_binary_size{ 64 * 1024 * 1024 };
+
+struct File_header
+{
+    uint32_t magic;
+    uint32_t binary_format;
+    uint64_t key;
+    uint32_t binary_size;
+};
+
+shader_binary_cache::Stats s_stats;
+
+uint64_t fnv1a_hash(void const* data, size_t size, uint64_t hash)
+{
+    auto bytes{ static_cast<uint8_t const*>(data) };
+    for (size_t i = 0; i < size; i++)
+    {
+        hash ^= bytes[i];
+        hash *= 0x100000001b3ull;
+    }
+    return hash;
+}
+
+uint64_t fnv1a_hash_str(string const& str, uint64_t hash)
+{   // Include the null terminator so that concatenations of different strings differ.
+    return fnv1a_hash(str.c_str(), str.size() + 1, hash);
+}
+
+string const& get_driver_identity()
+{
+    static string const s_driver_identity{ [] {
+        string identity;
+        for (GLenum name : { GL_VENDOR, GL_RENDERER, GL_VERSION })
+        {
+            auto str{ reinterpret_cast<char const*>(glGetString(name)) };
+            identity += (str != nullptr ? str : "");
+            identity += '\n';
+        }
+        return identity;
+    }() };
+    return s_driver_identity;
+}
+
+string get_cache_fname(uint64_t key)
+{
+    char key_str[17];
+    snprintf(key_str, sizeof(key_str), "%016llx", static_cast<unsigned long long>(key));
+    return string{ k_cache_dir } + key_str + ".bin";
+}
+
+}  // namespace
+
+
+uint64_t BT::shader_binary_cache::calc_program_key(std::initializer_list<string const*> sources,
+                                                   string const& defines)
+{
+    uint64_t hash{ 0xcbf29ce484222325ull };
+    hash = fnv1a_hash_str(get_driver_identity(), hash);
+    hash = fnv1a_hash_str(defines, hash);
+    for (auto source : sources)
+    {
+        hash = fnv1a_hash_str(*source, hash);
+    }
+    return hash;
+}
+
+bool BT::shader_binary_cache::try_load_program(uint64_t key, uint32_t program)
+{
+    auto fname{ get_cache_fname(key) };
+    std::ifstream file{ fname, std::ios::binary };
+    if (!file.is_open())
+    {
+        s_stats.num_cache_misses++;
+        return false;
+    }
+
+    File_header header;
+    file.read(reinterpret_cast<char*>(&header), sizeof(header));
+    if (!file || header.magic != k_file_magic || header.key != key)
+    {
+        BT_WARNF("Ignoring invalid shader binary cache file \"%s\".", fname.c_str());
+        s_stats.num_cache_misses++;
+        return false;
+    }
+
+    // Check size before allocating, so a corrupt header can't ask for gigabytes.
+    std::error_code ec;
+    auto file_size{ std::filesystem::file_size(fname, ec) };
+    if (ec ||
+        header.binary_size == 0 ||
+        header.binary_size > k_max_binary_size ||
+        header.binary_size > file_size - sizeof(header))
+    {
+        BT_WARNF("Ignoring shader binary cache file \"%s\" w/ bad binary size %u.",
+                 fname.c_str(),
+                 header.binary_size);
+        s_stats.num_cache_misses++;
+        return false;
+    }
+
+    std::vector<char> binary(header.binary_size);
+    file.read(binary.data(), header.binary_size);
+    if (!file)
+    {
+        BT_WARNF("Ignoring truncated shader binary cache file \"%s\".", fname.c_str());
+        s_stats.num_cache_misses++;
+        return false;
+    }
+
+    // @NOTE: Driver rejects the binary if the format isn't supported anymore.
+    glProgramBinary(program, header.binary_format, binary.data(), header.binary_size);
+
+    int32_t success;
+    glGetProgramiv(program, GL_LINK_STATUS, &success);
+    if (!success)
+    {
+        BT_TRACEF("Shader binary cache file \"%s\" rejected by driver. Recompiling.",
+                  fname.c_str());
+        s_stats.num_rejected_binaries++;
+        s_stats.num_cache_misses++;
+        return false;
+    }
+
+    s_stats.num_cache_hits++;
+    return true;
+}
+
+void BT::shader_binary_cache::save_program(uint64_t key, uint32_t program)
+{
+    int32_t binary_size{ 0 };
+    glGetProgramiv(program, GL_PROGRAM_BINARY_LENGTH, &binary_size);
+    if (binary_size <= 0)
+    {   // Driver doesn't support retrieving binaries.
+        return;
+    }
+
+    std::vector<char> binary(binary_size);
+    GLenum binary_format;
+    glGetProgramBinary(program, binary_size, nullptr, &binary_format, binary.data());
+
+    std::error_code ec;
+    std::filesystem::create_directories(k_cache_dir, ec);
+
+    auto fname{ get_cache_fname(key) };
+    std::ofstream file{ fname, std::ios::binary | std::ios::trunc };
+    if (!file.is_open())
+    {
+        BT_WARNF("Could not write shader binary cache file \"%s\".", fname.c_str());
+        return;
+    }
+
+    File_header header{ k_file_magic,
+                        binary_format,
+                        key,
+                        static_cast<uint32_t>(binary_size) };
+    file.write(reinterpret_cast<char const*>(&header), sizeof(header));
+    file.write(binary.data(), binary_size);
+}
+
+void BT::shader_binary_cache::record_program_load_time(bool cache_hit, float_t load_time)
+{
+    if (cache_hit)
+        s_stats.cache_hit_load_time += load_time;
+    else
+        s_stats.cache_miss_load_time += load_time;
+}
+
+BT::shader_binary_cache::Stats const& BT::shader_binary_cache::get_stats()
+{
+    return s_stats;
+}
@@ -0,0 +1,47 @@
+#pragma once
+
+#include "btglm.h"
+#include <cstddef>
+#include <cstdint>
+#include <initializer_list>
+#include <string>
+
+using std::string;
+
+
+namespace BT
+{
+
+/// On-disk cache of linked shader program binaries, so that shaders don't need compiling from
+/// source on every launch.
+namespace shader_binary_cache
+{
+
+/// Combines the hash of all shader stage sources, defines and driver identity (vendor, renderer
+/// and version strings), so changing any of them misses the cache.
+uint64_t calc_program_key(std::initializer_list<string const*> sources, string const& defines);
+
+/// Loads the cached binary of `key` into `program`. Returns false if there's no cached binary, or
+/// if the driver rejected it (e.g. binary format mismatch after a driver update). On false,
+/// `program` must be recreated before compiling from source.
+bool try_load_program(uint64_t key, uint32_t program);
+
+/// Writes the binary of linked `program` to the cache.
+// @NOTE: `program` should be linked with `GL_PROGRAM_BINARY_RETRIEVABLE_HINT` set.
+void save_program(uint64_t key, uint32_t program);
+
+struct Stats
+{
+    size_t num_cache_hits{ 0 };
+    size_t num_cache_misses{ 0 };
+    size_t num_rejected_binaries{ 0 };  // Included in misses.
+    float_t cache_hit_load_time{ 0.0f };  // Seconds.
+    float_t cache_miss_load_time{ 0.0f };  // Seconds (compile from source + save).
+};
+
+void record_program_load_time(bool cache_hit, float_t load_time);
+Stats const& get_stats();
+
+}  // namespace shader_binary_cache
+
+}  // namespace BT
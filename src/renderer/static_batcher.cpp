@@ -0,0 +1,185 @@
+#include "static_batcher.h"
+
+#include "btglm.h"
+#include "glad/glad.h"
+#include "gl_state_cache.h"
+#include "mesh.h"
+#include "render_queue.h"
+#include "vertex_formats.h"
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+
+
+BT::static_batcher::Source BT::static_batcher::make_model_source(Model const& model,
+                                                                vec4 const* transform,
+                                                                Render_layer layer)
+{
+    Source source{ .vertices = &model.get_vertices(),
+                   .model_aabb = &model.get_aabb(),
+                   .transform = transform,
+                   .layer = layer };
+    for (auto const& mesh : model.get_meshes())
+        source.meshes.push_back({ &mesh.get_indices(), mesh.get_material() });
+    return source;
+}
+
+vector<BT::static_batcher::Merged_batch> BT::static_batcher::merge(
+    vector<Source> const& sources,
+    float_t cell_size,
+    size_t max_batch_vertices)
+{
+    assert(cell_size > 0.0f);
+    vector<Merged_batch> batches;
+
+    // Source vertex idx to batch vertex idx. Stamps mark which entries are from the current mesh,
+    // so that they don't need clearing between meshes.
+    vector<uint32_t> vertex_remap;
+    vector<uint32_t> vertex_remap_stamps;
+    uint32_t stamp{ 0 };
+
+    for (auto const& source : sources)
+    {
+        auto const& vertices{ *source.vertices };
+        vertex_remap.resize(vertices.size());
+        vertex_remap_stamps.resize(vertices.size(), 0);
+
+        mat4 transform;
+        glm_mat4_copy(const_cast<vec4*>(source.transform), transform);
+        mat3 normal_matrix;
+        btglm_mat4_normal_matrix(transform, normal_matrix);
+
+        // Whole source goes into the cell its world bounds are centered in.
+        AA_bounding_box source_world_aabb;
+        source.model_aabb->calc_transformed(transform, source_world_aabb);
+        int32_t cell[3];
+        for (size_t i = 0; i < 3; i++)
+        {
+            float_t center{ (source_world_aabb.min[i] + source_world_aabb.max[i]) * 0.5f };
+            cell[i] = static_cast<int32_t>(std::floor(center / cell_size));
+        }
+
+        for (auto const& mesh : source.meshes)
+        {
+            auto const& indices{ *mesh.indices };
+            if (indices.empty())
+                continue;
+
+            // Count vertices used by mesh.
+            stamp++;
+            size_t num_mesh_vertices{ 0 };
+            for (uint32_t idx : indices)
+                if (vertex_remap_stamps[idx] != stamp)
+                {
+                    vertex_remap_stamps[idx] = stamp;
+                    num_mesh_vertices++;
+                }
+
+            // Find batch to merge into (only the latest one with the same layer, material and cell).
+            Merged_batch* batch{ nullptr };
+            for (auto it = batches.rbegin(); it != batches.rend(); it++)
+                if (it->layer == source.layer &&
+                    it->material == mesh.material &&
+                    std::equal(cell, cell + 3, it->cell))
+                {
+                    if (it->vertices.size() + num_mesh_vertices <= max_batch_vertices)
+                        batch = &*it;
+                    break;
+                }
+
+            if (batch == nullptr)
+            {   // Start new batch.
+                batches.emplace_back(Merged_batch{ .layer = source.layer,
+                                                   .material = mesh.material,
+                                                   .cell = { cell[0], cell[1], cell[2] } });
+                batch = &batches.back();
+                batch->world_aabb.reset();
+            }
+
+            // Copy used vertices into world space.
+            stamp++;
+            batch->indices.reserve(batch->indices.size() + indices.size());
+            for (uint32_t idx : indices)
+            {
+                if (vertex_remap_stamps[idx] != stamp)
+                {
+                    vertex_remap_stamps[idx] = stamp;
+                    vertex_remap[idx] = static_cast<uint32_t>(batch->vertices.size());
+
+                    Vertex world_vertex{ vertices[idx] };
+                    glm_mat4_mulv3(transform, world_vertex.position, 1.0f, world_vertex.position);
+                    glm_mat3_mulv(normal_matrix, world_vertex.normal, world_vertex.normal);
+                    glm_vec3_normalize(world_vertex.normal);
+
+                    batch->world_aabb.feed_position(world_vertex.position);
+                    batch->vertices.emplace_back(world_vertex);
+                }
+
+                batch->indices.emplace_back(vertex_remap[idx]);
+            }
+
+            batch->num_merged_meshes++;
+        }
+    }
+
+    return batches;
+}
+
+
+BT::Static_batch::Static_batch(static_batcher::Merged_batch const& merged_batch)
+    : m_layer{ merged_batch.layer }
+    , m_material{ merged_batch.material }
+    , m_world_aabb{ merged_batch.world_aabb }
+    , m_num_indices{ static_cast<uint32_t>(merged_batch.indices.size()) }
+    , m_mesh_sort_id{ Mesh::acquire_sort_id() }
+{
+    assert(m_material != nullptr);
+
+    auto compact_vertices{ vertex_formats::make_compact_vertices(merged_batch.vertices.data(),
+                                                                 merged_batch.vertices.size()) };
+
+    glGenVertexArrays(1, &m_vertex_vao);
+    glGenBuffers(1, &m_vertex_vbo);
+    glGenBuffers(1, &m_index_ebo);
+
+    get_main_gl_state_cache().bind_vertex_array(m_vertex_vao);
+    glBindBuffer(GL_ARRAY_BUFFER, m_vertex_vbo);
+    glBufferData(GL_ARRAY_BUFFER,
+                 compact_vertices.size() * sizeof(Compact_vertex),
+                 compact_vertices.data(),
+                 GL_STATIC_DRAW);
+
+    // Register vertex attributes.
+    vertex_formats::setup_compact_vertex_attribs();
+
+    // @NOTE: Element array buffer binding is part of VAO state.
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, m_index_ebo);
+    glBufferData(GL_ELEMENT_ARRAY_BUFFER,
+                 merged_batch.indices.size() * sizeof(uint32_t),
+                 merged_batch.indices.data(),
+                 GL_STATIC_DRAW);
+
+    // Unbind.
+    get_main_gl_state_cache().bind_vertex_array(0);
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
+}
+
+BT::Static_batch::~Static_batch()
+{
+    get_main_gl_state_cache().delete_vertex_array(m_vertex_vao);
+    glDeleteBuffers(1, &m_vertex_vbo);
+    glDeleteBuffers(1, &m_index_ebo);
+    Mesh::release_sort_id(m_mesh_sort_id);
+}
+
+void BT::Static_batch::emplace_draw(Render_queue& render_queue) const
+{
+    render_queue.emplace_draw(m_layer,
+                              *m_material,
+                              m_mesh_sort_id * Mesh::k_max_lod_levels,
+                              m_vertex_vao,
+                              m_index_ebo,
+                              m_num_indices,
+                              const_cast<vec4*>(m_transform));
+}
@@ -0,0 +1,97 @@
+#pragma once
+
+#include "btglm.h"
+#include "mesh.h"
+#include "render_layer.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+using std::vector;
+
+
+namespace BT
+{
+
+class Material_ifc;
+class Render_queue;
+
+/// Merging of static (never moving) render objects into world space batches, so that static
+/// scenery sharing a material gets drawn with one draw call.
+namespace static_batcher
+{
+
+struct Source_mesh
+{
+    vector<uint32_t> const* indices;  // Full detail.
+    Material_ifc* material;
+};
+
+struct Source
+{
+    vector<Vertex> const* vertices;  // Model space, shared by all meshes.
+    vector<Source_mesh> meshes;
+    AA_bounding_box const* model_aabb;
+    vec4 const* transform;  // Model to world.
+    Render_layer layer;
+};
+
+/// Source w/ the full detail meshes of `model`.
+Source make_model_source(Model const& model, vec4 const* transform, Render_layer layer);
+
+struct Merged_batch
+{
+    Render_layer layer;
+    Material_ifc* material;
+    int32_t cell[3];  // Grid cell the merged sources' bounds are centered in.
+    vector<Vertex> vertices;  // World space.
+    vector<uint32_t> indices;
+    AA_bounding_box world_aabb;
+    size_t num_merged_meshes{ 0 };
+};
+
+/// Merges the meshes of `sources` into batches with the same layer, material and grid cell (a
+/// `cell_size` sized cube in world space), so that batches stay small enough to get frustum and
+/// occlusion culled. Only the vertices a mesh uses get copied into its batch. A new batch gets
+/// started once a batch would go over `max_batch_vertices` (unless it's empty). Batches are in
+/// order of first appearance in `sources`, so the result is deterministic.
+// @NOTE: Does not touch OpenGL.
+vector<Merged_batch> merge(vector<Source> const& sources,
+                           float_t cell_size,
+                           size_t max_batch_vertices);
+
+}  // namespace static_batcher
+
+/// GPU copy of a merged static batch.
+// @NOTE: Always drawn at full detail, since LOD levels don't get merged.
+class Static_batch
+{
+public:
+    Static_batch(static_batcher::Merged_batch const& merged_batch);
+    Static_batch(Static_batch const&)            = delete;
+    Static_batch(Static_batch&&)                 = delete;
+    Static_batch& operator=(Static_batch const&) = delete;
+    Static_batch& operator=(Static_batch&&)      = delete;
+    ~Static_batch();
+
+    Render_layer get_layer() const { return m_layer; }
+    AA_bounding_box const& get_world_aabb() const { return m_world_aabb; }
+
+    void emplace_draw(Render_queue& render_queue) const;
+
+private:
+    Render_layer m_layer;
+    Material_ifc* m_material;
+    AA_bounding_box m_world_aabb;
+    uint32_t m_num_indices;
+    uint32_t m_mesh_sort_id;
+
+    uint32_t m_vertex_vao;
+    uint32_t m_vertex_vbo;
+    uint32_t m_index_ebo;
+
+    mat4 m_transform = GLM_MAT4_IDENTITY_INIT;  // Vertices are already in world space.
+};
+
+}  // namespace BT
@@ -0,0 +1,97 @@
+#include "stream_buffer.h"
+
+#include "btlogger.h"
+#include "glad/glad.h"
+#include <algorithm>
+#include <cassert>
+
+
+BT::Stream_buffer::Stream_buffer(size_t region_size)
+{
+    // Align to the strictest binding offset alignment so any allocation can be bound as a range.
+    GLint ubo_alignment;
+    GLint ssbo_alignment;
+    glGetIntegerv(GL_UNIFORM_BUFFER_OFFSET_ALIGNMENT, &ubo_alignment);
+    glGetIntegerv(GL_SHADER_STORAGE_BUFFER_OFFSET_ALIGNMENT, &ssbo_alignment);
+    m_alignment = static_cast<size_t>(std::max({ ubo_alignment, ssbo_alignment, 16 }));
+
+    m_region_size = (region_size + m_alignment - 1) / m_alignment * m_alignment;
+
+    constexpr GLbitfield k_flags{ GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT };
+    size_t total_size{ m_region_size * k_num_frames_in_flight };
+
+    glGenBuffers(1, &m_buffer);
+    glBindBuffer(GL_SHADER_STORAGE_BUFFER, m_buffer);
+    glBufferStorage(GL_SHADER_STORAGE_BUFFER, total_size, nullptr, k_flags);
+    m_mapped_data = static_cast<uint8_t*>(
+        glMapBufferRange(GL_SHADER_STORAGE_BUFFER, 0, total_size, k_flags));
+    glBindBuffer(GL_SHADER_STORAGE_BUFFER, 0);
+
+    if (m_mapped_data == nullptr)
+    {
+        logger::printe(logger::ERROR, "Failed to persistently map stream buffer.");
+        assert(false);
+    }
+}
+
+BT::Stream_buffer::~Stream_buffer()
+{
+    for (auto& fence : m_region_fences)
+        if (fence != nullptr)
+            glDeleteSync(reinterpret_cast<GLsync>(fence));
+
+    glBindBuffer(GL_SHADER_STORAGE_BUFFER, m_buffer);
+    glUnmapBuffer(GL_SHADER_STORAGE_BUFFER);
+    glBindBuffer(GL_SHADER_STORAGE_BUFFER, 0);
+    glDeleteBuffers(1, &m_buffer);
+}
+
+void BT::Stream_buffer::begin_frame()
+{
+    m_curr_region_idx    = (m_curr_region_idx + 1) % k_num_frames_in_flight;
+    m_curr_region_offset = 0;
+
+    auto& fence{ m_region_fences[m_curr_region_idx] };
+    if (fence == nullptr)
+        return;
+
+    // Wait until GPU is done reading this region.
+    auto sync{ reinterpret_cast<GLsync>(fence) };
+    GLenum wait_result{ glClientWaitSync(sync, 0, 0) };
+    if (wait_result == GL_TIMEOUT_EXPIRED)
+    {
+        m_stats.num_fence_waits++;
+        do
+        {
+            constexpr GLuint64 k_timeout_ns{ 1'000'000 };
+            wait_result = glClientWaitSync(sync, GL_SYNC_FLUSH_COMMANDS_BIT, k_timeout_ns);
+        } while (wait_result == GL_TIMEOUT_EXPIRED);
+    }
+    assert(wait_result != GL_WAIT_FAILED);
+
+    glDeleteSync(sync);
+    fence = nullptr;
+}
+
+BT::Stream_buffer::Allocation BT::Stream_buffer::allocate(size_t size)
+{
+    size_t aligned_size{ (size + m_alignment - 1) / m_alignment * m_alignment };
+    if (m_curr_region_offset + aligned_size > m_region_size)
+    {   // Not enough space.
+        return {};
+    }
+
+    size_t offset{ m_curr_region_idx * m_region_size + m_curr_region_offset };
+    m_curr_region_offset += aligned_size;
+
+    return { m_mapped_data + offset, offset, size };
+}
+
+void BT::Stream_buffer::end_frame()
+{
+    auto& fence{ m_region_fences[m_curr_region_idx] };
+    assert(fence == nullptr);
+    fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+
+    m_stats.bytes_allocated_last_frame = m_curr_region_offset;
+}
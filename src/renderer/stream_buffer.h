@@ -0,0 +1,66 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+
+namespace BT
+{
+
+/// Persistently mapped GPU buffer for data that gets rewritten every frame (debug lines, instance
+/// transforms, etc.). The buffer is split into one region per frame in flight, and each region is
+/// fenced after the frame's draws. Writing only waits on the GPU if it's still reading the region
+/// from `k_num_frames_in_flight` frames ago.
+class Stream_buffer
+{
+public:
+    static constexpr uint32_t k_num_frames_in_flight{ 3 };
+
+    Stream_buffer(size_t region_size);
+    Stream_buffer(Stream_buffer const&)            = delete;
+    Stream_buffer(Stream_buffer&&)                 = delete;
+    Stream_buffer& operator=(Stream_buffer const&) = delete;
+    Stream_buffer& operator=(Stream_buffer&&)      = delete;
+    ~Stream_buffer();
+
+    struct Allocation
+    {
+        void* data{ nullptr };  // Nullptr if there wasn't enough space left in the region.
+        size_t offset{ 0 };     // Offset in buffer, for `glBindBufferRange()`.
+        size_t size{ 0 };
+    };
+
+    /// Moves to the next region, waiting on its fence if the GPU isn't done with it.
+    void begin_frame();
+
+    /// Allocates `size` bytes in the current region. Offsets are aligned for binding as uniform or
+    /// shader storage buffer ranges.
+    Allocation allocate(size_t size);
+
+    /// Fences the current region. Call after all draws reading this frame's allocations.
+    void end_frame();
+
+    uint32_t get_buffer() const { return m_buffer; }
+
+    struct Stats
+    {
+        size_t bytes_allocated_last_frame{ 0 };
+        size_t num_fence_waits{ 0 };  // Total times the CPU had to wait on the GPU.
+    };
+    Stats const& get_stats() const { return m_stats; }
+
+private:
+    size_t m_region_size;
+    size_t m_alignment;
+    uint32_t m_buffer{ 0 };
+    uint8_t* m_mapped_data{ nullptr };
+
+    uint32_t m_curr_region_idx{ 0 };
+    size_t m_curr_region_offset{ 0 };
+    std::array<void*, k_num_frames_in_flight> m_region_fences{};  // `GLsync`.
+
+    Stats m_stats;
+};
+
+}  // namespace BT
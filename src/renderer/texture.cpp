@@ -3,6 +3,7 @@
 #include "btlogger.h"
 // @NOTE: This should be abstract but is actually a specialization of OpenGL code.
 #include "glad/glad.h"
+#include "gl_state_cache.h"
 #define STB_IMAGE_IMPLEMENTATION
 #include "stb_image.h"
 #include <cassert>
@@ -27,7 +28,7 @@ uint32_t BT::Texture_bank::load_texture_2d_from_file(string const& fname, uint32
     assert(channels == 3);
     uint32_t texture_id;
     glGenTextures(1, &texture_id);
-    glBindTexture(GL_TEXTURE_2D, texture_id);
+    get_main_gl_state_cache().bind_texture_2d(0, texture_id);
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
@@ -0,0 +1,210 @@
+#include "vertex_cache_optimizer.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <limits>
+
+
+namespace
+{
+
+constexpr size_t k_sim_cache_size{ 32 };
+constexpr float_t k_cache_decay_power{ 1.5f };
+constexpr float_t k_last_tri_score{ 0.75f };
+constexpr float_t k_valence_boost_scale{ 2.0f };
+constexpr float_t k_valence_boost_power{ 0.5f };
+constexpr uint32_t k_invalid_idx{ std::numeric_limits<uint32_t>::max() };
+
+float_t calc_vertex_score(int32_t cache_pos, uint32_t num_remaining_tris)
+{
+    if (num_remaining_tris == 0)
+        return -1.0f;  // Not used by any more triangles.
+
+    float_t score{ 0.0f };
+    if (cache_pos >= 0)
+    {
+        if (cache_pos < 3)
+        {   // Was in the last triangle. Fixed score so that strips don't get favored too much.
+            score = k_last_tri_score;
+        }
+        else
+        {
+            float_t scaler{ 1.0f / (k_sim_cache_size - 3) };
+            score = std::pow(1.0f - (cache_pos - 3) * scaler, k_cache_decay_power);
+        }
+    }
+
+    // Bonus for vertices with few triangles left, so that lone triangles don't get left behind.
+    score += k_valence_boost_scale *
+             std::pow(static_cast<float_t>(num_remaining_tris), -k_valence_boost_power);
+    return score;
+}
+
+}  // namespace
+
+
+void BT::vertex_cache_optimizer::optimize_triangle_order(vector<uint32_t>& indices,
+                                                         size_t num_vertices)
+{
+    size_t num_tris{ indices.size() / 3 };
+    if (num_tris == 0)
+        return;
+
+    // Vertex to triangle adjacency. Emitted triangles get swapped out past the active count.
+    vector<uint32_t> adj_offsets(num_vertices + 1, 0);
+    for (size_t i = 0; i < num_tris * 3; i++)
+    {
+        assert(indices[i] < num_vertices);
+        adj_offsets[indices[i] + 1]++;
+    }
+    for (size_t i = 1; i < adj_offsets.size(); i++)
+        adj_offsets[i] += adj_offsets[i - 1];
+
+    vector<uint32_t> adj_tris(num_tris * 3);
+    vector<uint32_t> num_active_tris(num_vertices, 0);
+    for (size_t i = 0; i < num_tris * 3; i++)
+    {
+        uint32_t vert_idx{ indices[i] };
+        adj_tris[adj_offsets[vert_idx] + num_active_tris[vert_idx]] = static_cast<uint32_t>(i / 3);
+        num_active_tris[vert_idx]++;
+    }
+
+    vector<float_t> vertex_scores(num_vertices);
+    for (size_t i = 0; i < num_vertices; i++)
+        vertex_scores[i] = calc_vertex_score(-1, num_active_tris[i]);
+
+    vector<float_t> tri_scores(num_tris);
+    vector<uint8_t> tri_emitted(num_tris, 0);
+    uint32_t best_tri{ 0 };
+    for (size_t i = 0; i < num_tris; i++)
+    {
+        tri_scores[i] = (vertex_scores[indices[i * 3 + 0]] +
+                         vertex_scores[indices[i * 3 + 1]] +
+                         vertex_scores[indices[i * 3 + 2]]);
+        if (tri_scores[i] > tri_scores[best_tri])
+            best_tri = static_cast<uint32_t>(i);
+    }
+
+    vector<uint32_t> new_indices;
+    new_indices.reserve(num_tris * 3);
+
+    vector<uint32_t> cache;
+    vector<uint32_t> next_cache;
+    cache.reserve(k_sim_cache_size + 3);
+    next_cache.reserve(k_sim_cache_size + 3);
+
+    size_t next_unemitted_tri{ 0 };
+    for (size_t num_emitted = 0; num_emitted < num_tris; num_emitted++)
+    {
+        if (best_tri == k_invalid_idx)
+        {   // Nothing in the cache is connected to anything left, so start somewhere else.
+            while (tri_emitted[next_unemitted_tri])
+                next_unemitted_tri++;
+            best_tri = static_cast<uint32_t>(next_unemitted_tri);
+        }
+
+        // Emit triangle.
+        uint32_t const* tri{ &indices[best_tri * 3] };
+        tri_emitted[best_tri] = 1;
+        next_cache.clear();
+        for (size_t i = 0; i < 3; i++)
+        {
+            uint32_t vert_idx{ tri[i] };
+            new_indices.emplace_back(vert_idx);
+            next_cache.emplace_back(vert_idx);
+
+            uint32_t* vert_adj_tris{ &adj_tris[adj_offsets[vert_idx]] };
+            uint32_t& num_vert_active_tris{ num_active_tris[vert_idx] };
+            for (uint32_t j = 0; j < num_vert_active_tris; j++)
+                if (vert_adj_tris[j] == best_tri)
+                {
+                    std::swap(vert_adj_tris[j], vert_adj_tris[num_vert_active_tris - 1]);
+                    num_vert_active_tris--;
+                    break;
+                }
+        }
+
+        // Push triangle's vertices to the front of the cache.
+        for (uint32_t vert_idx : cache)
+            if (vert_idx != tri[0] && vert_idx != tri[1] && vert_idx != tri[2])
+                next_cache.emplace_back(vert_idx);
+        std::swap(cache, next_cache);
+
+        // Update scores of vertices in the cache and the ones that just fell out of it.
+        for (size_t i = 0; i < cache.size(); i++)
+        {
+            uint32_t vert_idx{ cache[i] };
+            int32_t cache_pos{ i < k_sim_cache_size ? static_cast<int32_t>(i) : -1 };
+
+            float_t new_score{ calc_vertex_score(cache_pos, num_active_tris[vert_idx]) };
+            float_t score_delta{ new_score - vertex_scores[vert_idx] };
+            vertex_scores[vert_idx] = new_score;
+
+            uint32_t const* vert_adj_tris{ &adj_tris[adj_offsets[vert_idx]] };
+            for (uint32_t j = 0; j < num_active_tris[vert_idx]; j++)
+                tri_scores[vert_adj_tris[j]] += score_delta;
+        }
+        if (cache.size() > k_sim_cache_size)
+            cache.resize(k_sim_cache_size);
+
+        // Next best triangle is one of the triangles using the cached vertices.
+        best_tri = k_invalid_idx;
+        float_t best_tri_score{ -std::numeric_limits<float_t>::max() };
+        for (uint32_t vert_idx : cache)
+        {
+            uint32_t const* vert_adj_tris{ &adj_tris[adj_offsets[vert_idx]] };
+            for (uint32_t j = 0; j < num_active_tris[vert_idx]; j++)
+                if (tri_scores[vert_adj_tris[j]] > best_tri_score)
+                {
+                    best_tri = vert_adj_tris[j];
+                    best_tri_score = tri_scores[best_tri];
+                }
+        }
+    }
+
+    std::copy(new_indices.begin(), new_indices.end(), indices.begin());
+}
+
+float_t BT::vertex_cache_optimizer::calc_acmr(vector<uint32_t> const& indices, size_t cache_size)
+{
+    size_t num_tris{ indices.size() / 3 };
+    if (num_tris == 0)
+        return 0.0f;
+
+    uint32_t max_vert_idx{ *std::max_element(indices.begin(), indices.end()) };
+
+    // FIFO cache: a vertex is in the cache if it was pushed within the last `cache_size` misses.
+    vector<size_t> push_times(static_cast<size_t>(max_vert_idx) + 1, 0);
+    size_t num_misses{ 0 };
+    for (size_t i = 0; i < num_tris * 3; i++)
+    {
+        size_t& push_time{ push_times[indices[i]] };
+        if (push_time == 0 || num_misses - push_time >= cache_size)
+        {
+            num_misses++;
+            push_time = num_misses;
+        }
+    }
+
+    return static_cast<float_t>(num_misses) / num_tris;
+}
+
+vector<uint32_t> BT::vertex_cache_optimizer::calc_vertex_fetch_remap(
+    vector<vector<uint32_t> const*> const& index_lists,
+    size_t num_vertices)
+{
+    vector<uint32_t> remap(num_vertices, k_invalid_idx);
+    uint32_t next_vert_idx{ 0 };
+    for (auto index_list : index_lists)
+        for (uint32_t vert_idx : *index_list)
+            if (remap[vert_idx] == k_invalid_idx)
+                remap[vert_idx] = next_vert_idx++;
+
+    for (auto& new_vert_idx : remap)
+        if (new_vert_idx == k_invalid_idx)
+            new_vert_idx = next_vert_idx++;
+
+    assert(next_vert_idx == num_vertices);
+    return remap;
+}
@@ -0,0 +1,34 @@
+#pragma once
+
+#include "btglm.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+using std::vector;
+
+
+namespace BT
+{
+
+/// Import stage reorders of index and vertex buffers for the post-transform vertex cache and for
+/// vertex fetch locality.
+namespace vertex_cache_optimizer
+{
+
+/// Reorders triangles of triangle list `indices` so that vertices get reused while still in the
+/// post-transform cache (Forsyth's linear-speed algorithm). Winding of triangles is kept.
+void optimize_triangle_order(vector<uint32_t>& indices, size_t num_vertices);
+
+/// Average cache miss ratio (transformed vertices per triangle) of `indices` with a FIFO cache of
+/// `cache_size` entries. 0.5 is the best case for big regular meshes, 3.0 is the worst.
+float_t calc_acmr(vector<uint32_t> const& indices, size_t cache_size = 16);
+
+/// Old to new vertex idx remap so that vertices are in order of first use by `index_lists`.
+/// Vertices that aren't used go at the end in their original order.
+vector<uint32_t> calc_vertex_fetch_remap(vector<vector<uint32_t> const*> const& index_lists,
+                                         size_t num_vertices);
+
+}  // namespace vertex_cache_optimizer
+}  // namespace BT
@@ -0,0 +1,196 @@
+#include "vertex_formats.h"
+
+#include "btglm.h"
+#include "glad/glad.h"
+#include "mesh.h"
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <cstddef>
+#include <cstring>
+
+
+namespace
+{
+
+int32_t quantize_snorm(float_t value, int32_t max_value)
+{
+    return static_cast<int32_t>(std::round(std::clamp(value, -1.0f, 1.0f) * max_value));
+}
+
+}  // namespace
+
+
+uint16_t BT::vertex_formats::pack_half(float_t value)
+{
+    uint32_t bits;
+    std::memcpy(&bits, &value, sizeof(bits));
+
+    uint32_t sign{ (bits >> 16) & 0x8000 };
+    uint32_t float_exponent{ (bits >> 23) & 0xFF };
+    int32_t exponent{ static_cast<int32_t>(float_exponent) - 127 + 15 };
+    uint32_t mantissa{ bits & 0x7FFFFF };
+
+    if (float_exponent == 0xFF)  // Inf or NaN.
+        return static_cast<uint16_t>(sign | 0x7C00 | (mantissa != 0 ? 0x200 : 0));
+    if (exponent >= 31)  // Too big, so inf.
+        return static_cast<uint16_t>(sign | 0x7C00);
+
+    if (exponent <= 0)
+    {   // Subnormal half (or zero if too small).
+        if (exponent < -10)
+            return static_cast<uint16_t>(sign);
+
+        mantissa |= 0x800000;
+        uint32_t shift{ static_cast<uint32_t>(14 - exponent) };
+        uint32_t half_mantissa{ mantissa >> shift };
+        uint32_t remainder{ mantissa & ((1u << shift) - 1) };
+        uint32_t halfway{ 1u << (shift - 1) };
+        if (remainder > halfway || (remainder == halfway && (half_mantissa & 1)))
+            half_mantissa++;
+        return static_cast<uint16_t>(sign | half_mantissa);
+    }
+
+    // Round to nearest even. Carry into the exponent rounds up to the next power of 2 (or inf).
+    uint32_t half{ sign | (static_cast<uint32_t>(exponent) << 10) | (mantissa >> 13) };
+    uint32_t remainder{ mantissa & 0x1FFF };
+    if (remainder > 0x1000 || (remainder == 0x1000 && (half & 1)))
+        half++;
+    return static_cast<uint16_t>(half);
+}
+
+uint32_t BT::vertex_formats::pack_half2(vec2 value)
+{
+    return (static_cast<uint32_t>(pack_half(value[0])) |
+            (static_cast<uint32_t>(pack_half(value[1])) << 16));
+}
+
+uint32_t BT::vertex_formats::pack_snorm_10_10_10_2(vec3 normal)
+{
+    constexpr int32_t k_max_value{ 511 };
+    return ((static_cast<uint32_t>(quantize_snorm(normal[0], k_max_value)) & 0x3FF) |
+            ((static_cast<uint32_t>(quantize_snorm(normal[1], k_max_value)) & 0x3FF) << 10) |
+            ((static_cast<uint32_t>(quantize_snorm(normal[2], k_max_value)) & 0x3FF) << 20));
+}
+
+uint32_t BT::vertex_formats::pack_octahedral_snorm16(vec3 normal)
+{
+    float_t l1_norm{ std::abs(normal[0]) + std::abs(normal[1]) + std::abs(normal[2]) };
+    if (l1_norm <= 0.0f)
+        return 0;
+
+    float_t oct_x{ normal[0] / l1_norm };
+    float_t oct_y{ normal[1] / l1_norm };
+    if (normal[2] < 0.0f)
+    {   // Fold lower hemisphere over the diagonals.
+        float_t folded_x{ (1.0f - std::abs(oct_y)) * (oct_x >= 0.0f ? 1.0f : -1.0f) };
+        float_t folded_y{ (1.0f - std::abs(oct_x)) * (oct_y >= 0.0f ? 1.0f : -1.0f) };
+        oct_x = folded_x;
+        oct_y = folded_y;
+    }
+
+    constexpr int32_t k_max_value{ 32767 };
+    return ((static_cast<uint32_t>(quantize_snorm(oct_x, k_max_value)) & 0xFFFF) |
+            ((static_cast<uint32_t>(quantize_snorm(oct_y, k_max_value)) & 0xFFFF) << 16));
+}
+
+void BT::vertex_formats::unpack_octahedral_snorm16(uint32_t packed, vec3 out_normal)
+{
+    float_t oct_x{ std::max(static_cast<int16_t>(packed & 0xFFFF) / 32767.0f, -1.0f) };
+    float_t oct_y{ std::max(static_cast<int16_t>(packed >> 16) / 32767.0f, -1.0f) };
+
+    out_normal[0] = oct_x;
+    out_normal[1] = oct_y;
+    out_normal[2] = 1.0f - std::abs(oct_x) - std::abs(oct_y);
+    if (out_normal[2] < 0.0f)
+    {
+        out_normal[0] = (1.0f - std::abs(oct_y)) * (oct_x >= 0.0f ? 1.0f : -1.0f);
+        out_normal[1] = (1.0f - std::abs(oct_x)) * (oct_y >= 0.0f ? 1.0f : -1.0f);
+    }
+    glm_vec3_normalize(out_normal);
+}
+
+vector<BT::Compact_vertex> BT::vertex_formats::make_compact_vertices(Vertex const* vertices,
+                                                                     size_t num_vertices)
+{
+    vector<Compact_vertex> compact_vertices(num_vertices);
+    for (size_t i = 0; i < num_vertices; i++)
+    {
+        auto& vertex{ const_cast<Vertex&>(vertices[i]) };
+        glm_vec3_copy(vertex.position, compact_vertices[i].position);
+        compact_vertices[i].normal = pack_snorm_10_10_10_2(vertex.normal);
+        compact_vertices[i].tex_coord = pack_half2(vertex.tex_coord);
+    }
+
+    return compact_vertices;
+}
+
+vector<BT::Compact_skinning_vertex> BT::vertex_formats::make_compact_skinning_vertices(
+    Vertex const* vertices,
+    size_t num_vertices)
+{
+    vector<Compact_skinning_vertex> compact_vertices(num_vertices);
+    for (size_t i = 0; i < num_vertices; i++)
+    {
+        auto& vertex{ const_cast<Vertex&>(vertices[i]) };
+        glm_vec3_copy(vertex.position, compact_vertices[i].position);
+        compact_vertices[i].oct_normal = pack_octahedral_snorm16(vertex.normal);
+        compact_vertices[i].tex_coord = pack_half2(vertex.tex_coord);
+    }
+
+    return compact_vertices;
+}
+
+vector<BT::Compact_vertex_skin_data> BT::vertex_formats::make_compact_skin_datas(
+    Vertex_skin_data const* skin_datas,
+    size_t num_skin_datas)
+{
+    vector<Compact_vertex_skin_data> compact_skin_datas(num_skin_datas);
+    for (size_t i = 0; i < num_skin_datas; i++)
+    {
+        auto const& skin_data{ skin_datas[i] };
+        auto& compact_skin_data{ compact_skin_datas[i] };
+
+        uint32_t weight_sum{ 0 };
+        size_t biggest_weight_idx{ 0 };
+        for (size_t j = 0; j < 4; j++)
+        {
+            assert(skin_data.joint_mat_idxs[j] <= 0xFFFF);
+            compact_skin_data.joint_mat_idxs[j] =
+                static_cast<uint16_t>(skin_data.joint_mat_idxs[j]);
+            compact_skin_data.weights[j] = static_cast<uint16_t>(
+                std::round(std::clamp(skin_data.weights[j], 0.0f, 1.0f) * 65535.0f));
+
+            weight_sum += compact_skin_data.weights[j];
+            if (compact_skin_data.weights[j] > compact_skin_data.weights[biggest_weight_idx])
+                biggest_weight_idx = j;
+        }
+
+        if (weight_sum > 0)
+        {   // Put rounding error into the biggest weight so that weights still sum to 1.
+            int32_t fixed_weight{ static_cast<int32_t>(
+                                      compact_skin_data.weights[biggest_weight_idx]) +
+                                  (65535 - static_cast<int32_t>(weight_sum)) };
+            compact_skin_data.weights[biggest_weight_idx] =
+                static_cast<uint16_t>(std::clamp(fixed_weight, 0, 65535));
+        }
+    }
+
+    return compact_skin_datas;
+}
+
+void BT::vertex_formats::setup_compact_vertex_attribs()
+{
+    glEnableVertexAttribArray(0);
+    glEnableVertexAttribArray(1);
+    glEnableVertexAttribArray(2);
+    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE,
+                          sizeof(Compact_vertex),
+                          reinterpret_cast<void*>(offsetof(Compact_vertex, position)));
+    glVertexAttribPointer(1, 4, GL_INT_2_10_10_10_REV, GL_TRUE,
+                          sizeof(Compact_vertex),
+                          reinterpret_cast<void*>(offsetof(Compact_vertex, normal)));
+    glVertexAttribPointer(2, 2, GL_HALF_FLOAT, GL_FALSE,
+                          sizeof(Compact_vertex),
+                          reinterpret_cast<void*>(offsetof(Compact_vertex, tex_coord)));
+}
@@ -0,0 +1,70 @@
+#pragma once
+
+#include "btglm.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+using std::vector;
+
+
+namespace BT
+{
+
+struct Vertex;
+struct Vertex_skin_data;
+
+/// Compact vertex for static vertex buffers (20 bytes instead of the 32 of `Vertex`).
+/// Attributes get unpacked by the vertex fetch, so shaders still read `vec3` normals and `vec2`
+/// tex coords.
+struct Compact_vertex
+{
+    vec3 position;
+    uint32_t normal;     // Signed normalized 10:10:10:2 (`GL_INT_2_10_10_10_REV`).
+    uint32_t tex_coord;  // Half float x2.
+};
+static_assert(sizeof(Compact_vertex) == 20);
+
+/// Compact vertex for the skinning compute input.
+/// @NOTE: Must match `Compact_vertex` in "skinned_mesh.comp" (std430).
+struct Compact_skinning_vertex
+{
+    vec3 position;
+    uint32_t oct_normal;  // Octahedral encoded, signed normalized 16-bit x2.
+    uint32_t tex_coord;   // Half float x2.
+};
+static_assert(sizeof(Compact_skinning_vertex) == 20);
+
+/// Compact skin data for the skinning compute input (16 bytes instead of 32).
+/// @NOTE: Must match `Compact_vertex_skin_data` in "skinned_mesh.comp" (std430).
+struct Compact_vertex_skin_data
+{
+    uint16_t joint_mat_idxs[4];
+    uint16_t weights[4];  // Unsigned normalized 16-bit. Sum is exactly 1.0.
+};
+static_assert(sizeof(Compact_vertex_skin_data) == 16);
+
+namespace vertex_formats
+{
+
+uint16_t pack_half(float_t value);
+uint32_t pack_half2(vec2 value);
+uint32_t pack_snorm_10_10_10_2(vec3 normal);
+uint32_t pack_octahedral_snorm16(vec3 normal);
+
+/// Inverse of `pack_octahedral_snorm16()`. Same as the decode in "skinned_mesh.comp".
+void unpack_octahedral_snorm16(uint32_t packed, vec3 out_normal);
+
+vector<Compact_vertex> make_compact_vertices(Vertex const* vertices, size_t num_vertices);
+vector<Compact_skinning_vertex> make_compact_skinning_vertices(Vertex const* vertices,
+                                                               size_t num_vertices);
+vector<Compact_vertex_skin_data> make_compact_skin_datas(Vertex_skin_data const* skin_datas,
+                                                         size_t num_skin_datas);
+
+/// Registers attributes 0 (position), 1 (normal) and 2 (tex coord) of `Compact_vertex` for the
+/// currently bound vertex array and array buffer.
+void setup_compact_vertex_attribs();
+
+}  // namespace vertex_formats
+}  // namespace BT
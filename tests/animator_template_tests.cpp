@@ -0,0 +1,89 @@
+#include "renderer/animator_template.h"
+#include "renderer/animator_template_types.h"
+#include "test_harness.h"
+
+#include <string>
+#include <vector>
+
+
+namespace
+{
+
+using namespace BT::anim_tmpl_types;
+using BT::Animator_template;
+
+/// States A thru D, chained A -> B -> C -> D -> A, w/ some transitions leaving more than one
+/// state.
+Animator_template make_chained_test_template()
+{
+    Animator_template anim_template;
+    for (char const* state_name : { "st_a", "st_b", "st_c", "st_d" })
+        anim_template.animator_states.push_back({ state_name, "Idle", 1.0f, true });
+
+    anim_template.variables = { "bool go", "trig hit" };
+    anim_template.state_transitions = {
+        { { { "st_a" }, "st_b" }, "go eq true" },
+        { { { "st_b", "st_c", "st_b" }, "st_d" }, "hit" },  // `st_b` listed twice.
+        { { { "st_b" }, "st_c" }, "go eq false" },
+        { { { "st_a", "st_c" }, "st_d" }, "ON_ANIM_END" },
+        { { { "st_d" }, "st_a" }, "go neq true" },
+    };
+    anim_template.cook();
+    return anim_template;
+}
+
+/// Predicates of state `state_idx` in the compiled tables.
+std::vector<Transition_predicate> get_state_predicates(Compiled_state_transitions const& compiled,
+                                                       uint32_t state_idx)
+{
+    return { compiled.predicates.begin() + compiled.state_offsets[state_idx],
+             compiled.predicates.begin() + compiled.state_offsets[state_idx + 1] };
+}
+
+bool is_predicate(Transition_predicate const& predicate,
+                  size_t condition_var_idx,
+                  float_t compare_value,
+                  uint32_t to_state,
+                  uint32_t template_idx)
+{
+    return (predicate.condition_var_idx == condition_var_idx &&
+            predicate.compare_operator == Animator_state_transition::COMP_EQ &&
+            predicate.compare_value == compare_value &&
+            predicate.to_state == to_state &&
+            predicate.template_idx == template_idx);
+}
+
+}  // namespace
+
+
+BT_TEST(animator_template_compiles_per_state_transition_tables)
+{
+    auto anim_template{ make_chained_test_template() };
+    auto const& compiled{ anim_template.state_transitions_compiled };
+
+    // One predicate per from state of each transition (duplicate from states only once).
+    BT_CHECK(compiled.state_offsets == std::vector<uint32_t>({ 0, 2, 4, 6, 7 }));
+    BT_CHECK(compiled.predicates.size() == 7);
+    if (compiled.state_offsets.size() != 5 || compiled.predicates.size() != 7)
+        return;
+
+    // Kept in template order within each state, w/ conditions and target states resolved.
+    constexpr size_t k_go{ 0 };
+    constexpr size_t k_hit{ 1 };
+    auto state_a{ get_state_predicates(compiled, 0) };
+    BT_CHECK(is_predicate(state_a[0], k_go, k_bool_true, 1, 0));
+    BT_CHECK(is_predicate(state_a[1], k_on_anim_end_var_idx, k_trig_triggered, 3, 3));
+
+    auto state_b{ get_state_predicates(compiled, 1) };
+    BT_CHECK(is_predicate(state_b[0], k_hit, k_trig_triggered, 3, 1));
+    BT_CHECK(is_predicate(state_b[1], k_go, k_bool_false, 2, 2));
+
+    auto state_c{ get_state_predicates(compiled, 2) };
+    BT_CHECK(is_predicate(state_c[0], k_hit, k_trig_triggered, 3, 1));
+    BT_CHECK(is_predicate(state_c[1], k_on_anim_end_var_idx, k_trig_triggered, 3, 3));
+
+    auto state_d{ get_state_predicates(compiled, 3) };
+    BT_CHECK(state_d[0].compare_operator == Animator_state_transition::COMP_NEQ);
+    BT_CHECK(state_d[0].condition_var_idx == k_go && state_d[0].compare_value == k_bool_true);
+    BT_CHECK(state_d[0].to_state == 0 && state_d[0].template_idx == 4);
+}
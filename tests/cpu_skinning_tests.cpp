@@ -0,0 +1,167 @@
+#include "btglm.h"
+#include "renderer/cpu_skinning.h"
+#include "renderer/mesh.h"
+#include "test_harness.h"
+
+#include <cmath>
+#include <vector>
+
+
+namespace
+{
+
+using namespace BT;
+
+/// Joint matrix from a rotation (axis angle), non-uniform scale and translation.
+void make_joint_matrix(float_t angle,
+                       vec3 const& axis,
+                       vec3 const& scale,
+                       vec3 const& translation,
+                       mat4 out_matrix)
+{
+    glm_translate_make(out_matrix, const_cast<float_t*>(translation));
+    glm_rotate(out_matrix, angle, const_cast<float_t*>(axis));
+    glm_scale(out_matrix, const_cast<float_t*>(scale));
+}
+
+/// Normals pointing in a spread of directions.
+std::vector<Vertex> make_test_vertices()
+{
+    std::vector<Vertex> vertices;
+    for (int32_t x = -1; x <= 1; x++)
+    for (int32_t y = -1; y <= 1; y++)
+    for (int32_t z = -1; z <= 1; z++)
+    {
+        if (x == 0 && y == 0 && z == 0)
+            continue;
+
+        Vertex vertex{ { x * 0.5f, y * 2.0f, z * 1.0f },
+                       { static_cast<float_t>(x), static_cast<float_t>(y), static_cast<float_t>(z) },
+                       { 0.0f, 0.0f } };
+        glm_vec3_normalize(vertex.normal);
+        vertices.emplace_back(vertex);
+    }
+    return vertices;
+}
+
+/// What `skinned_mesh.comp` does per vertex w/ the palette: blend the joint matrices for the
+/// position and the normal matrices for the normal.
+void calc_reference_vertex(std::vector<cpu_skinning::Palette_entry> const& palette,
+                           Vertex_skin_data const& skin_data,
+                           Vertex const& vertex,
+                           Vertex& out_vertex)
+{
+    mat4 deform_transform = GLM_MAT4_ZERO_INIT;
+    mat4 normal_transform = GLM_MAT4_ZERO_INIT;
+    for (uint32_t j = 0; j < 4; j++)
+    for (uint32_t col = 0; col < 4; col++)
+    for (uint32_t row = 0; row < 4; row++)
+    {
+        auto const& entry{ palette[skin_data.joint_mat_idxs[j]] };
+        deform_transform[col][row] += entry.joint_matrix.raw[col][row] * skin_data.weights[j];
+        normal_transform[col][row] += entry.normal_matrix.raw[col][row] * skin_data.weights[j];
+    }
+
+    glm_mat4_mulv3(deform_transform, const_cast<float_t*>(vertex.position), 1.0f,
+                   out_vertex.position);
+    glm_mat4_mulv3(normal_transform, const_cast<float_t*>(vertex.normal), 0.0f, out_vertex.normal);
+    glm_vec3_normalize(out_vertex.normal);
+}
+
+/// Skins `vertices` w/ `kernel`, where every vertex uses `skin_data`.
+std::vector<Vertex> skin_test_vertices(std::vector<Vertex> const& vertices,
+                                       std::vector<cpu_skinning::Palette_entry> const& palette,
+                                       Vertex_skin_data const& skin_data,
+                                       cpu_skinning::Kernel kernel)
+{
+    std::vector<Vertex_skin_data> skin_datas(vertices.size(), skin_data);
+    std::vector<Vertex> skinned_vertices(vertices.size());
+    cpu_skinning::skin_vertex_range(kernel,
+                                    vertices.data(),
+                                    skin_datas.data(),
+                                    palette.data(),
+                                    0,
+                                    vertices.size(),
+                                    skinned_vertices.data());
+    return skinned_vertices;
+}
+
+/// Palette of a non-uniformly scaled joint, a rigid joint and a joint that collapses everything
+/// (so its normals are 0).
+std::vector<cpu_skinning::Palette_entry> make_test_palette()
+{
+    mat4 joint_matrices[3];
+    make_joint_matrix(0.7f, vec3{ 0, 1, 0 }, vec3{ 1.0f, 3.0f, 0.5f }, vec3{ 1, 2, 3 },
+                      joint_matrices[0]);
+    make_joint_matrix(-2.1f, vec3{ 1, 1, 0 }, vec3{ 1, 1, 1 }, vec3{ 0, -5, 0 },
+                      joint_matrices[1]);
+    make_joint_matrix(0.0f, vec3{ 0, 1, 0 }, vec3{ 0, 0, 0 }, vec3{ 0, 0, 0 },
+                      joint_matrices[2]);
+
+    std::vector<cpu_skinning::Palette_entry> palette(3);
+    for (size_t i = 0; i < 3; i++)
+        cpu_skinning::calc_palette_entry(joint_matrices[i], palette[i]);
+    return palette;
+}
+
+Vertex_skin_data const k_test_skin_datas[]{
+    { { 0, 0, 0, 0 }, { 1.0f, 0, 0, 0 } },
+    { { 0, 1, 0, 0 }, { 0.7f, 0.3f, 0, 0 } },
+    { { 2, 0, 0, 0 }, { 1.0f, 0, 0, 0 } },
+};
+
+}  // namespace
+
+
+BT_TEST(scalar_kernel_matches_palette_reference)
+{
+    auto palette{ make_test_palette() };
+    auto vertices{ make_test_vertices() };
+    for (auto const& skin_data : k_test_skin_datas)
+    {
+        auto skinned_vertices{
+            skin_test_vertices(vertices, palette, skin_data, cpu_skinning::KERNEL_SCALAR) };
+
+        for (size_t i = 0; i < vertices.size(); i++)
+        {
+            Vertex reference_vertex;
+            calc_reference_vertex(palette, skin_data, vertices[i], reference_vertex);
+            for (uint32_t axis = 0; axis < 3; axis++)
+            {
+                BT_CHECK_NEAR(skinned_vertices[i].position[axis],
+                              reference_vertex.position[axis],
+                              1e-5f);
+                BT_CHECK(std::isfinite(skinned_vertices[i].normal[axis]));
+                BT_CHECK_NEAR(skinned_vertices[i].normal[axis],
+                              reference_vertex.normal[axis],
+                              1e-5f);
+            }
+        }
+    }
+}
+
+BT_TEST(avx2_kernel_matches_scalar_kernel)
+{
+    if (!cpu_skinning::is_avx2_supported())
+        return;
+
+    auto palette{ make_test_palette() };
+    auto vertices{ make_test_vertices() };
+    for (auto const& skin_data : k_test_skin_datas)
+    {
+        auto scalar_vertices{
+            skin_test_vertices(vertices, palette, skin_data, cpu_skinning::KERNEL_SCALAR) };
+        auto avx2_vertices{
+            skin_test_vertices(vertices, palette, skin_data, cpu_skinning::KERNEL_AVX2) };
+
+        for (size_t i = 0; i < vertices.size(); i++)
+        for (uint32_t axis = 0; axis < 3; axis++)
+        {
+            BT_CHECK_NEAR(avx2_vertices[i].position[axis],
+                          scalar_vertices[i].position[axis],
+                          1e-5f);
+            BT_CHECK(std::isfinite(avx2_vertices[i].normal[axis]));
+            BT_CHECK_NEAR(avx2_vertices[i].normal[axis], scalar_vertices[i].normal[axis], 1e-5f);
+        }
+    }
+}
@@ -0,0 +1,151 @@
+#include "renderer/debug_render_job.h"
+#include "test_harness.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstdint>
+#include <iterator>
+#include <memory>
+#include <thread>
+#include <vector>
+
+
+namespace
+{
+
+using BT::Debug_line;
+using BT::Debug_line_pool;
+
+constexpr uint32_t k_num_threads{ 8 };
+constexpr uint32_t k_num_lines_per_thread{ Debug_line_pool::k_num_lines / k_num_threads };
+constexpr uint32_t k_batch_size{ 16 };
+
+/// Short, mid, long, and past the last expiry bucket (so kept in the overflow list).
+constexpr float_t k_test_timeouts[]{ 0.05f, 1.3f, 9.7f, 25.5f };
+constexpr size_t k_num_test_timeouts{ std::size(k_test_timeouts) };
+static_assert(k_test_timeouts[k_num_test_timeouts - 1] >
+              Debug_line_pool::k_num_expiry_buckets * Debug_line_pool::k_expiry_bucket_duration);
+
+float_t get_test_timeout(uint32_t line_id)
+{
+    return k_test_timeouts[line_id % k_num_test_timeouts];
+}
+
+/// Line tagged w/ its id, so it can be told apart from every other line.
+Debug_line make_test_line(uint32_t line_id)
+{
+    float_t id{ static_cast<float_t>(line_id) };
+    return { { id, 0, 0, 1 }, { id * 2.0f, 0, 0, 1 }, { 1, 1, 1, 1 }, { 1, 1, 1, 1 } };
+}
+
+/// Submits this thread's lines. Lines sharing a timeout go in as batches, every other batch as
+/// single lines instead.
+void submit_test_lines(Debug_line_pool& dbg_line_pool, uint32_t thread_idx)
+{
+    uint32_t first_line_id{ thread_idx * k_num_lines_per_thread };
+    for (uint32_t timeout_idx = 0; timeout_idx < k_num_test_timeouts; timeout_idx++)
+    {
+        std::vector<Debug_line> batch;
+        for (uint32_t i = timeout_idx; i < k_num_lines_per_thread; i += k_num_test_timeouts)
+        {
+            batch.emplace_back(make_test_line(first_line_id + i));
+            if (batch.size() == k_batch_size || i + k_num_test_timeouts >= k_num_lines_per_thread)
+            {
+                if ((i / k_num_test_timeouts / k_batch_size) % 2 == 0)
+                    dbg_line_pool.emplace_debug_lines(batch, k_test_timeouts[timeout_idx]);
+                else
+                    for (auto& dbg_line : batch)
+                        dbg_line_pool.emplace_debug_line(std::move(dbg_line),
+                                                         k_test_timeouts[timeout_idx]);
+                batch.clear();
+            }
+        }
+    }
+}
+
+}  // namespace
+
+
+BT_TEST(debug_line_pool_draws_lines_from_many_threads_until_expiry)
+{
+    auto dbg_line_pool{ std::make_unique<Debug_line_pool>() };
+
+    {   // Submit all lines from several threads while draining (w/o advancing time).
+        std::atomic_uint32_t num_done_threads{ 0 };
+        std::vector<std::thread> threads;
+        for (uint32_t i = 0; i < k_num_threads; i++)
+            threads.emplace_back([&, i]() {
+                submit_test_lines(*dbg_line_pool, i);
+                num_done_threads++;
+            });
+
+        while (num_done_threads.load() < k_num_threads)
+            dbg_line_pool->update_live_lines(0.0f);
+        for (auto& thread : threads)
+            thread.join();
+        dbg_line_pool->update_live_lines(0.0f);
+    }
+
+    // Exactly fills the submission queue, so nothing should be dropped.
+    auto stats{ dbg_line_pool->get_stats() };
+    BT_CHECK(stats.num_dropped_lines == 0);
+    BT_CHECK(stats.num_live_lines == Debug_line_pool::k_num_lines);
+
+    // Step thru all the timeouts w/ uneven frame times, checking the drawn lines after every
+    // bucket advance.
+    constexpr float_t k_delta_times[]{ 1.0f / 60.0f, 1.0f / 144.0f, 1.0f / 30.0f, 0.25f };
+    std::vector<Debug_line> drawn_lines(Debug_line_pool::k_num_lines);
+    std::vector<uint32_t> num_times_drawn(Debug_line_pool::k_num_lines);
+    double_t time{ 0.0 };
+    for (size_t frame = 0; time < k_test_timeouts[k_num_test_timeouts - 1] + 1.0; frame++)
+    {
+        float_t delta_time{ k_delta_times[frame % std::size(k_delta_times)] };
+        dbg_line_pool->update_live_lines(delta_time);
+        time += delta_time;
+
+        size_t num_drawn{ dbg_line_pool->copy_live_lines(drawn_lines) };
+        BT_CHECK(num_drawn == dbg_line_pool->get_stats().num_live_lines);
+
+        std::fill(num_times_drawn.begin(), num_times_drawn.end(), 0);
+        size_t num_torn_lines{ 0 };
+        for (size_t i = 0; i < num_drawn; i++)
+        {
+            uint32_t line_id{ static_cast<uint32_t>(drawn_lines[i].pos1[0]) };
+            if (line_id >= Debug_line_pool::k_num_lines ||
+                drawn_lines[i].pos2[0] != drawn_lines[i].pos1[0] * 2.0f)
+            {
+                num_torn_lines++;
+                continue;
+            }
+            num_times_drawn[line_id]++;
+        }
+
+        // Every line is drawn once until its expiry, and gone at most a bucket later.
+        size_t num_duplicated{ 0 };
+        size_t num_missing{ 0 };
+        size_t num_overstayed{ 0 };
+        for (uint32_t line_id = 0; line_id < Debug_line_pool::k_num_lines; line_id++)
+        {
+            double_t expiry_time{ get_test_timeout(line_id) };
+            if (num_times_drawn[line_id] > 1)
+                num_duplicated++;
+            else if (time < expiry_time && num_times_drawn[line_id] == 0)
+                num_missing++;
+            else if (time >= expiry_time + Debug_line_pool::k_expiry_bucket_duration &&
+                     num_times_drawn[line_id] != 0)
+                num_overstayed++;
+        }
+
+        BT_CHECK(num_torn_lines == 0);
+        BT_CHECK(num_duplicated == 0);
+        BT_CHECK(num_missing == 0);
+        BT_CHECK(num_overstayed == 0);
+        if (num_torn_lines + num_duplicated + num_missing + num_overstayed > 0)
+            break;
+    }
+
+    stats = dbg_line_pool->get_stats();
+    BT_CHECK(stats.num_live_lines == 0);
+    BT_CHECK(stats.num_dropped_lines == 0);
+}
@@ -0,0 +1,177 @@
+#include "renderer/dynamic_resolution.h"
+#include "test_harness.h"
+
+#include <algorithm>
+#include <cmath>
+#include <random>
+#include <vector>
+
+
+namespace
+{
+
+using BT::Dynamic_resolution_controller;
+
+constexpr float_t k_target_frame_time{ 0.010f };
+
+/// Scale changes seen while feeding a trace of frame times to a controller.
+struct Trace_result
+{
+    vector<float_t> scales;  // Scale after each change, in order.
+    vector<size_t> change_frames;
+    float_t min_seen_scale{ 1000.0f };
+    float_t max_seen_scale{ 0.0f };
+};
+
+/// Feeds `num_frames` frame times of a GPU that takes `full_scale_frame_time` at scale 1 (frame
+/// time goes w/ pixel count, so the scale squared), w/ each frame off by up to `noise` (ratio).
+Trace_result run_trace(Dynamic_resolution_controller& controller,
+                       float_t full_scale_frame_time,
+                       size_t num_frames,
+                       float_t noise = 0.0f,
+                       uint32_t seed = 1234)
+{
+    std::mt19937 rng{ seed };
+    std::uniform_real_distribution<float_t> noise_dist{ -noise, noise };
+
+    Trace_result result;
+    for (size_t i = 0; i < num_frames; i++)
+    {
+        float_t scale{ controller.get_render_scale() };
+        float_t frame_time{ full_scale_frame_time * scale * scale * (1.0f + noise_dist(rng)) };
+        if (controller.submit_frame_time(frame_time))
+        {
+            result.scales.emplace_back(controller.get_render_scale());
+            result.change_frames.emplace_back(i);
+        }
+
+        result.min_seen_scale = std::min(result.min_seen_scale, controller.get_render_scale());
+        result.max_seen_scale = std::max(result.max_seen_scale, controller.get_render_scale());
+    }
+    return result;
+}
+
+}  // namespace
+
+
+BT_TEST(dynamic_resolution_scales_down_when_over_budget)
+{
+    auto settings{ Dynamic_resolution_controller::make_default_settings(k_target_frame_time) };
+    Dynamic_resolution_controller controller{ settings };
+    BT_CHECK(controller.get_render_scale() == settings.max_scale);
+
+    // Twice the budget. Decides after a full history, aiming for the middle of the hold range.
+    auto result{ run_trace(controller, 2.0f * k_target_frame_time, settings.num_history_frames) };
+    BT_CHECK(result.scales.size() == 1);
+    BT_CHECK(result.change_frames.size() == 1 &&
+             result.change_frames[0] == settings.num_history_frames - 1);
+    float_t aim_ratio{ (1.0f + settings.scale_up_threshold) * 0.5f };
+    BT_CHECK_NEAR(controller.get_render_scale(), std::sqrt(aim_ratio / 2.0f), 1e-5f);
+
+    // Way over budget clamps to min scale, and stays there.
+    result = run_trace(controller, 100.0f * k_target_frame_time, 500);
+    BT_CHECK(controller.get_render_scale() == settings.min_scale);
+    BT_CHECK(result.min_seen_scale >= settings.min_scale);
+    BT_CHECK(result.scales.size() == 1);
+}
+
+BT_TEST(dynamic_resolution_scales_up_in_limited_steps_when_under_budget)
+{
+    auto settings{ Dynamic_resolution_controller::make_default_settings(k_target_frame_time) };
+    settings.max_scale_up_step = 0.125f;  // Exact in binary, so steps land right on max scale.
+    Dynamic_resolution_controller controller{ settings };
+    run_trace(controller, 100.0f * k_target_frame_time, 200);
+    BT_CHECK(controller.get_render_scale() == settings.min_scale);
+
+    // Way under budget. Goes back up one step at a time, and stops at max scale.
+    auto result{ run_trace(controller, 0.1f * k_target_frame_time, 1000) };
+    BT_CHECK(controller.get_render_scale() == settings.max_scale);
+    BT_CHECK(result.max_seen_scale <= settings.max_scale);
+    BT_CHECK(result.scales.size() == 4);
+
+    float_t prev_scale{ settings.min_scale };
+    for (float_t scale : result.scales)
+    {
+        BT_CHECK(scale > prev_scale);
+        BT_CHECK(scale - prev_scale <= settings.max_scale_up_step);
+        prev_scale = scale;
+    }
+
+    // Each change waits out the cooldown and a full new history.
+    for (size_t i = 1; i < result.change_frames.size(); i++)
+        BT_CHECK(result.change_frames[i] - result.change_frames[i - 1] ==
+                 settings.num_cooldown_frames + settings.num_history_frames);
+}
+
+BT_TEST(dynamic_resolution_holds_scale_between_thresholds)
+{
+    auto settings{ Dynamic_resolution_controller::make_default_settings(k_target_frame_time) };
+    Dynamic_resolution_controller controller{ settings };
+
+    // Just under budget, and just over the scale up threshold.
+    for (float_t budget_ratio : { 0.99f, 0.9f, settings.scale_up_threshold + 0.01f })
+    {
+        auto result{ run_trace(controller, budget_ratio * k_target_frame_time, 500) };
+        BT_CHECK(result.scales.empty());
+        BT_CHECK(controller.get_render_scale() == settings.max_scale);
+    }
+
+    // Same at a lower scale, where changes either way would be possible.
+    controller.reset();
+    run_trace(controller, 2.0f * k_target_frame_time, settings.num_history_frames);
+    float_t held_scale{ controller.get_render_scale() };
+    BT_CHECK(held_scale < settings.max_scale && held_scale > settings.min_scale);
+
+    float_t full_scale_frame_time{ 0.9f * k_target_frame_time / (held_scale * held_scale) };
+    auto result{ run_trace(controller, full_scale_frame_time, 500) };
+    BT_CHECK(result.scales.empty());
+    BT_CHECK(controller.get_render_scale() == held_scale);
+}
+
+BT_TEST(dynamic_resolution_skips_small_changes_unless_at_limit)
+{
+    auto settings{ Dynamic_resolution_controller::make_default_settings(k_target_frame_time) };
+    settings.max_scale_up_step = 0.05f;
+    settings.min_scale_change = 0.1f;  // More than a scale up step.
+    Dynamic_resolution_controller controller{ settings };
+
+    run_trace(controller, 100.0f * k_target_frame_time, 200);
+    BT_CHECK(controller.get_render_scale() == settings.min_scale);
+
+    // Scale up steps are all too small, so the scale stays.
+    auto result{ run_trace(controller, 0.1f * k_target_frame_time, 500) };
+    BT_CHECK(result.scales.empty());
+    BT_CHECK(controller.get_render_scale() == settings.min_scale);
+
+    // Small steps that reach a limit still go thru.
+    settings.min_scale = 0.97f;
+    controller.set_settings(settings);
+    run_trace(controller, 100.0f * k_target_frame_time, 200);
+    BT_CHECK(controller.get_render_scale() == settings.min_scale);
+    result = run_trace(controller, 0.1f * k_target_frame_time, 500);
+    BT_CHECK(result.scales.size() == 1);
+    BT_CHECK(controller.get_render_scale() == settings.max_scale);
+}
+
+BT_TEST(dynamic_resolution_settles_on_noisy_trace)
+{
+    auto settings{ Dynamic_resolution_controller::make_default_settings(k_target_frame_time) };
+    Dynamic_resolution_controller controller{ settings };
+
+    // 1.5x over budget at full scale, w/ frames up to 20% off either way.
+    constexpr float_t k_full_scale_ratio{ 1.5f };
+    constexpr float_t k_noise{ 0.2f };
+    auto result{ run_trace(controller, k_full_scale_ratio * k_target_frame_time, 3000, k_noise) };
+
+    // Settles quickly, then noise doesn't make it go back and forth.
+    BT_CHECK(!result.scales.empty() && result.scales.size() <= 2);
+    BT_CHECK(!result.change_frames.empty() && result.change_frames.back() < 100);
+    BT_CHECK(result.min_seen_scale >= settings.min_scale);
+    BT_CHECK(result.max_seen_scale <= settings.max_scale);
+
+    // Settled frame time is within budget, but not so far under that it wastes resolution.
+    float_t scale{ controller.get_render_scale() };
+    float_t settled_ratio{ k_full_scale_ratio * scale * scale };
+    BT_CHECK(settled_ratio <= 1.0f);
+    BT_CHECK(settled_ratio >= settings.scale_up_threshold);
+}
@@ -0,0 +1,142 @@
+#include "renderer/geometry_arena.h"
+#include "renderer/render_queue.h"
+#include "test_harness.h"
+
+#include <vector>
+
+
+BT_TEST(arena_range_allocator_packs_ranges_back_to_back)
+{
+    BT::Arena_range_allocator allocator{ 100 };
+
+    uint32_t base_a;
+    uint32_t base_b;
+    uint32_t base_c;
+    BT_CHECK(allocator.allocate(30, base_a));
+    BT_CHECK(allocator.allocate(0, base_b));  // Empty range (eg. a mesh w/o LOD levels).
+    BT_CHECK(allocator.allocate(70, base_c));
+
+    // Offsets are in elements, so every range starts aligned to its element size.
+    BT_CHECK(base_a == 0);
+    BT_CHECK(base_b == 30);
+    BT_CHECK(base_c == 30);
+    BT_CHECK(allocator.get_num_used() == 100);
+}
+
+BT_TEST(arena_range_allocator_fails_when_exhausted)
+{
+    BT::Arena_range_allocator allocator{ 100 };
+
+    uint32_t base;
+    BT_CHECK(allocator.allocate(60, base));
+
+    base = 12345;
+    BT_CHECK(!allocator.allocate(41, base));
+    BT_CHECK(base == 12345);  // Failed allocation doesn't touch the output.
+    BT_CHECK(allocator.get_num_used() == 60);
+
+    // Exactly fits.
+    BT_CHECK(allocator.allocate(40, base));
+    BT_CHECK(base == 60);
+    BT_CHECK(!allocator.allocate(1, base));
+}
+
+BT_TEST(geometry_arena_packer_spills_into_new_arena)
+{
+    BT::Geometry_arena_packer packer{ 100, 300 };
+
+    auto placement_a{ packer.place(60, 90) };
+    auto placement_b{ packer.place(40, 150) };  // Exactly fills the vertices.
+    auto placement_c{ packer.place(1, 3) };     // Spills.
+    auto placement_d{ packer.place(10, 30) };
+
+    BT_CHECK(placement_a.arena_idx == 0);
+    BT_CHECK(placement_a.base_vertex == 0 && placement_a.first_index == 0);
+    BT_CHECK(placement_b.arena_idx == 0);
+    BT_CHECK(placement_b.base_vertex == 60 && placement_b.first_index == 90);
+    BT_CHECK(placement_c.arena_idx == 1);
+    BT_CHECK(placement_c.base_vertex == 0 && placement_c.first_index == 0);
+    BT_CHECK(placement_d.arena_idx == 1);
+    BT_CHECK(placement_d.base_vertex == 1 && placement_d.first_index == 3);
+
+    auto const& arenas{ packer.get_arenas() };
+    BT_CHECK(arenas.size() == 2);
+    BT_CHECK(arenas[0].vertex_allocator.get_num_used() == 100);
+    BT_CHECK(arenas[0].index_allocator.get_num_used() == 240);
+    BT_CHECK(arenas[1].vertex_allocator.get_num_used() == 11);
+    BT_CHECK(arenas[1].index_allocator.get_num_used() == 33);
+}
+
+BT_TEST(geometry_arena_packer_sizes_up_arena_for_oversized_ranges)
+{
+    BT::Geometry_arena_packer packer{ 100, 300 };
+    packer.place(10, 30);
+
+    auto placement{ packer.place(250, 900) };
+    BT_CHECK(placement.arena_idx == 1);
+    BT_CHECK(placement.base_vertex == 0 && placement.first_index == 0);
+
+    auto const& arenas{ packer.get_arenas() };
+    BT_CHECK(arenas.size() == 2);
+    BT_CHECK(arenas[1].vertex_allocator.get_capacity() == 250);
+    BT_CHECK(arenas[1].index_allocator.get_capacity() == 900);
+
+    // Next ranges go into a new regular sized arena.
+    auto next_placement{ packer.place(1, 3) };
+    BT_CHECK(next_placement.arena_idx == 2);
+    BT_CHECK(arenas.size() == 3);
+    BT_CHECK(packer.get_arenas()[2].vertex_allocator.get_capacity() == 100);
+}
+
+BT_TEST(geometry_arena_placements_end_up_in_indirect_commands)
+{
+    // Three meshes, where the last one spills into a second arena.
+    struct Test_mesh
+    {
+        uint32_t num_vertices;
+        uint32_t num_indices;
+        BT::Geometry_arena_packer::Placement placement;
+    };
+    Test_mesh meshes[]{ { 50, 120 }, { 40, 60 }, { 30, 90 } };
+
+    BT::Geometry_arena_packer packer{ 100, 300 };
+    for (auto& mesh : meshes)
+        mesh.placement = packer.place(mesh.num_vertices, mesh.num_indices);
+    BT_CHECK(meshes[2].placement.arena_idx == 1);
+
+    mat4 transform;
+    glm_mat4_identity(transform);
+
+    BT::Render_queue render_queue;
+    for (uint32_t i = 0; i < 3; i++)
+    {   // Arena idx + 1 stands in for the arena's VAO and EBO.
+        auto const& placement{ meshes[i].placement };
+        render_queue.emplace_draw_item({
+            BT::Render_queue::make_sort_key(BT::RENDER_LAYER_DEFAULT, 1, 2, i),
+            nullptr,
+            placement.arena_idx + 1,
+            placement.arena_idx + 1,
+            meshes[i].num_indices,
+            transform,
+            placement.first_index,
+            static_cast<int32_t>(placement.base_vertex) });
+    }
+    render_queue.sort();
+
+    auto const& commands{ render_queue.get_indirect_commands() };
+    BT_CHECK(commands.size() == 3);
+    for (uint32_t i = 0; i < 3 && i < commands.size(); i++)
+    {
+        BT_CHECK(commands[i].count == meshes[i].num_indices);
+        BT_CHECK(commands[i].first_index == meshes[i].placement.first_index);
+        BT_CHECK(commands[i].base_vertex == static_cast<int32_t>(meshes[i].placement.base_vertex));
+        BT_CHECK(commands[i].base_instance == i);
+    }
+    BT_CHECK(commands.size() == 3 && commands[1].first_index == 120);
+    BT_CHECK(commands.size() == 3 && commands[1].base_vertex == 50);
+
+    // One multi-draw per arena.
+    auto const& groups{ render_queue.get_multi_draw_groups() };
+    BT_CHECK(groups.size() == 2);
+    BT_CHECK(groups.size() == 2 && groups[0].num_commands == 2 && groups[1].num_commands == 1);
+}
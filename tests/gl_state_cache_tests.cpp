@@ -0,0 +1,229 @@
+#include "glad/glad.h"
+#include "renderer/gl_state_cache.h"
+#include "test_harness.h"
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+
+namespace
+{
+
+using BT::Gl_state_cache;
+
+/// Writes down every call that reaches the backend, instead of calling GL.
+class Recording_backend : public BT::Gl_state_backend_ifc
+{
+public:
+    std::vector<std::string> calls;
+
+    void enable(uint32_t capability) override { record("enable", { capability }); }
+    void disable(uint32_t capability) override { record("disable", { capability }); }
+    void depth_func(uint32_t func) override { record("depth_func", { func }); }
+    void depth_mask(bool mask) override { record("depth_mask", { mask }); }
+    void cull_face(uint32_t mode) override { record("cull_face", { mode }); }
+    void front_face(uint32_t mode) override { record("front_face", { mode }); }
+
+    void blend_func(uint32_t src_factor, uint32_t dst_factor) override
+    {
+        record("blend_func", { src_factor, dst_factor });
+    }
+
+    void viewport(int32_t x, int32_t y, int32_t width, int32_t height) override
+    {
+        record("viewport", { x, y, width, height });
+    }
+
+    void bind_framebuffer(uint32_t target, uint32_t framebuffer) override
+    {
+        record("bind_framebuffer", { target, framebuffer });
+    }
+
+    void use_program(uint32_t program) override { record("use_program", { program }); }
+    void active_texture(uint32_t unit) override { record("active_texture", { unit }); }
+    void bind_texture_2d(uint32_t texture) override { record("bind_texture_2d", { texture }); }
+
+    void bind_vertex_array(uint32_t vertex_array) override
+    {
+        record("bind_vertex_array", { vertex_array });
+    }
+
+    void delete_vertex_array(uint32_t vertex_array) override
+    {
+        record("delete_vertex_array", { vertex_array });
+    }
+
+private:
+    void record(char const* name, std::vector<int64_t> const& args)
+    {
+        std::string call{ name };
+        for (int64_t arg : args)
+            call += " " + std::to_string(arg);
+        calls.emplace_back(std::move(call));
+    }
+};
+
+/// Cache w/ a recording backend. The cache owns the backend, so this keeps a pointer to it.
+struct Recorded_cache
+{
+    Recording_backend* backend;
+    Gl_state_cache cache;
+
+    Recorded_cache()
+        : Recorded_cache{ std::make_unique<Recording_backend>() }
+    {
+    }
+
+private:
+    Recorded_cache(std::unique_ptr<Recording_backend>&& recording_backend)
+        : backend{ recording_backend.get() }
+        , cache{ std::move(recording_backend) }
+    {
+    }
+};
+
+/// One of each kind of call the renderer makes when setting up a draw.
+void set_draw_state(Gl_state_cache& cache)
+{
+    cache.bind_framebuffer(GL_FRAMEBUFFER, 3);
+    cache.set_viewport(0, 0, 1920, 1080);
+    cache.set_capability(GL_DEPTH_TEST, true);
+    cache.set_depth_func(GL_LEQUAL);
+    cache.set_depth_mask(false);
+    cache.set_capability(GL_BLEND, true);
+    cache.set_blend_func(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+    cache.set_capability(GL_CULL_FACE, false);
+    cache.use_program(7);
+    cache.bind_texture_2d(2, 11);
+    cache.bind_vertex_array(5);
+}
+
+// @NOTE: The texture bind also sets the active unit, which counts as its own issued call.
+constexpr size_t k_num_draw_state_calls{ 11 };
+constexpr size_t k_num_draw_state_backend_calls{ 12 };
+
+}  // namespace
+
+
+BT_TEST(gl_state_cache_skips_repeated_calls)
+{
+    Recorded_cache recorded;
+    auto& cache{ recorded.cache };
+    auto& calls{ recorded.backend->calls };
+
+    set_draw_state(cache);
+    BT_CHECK(calls.size() == k_num_draw_state_backend_calls);
+
+    // Same state again doesn't reach the backend.
+    auto const first_calls{ calls };
+    set_draw_state(cache);
+    set_draw_state(cache);
+    BT_CHECK(calls == first_calls);
+
+    // Only the changed state gets issued.
+    cache.set_blend_func(GL_ONE, GL_ONE);
+    cache.set_blend_func(GL_ONE, GL_ONE);
+    cache.set_capability(GL_BLEND, false);
+    cache.set_depth_func(GL_LESS);
+    cache.bind_texture_2d(2, 12);  // Unit 2 is still active.
+    cache.bind_texture_2d(0, 12);  // Other unit, so its own binding.
+    cache.bind_framebuffer(GL_DRAW_FRAMEBUFFER, 3);  // Already bound by `GL_FRAMEBUFFER`.
+    cache.bind_framebuffer(GL_READ_FRAMEBUFFER, 0);
+
+    std::vector<std::string> const expected_calls{
+        "blend_func " + std::to_string(GL_ONE) + " " + std::to_string(GL_ONE),
+        "disable " + std::to_string(GL_BLEND),
+        "depth_func " + std::to_string(GL_LESS),
+        "bind_texture_2d 12",
+        "active_texture 0",
+        "bind_texture_2d 12",
+        "bind_framebuffer " + std::to_string(GL_READ_FRAMEBUFFER) + " 0",
+    };
+    BT_CHECK(calls.size() == first_calls.size() + expected_calls.size());
+    for (size_t i = 0; i < expected_calls.size() && first_calls.size() + i < calls.size(); i++)
+        BT_CHECK(calls[first_calls.size() + i] == expected_calls[i]);
+}
+
+BT_TEST(gl_state_cache_reissues_after_invalidate)
+{
+    Recorded_cache recorded;
+    auto& cache{ recorded.cache };
+    auto& calls{ recorded.backend->calls };
+
+    set_draw_state(cache);
+    auto const first_calls{ calls };
+
+    // Eg. after imgui did its own GL calls, everything gets set again.
+    cache.invalidate();
+    set_draw_state(cache);
+    BT_CHECK(calls.size() == 2 * first_calls.size());
+    for (size_t i = 0; i < first_calls.size() && first_calls.size() + i < calls.size(); i++)
+        BT_CHECK(calls[first_calls.size() + i] == first_calls[i]);
+
+    // And gets filtered again from there on.
+    set_draw_state(cache);
+    BT_CHECK(calls.size() == 2 * first_calls.size());
+}
+
+BT_TEST(gl_state_cache_forwards_everything_when_disabled)
+{
+    Recorded_cache recorded;
+    auto& cache{ recorded.cache };
+    auto& calls{ recorded.backend->calls };
+    cache.set_enabled(false);
+
+    set_draw_state(cache);
+    set_draw_state(cache);
+    BT_CHECK(calls.size() == 2 * k_num_draw_state_backend_calls);
+
+    // Turning it back on still filters against what was last set.
+    cache.set_enabled(true);
+    set_draw_state(cache);
+    BT_CHECK(calls.size() == 2 * k_num_draw_state_backend_calls);
+}
+
+BT_TEST(gl_state_cache_counts_calls_per_frame)
+{
+    Recorded_cache recorded;
+    auto& cache{ recorded.cache };
+
+    cache.begin_frame();
+    set_draw_state(cache);
+    set_draw_state(cache);
+    set_draw_state(cache);
+    BT_CHECK(cache.get_stats_last_frame().num_issued == 0);
+
+    // New frame starts from nothing tracked, so the first draw state gets issued again.
+    cache.begin_frame();
+    BT_CHECK(cache.get_stats_last_frame().num_issued == k_num_draw_state_backend_calls);
+    BT_CHECK(cache.get_stats_last_frame().num_skipped == 2 * k_num_draw_state_calls);
+    BT_CHECK(recorded.backend->calls.size() == k_num_draw_state_backend_calls);
+
+    set_draw_state(cache);
+    cache.begin_frame();
+    BT_CHECK(cache.get_stats_last_frame().num_issued == k_num_draw_state_backend_calls);
+    BT_CHECK(cache.get_stats_last_frame().num_skipped == 0);
+    BT_CHECK(recorded.backend->calls.size() == 2 * k_num_draw_state_backend_calls);
+}
+
+BT_TEST(gl_state_cache_clears_binding_of_deleted_vertex_array)
+{
+    Recorded_cache recorded;
+    auto& cache{ recorded.cache };
+    auto& calls{ recorded.backend->calls };
+
+    // Deleting an unbound vertex array keeps the binding.
+    cache.bind_vertex_array(5);
+    cache.delete_vertex_array(6);
+    cache.bind_vertex_array(5);
+    BT_CHECK(calls == std::vector<std::string>({ "bind_vertex_array 5", "delete_vertex_array 6" }));
+
+    // Deleting the bound one reverts to 0, so a new vertex array reusing the name gets bound.
+    calls.clear();
+    cache.delete_vertex_array(5);
+    cache.bind_vertex_array(0);
+    cache.bind_vertex_array(5);
+    BT_CHECK(calls == std::vector<std::string>({ "delete_vertex_array 5", "bind_vertex_array 5" }));
+}
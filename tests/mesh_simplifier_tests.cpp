@@ -0,0 +1,177 @@
+#include "btglm.h"
+#include "renderer/mesh.h"
+#include "renderer/mesh_simplifier.h"
+#include "test_harness.h"
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+
+namespace
+{
+
+using namespace BT;
+
+constexpr uint32_t k_num_sphere_rings{ 32 };
+constexpr uint32_t k_num_sphere_segments{ 64 };
+
+/// Closed unit sphere w/o any seams (poles are single vertices, and the last segment wraps around
+/// to the first one), so the simplifier doesn't lock any vertices.
+void make_test_sphere(vector<Vertex>& out_vertices, vector<uint32_t>& out_indices)
+{
+    out_vertices.clear();
+    out_indices.clear();
+
+    auto emplace_vertex{ [&](float_t polar, float_t azimuth) {
+        Vertex vertex{ { std::sin(polar) * std::cos(azimuth),
+                         std::cos(polar),
+                         std::sin(polar) * std::sin(azimuth) },
+                       { 0.0f, 0.0f, 0.0f },
+                       { 0.0f, 0.0f } };
+        glm_vec3_copy(vertex.position, vertex.normal);
+        out_vertices.emplace_back(vertex);
+    } };
+
+    emplace_vertex(0.0f, 0.0f);  // Top pole.
+    for (uint32_t ring = 1; ring < k_num_sphere_rings; ring++)
+    for (uint32_t segment = 0; segment < k_num_sphere_segments; segment++)
+        emplace_vertex(glm_rad(180.0f) * ring / k_num_sphere_rings,
+                       glm_rad(360.0f) * segment / k_num_sphere_segments);
+    emplace_vertex(glm_rad(180.0f), 0.0f);  // Bottom pole.
+
+    auto ring_vertex{ [](uint32_t ring, uint32_t segment) {
+        return 1 + (ring - 1) * k_num_sphere_segments + segment % k_num_sphere_segments;
+    } };
+    uint32_t bottom_pole{ static_cast<uint32_t>(out_vertices.size() - 1) };
+    for (uint32_t segment = 0; segment < k_num_sphere_segments; segment++)
+    {
+        out_indices.insert(out_indices.end(),
+                           { 0, ring_vertex(1, segment + 1), ring_vertex(1, segment) });
+        out_indices.insert(out_indices.end(),
+                           { bottom_pole,
+                             ring_vertex(k_num_sphere_rings - 1, segment),
+                             ring_vertex(k_num_sphere_rings - 1, segment + 1) });
+    }
+    for (uint32_t ring = 1; ring + 1 < k_num_sphere_rings; ring++)
+    for (uint32_t segment = 0; segment < k_num_sphere_segments; segment++)
+    {
+        uint32_t a{ ring_vertex(ring, segment) };
+        uint32_t b{ ring_vertex(ring, segment + 1) };
+        uint32_t c{ ring_vertex(ring + 1, segment) };
+        uint32_t d{ ring_vertex(ring + 1, segment + 1) };
+        out_indices.insert(out_indices.end(), { a, b, d, a, d, c });
+    }
+}
+
+/// Max distance from the unit sphere of the triangles' corners, edge midpoints and centroids.
+float_t calc_max_sphere_deviation(vector<Vertex> const& vertices, vector<uint32_t> const& indices)
+{
+    float_t max_deviation{ 0.0f };
+    for (size_t i = 0; i + 2 < indices.size(); i += 3)
+    {
+        float_t const* p0{ vertices[indices[i + 0]].position };
+        float_t const* p1{ vertices[indices[i + 1]].position };
+        float_t const* p2{ vertices[indices[i + 2]].position };
+
+        constexpr float_t k_sample_weights[][3]{
+            { 1.0f, 0.0f, 0.0f }, { 0.5f, 0.5f, 0.0f }, { 0.0f, 0.5f, 0.5f },
+            { 0.5f, 0.0f, 0.5f }, { 1.0f / 3.0f, 1.0f / 3.0f, 1.0f / 3.0f },
+        };
+        for (auto const& weights : k_sample_weights)
+        {
+            float_t sample_length_sq{ 0.0f };
+            for (uint32_t axis = 0; axis < 3; axis++)
+            {
+                float_t sample{ p0[axis] * weights[0] + p1[axis] * weights[1] +
+                                p2[axis] * weights[2] };
+                sample_length_sq += sample * sample;
+            }
+            max_deviation = std::max(max_deviation, std::abs(1.0f - std::sqrt(sample_length_sq)));
+        }
+    }
+    return max_deviation;
+}
+
+}  // namespace
+
+
+BT_TEST(mesh_simplifier_keeps_sphere_within_target_and_error)
+{
+    vector<Vertex> vertices;
+    vector<uint32_t> indices;
+    make_test_sphere(vertices, indices);
+
+    constexpr float_t k_max_error{ 0.05f };
+    auto result{ mesh_simplifier::simplify(vertices, indices, indices.size() / 2, k_max_error) };
+    BT_CHECK(result.indices.size() <= indices.size() / 2);
+    BT_CHECK(result.indices.size() % 3 == 0);
+    BT_CHECK(result.error > 0.0f && result.error <= k_max_error);
+
+    // Collapses only move vertices onto neighbors, so there are no degenerate triangles left.
+    for (size_t i = 0; i + 2 < result.indices.size(); i += 3)
+    {
+        BT_CHECK(result.indices[i + 0] != result.indices[i + 1]);
+        BT_CHECK(result.indices[i + 1] != result.indices[i + 2]);
+        BT_CHECK(result.indices[i + 2] != result.indices[i + 0]);
+    }
+}
+
+BT_TEST(mesh_simplifier_stops_at_max_error)
+{
+    vector<Vertex> vertices;
+    vector<uint32_t> indices;
+    make_test_sphere(vertices, indices);
+
+    // Curved everywhere, so a tiny error bound allows hardly any collapses.
+    constexpr float_t k_tiny_max_error{ 1e-5f };
+    auto result{ mesh_simplifier::simplify(vertices, indices, 0, k_tiny_max_error) };
+    BT_CHECK(result.indices.size() > indices.size() / 2);
+    BT_CHECK(result.error <= k_tiny_max_error);
+}
+
+BT_TEST(mesh_simplifier_lod_levels_stay_within_budgets)
+{
+    vector<Vertex> vertices;
+    vector<uint32_t> indices;
+    make_test_sphere(vertices, indices);
+
+    // Same settings as models use (see `Model::generate_lod_levels()`). Diagonal is 2 * sqrt(3).
+    constexpr uint32_t k_max_num_levels{ 4 };
+    constexpr float_t k_min_reduction{ 0.8f };
+    float_t const max_error{ 2.0f * std::sqrt(3.0f) * 0.02f };
+    auto lod_levels{ mesh_simplifier::generate_lod_levels(
+        vertices, { indices }, k_max_num_levels, max_error, k_min_reduction) };
+
+    auto const& errors{ lod_levels.errors };
+    BT_CHECK(lod_levels.mesh_level_indices.size() == 1);
+    BT_CHECK(errors.size() >= 3 && errors.size() <= k_max_num_levels);
+    BT_CHECK(errors.size() == lod_levels.mesh_level_indices[0].size() + 1);
+    BT_CHECK(errors[0] == 0.0f);
+
+    size_t prev_num_indices{ indices.size() };
+    float_t const full_detail_sphere_deviation{ calc_max_sphere_deviation(vertices, indices) };
+    float_t prev_sphere_deviation{ full_detail_sphere_deviation };
+    for (size_t level = 1; level < errors.size(); level++)
+    {
+        auto const& level_indices{ lod_levels.mesh_level_indices[0][level - 1] };
+
+        // At most half the triangles of the previous level.
+        BT_CHECK(level_indices.size() <= (prev_num_indices / 6) * 3);
+        BT_CHECK(level_indices.size() % 3 == 0);
+        BT_CHECK(!level_indices.empty());
+
+        // Errors add up over levels, each level adding no more than the max error.
+        BT_CHECK(errors[level] > errors[level - 1]);
+        BT_CHECK(errors[level] - errors[level - 1] <= max_error);
+
+        // Coarser levels cut further into the sphere, but stay within the estimated error of the
+        // full detail surface.
+        float_t sphere_deviation{ calc_max_sphere_deviation(vertices, level_indices) };
+        BT_CHECK(sphere_deviation > prev_sphere_deviation);
+        BT_CHECK(sphere_deviation <= full_detail_sphere_deviation + errors[level]);
+
+        prev_num_indices = level_indices.size();
+        prev_sphere_deviation = sphere_deviation;
+    }
+}
@@ -0,0 +1,147 @@
+#include "renderer/animator_template_types.h"
+#include "renderer/model_animator.h"
+#include "test_harness.h"
+
+#include <string>
+#include <vector>
+
+
+namespace
+{
+
+using BT::anim_tmpl_types::Animator_variable;
+
+constexpr size_t k_num_test_variables{ 64 };
+
+/// Cycles thru the var types, so every type has vars both near the front and the back.
+Animator_variable::Type get_test_variable_type(size_t idx)
+{
+    constexpr Animator_variable::Type k_types[]{
+        Animator_variable::TYPE_BOOL,
+        Animator_variable::TYPE_INT,
+        Animator_variable::TYPE_FLOAT,
+        Animator_variable::TYPE_TRIGGER,
+    };
+    return k_types[idx % 4];
+}
+
+/// Animator w/ `k_num_test_variables` vars and a single state w/o transitions.
+void configure_test_animator(BT::Model_animator& animator)
+{
+    std::vector<Animator_variable> variables;
+    for (size_t i = 0; i < k_num_test_variables; i++)
+        variables.emplace_back(get_test_variable_type(i), "var_" + std::to_string(i), 0.0f);
+
+    BT::anim_tmpl_types::Compiled_state_transitions transitions;
+    transitions.state_offsets = { 0, 0 };
+
+    animator.configure_animator_states({ { "idle", 0 } }, variables, transitions);
+}
+
+}  // namespace
+
+
+BT_TEST(model_animator_resolves_handles_for_all_variables)
+{
+    BT::Model_skin model_skin;
+    std::vector<BT::Model_joint_animation> model_animations;
+    BT::Model_animator animator{ model_skin, model_animations, false };
+    configure_test_animator(animator);
+
+    BT_CHECK(animator.get_num_animator_variables() == k_num_test_variables);
+    for (size_t i = 0; i < k_num_test_variables; i++)
+    {
+        auto handle{ animator.find_variable_handle("var_" + std::to_string(i)) };
+        BT_CHECK(handle.is_valid());
+        BT_CHECK(handle.var_idx == i);
+        BT_CHECK(handle.type == get_test_variable_type(i));
+    }
+
+    BT_CHECK(!animator.find_variable_handle("var_missing").is_valid());
+}
+
+BT_TEST(model_animator_sets_variables_via_handles)
+{
+    BT::Model_skin model_skin;
+    std::vector<BT::Model_joint_animation> model_animations;
+    BT::Model_animator animator{ model_skin, model_animations, false };
+    configure_test_animator(animator);
+
+    std::vector<BT::anim_tmpl_types::Animator_variable_handle> handles;
+    for (size_t i = 0; i < k_num_test_variables; i++)
+        handles.emplace_back(animator.find_variable_handle("var_" + std::to_string(i)));
+
+    for (size_t i = 0; i < k_num_test_variables; i++)
+        switch (get_test_variable_type(i))
+        {
+        case Animator_variable::TYPE_BOOL:
+            animator.set_bool_variable(handles[i], (i % 8 == 0));
+            break;
+        case Animator_variable::TYPE_INT:
+            animator.set_int_variable(handles[i], static_cast<int32_t>(i) * 3);
+            break;
+        case Animator_variable::TYPE_FLOAT:
+            animator.set_float_variable(handles[i], static_cast<float_t>(i) * 0.5f);
+            break;
+        case Animator_variable::TYPE_TRIGGER:
+            animator.set_trigger_variable(handles[i]);
+            break;
+        default: break;
+        }
+
+    // Each set lands on its own var only.
+    for (size_t i = 0; i < k_num_test_variables; i++)
+        switch (get_test_variable_type(i))
+        {
+        case Animator_variable::TYPE_BOOL:
+            BT_CHECK(animator.get_bool_variable(handles[i]) == (i % 8 == 0));
+            break;
+        case Animator_variable::TYPE_INT:
+            BT_CHECK(animator.get_int_variable(handles[i]) == static_cast<int32_t>(i) * 3);
+            break;
+        case Animator_variable::TYPE_FLOAT:
+            BT_CHECK(animator.get_float_variable(handles[i]) == static_cast<float_t>(i) * 0.5f);
+            break;
+        case Animator_variable::TYPE_TRIGGER:
+            BT_CHECK(animator.get_animator_variable(i).var_value ==
+                     BT::anim_tmpl_types::k_trig_triggered);
+            break;
+        default: break;
+        }
+}
+
+BT_TEST(model_animator_name_setters_match_handle_setters)
+{
+    BT::Model_skin model_skin;
+    std::vector<BT::Model_joint_animation> model_animations;
+    BT::Model_animator animator{ model_skin, model_animations, false };
+    configure_test_animator(animator);
+
+    // Last var of each type, to go thru the whole name lookup.
+    animator.set_bool_variable("var_60", true);
+    animator.set_int_variable("var_61", -7);
+    animator.set_float_variable("var_62", 2.25f);
+
+    BT_CHECK(animator.get_bool_variable(animator.find_variable_handle("var_60")));
+    BT_CHECK(animator.get_int_variable(animator.find_variable_handle("var_61")) == -7);
+    BT_CHECK(animator.get_float_variable(animator.find_variable_handle("var_62")) == 2.25f);
+}
+
+BT_TEST(model_animator_variables_generation_changes_on_configure)
+{
+    BT::Model_skin model_skin;
+    std::vector<BT::Model_joint_animation> model_animations;
+    BT::Model_animator animator_a{ model_skin, model_animations, false };
+    BT::Model_animator animator_b{ model_skin, model_animations, false };
+    configure_test_animator(animator_a);
+    configure_test_animator(animator_b);
+
+    // Never shared, even w/ the same template.
+    BT_CHECK(animator_a.get_variables_generation() != 0);
+    BT_CHECK(animator_a.get_variables_generation() != animator_b.get_variables_generation());
+
+    // Reconfiguring invalidates handles resolved before.
+    auto prev_generation{ animator_a.get_variables_generation() };
+    configure_test_animator(animator_a);
+    BT_CHECK(animator_a.get_variables_generation() != prev_generation);
+}
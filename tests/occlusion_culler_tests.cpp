@@ -0,0 +1,126 @@
+#include "renderer/occlusion_culler.h"
+#include "test_harness.h"
+
+#include <cstdint>
+
+
+namespace
+{
+
+using BT::Occlusion_culler;
+
+/// Depth buffer pixel coords to NDC, for building occluders and bounds that line up w/ pixels.
+float_t pixel_x_to_ndc(float_t pixel_x)
+{
+    return pixel_x / Occlusion_culler::k_width * 2.0f - 1.0f;
+}
+
+float_t pixel_y_to_ndc(float_t pixel_y)
+{
+    return pixel_y / Occlusion_culler::k_height * 2.0f - 1.0f;
+}
+
+/// Rasterizes a wall facing the camera at NDC depth `depth`, from the left edge of the screen to
+/// `right_pixel_x`, over the full height. Uses an identity projection view, so world space is NDC.
+// @NOTE: The wall is a single triangle w/ its other edges off screen, so that there's no shared
+//        edge (which doesn't get covered) on screen.
+void rasterize_test_wall(Occlusion_culler& occlusion_culler, float_t right_pixel_x, float_t depth)
+{
+    mat4 identity;
+    glm_mat4_identity(identity);
+    occlusion_culler.begin_frame(identity);
+
+    float_t right_x{ pixel_x_to_ndc(right_pixel_x) };
+    float_t const positions[3][3]{
+        { right_x, -3.0f, depth },
+        { right_x, 3.0f, depth },
+        { -5.0f, 0.0f, depth },
+    };
+    uint32_t const indices[3]{ 0, 1, 2 };
+    occlusion_culler.rasterize_occluder(
+        &positions[0][0], sizeof(positions[0]), 3, indices, 3, identity);
+    occlusion_culler.finish_occluders();
+}
+
+/// Tests bounds spanning pixel columns `min_pixel_x` to `max_pixel_x` at NDC depth `depth`.
+bool is_test_box_visible(Occlusion_culler& occlusion_culler,
+                         float_t min_pixel_x,
+                         float_t max_pixel_x,
+                         float_t depth)
+{
+    vec3 aabb_min{ pixel_x_to_ndc(min_pixel_x), pixel_y_to_ndc(60.2f), depth };
+    vec3 aabb_max{ pixel_x_to_ndc(max_pixel_x), pixel_y_to_ndc(70.8f), depth + 0.1f };
+    return occlusion_culler.is_visible(aabb_min, aabb_max);
+}
+
+}  // namespace
+
+
+BT_TEST(occlusion_culler_occludes_bounds_behind_occluder_only)
+{
+    Occlusion_culler occlusion_culler;
+    rasterize_test_wall(occlusion_culler, 128.0f, 0.0f);
+
+    BT_CHECK(!is_test_box_visible(occlusion_culler, 20.2f, 100.8f, 0.5f));  // Behind.
+    BT_CHECK(is_test_box_visible(occlusion_culler, 20.2f, 100.8f, -0.5f));  // In front.
+    BT_CHECK(is_test_box_visible(occlusion_culler, 140.2f, 150.8f, 0.5f));  // Next to.
+    BT_CHECK(is_test_box_visible(occlusion_culler, 120.2f, 150.8f, 0.5f));  // Partly behind.
+
+    auto const& stats{ occlusion_culler.get_stats() };
+    BT_CHECK(stats.num_tested == 4);
+    BT_CHECK(stats.num_occluded == 1);
+}
+
+BT_TEST(occlusion_culler_skips_partly_covered_pixels)
+{
+    // Edge runs thru the middle of pixel column 128, which sample at pixel centers would cover.
+    Occlusion_culler occlusion_culler;
+    rasterize_test_wall(occlusion_culler, 128.5f, 0.0f);
+
+    auto const& depth_buffer{ occlusion_culler.get_depth_buffer() };
+    for (uint32_t y = 0; y < Occlusion_culler::k_height; y++)
+    {
+        BT_CHECK(depth_buffer[y * Occlusion_culler::k_width + 127] <= 0.0f);
+        BT_CHECK(depth_buffer[y * Occlusion_culler::k_width + 128] == 1.0f);
+    }
+
+    // Bounds in the uncovered half of column 128 are not behind the occluder.
+    BT_CHECK(is_test_box_visible(occlusion_culler, 128.6f, 128.9f, 0.5f));
+    BT_CHECK(!is_test_box_visible(occlusion_culler, 127.1f, 127.9f, 0.5f));
+}
+
+BT_TEST(occlusion_culler_writes_farthest_depth_over_pixel)
+{
+    // Sloped occluder, going from NDC depth 0 at the left edge to 0.5 at the right edge.
+    mat4 identity;
+    glm_mat4_identity(identity);
+
+    Occlusion_culler occlusion_culler;
+    occlusion_culler.begin_frame(identity);
+    float_t const positions[4][3]{
+        { -1.0f, -1.0f, 0.0f },
+        { 1.0f, -1.0f, 0.5f },
+        { 1.0f, 1.0f, 0.5f },
+        { -1.0f, 1.0f, 0.0f },
+    };
+    uint32_t const indices[6]{ 0, 1, 2, 0, 2, 3 };
+    occlusion_culler.rasterize_occluder(
+        &positions[0][0], sizeof(positions[0]), 4, indices, 6, identity);
+    occlusion_culler.finish_occluders();
+
+    // Every written pixel holds the depth at its right (farther) edge.
+    constexpr float_t k_depth_per_pixel{ 0.5f / Occlusion_culler::k_width };
+    auto const& depth_buffer{ occlusion_culler.get_depth_buffer() };
+    uint32_t num_written_pixels{ 0 };
+    for (uint32_t y = 0; y < Occlusion_culler::k_height; y++)
+    for (uint32_t x = 0; x < Occlusion_culler::k_width; x++)
+    {
+        float_t depth{ depth_buffer[y * Occlusion_culler::k_width + x] };
+        if (depth == 1.0f)
+            continue;
+
+        BT_CHECK_NEAR(depth, (x + 1) * k_depth_per_pixel, 1e-5f);
+        num_written_pixels++;
+    }
+    BT_CHECK(num_written_pixels > Occlusion_culler::k_width * Occlusion_culler::k_height / 2);
+}
@@ -0,0 +1,336 @@
+#include "renderer/material.h"
+#include "renderer/render_queue.h"
+#include "test_harness.h"
+
+#include <cstdlib>
+#include <iterator>
+#include <vector>
+
+
+namespace
+{
+
+using BT::Render_queue;
+
+constexpr uint32_t k_test_vao{ 7 };
+constexpr uint32_t k_test_ebo{ 8 };
+
+/// Draw item of mesh `mesh_id` in the shared test vertex array and index buffer.
+// @NOTE: Batching only compares material pointers, so no material (or GL context) is needed.
+Render_queue::Draw_item make_test_draw_item(uint32_t mesh_id,
+                                            mat4 transform,
+                                            uint32_t first_index,
+                                            int32_t base_vertex,
+                                            uint32_t num_indices = 36)
+{
+    return Render_queue::Draw_item{
+        Render_queue::make_sort_key(BT::RENDER_LAYER_DEFAULT, 1, 2, mesh_id),
+        nullptr,
+        k_test_vao,
+        k_test_ebo,
+        num_indices,
+        transform,
+        first_index,
+        base_vertex
+    };
+}
+
+/// Material that only exists to be told apart by address (stats only compare material pointers).
+class Test_material : public BT::Material_ifc
+{
+public:
+    BT::Shader const& get_shader() const override { std::abort(); }
+    void bind_material_shared() override {}
+    void set_material_transform(mat4) override {}
+    void unbind_material() override {}
+};
+
+/// Every batch's draw items share the geometry range of its first draw item.
+void check_batches_share_geometry(Render_queue const& render_queue)
+{
+    auto const& draw_items{ render_queue.get_draw_items() };
+    for (auto const& batch : render_queue.get_instance_batches())
+    {
+        auto const& first_item{ draw_items[batch.first_draw_item_idx] };
+        for (uint32_t i = 1; i < batch.num_instances; i++)
+        {
+            auto const& draw_item{ draw_items[batch.first_draw_item_idx + i] };
+            BT_CHECK(draw_item.sort_key == first_item.sort_key);
+            BT_CHECK(draw_item.num_indices == first_item.num_indices);
+            BT_CHECK(draw_item.first_index == first_item.first_index);
+            BT_CHECK(draw_item.base_vertex == first_item.base_vertex);
+        }
+    }
+}
+
+/// Every indirect command points at its batch's draw items and transforms.
+void check_indirect_commands_match_batches(Render_queue const& render_queue)
+{
+    auto const& batches{ render_queue.get_instance_batches() };
+    auto const& commands{ render_queue.get_indirect_commands() };
+    BT_CHECK(commands.size() == batches.size());
+    for (size_t i = 0; i < commands.size() && i < batches.size(); i++)
+    {
+        auto const& draw_item{ render_queue.get_draw_items()[batches[i].first_draw_item_idx] };
+        BT_CHECK(commands[i].base_instance == batches[i].first_draw_item_idx);
+        BT_CHECK(commands[i].instance_count == batches[i].num_instances);
+        BT_CHECK(commands[i].count == draw_item.num_indices);
+        BT_CHECK(commands[i].first_index == draw_item.first_index);
+        BT_CHECK(commands[i].base_vertex == draw_item.base_vertex);
+    }
+}
+
+}  // namespace
+
+
+BT_TEST(render_queue_merges_equal_sort_keys_into_one_batch)
+{
+    mat4 transforms[3];
+    for (size_t i = 0; i < 3; i++)
+    {
+        glm_mat4_identity(transforms[i]);
+        transforms[i][3][0] = static_cast<float_t>(i);
+    }
+
+    Render_queue render_queue;
+    for (auto& transform : transforms)
+        render_queue.emplace_draw_item(make_test_draw_item(5, transform, 12, 100));
+    render_queue.sort();
+
+    auto const& batches{ render_queue.get_instance_batches() };
+    BT_CHECK(batches.size() == 1);
+    BT_CHECK(batches.size() == 1 && batches[0].first_draw_item_idx == 0);
+    BT_CHECK(batches.size() == 1 && batches[0].num_instances == 3);
+
+    // Each instance's transform is in the instance transforms.
+    auto const& instance_transforms{ render_queue.get_instance_transforms() };
+    BT_CHECK(instance_transforms.size() == 3);
+    float_t translation_sum{ 0.0f };
+    for (auto const& transform : instance_transforms)
+        translation_sum += transform.raw[3][0];
+    BT_CHECK_NEAR(translation_sum, 3.0f, 1e-6f);
+}
+
+BT_TEST(render_queue_splits_batches_on_different_geometry_ranges)
+{
+    mat4 transform;
+    glm_mat4_identity(transform);
+
+    {   // Same sort key, different first index (eg. meshes packed into one index buffer).
+        Render_queue render_queue;
+        render_queue.emplace_draw_item(make_test_draw_item(5, transform, 0, 100));
+        render_queue.emplace_draw_item(make_test_draw_item(5, transform, 36, 100));
+        render_queue.sort();
+        BT_CHECK(render_queue.get_instance_batches().size() == 2);
+        check_batches_share_geometry(render_queue);
+    }
+
+    {   // Same sort key, different base vertex.
+        Render_queue render_queue;
+        render_queue.emplace_draw_item(make_test_draw_item(5, transform, 0, 100));
+        render_queue.emplace_draw_item(make_test_draw_item(5, transform, 0, 200));
+        render_queue.sort();
+        BT_CHECK(render_queue.get_instance_batches().size() == 2);
+        check_batches_share_geometry(render_queue);
+    }
+
+    {   // Same sort key, different index count.
+        Render_queue render_queue;
+        render_queue.emplace_draw_item(make_test_draw_item(5, transform, 0, 100, 36));
+        render_queue.emplace_draw_item(make_test_draw_item(5, transform, 0, 100, 72));
+        render_queue.sort();
+        BT_CHECK(render_queue.get_instance_batches().size() == 2);
+        check_batches_share_geometry(render_queue);
+    }
+}
+
+BT_TEST(render_queue_batch_transforms_belong_to_batch_mesh)
+{
+    // Interleaved meshes, so sorting has to group them.
+    constexpr uint32_t k_mesh_ids[]{ 3, 1, 3, 2, 1, 3, 2, 3 };
+    constexpr size_t k_num_items{ std::size(k_mesh_ids) };
+    mat4 transforms[k_num_items];
+
+    Render_queue render_queue;
+    for (size_t i = 0; i < k_num_items; i++)
+    {   // Tag each transform w/ its mesh id.
+        glm_mat4_identity(transforms[i]);
+        transforms[i][3][1] = static_cast<float_t>(k_mesh_ids[i]);
+        render_queue.emplace_draw_item(make_test_draw_item(k_mesh_ids[i],
+                                                           transforms[i],
+                                                           k_mesh_ids[i] * 36,
+                                                           k_mesh_ids[i] * 24));
+    }
+    render_queue.sort();
+
+    auto const& batches{ render_queue.get_instance_batches() };
+    BT_CHECK(batches.size() == 3);
+    check_batches_share_geometry(render_queue);
+
+    // Batches cover the transforms back to back, each only covering transforms of its own mesh.
+    auto const& draw_items{ render_queue.get_draw_items() };
+    auto const& instance_transforms{ render_queue.get_instance_transforms() };
+    uint32_t num_covered_instances{ 0 };
+    for (auto const& batch : batches)
+    {
+        auto const& first_item{ draw_items[batch.first_draw_item_idx] };
+        float_t mesh_id{ static_cast<float_t>(first_item.first_index / 36) };
+        for (uint32_t i = 0; i < batch.num_instances; i++)
+            BT_CHECK(instance_transforms[batch.first_draw_item_idx + i].raw[3][1] == mesh_id);
+
+        BT_CHECK(batch.first_draw_item_idx == num_covered_instances);
+        num_covered_instances += batch.num_instances;
+    }
+    BT_CHECK(num_covered_instances == k_num_items);
+}
+
+BT_TEST(render_queue_without_instancing_draws_each_item_alone)
+{
+    mat4 transform;
+    glm_mat4_identity(transform);
+
+    Render_queue render_queue;
+    render_queue.set_instancing_enabled(false);
+    for (size_t i = 0; i < 4; i++)
+        render_queue.emplace_draw_item(make_test_draw_item(5, transform, 0, 0));
+    render_queue.sort();
+
+    BT_CHECK(render_queue.get_instance_batches().size() == 4);
+    for (auto const& batch : render_queue.get_instance_batches())
+        BT_CHECK(batch.num_instances == 1);
+}
+
+BT_TEST(render_queue_builds_indirect_command_per_batch)
+{
+    // Interleaved meshes, so sorting has to group them.
+    constexpr uint32_t k_mesh_ids[]{ 3, 1, 3, 2, 1, 3, 2, 3 };
+    constexpr size_t k_num_items{ std::size(k_mesh_ids) };
+    mat4 transforms[k_num_items];
+
+    Render_queue render_queue;
+    for (size_t i = 0; i < k_num_items; i++)
+    {   // Tag each transform w/ its mesh id.
+        glm_mat4_identity(transforms[i]);
+        transforms[i][3][1] = static_cast<float_t>(k_mesh_ids[i]);
+        render_queue.emplace_draw_item(make_test_draw_item(k_mesh_ids[i],
+                                                           transforms[i],
+                                                           k_mesh_ids[i] * 36,
+                                                           k_mesh_ids[i] * 24));
+    }
+    render_queue.sort();
+    check_indirect_commands_match_batches(render_queue);
+
+    // Base instance to base instance + instance count covers transforms of that mesh only.
+    auto const& instance_transforms{ render_queue.get_instance_transforms() };
+    for (auto const& command : render_queue.get_indirect_commands())
+    {
+        float_t mesh_id{ static_cast<float_t>(command.first_index / 36) };
+        for (uint32_t i = 0; i < command.instance_count; i++)
+            BT_CHECK(instance_transforms[command.base_instance + i].raw[3][1] == mesh_id);
+    }
+
+    // All meshes are in the same buffers w/ the same material, so it's a single multi-draw.
+    auto const& groups{ render_queue.get_multi_draw_groups() };
+    BT_CHECK(groups.size() == 1);
+    BT_CHECK(groups.size() == 1 && groups[0].first_command_idx == 0 && groups[0].num_commands == 3);
+}
+
+BT_TEST(render_queue_splits_multi_draws_on_different_buffers)
+{
+    mat4 transform;
+    glm_mat4_identity(transform);
+
+    // Meshes 1 and 2 share buffers, mesh 3 is in another index buffer (eg. another arena).
+    auto draw_item_in_other_ebo{ make_test_draw_item(3, transform, 0, 0) };
+    draw_item_in_other_ebo.index_ebo = k_test_ebo + 1;
+
+    Render_queue render_queue;
+    render_queue.emplace_draw_item(make_test_draw_item(1, transform, 0, 0));
+    render_queue.emplace_draw_item(draw_item_in_other_ebo);
+    render_queue.emplace_draw_item(make_test_draw_item(2, transform, 36, 24));
+    render_queue.emplace_draw_item(make_test_draw_item(1, transform, 0, 0));
+    render_queue.sort();
+    check_indirect_commands_match_batches(render_queue);
+
+    // Groups cover the commands back to back.
+    auto const& groups{ render_queue.get_multi_draw_groups() };
+    BT_CHECK(groups.size() == 2);
+    BT_CHECK(groups.size() == 2 && groups[0].first_command_idx == 0 && groups[0].num_commands == 2);
+    BT_CHECK(groups.size() == 2 && groups[1].first_command_idx == 2 && groups[1].num_commands == 1);
+}
+
+BT_TEST(render_queue_sort_key_orders_layer_shader_material_mesh)
+{
+    using BT::RENDER_LAYER_DEFAULT;
+    auto const base_key{ Render_queue::make_sort_key(RENDER_LAYER_DEFAULT, 5, 5, 5) };
+
+    // Each field outranks all fields after it, even at their max values.
+    BT_CHECK(Render_queue::make_sort_key(RENDER_LAYER_DEFAULT, 5, 5, 6) > base_key);
+    BT_CHECK(Render_queue::make_sort_key(RENDER_LAYER_DEFAULT, 5, 6, 0) >
+             Render_queue::make_sort_key(RENDER_LAYER_DEFAULT, 5, 5, 0xFFFFFF));
+    BT_CHECK(Render_queue::make_sort_key(RENDER_LAYER_DEFAULT, 6, 0, 0) >
+             Render_queue::make_sort_key(RENDER_LAYER_DEFAULT, 5, 0xFFFF, 0xFFFFFF));
+    BT_CHECK(Render_queue::make_sort_key(BT::RENDER_LAYER_INVISIBLE, 0, 0, 0) >
+             Render_queue::make_sort_key(RENDER_LAYER_DEFAULT, 0xFFFF, 0xFFFF, 0xFFFFFF));
+
+    BT_CHECK(Render_queue::get_shader_id_from_sort_key(base_key) == 5);
+    BT_CHECK(Render_queue::get_shader_id_from_sort_key(
+                 Render_queue::make_sort_key(RENDER_LAYER_DEFAULT, 0xFFFF, 0xFFFF, 0xFFFFFF)) ==
+             0xFFFF);
+}
+
+BT_TEST(render_queue_calc_stats_counts_state_changes)
+{
+    mat4 transform;
+    glm_mat4_identity(transform);
+    Test_material materials[3];
+
+    auto make_draw_item{ [&](uint16_t shader_id,
+                             uint16_t material_id,
+                             uint32_t mesh_id,
+                             uint32_t vertex_vao) {
+        return Render_queue::Draw_item{
+            Render_queue::make_sort_key(BT::RENDER_LAYER_DEFAULT, shader_id, material_id, mesh_id),
+            &materials[material_id],
+            vertex_vao,
+            k_test_ebo,
+            36,
+            transform,
+            mesh_id * 36,
+            0
+        };
+    } };
+
+    // Sorted, these are: shader 0 { material 0 { mesh 1 (x2, vao 7), mesh 2 (vao 8) },
+    // material 1 { mesh 1 (vao 8) } }, shader 1 { material 2 { mesh 1 (vao 8), mesh 2 (vao 7) } }.
+    Render_queue::Draw_item const draw_items[]{
+        make_draw_item(1, 2, 2, k_test_vao),
+        make_draw_item(0, 0, 2, k_test_vao + 1),
+        make_draw_item(0, 0, 1, k_test_vao),
+        make_draw_item(1, 2, 1, k_test_vao + 1),
+        make_draw_item(0, 1, 1, k_test_vao + 1),
+        make_draw_item(0, 0, 1, k_test_vao),
+    };
+
+    Render_queue render_queue;
+    for (auto const& draw_item : draw_items)
+        render_queue.emplace_draw_item(draw_item);
+    render_queue.sort();
+
+    auto stats{ render_queue.calc_stats() };
+    BT_CHECK(stats.num_draws == 5);
+    BT_CHECK(stats.num_instances == 6);
+    BT_CHECK(stats.num_shader_changes == 2);
+    BT_CHECK(stats.num_material_binds == 3);
+    BT_CHECK(stats.num_vao_binds == 3);
+
+    // W/o instancing, the two mesh 1 draws get drawn apart, but don't need any more binds.
+    render_queue.set_instancing_enabled(false);
+    render_queue.sort();
+    stats = render_queue.calc_stats();
+    BT_CHECK(stats.num_draws == 6);
+    BT_CHECK(stats.num_instances == 6);
+    BT_CHECK(stats.num_shader_changes == 2);
+    BT_CHECK(stats.num_material_binds == 3);
+    BT_CHECK(stats.num_vao_binds == 3);
+}
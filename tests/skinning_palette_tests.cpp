@@ -0,0 +1,183 @@
+#include "btglm.h"
+#include "renderer/mesh.h"
+#include "test_harness.h"
+
+#include <cmath>
+#include <vector>
+
+
+namespace
+{
+
+using namespace BT;
+
+/// Joint matrix from a rotation (axis angle), non-uniform scale and translation.
+void make_joint_matrix(float_t angle,
+                       vec3 const& axis,
+                       vec3 const& scale,
+                       vec3 const& translation,
+                       mat4 out_matrix)
+{
+    glm_translate_make(out_matrix, const_cast<float_t*>(translation));
+    glm_rotate(out_matrix, angle, const_cast<float_t*>(axis));
+    glm_scale(out_matrix, const_cast<float_t*>(scale));
+}
+
+/// What `skinned_mesh.comp` used to do per vertex: blend the joint matrices, then take the
+/// inverse transpose of the blended upper 3x3.
+void calc_reference_normal(mat4 const* joint_matrices,
+                           Vertex_skin_data const& skin_data,
+                           vec3 normal,
+                           vec3 out_normal)
+{
+    mat4 deform_transform = GLM_MAT4_ZERO_INIT;
+    for (uint32_t j = 0; j < 4; j++)
+    for (uint32_t col = 0; col < 4; col++)
+    for (uint32_t row = 0; row < 4; row++)
+    {
+        deform_transform[col][row] +=
+            joint_matrices[skin_data.joint_mat_idxs[j]][col][row] * skin_data.weights[j];
+    }
+
+    mat3 normal_transform;
+    glm_mat4_pick3(deform_transform, normal_transform);
+    glm_mat3_inv(normal_transform, normal_transform);
+    glm_mat3_transpose(normal_transform);
+    glm_mat3_mulv(normal_transform, normal, out_normal);
+    glm_vec3_normalize(out_normal);
+}
+
+/// What `skinned_mesh.comp` does now: blend the palette's per-joint normal matrices.
+void calc_palette_normal(mat4 const* joint_matrices,
+                         Vertex_skin_data const& skin_data,
+                         vec3 normal,
+                         vec3 out_normal)
+{
+    mat3 normal_transform = GLM_MAT3_ZERO_INIT;
+    for (uint32_t j = 0; j < 4; j++)
+    {
+        mat3 joint_normal_matrix;
+        btglm_mat4_normal_matrix(joint_matrices[skin_data.joint_mat_idxs[j]],
+                                 joint_normal_matrix);
+        for (uint32_t col = 0; col < 3; col++)
+        for (uint32_t row = 0; row < 3; row++)
+            normal_transform[col][row] += joint_normal_matrix[col][row] * skin_data.weights[j];
+    }
+
+    glm_mat3_mulv(normal_transform, normal, out_normal);
+    glm_vec3_normalize(out_normal);
+}
+
+/// Normals pointing in a spread of directions.
+std::vector<Vertex> make_test_vertices()
+{
+    std::vector<Vertex> vertices;
+    for (int32_t x = -1; x <= 1; x++)
+    for (int32_t y = -1; y <= 1; y++)
+    for (int32_t z = -1; z <= 1; z++)
+    {
+        if (x == 0 && y == 0 && z == 0)
+            continue;
+
+        Vertex vertex{ { x * 0.5f, y * 2.0f, z * 1.0f },
+                       { static_cast<float_t>(x), static_cast<float_t>(y), static_cast<float_t>(z) },
+                       { 0.0f, 0.0f } };
+        glm_vec3_normalize(vertex.normal);
+        vertices.emplace_back(vertex);
+    }
+    return vertices;
+}
+
+/// Checks palette normals against the old per-vertex formula for every test vertex.
+void check_palette_normals_match_reference(mat4 const* joint_matrices,
+                                           Vertex_skin_data const& skin_data)
+{
+    for (auto& vertex : make_test_vertices())
+    {
+        vec3 palette_normal;
+        vec3 reference_normal;
+        calc_palette_normal(joint_matrices, skin_data, vertex.normal, palette_normal);
+        calc_reference_normal(joint_matrices, skin_data, vertex.normal, reference_normal);
+        for (uint32_t axis = 0; axis < 3; axis++)
+            BT_CHECK_NEAR(palette_normal[axis], reference_normal[axis], 1e-5f);
+    }
+}
+
+}  // namespace
+
+
+BT_TEST(palette_normals_match_reference_for_single_joint)
+{
+    // Rotations w/ non-uniform scales, one joint per vertex.
+    constexpr uint32_t k_num_joints{ 3 };
+    mat4 joint_matrices[k_num_joints];
+    make_joint_matrix(0.7f, vec3{ 0, 1, 0 }, vec3{ 1.0f, 3.0f, 0.5f }, vec3{ 1, 2, 3 },
+                      joint_matrices[0]);
+    make_joint_matrix(-2.1f, vec3{ 1, 1, 0 }, vec3{ 0.2f, 0.2f, 4.0f }, vec3{ 0, -5, 0 },
+                      joint_matrices[1]);
+    make_joint_matrix(3.0f, vec3{ 0, 0, 1 }, vec3{ -1.0f, 1.0f, 1.0f }, vec3{ 0, 0, 0 },
+                      joint_matrices[2]);  // Mirrored.
+
+    for (uint32_t joint_idx = 0; joint_idx < k_num_joints; joint_idx++)
+    {
+        Vertex_skin_data skin_data{ { joint_idx, 0, 0, 0 }, { 1.0f, 0.0f, 0.0f, 0.0f } };
+        check_palette_normals_match_reference(joint_matrices, skin_data);
+    }
+}
+
+BT_TEST(palette_normals_match_reference_for_blends_of_same_matrix)
+{
+    mat4 joint_matrices[4];
+    for (auto& joint_matrix : joint_matrices)
+        make_joint_matrix(1.3f, vec3{ 1, 2, 3 }, vec3{ 2.0f, 0.5f, 1.0f }, vec3{ 0, 1, 0 },
+                          joint_matrix);
+
+    Vertex_skin_data skin_data{ { 0, 1, 2, 3 }, { 0.1f, 0.2f, 0.3f, 0.4f } };
+    check_palette_normals_match_reference(joint_matrices, skin_data);
+}
+
+BT_TEST(palette_normals_stay_close_to_reference_for_blended_rigid_joints)
+{
+    // Blending different rotations is where blending normal matrices is an approximation.
+    // @NOTE: Halfway between rotations 60 deg apart, the blended 3x3 is the 30 deg rotation scaled
+    //        by cos(30 deg) across the rotation axis, so the worst case is
+    //        atan(1 / cos(30 deg)) - atan(cos(30 deg)), about 8.2 deg.
+    mat4 joint_matrices[2];
+    make_joint_matrix(0.0f, vec3{ 0, 1, 0 }, vec3{ 1, 1, 1 }, vec3{ 0, 0, 0 }, joint_matrices[0]);
+    make_joint_matrix(glm_rad(60.0f), vec3{ 1, 1, 0 }, vec3{ 1, 1, 1 }, vec3{ 0, 0, 0 },
+                      joint_matrices[1]);
+
+    Vertex_skin_data skin_data{ { 0, 1, 0, 0 }, { 0.5f, 0.5f, 0.0f, 0.0f } };
+    for (auto& vertex : make_test_vertices())
+    {
+        vec3 palette_normal;
+        vec3 reference_normal;
+        calc_palette_normal(joint_matrices, skin_data, vertex.normal, palette_normal);
+        calc_reference_normal(joint_matrices, skin_data, vertex.normal, reference_normal);
+        BT_CHECK(glm_vec3_dot(palette_normal, reference_normal) > std::cos(glm_rad(8.5f)));
+    }
+}
+
+BT_TEST(palette_normal_matrix_handles_singular_joint)
+{
+    // Flattened onto the XY plane, so every normal w/ a Z part ends up pointing along Z.
+    mat4 joint_matrix;
+    make_joint_matrix(0.0f, vec3{ 0, 1, 0 }, vec3{ 2.0f, 2.0f, 0.0f }, vec3{ 0, 0, 0 },
+                      joint_matrix);
+
+    mat3 normal_matrix;
+    btglm_mat4_normal_matrix(joint_matrix, normal_matrix);
+    for (uint32_t col = 0; col < 3; col++)
+    for (uint32_t row = 0; row < 3; row++)
+        BT_CHECK(std::isfinite(normal_matrix[col][row]));
+
+    Vertex_skin_data skin_data{ { 0, 0, 0, 0 }, { 1.0f, 0.0f, 0.0f, 0.0f } };
+    for (auto& vertex : make_test_vertices())
+    {
+        vec3 normal;
+        calc_palette_normal(&joint_matrix, skin_data, vertex.normal, normal);
+        BT_CHECK(std::isfinite(normal[0]) && std::isfinite(normal[1]) && std::isfinite(normal[2]));
+        if (vertex.normal[2] != 0.0f)
+            BT_CHECK_NEAR(std::abs(normal[2]), 1.0f, 1e-5f);
+    }
+}
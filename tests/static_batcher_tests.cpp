@@ -0,0 +1,224 @@
+#include "btglm.h"
+#include "renderer/material.h"
+#include "renderer/mesh.h"
+#include "renderer/static_batcher.h"
+#include "test_harness.h"
+
+#include <cmath>
+#include <cstdlib>
+#include <vector>
+
+
+namespace
+{
+
+using namespace BT;
+
+/// Stands in for a distinct material. Merging only compares material pointers, so it never gets
+/// bound.
+class Test_material : public Material_ifc
+{
+public:
+    Shader const& get_shader() const override { std::abort(); }
+    void bind_material_shared() override {}
+    void set_material_transform(mat4 transform) override {}
+    void unbind_material() override {}
+};
+
+/// Unit quad on the XY plane w/ tilted normals, plus a vertex that no index uses.
+struct Test_model
+{
+    vector<Vertex> vertices;
+    vector<uint32_t> indices;
+    AA_bounding_box model_aabb;
+
+    Test_model()
+    {
+        constexpr float_t k_inv_sqrt_2{ 0.70710678f };
+        constexpr float_t k_positions[5][3]{
+            { 0, 0, 0 }, { 1, 0, 0 }, { 1, 1, 0 }, { 0, 1, 0 }, { 9, 9, 9 }
+        };
+        for (auto const& position : k_positions)
+        {
+            Vertex vertex{ { position[0], position[1], position[2] },
+                           { k_inv_sqrt_2, 0.0f, k_inv_sqrt_2 },
+                           { 0.0f, 0.0f } };
+            vertices.emplace_back(vertex);
+        }
+        indices = { 0, 1, 2, 0, 2, 3 };
+
+        model_aabb.reset();
+        for (size_t i = 0; i < 4; i++)
+            model_aabb.feed_position(vertices[i].position);
+    }
+
+    static_batcher::Source make_source(mat4s const& transform,
+                                       Material_ifc* material,
+                                       Render_layer layer = RENDER_LAYER_DEFAULT) const
+    {
+        return static_batcher::Source{ .vertices = &vertices,
+                                       .meshes = { { &indices, material } },
+                                       .model_aabb = &model_aabb,
+                                       .transform = transform.raw,
+                                       .layer = layer };
+    }
+};
+
+mat4s make_transform(float_t angle, vec3 const& scale, vec3 const& translation)
+{
+    mat4s transform;
+    glm_translate_make(transform.raw, const_cast<float_t*>(translation));
+    vec3 up{ 0.0f, 1.0f, 0.0f };
+    glm_rotate(transform.raw, angle, up);
+    glm_scale(transform.raw, const_cast<float_t*>(scale));
+    return transform;
+}
+
+/// What the merged vertex should be: position transformed, normal by the inverse transpose.
+void calc_reference_vertex(mat4s const& transform, Vertex const& vertex, Vertex& out_vertex)
+{
+    mat4 matrix;
+    glm_mat4_copy(const_cast<vec4*>(transform.raw), matrix);
+    glm_mat4_mulv3(matrix, const_cast<float_t*>(vertex.position), 1.0f, out_vertex.position);
+
+    mat3 normal_matrix;
+    glm_mat4_pick3(matrix, normal_matrix);
+    glm_mat3_inv(normal_matrix, normal_matrix);
+    glm_mat3_transpose(normal_matrix);
+    glm_mat3_mulv(normal_matrix, const_cast<float_t*>(vertex.normal), out_vertex.normal);
+    glm_vec3_normalize(out_vertex.normal);
+}
+
+constexpr float_t k_big_cell_size{ 1000.0f };
+constexpr size_t k_big_max_vertices{ 1000 };
+
+}  // namespace
+
+
+BT_TEST(static_batcher_merges_sources_into_world_space)
+{
+    Test_model model;
+    Test_material material;
+    mat4s transforms[2]{
+        make_transform(0.0f, vec3{ 1, 1, 1 }, vec3{ 10, 0, 0 }),
+        make_transform(glm_rad(90.0f), vec3{ 2.0f, 1.0f, 0.5f }, vec3{ 2, 3, 5 }),
+    };
+
+    auto batches{ static_batcher::merge(
+        { model.make_source(transforms[0], &material), model.make_source(transforms[1], &material) },
+        k_big_cell_size,
+        k_big_max_vertices) };
+    BT_CHECK(batches.size() == 1);
+    if (batches.size() != 1)
+        return;
+
+    // Only used vertices get copied, and each source's indices are offset past the previous ones.
+    auto const& batch{ batches[0] };
+    BT_CHECK(batch.material == &material);
+    BT_CHECK(batch.num_merged_meshes == 2);
+    BT_CHECK(batch.vertices.size() == 8);
+    BT_CHECK(batch.indices.size() == 12);
+    for (size_t i = 0; i < 6 && i + 6 < batch.indices.size(); i++)
+    {
+        BT_CHECK(batch.indices[i] == model.indices[i]);
+        BT_CHECK(batch.indices[i + 6] == model.indices[i] + 4);
+    }
+
+    for (size_t source_idx = 0; source_idx < 2; source_idx++)
+    for (size_t i = 0; i < 4 && source_idx * 4 + i < batch.vertices.size(); i++)
+    {
+        Vertex reference_vertex;
+        calc_reference_vertex(transforms[source_idx], model.vertices[i], reference_vertex);
+
+        auto const& merged_vertex{ batch.vertices[source_idx * 4 + i] };
+        for (uint32_t axis = 0; axis < 3; axis++)
+        {
+            BT_CHECK_NEAR(merged_vertex.position[axis], reference_vertex.position[axis], 1e-5f);
+            BT_CHECK_NEAR(merged_vertex.normal[axis], reference_vertex.normal[axis], 1e-5f);
+        }
+    }
+
+    // Bounds cover both quads.
+    BT_CHECK_NEAR(batch.world_aabb.min[0], 2.0f, 1e-5f);
+    BT_CHECK_NEAR(batch.world_aabb.max[0], 11.0f, 1e-5f);
+    BT_CHECK_NEAR(batch.world_aabb.min[1], 0.0f, 1e-5f);
+    BT_CHECK_NEAR(batch.world_aabb.max[1], 4.0f, 1e-5f);
+    BT_CHECK_NEAR(batch.world_aabb.min[2], 0.0f, 1e-5f);
+    BT_CHECK_NEAR(batch.world_aabb.max[2], 5.0f, 1e-5f);
+}
+
+BT_TEST(static_batcher_splits_by_material_layer_and_cell)
+{
+    Test_model model;
+    Test_material material_a;
+    Test_material material_b;
+    mat4s near_transform{ make_transform(0.0f, vec3{ 1, 1, 1 }, vec3{ 1, 0, 1 }) };
+    mat4s other_near_transform{ make_transform(0.0f, vec3{ 1, 1, 1 }, vec3{ 20, 0, 20 }) };
+    mat4s far_transform{ make_transform(0.0f, vec3{ 1, 1, 1 }, vec3{ 100, 0, 1 }) };
+
+    constexpr float_t k_cell_size{ 32.0f };
+    auto batches{ static_batcher::merge(
+        {
+            model.make_source(near_transform, &material_a),
+            model.make_source(far_transform, &material_a),  // Other cell.
+            model.make_source(near_transform, &material_b),  // Other material.
+            model.make_source(near_transform, &material_a, RENDER_LAYER_LEVEL_EDITOR),
+            model.make_source(other_near_transform, &material_a),  // Same as first.
+        },
+        k_cell_size,
+        k_big_max_vertices) };
+
+    // In order of first appearance.
+    BT_CHECK(batches.size() == 4);
+    if (batches.size() != 4)
+        return;
+
+    BT_CHECK(batches[0].material == &material_a && batches[0].num_merged_meshes == 2);
+    BT_CHECK(batches[0].cell[0] == 0 && batches[0].cell[1] == 0 && batches[0].cell[2] == 0);
+    BT_CHECK(batches[1].material == &material_a && batches[1].cell[0] == 3);
+    BT_CHECK(batches[2].material == &material_b);
+    BT_CHECK(batches[3].layer == RENDER_LAYER_LEVEL_EDITOR);
+    for (size_t i = 1; i < 4; i++)
+        BT_CHECK(batches[i].num_merged_meshes == 1 && batches[i].vertices.size() == 4);
+
+    // Batch bounds only cover their own cell's sources.
+    BT_CHECK(batches[0].world_aabb.max[0] < k_cell_size);
+    BT_CHECK(batches[1].world_aabb.min[0] >= 3 * k_cell_size);
+}
+
+BT_TEST(static_batcher_starts_new_batch_at_max_vertices)
+{
+    Test_model model;
+    Test_material material;
+    mat4s transform{ make_transform(0.0f, vec3{ 1, 1, 1 }, vec3{ 0, 0, 0 }) };
+
+    vector<static_batcher::Source> sources(5, model.make_source(transform, &material));
+    auto batches{ static_batcher::merge(sources, k_big_cell_size, 8) };
+    BT_CHECK(batches.size() == 3);
+    if (batches.size() != 3)
+        return;
+
+    BT_CHECK(batches[0].vertices.size() == 8 && batches[0].indices.size() == 12);
+    BT_CHECK(batches[1].vertices.size() == 8);
+    BT_CHECK(batches[2].vertices.size() == 4 && batches[2].indices.size() == 6);
+}
+
+BT_TEST(static_batcher_handles_flattened_transform)
+{
+    // Scaled to 0 along Z, which has no inverse.
+    Test_model model;
+    Test_material material;
+    mat4s transform{ make_transform(0.0f, vec3{ 1.0f, 1.0f, 0.0f }, vec3{ 0, 0, 0 }) };
+
+    auto batches{ static_batcher::merge(
+        { model.make_source(transform, &material) }, k_big_cell_size, k_big_max_vertices) };
+    BT_CHECK(batches.size() == 1);
+    for (auto const& batch : batches)
+    for (auto const& vertex : batch.vertices)
+    {
+        BT_CHECK(std::isfinite(vertex.normal[0]));
+        BT_CHECK(std::isfinite(vertex.normal[1]));
+        BT_CHECK(std::isfinite(vertex.normal[2]));
+        BT_CHECK_NEAR(std::abs(vertex.normal[2]), 1.0f, 1e-5f);  // Flattened onto the XY plane.
+    }
+}
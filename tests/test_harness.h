@@ -0,0 +1,52 @@
+#pragma once
+
+#include <cmath>
+#include <cstdint>
+#include <vector>
+
+
+namespace BT
+{
+namespace test
+{
+
+using Test_func = void (*)();
+
+struct Test_case
+{
+    char const* name;
+    Test_func func;
+};
+
+/// All tests defined with `BT_TEST()`, in registration order.
+std::vector<Test_case>& get_registered_tests();
+
+/// Registers a test at static init time (use `BT_TEST()` instead).
+struct Test_registrar
+{
+    Test_registrar(char const* name, Test_func func);
+};
+
+/// Records a failed check for the currently running test.
+void report_failed_check(char const* expr, char const* file, int32_t line);
+
+}  // namespace test
+}  // namespace BT
+
+
+/// Defines and registers a test.
+#define BT_TEST(test_name)                                                                  \
+    static void test_name();                                                                \
+    static BT::test::Test_registrar s_##test_name##_registrar{ #test_name, test_name };     \
+    static void test_name()
+
+/// Checks that `expr` is true. The test keeps running after a failed check.
+#define BT_CHECK(expr)                                                                      \
+    do                                                                                      \
+    {                                                                                       \
+        if (!(expr))                                                                        \
+            BT::test::report_failed_check(#expr, __FILE__, __LINE__);                       \
+    } while (false)
+
+/// Checks that `a` and `b` are at most `epsilon` apart.
+#define BT_CHECK_NEAR(a, b, epsilon)  BT_CHECK(std::abs((a) - (b)) <= (epsilon))
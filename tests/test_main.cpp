@@ -0,0 +1,55 @@
+#include "btlogger.h"
+#include "test_harness.h"
+
+#include <cstddef>
+#include <cstdint>
+
+
+namespace
+{
+
+size_t s_num_failed_checks{ 0 };
+
+}  // namespace
+
+std::vector<BT::test::Test_case>& BT::test::get_registered_tests()
+{
+    static std::vector<Test_case> s_registered_tests;
+    return s_registered_tests;
+}
+
+BT::test::Test_registrar::Test_registrar(char const* name, Test_func func)
+{
+    get_registered_tests().emplace_back(name, func);
+}
+
+void BT::test::report_failed_check(char const* expr, char const* file, int32_t line)
+{
+    BT_ERRORF("  Check failed: `%s` (%s:%d)", expr, file, line);
+    s_num_failed_checks++;
+}
+
+int32_t main()
+{
+    size_t num_failed_tests{ 0 };
+    for (auto const& test_case : BT::test::get_registered_tests())
+    {
+        s_num_failed_checks = 0;
+        test_case.func();
+
+        if (s_num_failed_checks == 0)
+        {
+            BT_TRACEF("PASS  %s", test_case.name);
+        }
+        else
+        {
+            BT_ERRORF("FAIL  %s (%zu failed checks)", test_case.name, s_num_failed_checks);
+            num_failed_tests++;
+        }
+    }
+
+    BT_TRACEF("%zu/%zu tests passed",
+              BT::test::get_registered_tests().size() - num_failed_tests,
+              BT::test::get_registered_tests().size());
+    return (num_failed_tests == 0 ? 0 : 1);
+}